@@ -0,0 +1,43 @@
+#include <benchmark/benchmark.h>
+#include <bitset_utils.hpp>
+
+using namespace noarch::bit_manip;
+
+namespace
+{
+
+template <std::size_t BYTES> void BM_bitset_to_bytearray(benchmark::State &state)
+{
+    std::bitset<BYTES * 8> source;
+    for (std::size_t idx = 0; idx < source.size(); idx += 3) { source.set(idx); }
+    std::array<uint8_t, BYTES> target;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(source);
+        benchmark::DoNotOptimize(bitset_to_bytearray(target, source));
+        benchmark::DoNotOptimize(target.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * BYTES));
+}
+
+/// @brief A 16-bit field inserted into a wider register image
+template <std::size_t TARGET_SIZE> void BM_insert_bitset_at_offset(benchmark::State &state)
+{
+    std::bitset<TARGET_SIZE> target;
+    const std::bitset<16> source{0xA5C3};
+    const uint16_t offset = static_cast<uint16_t>(state.range(0));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(source);
+        benchmark::DoNotOptimize(insert_bitset_at_offset(target, source, offset));
+        benchmark::DoNotOptimize(target);
+    }
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_bitset_to_bytearray, 8);
+BENCHMARK_TEMPLATE(BM_bitset_to_bytearray, 32);
+BENCHMARK_TEMPLATE(BM_insert_bitset_at_offset, 64)->Arg(0)->Arg(48);
+BENCHMARK_TEMPLATE(BM_insert_bitset_at_offset, 256)->Arg(0)->Arg(240);
@@ -0,0 +1,33 @@
+#include <array>
+#include <benchmark/benchmark.h>
+#include <byte_utils.hpp>
+#include <sstream>
+
+using namespace noarch::byte_manip;
+
+namespace
+{
+
+/// @brief print_bytes() formats into std::cout on X86, which is pointed at a string for the timed loop
+template <std::size_t SIZE> void BM_print_bytes(benchmark::State &state)
+{
+    std::array<uint8_t, SIZE> bytes;
+    for (std::size_t idx = 0; idx < SIZE; idx++) { bytes[idx] = static_cast<uint8_t>(idx * 7); }
+
+    std::ostringstream sink;
+    std::streambuf *const console = std::cout.rdbuf(sink.rdbuf());
+    const std::ios_base::fmtflags flags = std::cout.flags();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(print_bytes(bytes));
+        sink.str(std::string());
+    }
+    std::cout.flags(flags);
+    std::cout.rdbuf(console);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * SIZE));
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_print_bytes, 16);
+BENCHMARK_TEMPLATE(BM_print_bytes, 64);
@@ -0,0 +1,32 @@
+#include <benchmark/benchmark.h>
+#include <static_map.hpp>
+
+using namespace noarch::containers;
+
+namespace
+{
+
+// keys 0..SIZE-1, so the key is also the number of pairs searched before it
+template <std::size_t SIZE> StaticMap<int, int, SIZE> make_map()
+{
+    StaticMap<int, int, SIZE> map;
+    for (std::size_t idx = 0; idx < SIZE; idx++) { map.data[idx] = {static_cast<int>(idx), static_cast<int>(idx * 10)}; }
+    return map;
+}
+
+/// @brief find_key() is a linear search: the first, middle and last keys, and a missing one
+template <std::size_t SIZE> void BM_find_key(benchmark::State &state)
+{
+    StaticMap<int, int, SIZE> map = make_map<SIZE>();
+    int key = static_cast<int>(state.range(0));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(key);
+        benchmark::DoNotOptimize(map.find_key(key));
+    }
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_find_key, 8)->Arg(0)->Arg(4)->Arg(7)->Arg(-1);
+BENCHMARK_TEMPLATE(BM_find_key, 64)->Arg(0)->Arg(32)->Arg(63)->Arg(-1);
@@ -0,0 +1,64 @@
+#include <benchmark/benchmark.h>
+#include <static_string.hpp>
+
+using namespace noarch::containers;
+
+namespace
+{
+
+void BM_concat_literal(benchmark::State &state)
+{
+    StaticString<32> result;
+    for (auto _ : state)
+    {
+        result.concat(4, "Hello World!");
+        benchmark::DoNotOptimize(result.array().data());
+        benchmark::ClobberMemory();
+    }
+}
+
+void BM_concat_static_string(benchmark::State &state)
+{
+    StaticString<32> result;
+    StaticString<13> source{"Hello World!"};
+    for (auto _ : state)
+    {
+        result.concat(4, source);
+        benchmark::DoNotOptimize(result.array().data());
+        benchmark::ClobberMemory();
+    }
+}
+
+void BM_concat_array(benchmark::State &state)
+{
+    StaticString<32> result;
+    const std::array<char, 12> source{'H', 'e', 'l', 'l', 'o', ' ', 'W', 'o', 'r', 'l', 'd', '!'};
+    for (auto _ : state)
+    {
+        result.concat(4, source);
+        benchmark::DoNotOptimize(result.array().data());
+        benchmark::ClobberMemory();
+    }
+}
+
+/// @brief concat_int() converts one digit per iteration
+template <typename WIDTH> void BM_concat_int(benchmark::State &state)
+{
+    StaticString<32> result;
+    WIDTH number = static_cast<WIDTH>(state.range(0));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(number);
+        result.concat_int(4, number);
+        benchmark::DoNotOptimize(result.array().data());
+        benchmark::ClobberMemory();
+    }
+}
+
+} // namespace
+
+BENCHMARK(BM_concat_literal);
+BENCHMARK(BM_concat_static_string);
+BENCHMARK(BM_concat_array);
+BENCHMARK_TEMPLATE(BM_concat_int, uint8_t)->Arg(255);
+BENCHMARK_TEMPLATE(BM_concat_int, uint32_t)->Arg(7)->Arg(4294967295);
@@ -25,7 +25,8 @@ set(STACK_USAGE "-fstack-usage -Wstack-usage=2048")
 set(COVERAGE_FLAGS "--coverage")
 set(WARNING_FLAGS "-Wall -Werror -Wextra -Wdouble-promotion -Wformat=2 -Wformat-overflow -Wundef -Wformat-truncation -Wfloat-equal -Wshadow")
 set(COMMON_FLAGS " ${THREAD_FLAGS}  ${OPTIM_LVL} ${DEBUG_LVL} ${WARNING_FLAGS} ${STACK_USAGE} ${COVERAGE_FLAGS}  -pedantic  -fmessage-length=0 -ffunction-sections -fdata-sections -ffreestanding -fno-builtin")
-set(CMAKE_EXE_LINKER_FLAGS  "${COVERAGE_FLAGS}  " CACHE INTERNAL "exe link flags")
+# -rdynamic: export symbols so allocation_trace stack traces show function names
+set(CMAKE_EXE_LINKER_FLAGS  "${COVERAGE_FLAGS} -rdynamic " CACHE INTERNAL "exe link flags")
 
 # C compiler settings
 set(C_FLAGS "")
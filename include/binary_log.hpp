@@ -0,0 +1,228 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __BINARY_LOG_HPP__
+#define __BINARY_LOG_HPP__
+
+#include <array>
+#include <bit>
+#include <byte_utils.hpp>
+#include <cstdint>
+#include <restricted_base.hpp>
+#include <span>
+#include <static_string.hpp>
+#include <string_view>
+#include <type_traits>
+
+/// @brief Log a message without formatting it on the target. Only the format string's hash and the raw
+/// argument values are written to the logger's sink, tools/binary_log_decode.py turns them back into text.
+/// @param logger A noarch::binary_log::Logger
+/// @param format A string literal. "{}" is replaced by the next argument, see tools/binary_log_decode.py for format specs.
+/// The decoder finds log sites by scanning the sources for this macro, so the format must be a single literal.
+#define BINARY_LOG(logger, format, ...) \
+    (logger).template log<noarch::binary_log::fnv1a_32(format)>(__VA_OPT__(__VA_ARGS__))
+
+namespace noarch::binary_log
+{
+
+/// @brief The most arguments a single log site can carry
+inline constexpr std::size_t MAX_ARGUMENTS{8};
+
+/// @brief Each frame starts with this in the upper nibble of the header byte, the lower nibble is the argument count.
+/// The decoder uses it to find the start of the next frame if it joins the stream part way through.
+inline constexpr uint8_t FRAME_MARKER{0xA0};
+
+/// @brief Header byte plus the 32-bit log site ID
+inline constexpr std::size_t HEADER_SIZE{5};
+
+/// @brief Every argument is promoted to 4 bytes
+inline constexpr std::size_t ARGUMENT_SIZE{4};
+
+inline constexpr std::size_t MAX_FRAME_SIZE{HEADER_SIZE + (MAX_ARGUMENTS * ARGUMENT_SIZE)};
+
+/// @brief Storage for one encoded frame: [marker|count] [id, little endian] [argument, little endian]...
+using Frame = std::array<uint8_t, MAX_FRAME_SIZE>;
+
+/// @brief 32-bit FNV-1a hash. Used to give each log site an ID at compile time.
+/// Must match fnv1a_32() in tools/binary_log_decode.py.
+/// @param text The format string
+/// @return The hash
+constexpr uint32_t fnv1a_32(std::string_view text)
+{
+    uint32_t hash{0x811C9DC5};
+    for (const char c : text)
+    {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x01000193;
+    }
+    return hash;
+}
+
+/// @brief Promote a log argument to 32 bits. Signed integers are sign-extended, floating point is sent as
+/// the bit pattern of a float, enums as their underlying value.
+/// @tparam ARG Any arithmetic or enum type up to 32 bits wide, or double
+/// @param arg The argument value
+/// @return The 32-bit word to send
+template <typename ARG>
+constexpr uint32_t to_word(ARG arg)
+{
+    if constexpr (std::is_enum_v<ARG>)
+    {
+        return to_word(static_cast<std::underlying_type_t<ARG>>(arg));
+    }
+    else if constexpr (std::is_floating_point_v<ARG>)
+    {
+        return std::bit_cast<uint32_t>(static_cast<float>(arg));
+    }
+    else
+    {
+        static_assert(std::is_integral_v<ARG> && (sizeof(ARG) <= ARGUMENT_SIZE),
+                      "log arguments must be integers up to 32 bits, enums or floating point");
+        if constexpr (std::is_signed_v<ARG>) { return static_cast<uint32_t>(static_cast<int32_t>(arg)); }
+        else { return static_cast<uint32_t>(arg); }
+    }
+}
+
+/// @brief Write a frame for one log site
+/// @tparam ARGS The argument types, see to_word()
+/// @param frame The output frame
+/// @param id The log site ID
+/// @param args The argument values
+/// @return The number of bytes used in frame
+template <typename... ARGS>
+constexpr std::size_t encode(Frame &frame, uint32_t id, ARGS... args)
+{
+    static_assert(sizeof...(ARGS) <= MAX_ARGUMENTS, "too many log arguments");
+
+    std::size_t idx{0};
+    auto put_word = [&frame, &idx](uint32_t word) {
+        for (std::size_t shift = 0; shift < 32; shift += 8) { frame[idx++] = static_cast<uint8_t>(word >> shift); }
+    };
+
+    frame[idx++] = FRAME_MARKER | static_cast<uint8_t>(sizeof...(ARGS));
+    put_word(id);
+    (put_word(to_word(args)), ...);
+    return idx;
+}
+
+/// @brief Render an encoded frame as "#<id in hex> <arg> <arg>...", with the arguments as unsigned decimal.
+/// For showing a log on the target itself (e.g. on a display), where the format strings aren't available.
+/// @tparam CAPACITY The size of the StaticString
+/// @param frame An encoded frame, see encode()
+/// @param output The rendered text. Unused characters are left as they were.
+/// @return false if the frame is invalid or the text would not fit in output
+template <std::size_t CAPACITY>
+bool render(std::span<const uint8_t> frame, containers::StaticString<CAPACITY> &output)
+{
+    if ((frame.size() < HEADER_SIZE) || ((frame[0] & 0xF0) != FRAME_MARKER)) { return false; }
+    const std::size_t count = frame[0] & 0x0F;
+    if (frame.size() != HEADER_SIZE + (count * ARGUMENT_SIZE)) { return false; }
+
+    auto get_word = [&frame](std::size_t idx) {
+        return static_cast<uint32_t>(frame[idx]) | (static_cast<uint32_t>(frame[idx + 1]) << 8) |
+               (static_cast<uint32_t>(frame[idx + 2]) << 16) | (static_cast<uint32_t>(frame[idx + 3]) << 24);
+    };
+    auto digits = [](uint32_t word) {
+        std::size_t width{1};
+        while (word >= 10) { word /= 10; width++; }
+        return width;
+    };
+
+    // check the whole line fits before writing anything, concat_int() doesn't check the bounds
+    std::size_t length{1 + 8};
+    for (std::size_t arg = 0; arg < count; arg++) { length += 1 + digits(get_word(HEADER_SIZE + (arg * ARGUMENT_SIZE))); }
+    if (length > output.size()) { return false; }
+
+    static constexpr std::array<char, 16> hex{'0', '1', '2', '3', '4', '5', '6', '7',
+                                               '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'};
+    const uint32_t id = get_word(1);
+    std::size_t idx{0};
+    output[idx++] = '#';
+    for (int shift = 28; shift >= 0; shift -= 4) { output[idx++] = hex[(id >> shift) & 0xF]; }
+
+    for (std::size_t arg = 0; arg < count; arg++)
+    {
+        const uint32_t word = get_word(HEADER_SIZE + (arg * ARGUMENT_SIZE));
+        output[idx++] = ' ';
+        // concat_int() writes nothing for zero
+        if (word == 0) { output[idx] = '0'; }
+        else { output.concat_int(static_cast<int>(idx), word); }
+        idx += digits(word);
+    }
+    return true;
+}
+
+/// @brief Deferred-formatting logger. Each BINARY_LOG() call writes one frame (see encode()) to the sink,
+/// so the target stores no format strings and does no formatting. Frames are never split: if the sink
+/// doesn't have room for the whole frame it is dropped and counted, so the stream stays decodable.
+///
+/// Usage:
+///   static stm32::usart_ref::TransmitBuffer<256> usart5_tx(*USART5);
+///   static noarch::binary_log::Logger log(usart5_tx);
+///   BINARY_LOG(log, "adc channel {} read {:x}", channel, value);
+/// @tparam SINK Needs size(), capacity() and either write(std::span<const uint8_t>), e.g. stm32::usart_ref::TransmitBuffer,
+/// or push(std::span<const uint8_t>), e.g. a noarch::containers::StaticRingBuffer drained by DMA or RTT.
+/// The logger must be the sink's only writer, and log() must not be called from an interrupt.
+template <typename SINK>
+class Logger : public RestrictedBase
+{
+public:
+    /// @brief Construct the logger
+    /// @param sink Where frames are written. Must outlive the logger.
+    explicit Logger(SINK &sink) : m_sink(sink) {}
+
+    /// @brief Write one frame. Use BINARY_LOG() rather than calling this directly, so the decoder can find the format.
+    /// @tparam ID The log site ID, fnv1a_32() of the format string
+    /// @tparam ARGS The argument types, see to_word()
+    /// @param args The argument values
+    /// @return false if the frame was dropped because the sink was full
+    template <uint32_t ID, typename... ARGS>
+    bool log(ARGS... args)
+    {
+        Frame frame;
+        const std::size_t size = encode(frame, ID, args...);
+        if ((m_sink.capacity() - m_sink.size()) < size)
+        {
+            m_dropped++;
+            return false;
+        }
+        const std::span<const uint8_t> bytes(frame.data(), size);
+        if constexpr (requires { m_sink.push(bytes); }) { return m_sink.push(bytes) == size; }
+        else { return m_sink.write(bytes) == size; }
+    }
+
+    /// @brief The number of frames dropped because the sink was full, since construction or reset_statistics()
+    std::size_t dropped() const { return m_dropped; }
+
+    /// @brief Clear the dropped counter
+    void reset_statistics() { m_dropped = 0; }
+
+private:
+    SINK &m_sink;
+
+    std::size_t m_dropped{0};
+};
+
+} // namespace noarch::binary_log
+
+#endif // __BINARY_LOG_HPP__
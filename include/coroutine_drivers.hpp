@@ -0,0 +1,217 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __COROUTINE_DRIVERS_HPP__
+#define __COROUTINE_DRIVERS_HPP__
+
+#include <algorithm>
+#include <coroutine_scheduler.hpp>
+#include <i2c_transfer_ref.hpp>
+#include <spi_dma_ref.hpp>
+#include <usart_tx_ref.hpp>
+
+namespace stm32::coro
+{
+
+/// @brief Awaitable I2C transfers on an interrupt-driven i2c_ref::TransferEngine.
+/// The transfer is started when it is awaited and the task sleeps until irq_handler() finishes it,
+/// so other tasks run while the bus is busy:
+///
+///   stm32::coro::I2cBus i2c(scheduler, i2c1_engine);
+///   stm32::i2c_ref::Status status = co_await i2c.write(0x68 << 1, command);
+///
+/// Tasks sharing one engine should take turns; a transfer awaited while another is in progress returns BUSY.
+class I2cBus
+{
+public:
+  /// @brief Awaiter for one transfer. co_await returns ACK, NACK, ERROR, BUSY if the engine was already
+  /// busy, or TIMEOUT if the transfer hadn't finished by the deadline (the engine is then still busy).
+  class Transfer : public Awaiter
+  {
+  public:
+    Transfer(SchedulerBase &scheduler, i2c_ref::TransferEngine &engine, uint8_t addr, std::span<const uint8_t> tx_buffer,
+             std::span<uint8_t> rx_buffer, uint32_t timeout_us)
+        : Awaiter(scheduler, timeout_us), m_engine(engine), m_addr(addr), m_tx_buffer(tx_buffer), m_rx_buffer(rx_buffer)
+    {
+    }
+
+    bool await_ready()
+    {
+      if (m_rx_buffer.empty()) { m_started = m_engine.write(m_addr, m_tx_buffer); }
+      else if (m_tx_buffer.empty()) { m_started = m_engine.read(m_addr, m_rx_buffer); }
+      else { m_started = m_engine.transfer(m_addr, m_tx_buffer, m_rx_buffer); }
+
+      if (!m_started) { return true; }
+      return Awaiter::await_ready();
+    }
+
+    i2c_ref::Status await_resume() const
+    {
+      if (!m_started) { return i2c_ref::Status::BUSY; }
+      if (m_result == WaitStatus::TIMEOUT) { return i2c_ref::Status::TIMEOUT; }
+      return m_engine.status();
+    }
+
+  protected:
+    bool ready() override { return !m_engine.busy(); }
+
+  private:
+    i2c_ref::TransferEngine &m_engine;
+    uint8_t m_addr;
+    std::span<const uint8_t> m_tx_buffer;
+    std::span<uint8_t> m_rx_buffer;
+    bool m_started{false};
+  };
+
+  /// @param scheduler The scheduler that runs the awaiting tasks
+  /// @param engine The transfer engine. Its irq_handler() must be called from the I2C interrupt.
+  I2cBus(SchedulerBase &scheduler, i2c_ref::TransferEngine &engine) : m_scheduler(scheduler), m_engine(engine) {}
+
+  /// @brief START, addr+W, tx_buffer, STOP
+  Transfer write(uint8_t addr, std::span<const uint8_t> tx_buffer, uint32_t timeout_us = NO_TIMEOUT)
+  {
+    return Transfer(m_scheduler, m_engine, addr, tx_buffer, {}, timeout_us);
+  }
+
+  /// @brief START, addr+R, rx_buffer, STOP
+  Transfer read(uint8_t addr, std::span<uint8_t> rx_buffer, uint32_t timeout_us = NO_TIMEOUT)
+  {
+    return Transfer(m_scheduler, m_engine, addr, {}, rx_buffer, timeout_us);
+  }
+
+  /// @brief START, addr+W, tx_buffer, RESTART, addr+R, rx_buffer, STOP
+  Transfer transfer(uint8_t addr, std::span<const uint8_t> tx_buffer, std::span<uint8_t> rx_buffer, uint32_t timeout_us = NO_TIMEOUT)
+  {
+    return Transfer(m_scheduler, m_engine, addr, tx_buffer, rx_buffer, timeout_us);
+  }
+
+private:
+  SchedulerBase &m_scheduler;
+  i2c_ref::TransferEngine &m_engine;
+};
+
+/// @brief Awaitable one-shot transmits on a spi_ref::DmaTransmitter
+///
+///   stm32::coro::SpiDma spi(scheduler, spi1_dma);
+///   co_await spi.send(frame_buffer);
+class SpiDma
+{
+public:
+  /// @brief Awaiter for one transmit. co_await returns READY when the DMA has finished, ERROR if it failed
+  /// or the transmitter was already busy, TIMEOUT if it hadn't finished by the deadline.
+  class Send : public Awaiter
+  {
+  public:
+    Send(SchedulerBase &scheduler, spi_ref::DmaTransmitter &transmitter, std::span<const uint8_t> buffer, uint32_t timeout_us)
+        : Awaiter(scheduler, timeout_us), m_transmitter(transmitter), m_buffer(buffer)
+    {
+    }
+
+    bool await_ready()
+    {
+      m_started = m_transmitter.send(m_buffer);
+      if (!m_started) { return true; }
+      return Awaiter::await_ready();
+    }
+
+    WaitStatus await_resume() const
+    {
+      if (!m_started || (m_result == WaitStatus::READY && m_transmitter.last_event() == spi_ref::DmaEvent::ERROR)) { return WaitStatus::ERROR; }
+      return m_result;
+    }
+
+  protected:
+    bool ready() override { return !m_transmitter.busy(); }
+
+  private:
+    spi_ref::DmaTransmitter &m_transmitter;
+    std::span<const uint8_t> m_buffer;
+    bool m_started{false};
+  };
+
+  /// @param scheduler The scheduler that runs the awaiting tasks
+  /// @param transmitter The transmitter. Its irq_handler() must be called from the DMA interrupt.
+  SpiDma(SchedulerBase &scheduler, spi_ref::DmaTransmitter &transmitter) : m_scheduler(scheduler), m_transmitter(transmitter) {}
+
+  /// @brief Send a buffer of 8-bit frames. The buffer must remain valid until the awaiter returns.
+  Send send(std::span<const uint8_t> buffer, uint32_t timeout_us = NO_TIMEOUT) { return Send(m_scheduler, m_transmitter, buffer, timeout_us); }
+
+private:
+  SchedulerBase &m_scheduler;
+  spi_ref::DmaTransmitter &m_transmitter;
+};
+
+/// @brief Awaitable writes to a usart_ref::TransmitBuffer. Unlike OverflowPolicy::BLOCK, a write that doesn't
+/// fit suspends the task instead of spinning, and is queued piece by piece as the interrupt makes room.
+///
+///   stm32::coro::UsartTx usart(scheduler, usart5_tx);
+///   co_await usart.write(message);
+///   co_await usart.flush();
+/// @tparam CAPACITY The capacity of the TransmitBuffer
+template <std::size_t CAPACITY>
+class UsartTx
+{
+public:
+  /// @brief Awaiter for one write. co_await returns READY once every byte is queued, or TIMEOUT.
+  class Write : public Awaiter
+  {
+  public:
+    Write(SchedulerBase &scheduler, usart_ref::TransmitBuffer<CAPACITY> &buffer, std::span<const uint8_t> data, uint32_t timeout_us)
+        : Awaiter(scheduler, timeout_us), m_buffer(buffer), m_data(data)
+    {
+    }
+
+  protected:
+    bool ready() override
+    {
+      const std::size_t room = std::min(m_data.size(), CAPACITY - m_buffer.size());
+      if (room > 0) { m_data = m_data.subspan(m_buffer.write(m_data.first(room))); }
+      return m_data.empty();
+    }
+
+  private:
+    usart_ref::TransmitBuffer<CAPACITY> &m_buffer;
+    std::span<const uint8_t> m_data;
+  };
+
+  /// @param scheduler The scheduler that runs the awaiting tasks
+  /// @param buffer The transmit buffer. Its irq_handler() must be called from the USART interrupt.
+  UsartTx(SchedulerBase &scheduler, usart_ref::TransmitBuffer<CAPACITY> &buffer) : m_scheduler(scheduler), m_buffer(buffer) {}
+
+  /// @brief Queue data for transmit. The data must remain valid until the awaiter returns.
+  Write write(std::span<const uint8_t> data, uint32_t timeout_us = NO_TIMEOUT) { return Write(m_scheduler, m_buffer, data, timeout_us); }
+
+  /// @brief Wait until the interrupt has taken every queued byte
+  auto flush(uint32_t timeout_us = NO_TIMEOUT)
+  {
+    return m_scheduler.wait_until([this] { return m_buffer.empty(); }, timeout_us);
+  }
+
+private:
+  SchedulerBase &m_scheduler;
+  usart_ref::TransmitBuffer<CAPACITY> &m_buffer;
+};
+
+} // namespace stm32::coro
+
+#endif // __COROUTINE_DRIVERS_HPP__
@@ -0,0 +1,308 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __COROUTINE_SCHEDULER_HPP__
+#define __COROUTINE_SCHEDULER_HPP__
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <intrusive_list.hpp>
+#include <restricted_base.hpp>
+#include <static_pool.hpp>
+#include <timer_manager.hpp>
+#include <utility>
+#include <wait_utils.hpp>
+
+namespace stm32::coro
+{
+
+class SchedulerBase;
+
+/// @brief Pass as a timeout to wait without a deadline
+inline constexpr uint32_t NO_TIMEOUT{UINT32_MAX};
+
+/// @brief A cooperative task. Any function returning Task that uses co_await is a coroutine whose frame is
+/// taken from the frame pool of the Scheduler passed as its first argument, never from the heap:
+///
+///   stm32::coro::Task poll_sensor(stm32::coro::SchedulerBase &scheduler, Sensor &sensor);
+///
+/// The task does nothing until it is passed to SchedulerBase::spawn(). If the frame pool is exhausted the
+/// Task is invalid and spawn() refuses it.
+class Task
+{
+public:
+  struct promise_type
+  {
+    /// @brief A spawned task stops counting as active when its frame is destroyed
+    ~promise_type();
+
+    Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+
+    /// @brief Used instead of get_return_object() when operator new returns nullptr
+    static Task get_return_object_on_allocation_failure() { return Task(); }
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    /// @brief Don't suspend at the end, so the frame goes straight back to the pool
+    std::suspend_never final_suspend() noexcept { return {}; }
+
+    void return_void() {}
+
+    void unhandled_exception() { std::terminate(); }
+
+    /// @brief Allocate the frame from the scheduler's pool. The scheduler must be the first coroutine argument,
+    /// the rest are matched by the ellipsis and ignored. (A parameter pack would do, but GCC 12 then reports
+    /// -Wmismatched-new-delete in every coroutine.)
+    static void *operator new(std::size_t size, SchedulerBase &scheduler, ...) noexcept;
+
+    static void operator delete(void *frame) noexcept;
+
+    /// @brief Set by SchedulerBase::spawn(). A task that was never spawned was never counted as active.
+    SchedulerBase *spawned_by{nullptr};
+  };
+
+  Task() = default;
+  Task(Task &&other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+  Task &operator=(Task &&other) noexcept
+  {
+    if (this != &other)
+    {
+      if (m_handle) { m_handle.destroy(); }
+      m_handle = std::exchange(other.m_handle, nullptr);
+    }
+    return *this;
+  }
+  Task(const Task &) = delete;
+  Task &operator=(const Task &) = delete;
+
+  /// @brief A task that was never spawned is destroyed with its frame
+  ~Task()
+  {
+    if (m_handle) { m_handle.destroy(); }
+  }
+
+  /// @brief false if the frame couldn't be allocated, or the task has been spawned
+  bool valid() const { return static_cast<bool>(m_handle); }
+
+private:
+  friend class SchedulerBase;
+
+  explicit Task(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+
+  std::coroutine_handle<promise_type> m_handle;
+};
+
+/// @brief Base of every awaitable that suspends a task until a condition is met or a deadline passes.
+/// The awaiter lives in the suspended task's frame and is linked into the scheduler's wait list,
+/// so waiting needs no storage of its own. Derived classes supply the condition in ready().
+class Awaiter : public noarch::containers::ListHook<>
+{
+public:
+  /// @param scheduler The scheduler that polls this awaiter
+  /// @param timeout_us The deadline in microseconds, or NO_TIMEOUT
+  Awaiter(SchedulerBase &scheduler, uint32_t timeout_us) : m_scheduler(scheduler), m_timeout_us(timeout_us) {}
+  virtual ~Awaiter() = default;
+
+  bool await_ready()
+  {
+    if (!ready()) { return false; }
+    m_result = WaitStatus::READY;
+    return true;
+  }
+
+  void await_suspend(std::coroutine_handle<> handle);
+
+  /// @return READY if the condition was met, TIMEOUT if the deadline passed first
+  WaitStatus await_resume() const { return m_result; }
+
+protected:
+  /// @brief Polled by the scheduler while the task is suspended. Must not block.
+  virtual bool ready() = 0;
+
+  WaitStatus m_result{WaitStatus::TIMEOUT};
+
+private:
+  friend class SchedulerBase;
+
+  /// @brief Called by the scheduler on each pass
+  /// @return true if the task should be resumed
+  bool poll();
+
+  SchedulerBase &m_scheduler;
+  uint32_t m_timeout_us;
+  stm32::Deadline m_deadline{0};
+  std::coroutine_handle<> m_handle;
+};
+
+/// @brief Awaiter for any callable condition, see SchedulerBase::wait_until()
+template <typename CONDITION>
+class ConditionAwaiter : public Awaiter
+{
+public:
+  ConditionAwaiter(SchedulerBase &scheduler, CONDITION condition, uint32_t timeout_us)
+      : Awaiter(scheduler, timeout_us), m_condition(condition)
+  {
+  }
+
+protected:
+  bool ready() override { return m_condition(); }
+
+private:
+  CONDITION m_condition;
+};
+
+/// @brief Cooperative scheduler for a single-threaded super-loop. Tasks run until they co_await something
+/// that isn't ready, then the next task runs. run_once() polls every waiting task and resumes those that are
+/// ready or whose deadline has passed. Not for use from interrupts: ISRs should only change the state
+/// that the awaited conditions check.
+///
+/// Usage:
+///   static stm32::coro::Scheduler<256, 4> scheduler;
+///   stm32::coro::Task blink(stm32::coro::SchedulerBase &scheduler)
+///   {
+///     while (true) { toggle_led(); co_await scheduler.sleep(500); }
+///   }
+///   scheduler.spawn(blink(scheduler));
+///   while (true) { scheduler.run_once(); }
+class SchedulerBase : public RestrictedBase
+{
+public:
+  /// @brief Start a task. It runs straight away until its first co_await that isn't ready.
+  /// @return false if the task is invalid, i.e. its frame couldn't be allocated
+  bool spawn(Task &&task);
+
+  /// @brief Resume every waiting task whose condition is met or whose deadline has passed
+  /// @return The number of tasks resumed
+  std::size_t run_once();
+
+  /// @brief Run until every task has finished
+  void run()
+  {
+    while (active() > 0) { run_once(); }
+  }
+
+  /// @brief The number of tasks that have been spawned and haven't finished
+  std::size_t active() const { return m_active; }
+
+  /// @brief Suspend the calling task for a while: co_await scheduler.sleep(1000);
+  /// @param delay_us The delay in microseconds, see stm32::Deadline
+  auto sleep(uint32_t delay_us)
+  {
+    return ConditionAwaiter(*this, [] { return false; }, delay_us);
+  }
+
+  /// @brief Let the other tasks run, resuming the calling task on the next pass: co_await scheduler.yield();
+  auto yield() { return sleep(0); }
+
+  /// @brief Suspend the calling task until a condition is met: co_await scheduler.wait_until([&] { return done; });
+  /// @param condition A callable returning bool. Must not block.
+  /// @param timeout_us The deadline in microseconds, or NO_TIMEOUT
+  /// @return An awaitable whose result is READY, or TIMEOUT if the deadline passed first
+  template <typename CONDITION>
+  auto wait_until(CONDITION condition, uint32_t timeout_us = NO_TIMEOUT)
+  {
+    return ConditionAwaiter<CONDITION>(*this, condition, timeout_us);
+  }
+
+  /// @brief Allocate a coroutine frame. Called by Task::promise_type.
+  /// @return The frame, or nullptr if the pool is exhausted or the frame is too big
+  void *allocate_frame(std::size_t size);
+
+  /// @brief Free a frame from allocate_frame(), whichever scheduler it came from
+  static void free_frame(void *frame);
+
+protected:
+  SchedulerBase() = default;
+
+  /// @brief Take a block of at least size bytes, aligned for any type, from the frame pool
+  virtual void *allocate_block(std::size_t size) = 0;
+
+  /// @brief Return a block to the frame pool
+  virtual void free_block(void *block) = 0;
+
+private:
+  friend class Awaiter;
+  friend struct Task::promise_type;
+
+  /// @brief Stored in front of each frame, so free_frame() can find the pool
+  struct alignas(std::max_align_t) FrameHeader
+  {
+    SchedulerBase *scheduler;
+  };
+
+  /// @brief Suspended tasks, in the order they started waiting
+  noarch::containers::IntrusiveList<Awaiter> m_waiting;
+
+  std::size_t m_active{0};
+};
+
+/// @brief Scheduler with static storage for FRAMES coroutine frames of up to FRAME_SIZE bytes each.
+/// Frame sizes depend on the coroutine's locals and the optimisation level; a coroutine whose frame doesn't
+/// fit gets an invalid Task.
+/// @tparam FRAME_SIZE The largest coroutine frame, in bytes
+/// @tparam FRAMES The most tasks that can exist at once
+template <std::size_t FRAME_SIZE, std::size_t FRAMES>
+class Scheduler : public SchedulerBase
+{
+public:
+  Scheduler() = default;
+
+  /// @brief The number of frames in use
+  std::size_t frames_in_use() const { return m_frames.in_use(); }
+
+  /// @brief The most frames in use at once
+  std::size_t frames_high_watermark() const { return m_frames.high_watermark(); }
+
+protected:
+  void *allocate_block(std::size_t size) override { return (size <= sizeof(Block)) ? m_frames.allocate() : nullptr; }
+
+  void free_block(void *block) override { m_frames.deallocate(block); }
+
+private:
+  struct alignas(std::max_align_t) Block
+  {
+    std::byte storage[FRAME_SIZE];
+  };
+
+  noarch::memory::StaticPool<Block, FRAMES> m_frames;
+};
+
+inline Task::promise_type::~promise_type()
+{
+  if (spawned_by != nullptr) { spawned_by->m_active--; }
+}
+
+inline void *Task::promise_type::operator new(std::size_t size, SchedulerBase &scheduler, ...) noexcept
+{
+  return scheduler.allocate_frame(size);
+}
+
+inline void Task::promise_type::operator delete(void *frame) noexcept
+{
+  SchedulerBase::free_frame(frame);
+}
+
+} // namespace stm32::coro
+
+#endif // __COROUTINE_SCHEDULER_HPP__
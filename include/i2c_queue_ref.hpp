@@ -0,0 +1,235 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __I2C_QUEUE_REF_HPP__
+#define __I2C_QUEUE_REF_HPP__
+
+#include <array>
+#include <cstdint>
+#include <i2c_transfer_ref.hpp>
+#include <restricted_base.hpp>
+#include <span>
+
+namespace stm32::i2c_ref
+{
+
+/// @brief Descriptor for one queued I2C transaction: START, addr+W, tx_buffer, RESTART, addr+R, rx_buffer, STOP.
+/// Either buffer may be empty. The buffers must remain valid until the callback is called.
+struct Transaction
+{
+  /// @brief The address byte of the slave device
+  uint8_t addr{0};
+  /// @brief The data to send, may be empty
+  std::span<const uint8_t> tx_buffer{};
+  /// @brief The buffer to receive into, may be empty
+  std::span<uint8_t> rx_buffer{};
+  /// @brief Optional completion callback, called from the I2C interrupt
+  TransferCallback callback{nullptr};
+  /// @brief Optional user pointer passed to the callback
+  void *context{nullptr};
+  /// @brief Higher priority transactions are started first
+  uint8_t priority{0};
+};
+
+/// @brief Fixed-capacity I2C transaction queue for sharing one bus between several devices.
+/// Transactions are run back-to-back from the I2C interrupt: the next one is started from the
+/// completion of the previous one, so the bus never waits for the main loop.
+/// Scheduling: highest priority first. Within a priority level, transactions to the device that was
+/// just serviced are batched (up to MAX_BATCH in a row), otherwise they run in submission order.
+/// @tparam CAPACITY The maximum number of pending transactions
+/// @tparam MAX_BATCH The maximum consecutive transactions to one device before others get a turn
+template <std::size_t CAPACITY, std::size_t MAX_BATCH = 8>
+class TransactionQueue : public RestrictedBase
+{
+public:
+  /// @brief Construct the queue. The engine's irq_handler() must be serviced by the I2C interrupt.
+  /// @param engine The transfer engine for the shared I2C bus
+  explicit TransactionQueue(TransferEngine &engine) : m_engine(engine) {}
+
+  /// @brief Add a transaction to the queue, starting it immediately if the bus is idle.
+  /// Can be called from the main loop and from a transaction's completion callback.
+  /// @param transaction The transaction descriptor. It is copied, the buffers are not.
+  /// @return false if the queue is full
+  bool submit(const Transaction &transaction);
+
+  /// @brief Start the next pending transaction if the engine is idle. Only needed when the engine is shared with
+  /// something else, e.g. a BusScanner: a transaction that finds the engine in use waits for this or the next submit().
+  void poll()
+  {
+    if (!m_engine.busy()) { dispatch(); }
+  }
+
+  /// @brief Get the number of transactions waiting or in progress
+  /// @return std::size_t
+  std::size_t size() const;
+
+  /// @brief Check if all transactions have completed
+  /// @return true if nothing is waiting or in progress
+  bool empty() const { return size() == 0; }
+
+private:
+  enum class SlotState : uint8_t
+  {
+    FREE,
+    PENDING,
+    ACTIVE,
+  };
+
+  struct Slot
+  {
+    Transaction transaction{};
+    uint32_t sequence{0};
+    volatile SlotState state{SlotState::FREE};
+  };
+
+  /// @brief Pick the next pending transaction and start it on the engine
+  void dispatch();
+
+  /// @brief Engine completion callback: notify the user then start the next transaction
+  static void on_complete(Status status, void *context);
+
+  TransferEngine &m_engine;
+
+  /// @brief Statically allocated storage for the queued transactions
+  std::array<Slot, CAPACITY> m_slots{};
+
+  /// @brief Submission counter, used to keep FIFO order within a priority level
+  uint32_t m_next_sequence{0};
+
+  /// @brief The slot currently running on the engine
+  Slot *m_active{nullptr};
+
+  /// @brief The device serviced by the previous transaction and how many ran in a row
+  uint8_t m_last_addr{0};
+  std::size_t m_batch_count{0};
+};
+
+template <std::size_t CAPACITY, std::size_t MAX_BATCH>
+bool TransactionQueue<CAPACITY, MAX_BATCH>::submit(const Transaction &transaction)
+{
+  // a completion callback submitting from the interrupt would race for the same slot and sequence number
+  const uint32_t enables = m_engine.mask_irq();
+  Slot *claimed{nullptr};
+  for (Slot &slot : m_slots)
+  {
+    if (slot.state != SlotState::FREE) { continue; }
+
+    claimed              = &slot;
+    claimed->transaction = transaction;
+    claimed->sequence    = m_next_sequence++;
+    claimed->state       = SlotState::PENDING;
+    break;
+  }
+  m_engine.unmask_irq(enables);
+
+  if (claimed == nullptr) { return false; }
+
+  // The interrupt is only active while the engine is busy, and it starts the next transaction itself.
+  // So only kick the queue from here if the bus is idle.
+  if (!m_engine.busy()) { dispatch(); }
+  return true;
+}
+
+template <std::size_t CAPACITY, std::size_t MAX_BATCH>
+std::size_t TransactionQueue<CAPACITY, MAX_BATCH>::size() const
+{
+  std::size_t count{0};
+  for (const Slot &slot : m_slots)
+  {
+    if (slot.state != SlotState::FREE) { count++; }
+  }
+  return count;
+}
+
+template <std::size_t CAPACITY, std::size_t MAX_BATCH>
+void TransactionQueue<CAPACITY, MAX_BATCH>::dispatch()
+{
+  if (m_active != nullptr) { return; }
+
+  const bool batch_allowed = m_batch_count < MAX_BATCH;
+  Slot *next{nullptr};
+  for (Slot &slot : m_slots)
+  {
+    if (slot.state != SlotState::PENDING) { continue; }
+    if (next == nullptr) { next = &slot; continue; }
+
+    const Transaction &candidate = slot.transaction;
+    const Transaction &best      = next->transaction;
+    if (candidate.priority != best.priority)
+    {
+      if (candidate.priority > best.priority) { next = &slot; }
+      continue;
+    }
+
+    // same priority: keep talking to the same device, otherwise oldest first
+    const bool candidate_batched = batch_allowed && (candidate.addr == m_last_addr);
+    const bool best_batched      = batch_allowed && (best.addr == m_last_addr);
+    if (candidate_batched != best_batched)
+    {
+      if (candidate_batched) { next = &slot; }
+      continue;
+    }
+    if (static_cast<int32_t>(slot.sequence - next->sequence) < 0) { next = &slot; }
+  }
+
+  if (next == nullptr) { return; }
+
+  // the transfer may complete as soon as it starts, so take the slot first
+  const uint8_t last_addr = m_last_addr;
+  const std::size_t batch = m_batch_count;
+  m_batch_count           = (next->transaction.addr == m_last_addr) ? m_batch_count + 1 : 1;
+  m_last_addr             = next->transaction.addr;
+  m_active                = next;
+  next->state             = SlotState::ACTIVE;
+  if (m_engine.transfer(next->transaction.addr, next->transaction.tx_buffer, next->transaction.rx_buffer, on_complete, this))
+  {
+    return;
+  }
+
+  // the engine is in use by something else, leave the transaction for poll() or the next submit()
+  next->state   = SlotState::PENDING;
+  m_active      = nullptr;
+  m_last_addr   = last_addr;
+  m_batch_count = batch;
+}
+
+template <std::size_t CAPACITY, std::size_t MAX_BATCH>
+void TransactionQueue<CAPACITY, MAX_BATCH>::on_complete(Status status, void *context)
+{
+  auto *queue = static_cast<TransactionQueue *>(context);
+  Slot *done  = queue->m_active;
+
+  // release the slot before the callback so it can submit a follow-up transaction
+  const Transaction transaction = done->transaction;
+  queue->m_active               = nullptr;
+  done->state                   = SlotState::FREE;
+
+  if (transaction.callback != nullptr) { transaction.callback(status, transaction.context); }
+
+  // keep the bus busy
+  queue->dispatch();
+}
+
+} // namespace stm32::i2c_ref
+
+#endif // __I2C_QUEUE_REF_HPP__
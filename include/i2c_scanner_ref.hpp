@@ -0,0 +1,141 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __I2C_SCANNER_REF_HPP__
+#define __I2C_SCANNER_REF_HPP__
+
+#include <bitset>
+#include <cstdint>
+#include <i2c_transfer_ref.hpp>
+#include <restricted_base.hpp>
+
+namespace stm32::i2c_ref
+{
+
+/// @brief I2C bus scanner and device-presence cache.
+/// Probes the 112 valid 7-bit addresses (0x08-0x77) with an address-only write (the equivalent of StartType::PROBE)
+/// on the interrupt-driven TransferEngine, so each probe costs only the address phase and STOP on the bus.
+/// Results are stored in a presence bitmap so drivers can skip optional devices that are not fitted.
+/// Addresses use the same convention as the rest of stm32::i2c_ref: the address byte, i.e. the 7-bit address << 1.
+/// The probes run at the engine's bus timing unless set_probe_timing() picks a faster one, and never faster than
+/// Fast-mode Plus (1MHz). A scan is refused while TIMINGR still has its reset value.
+class BusScanner : public RestrictedBase
+{
+public:
+  /// @brief When cached results are re-checked on the bus
+  enum class CachePolicy
+  {
+    /// @brief Results are valid until invalidate() is called
+    PERSISTENT,
+    /// @brief Present devices are cached, absent devices are re-probed on every is_present() (hot-plug)
+    RECHECK_ABSENT,
+  };
+
+  /// @brief Construct the scanner. The engine's irq_handler() must be serviced by the I2C interrupt.
+  /// @param engine The transfer engine for the I2C bus
+  /// @param policy The cache invalidation policy
+  explicit BusScanner(TransferEngine &engine, CachePolicy policy = CachePolicy::PERSISTENT) : m_engine(engine), m_policy(policy) {}
+
+  /// @brief Probe at a different bus timing to the engine's. Each probe is only an address phase, so a faster TIMINGR
+  /// shortens the scan, but every device on the bus must tolerate it, e.g. Fast-mode (400kHz) on a bus of Fast-mode
+  /// parts. The engine's timing is restored when the scan ends.
+  /// @param timingr The I2C_TIMINGR value for the probes, or 0 to probe at the engine's timing (the default)
+  /// @return false if timingr is faster than Fast-mode Plus
+  bool set_probe_timing(uint32_t timingr);
+
+  /// @brief Start probing all valid addresses in the background, from the I2C interrupt.
+  /// @return false if the engine is busy, or the probe timing is unset (TIMINGR zero) or faster than Fast-mode Plus
+  bool start_scan();
+
+  /// @brief Stop a background scan, aborting the probe in progress. Addresses not probed keep their cached results.
+  /// Must be called from the main loop.
+  void cancel_scan();
+
+  /// @brief Check if the background scan has finished
+  /// @return true if no scan is in progress
+  bool scan_complete() const { return !m_scanning; }
+
+  /// @brief Probe all valid addresses and wait for the result
+  /// @param timeout_us The deadline for the whole scan. TIMINGR_TIMEOUT allows each probe the deadline of a
+  /// blocking transaction with no data, see TransferEngine::transfer_timeout_us().
+  /// @return false if the scan couldn't start, see start_scan(), or was cancelled at the deadline
+  bool scan(uint32_t timeout_us = TIMINGR_TIMEOUT);
+
+  /// @brief Check if a device is present, probing the bus if there is no valid cached result.
+  /// Must be called from the main loop. If the bus is busy, or the probe times out, the cached (or absent) result is returned.
+  /// @param addr The address byte of the slave device
+  /// @return true if the device acknowledged its address
+  bool is_present(uint8_t addr);
+
+  /// @brief Update the cache with the result of a normal transaction, avoiding a separate probe
+  /// @param addr The address byte of the slave device
+  /// @param status The status of the transaction. ACK marks the device present, NACK absent. Others are ignored.
+  void update(uint8_t addr, Status status);
+
+  /// @brief Discard all cached results
+  void invalidate();
+
+  /// @brief Discard the cached result for one device
+  /// @param addr The address byte of the slave device
+  void invalidate(uint8_t addr);
+
+  /// @brief Get the number of devices marked present
+  /// @return std::size_t
+  std::size_t count() const { return m_present.count(); }
+
+  /// @brief The first and last valid address bytes. Others are reserved by the I2C specification.
+  static constexpr uint8_t m_first_addr{0x08 << 1};
+  static constexpr uint8_t m_last_addr{0x77 << 1};
+
+  /// @brief The shortest SCL period the probes may use: Fast-mode Plus, 1MHz
+  static constexpr uint32_t m_min_scl_period_ns{1000};
+
+private:
+  /// @brief Engine completion callback for the background scan: record the result and probe the next address
+  static void on_probe_complete(Status status, void *context);
+
+  /// @brief Check the address byte is in the valid range
+  static bool is_valid(uint8_t addr) { return (addr >= m_first_addr) && (addr <= m_last_addr); }
+
+  /// @brief Mark the scan finished and give the engine its own timing back
+  void end_scan();
+
+  TransferEngine &m_engine;
+  CachePolicy m_policy;
+
+  /// @brief Presence bitmap and cache validity, indexed by the 7-bit address
+  std::bitset<128> m_present;
+  std::bitset<128> m_valid;
+
+  /// @brief The address being probed by the background scan
+  uint8_t m_scan_addr{m_first_addr};
+  volatile bool m_scanning{false};
+
+  /// @brief The TIMINGR value for the probes (0 for the engine's), and the engine's own while a scan runs
+  uint32_t m_probe_timingr{0};
+  uint32_t m_bus_timingr{0};
+};
+
+} // namespace stm32::i2c_ref
+
+#endif // __I2C_SCANNER_REF_HPP__
@@ -0,0 +1,226 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __I2C_TRANSFER_REF_HPP__
+#define __I2C_TRANSFER_REF_HPP__
+
+#include <cstdint>
+#include <i2c_utils_ref.hpp>
+#include <restricted_base.hpp>
+#include <span>
+
+namespace stm32::i2c_ref
+{
+
+/// @brief Pass as timeout_us to the blocking transactions to allow twice the bus time of the transaction at the
+/// SCL frequency set by TIMINGR, plus the 25ms a slave may stretch SCL for under SMBus
+inline constexpr uint32_t TIMINGR_TIMEOUT{0};
+
+/// @brief The SCL period set by a TIMINGR value: (SCLL + 1 + SCLH + 1) * (PRESC + 1) kernel clocks, assuming the
+/// I2C kernel clock is SystemCoreClock. The sync and rise/fall times make the real period slightly longer.
+/// @param timingr The I2C_TIMINGR value
+/// @return The SCL period in nanoseconds
+inline uint32_t scl_period_ns(uint32_t timingr)
+{
+  const uint64_t presc = ((timingr & I2C_TIMINGR_PRESC_Msk) >> I2C_TIMINGR_PRESC_Pos) + 1;
+  const uint64_t scll  = ((timingr & I2C_TIMINGR_SCLL_Msk) >> I2C_TIMINGR_SCLL_Pos) + 1;
+  const uint64_t sclh  = ((timingr & I2C_TIMINGR_SCLH_Msk) >> I2C_TIMINGR_SCLH_Pos) + 1;
+  return static_cast<uint32_t>(((scll + sclh) * presc * 1000000000ULL) / SystemCoreClock);
+}
+
+/// @brief Called from the I2C interrupt when a queued transfer has finished
+/// @param status ACK if the transfer completed, NACK if the slave refused it, ERROR on bus error/arbitration loss
+/// @param context The user pointer passed when the transfer was started
+using TransferCallback = void (*)(Status status, void *context);
+
+/// @brief Interrupt-driven I2C master transfer engine.
+/// Transfers are started from the main loop and then progressed entirely by irq_handler(),
+/// so the CPU is free while the bus is busy. Transfers longer than 255 bytes are chained
+/// using NBYTES/RELOAD. Completion is reported via the optional callback and by status().
+///
+/// Usage:
+///   static stm32::i2c_ref::TransferEngine i2c1_engine(*I2C1);
+///   extern "C" void I2C1_IRQHandler() { i2c1_engine.irq_handler(); }
+class TransferEngine : public RestrictedBase
+{
+public:
+  /// @brief Construct the engine for a CMSIS memory-mapped I2C device. The peripheral must already be configured (TIMINGR, PE).
+  /// @param i2c_handle The CMSIS memory-mapped I2C device
+  explicit TransferEngine(I2C_TypeDef &i2c_handle) : m_i2c_handle(i2c_handle) {}
+
+  /// @brief Queue a write transfer: START, addr+W, tx_buffer, STOP
+  /// @param addr The address byte of the slave device
+  /// @param tx_buffer The data to send. Must remain valid until the transfer completes.
+  /// @param callback Optional completion callback, called from irq_handler()
+  /// @param context Optional user pointer passed to the callback
+  /// @return false if a transfer is already in progress
+  bool write(uint8_t addr, std::span<const uint8_t> tx_buffer, TransferCallback callback = nullptr, void *context = nullptr);
+
+  /// @brief Queue a read transfer: START, addr+R, rx_buffer, STOP
+  /// @param addr The address byte of the slave device
+  /// @param rx_buffer The buffer to receive into. Must remain valid until the transfer completes.
+  /// @param callback Optional completion callback, called from irq_handler()
+  /// @param context Optional user pointer passed to the callback
+  /// @return false if a transfer is already in progress
+  bool read(uint8_t addr, std::span<uint8_t> rx_buffer, TransferCallback callback = nullptr, void *context = nullptr);
+
+  /// @brief Queue a combined transfer: START, addr+W, tx_buffer, RESTART, addr+R, rx_buffer, STOP.
+  /// Either buffer may be empty. If both are empty only the address is sent (i.e. a probe).
+  /// @param addr The address byte of the slave device
+  /// @param tx_buffer The data to send. Must remain valid until the transfer completes.
+  /// @param rx_buffer The buffer to receive into. Must remain valid until the transfer completes.
+  /// @param callback Optional completion callback, called from irq_handler()
+  /// @param context Optional user pointer passed to the callback
+  /// @return false if a transfer is already in progress
+  bool transfer(uint8_t addr, std::span<const uint8_t> tx_buffer, std::span<uint8_t> rx_buffer, TransferCallback callback = nullptr,
+                void *context = nullptr);
+
+  /// @brief Pollable transfer status
+  /// @return BUSY while a transfer is in progress, otherwise the result of the last transfer
+  Status status() const { return m_status; }
+
+  /// @brief Check if a transfer is in progress
+  /// @return true if the engine is busy
+  bool busy() const { return m_status == Status::BUSY; }
+
+  /// @brief Abandon the transfer in progress, e.g. after a missed interrupt or while a slave holds SCL low.
+  /// The interrupts are disabled and the peripheral is reset (PE cleared then set again), which releases the bus
+  /// lines and clears the flags. The result is TIMEOUT, reported by status() and the callback.
+  /// Call from the main loop, not from the callback.
+  /// @return false if no transfer was in progress, i.e. it finished first
+  bool abort();
+
+  /// @brief Keep irq_handler() from running while the main loop changes state it shares with the completion callback.
+  /// Masks the engine's interrupt enables in CR1; flags raised meanwhile are serviced once unmask_irq() is called.
+  /// Has no effect from the callback, where the interrupts are already masked.
+  /// @return The interrupt enables that were set, for unmask_irq()
+  uint32_t mask_irq();
+
+  /// @brief Restore the interrupt enables returned by mask_irq(), if a transfer is still in progress
+  /// @param enables The return value of mask_irq()
+  void unmask_irq(uint32_t enables);
+
+  /// @brief Change the bus timing. TIMINGR can only be written while PE is clear, so the peripheral is briefly disabled.
+  /// @param timingr The new I2C_TIMINGR value
+  /// @return false if a transfer is in progress
+  bool set_timing(uint32_t timingr);
+
+  /// @brief The current I2C_TIMINGR value
+  uint32_t timing() const { return m_i2c_handle.TIMINGR; }
+
+  /// @brief The deadline TIMINGR_TIMEOUT stands for, assuming the I2C kernel clock is SystemCoreClock
+  /// @param bytes The number of data bytes in the transaction
+  /// @return The deadline in microseconds
+  uint32_t transfer_timeout_us(std::size_t bytes) const;
+
+  /// @brief Progress the active transfer. Must be called from the I2Cx_IRQHandler (event and error).
+  /// Does nothing while the interrupts are masked, e.g. if the NVIC latched the interrupt before mask_irq().
+  void irq_handler();
+
+private:
+  /// @brief Configure CR2 and generate START for the current phase (write or read)
+  void start_phase(bool read_phase);
+
+  /// @brief Take the next chunk of the current phase, at most 255 bytes
+  /// @return The chunk size for NBYTES. RELOAD is needed if m_unloaded is still non-zero.
+  std::size_t next_chunk();
+
+  /// @brief Load NBYTES with the next chunk of the current phase, setting RELOAD if more than 255 bytes remain
+  void load_next_chunk();
+
+  /// @brief Disable interrupts, latch the result and notify the callback
+  void finish(Status result);
+
+  /// @brief The CMSIS memory-mapped I2C device
+  I2C_TypeDef &m_i2c_handle;
+
+  /// @brief The data to transmit and the position of the next byte
+  std::span<const uint8_t> m_tx_buffer;
+  std::size_t m_tx_idx{0};
+
+  /// @brief The data to receive and the position of the next byte
+  std::span<uint8_t> m_rx_buffer;
+  std::size_t m_rx_idx{0};
+
+  /// @brief Bytes left in the current phase that have not been loaded into NBYTES yet
+  std::size_t m_unloaded{0};
+
+  /// @brief True once the read phase has been started
+  bool m_read_phase{false};
+
+  /// @brief The slave device address byte
+  uint8_t m_addr{0};
+
+  /// @brief The result latched if the slave NACKs or the bus errors before STOP is detected
+  Status m_result{Status::ACK};
+
+  /// @brief The pollable status. Written by irq_handler()
+  volatile Status m_status{Status::ACK};
+
+  TransferCallback m_callback{nullptr};
+  void *m_callback_context{nullptr};
+
+  /// @brief The maximum value of the NBYTES field in I2C_CR2
+  static constexpr std::size_t m_max_nbytes{255};
+
+  /// @brief All the interrupts used by the engine
+  static constexpr uint32_t m_irq_mask{I2C_CR1_TXIE | I2C_CR1_RXIE | I2C_CR1_TCIE | I2C_CR1_NACKIE | I2C_CR1_STOPIE | I2C_CR1_ERRIE};
+};
+
+/// @brief Blocking write transaction: START, addr+W, tx_buffer, STOP.
+/// Buffers of any length are sent as a single transaction, NBYTES is reloaded every 255 bytes.
+/// The engine's irq_handler() must be serviced by the I2C interrupt while waiting. The engine is aborted at the deadline.
+/// @param engine The transfer engine for the I2C device
+/// @param addr The address byte of the slave device
+/// @param tx_buffer The data to send
+/// @param timeout_us The deadline for the whole transaction, see TIMINGR_TIMEOUT
+/// @return ACK if the transaction completed, NACK/ERROR if it failed, BUSY if the engine was already busy,
+/// TIMEOUT if it was aborted at the deadline
+Status write(TransferEngine &engine, uint8_t addr, std::span<const uint8_t> tx_buffer, uint32_t timeout_us = TIMINGR_TIMEOUT);
+
+/// @brief Blocking read transaction: START, addr+R, rx_buffer, STOP.
+/// Buffers of any length are received as a single transaction, NBYTES is reloaded every 255 bytes.
+/// The engine's irq_handler() must be serviced by the I2C interrupt while waiting. The engine is aborted at the deadline.
+/// @param engine The transfer engine for the I2C device
+/// @param addr The address byte of the slave device
+/// @param rx_buffer The buffer to receive into
+/// @param timeout_us The deadline for the whole transaction, see TIMINGR_TIMEOUT
+/// @return ACK if the transaction completed, NACK/ERROR if it failed, BUSY if the engine was already busy,
+/// TIMEOUT if it was aborted at the deadline
+Status read(TransferEngine &engine, uint8_t addr, std::span<uint8_t> rx_buffer, uint32_t timeout_us = TIMINGR_TIMEOUT);
+
+/// @brief Blocking register read transaction: START, addr+W, reg, RESTART, addr+R, rx_buffer, STOP.
+/// The engine's irq_handler() must be serviced by the I2C interrupt while waiting. The engine is aborted at the deadline.
+/// @param engine The transfer engine for the I2C device
+/// @param addr The address byte of the slave device
+/// @param reg The register/memory address to read from
+/// @param rx_buffer The buffer to receive into
+/// @param timeout_us The deadline for the whole transaction, see TIMINGR_TIMEOUT
+/// @return ACK if the transaction completed, NACK/ERROR if it failed, BUSY if the engine was already busy,
+/// TIMEOUT if it was aborted at the deadline
+Status write_then_read(TransferEngine &engine, uint8_t addr, uint8_t reg, std::span<uint8_t> rx_buffer,
+                       uint32_t timeout_us = TIMINGR_TIMEOUT);
+
+} // namespace stm32::i2c_ref
+
+#endif // __I2C_TRANSFER_REF_HPP__
@@ -0,0 +1,88 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __I2C_UTILS_HPP__
+#define __I2C_UTILS_HPP__
+
+#include <i2c_utils_ref.hpp>
+
+// Null-checking wrappers for callers that hold the handle as a pointer. See stm32::i2c_ref for the implementation.
+
+namespace stm32::i2c
+{
+
+using Status    = stm32::i2c_ref::Status;
+using StartType = stm32::i2c_ref::StartType;
+
+/// @brief See stm32::i2c_ref::initialise_slave_device()
+/// @return Status::ERROR if i2c_handle is null
+inline Status initialise_slave_device(I2C_TypeDef *i2c_handle, uint8_t addr, StartType start_type, uint32_t timeout_us = 1000)
+{
+  if (i2c_handle == nullptr) { return Status::ERROR; }
+  return stm32::i2c_ref::initialise_slave_device(*i2c_handle, addr, start_type, timeout_us);
+}
+
+/// @brief See stm32::i2c_ref::send_byte()
+/// @return Status::ERROR if i2c_handle is null
+inline Status send_byte(I2C_TypeDef *i2c_handle, uint8_t tx_byte)
+{
+  if (i2c_handle == nullptr) { return Status::ERROR; }
+  return stm32::i2c_ref::send_byte(*i2c_handle, tx_byte);
+}
+
+/// @brief See stm32::i2c_ref::receive_byte()
+/// @return Status::ERROR if i2c_handle is null
+inline Status receive_byte(I2C_TypeDef *i2c_handle, uint8_t &rx_byte)
+{
+  if (i2c_handle == nullptr) { return Status::ERROR; }
+  return stm32::i2c_ref::receive_byte(*i2c_handle, rx_byte);
+}
+
+inline void generate_start_condition(I2C_TypeDef *i2c_handle)
+{
+  if (i2c_handle != nullptr) { stm32::i2c_ref::generate_start_condition(*i2c_handle); }
+}
+
+inline void generate_stop_condition(I2C_TypeDef *i2c_handle)
+{
+  if (i2c_handle != nullptr) { stm32::i2c_ref::generate_stop_condition(*i2c_handle); }
+}
+
+inline void set_numbytes(I2C_TypeDef *i2c_handle, uint32_t nbytes)
+{
+  if (i2c_handle != nullptr) { stm32::i2c_ref::set_numbytes(*i2c_handle, nbytes); }
+}
+
+inline void send_ack(I2C_TypeDef *i2c_handle)
+{
+  if (i2c_handle != nullptr) { stm32::i2c_ref::send_ack(*i2c_handle); }
+}
+
+inline void send_nack(I2C_TypeDef *i2c_handle)
+{
+  if (i2c_handle != nullptr) { stm32::i2c_ref::send_nack(*i2c_handle); }
+}
+
+} // namespace stm32::i2c
+
+#endif // __I2C_UTILS_HPP__
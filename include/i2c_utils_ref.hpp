@@ -32,6 +32,13 @@
   #include <stm32g0xx.h>
 #endif
 
+#include <mmio_peripheral.hpp>
+#include <register_field.hpp>
+#include <timer_manager.hpp>
+
+// The functions below are the only implementation of the polled I2C driver. They are defined inline so that the
+// compile-time bound device template and the pointer wrappers collapse into the same code at the call site.
+
 namespace stm32::i2c_ref
 {
 
@@ -44,7 +51,10 @@ enum class Status
   BUSY,
   /// @brief Slave device did not recognise the address
   NACK,
-
+  /// @brief Bus error or arbitration lost during the transaction
+  ERROR,
+  /// @brief Slave device did not respond before the deadline
+  TIMEOUT,
 };
 
 /// @brief Specify the type of message to send with initialise_slave_device() function
@@ -58,42 +68,153 @@ enum class StartType
   WRITE
 };
 
-/// @brief Send the address byte to the I2C slave device and use start_type to generate a start condition
+/// @brief I2C_CR2 fields, for stm32::reg::modify()
+namespace cr2
+{
+using SADD    = RegisterField<I2C_CR2_SADD, I2C_CR2_SADD_Pos>;
+using RD_WRN  = RegisterField<I2C_CR2_RD_WRN, I2C_CR2_RD_WRN_Pos>;
+using ADD10   = RegisterField<I2C_CR2_ADD10, I2C_CR2_ADD10_Pos>;
+using START   = RegisterField<I2C_CR2_START, I2C_CR2_START_Pos>;
+using NACK    = RegisterField<I2C_CR2_NACK, I2C_CR2_NACK_Pos>;
+using NBYTES  = RegisterField<I2C_CR2_NBYTES, I2C_CR2_NBYTES_Pos>;
+using RELOAD  = RegisterField<I2C_CR2_RELOAD, I2C_CR2_RELOAD_Pos>;
+using AUTOEND = RegisterField<I2C_CR2_AUTOEND, I2C_CR2_AUTOEND_Pos>;
+} // namespace cr2
+
+/// @brief Generation restart/start condition now
+/// The type of generated start condition will depend on the start_type argument used with initialise_slave_device()
+/// @param i2c_handle pointer to I2C Interface
+inline void generate_start_condition(I2C_TypeDef &i2c_handle) { i2c_handle.CR2 = i2c_handle.CR2 | (I2C_CR2_START); }
+
+/// @brief Generate a stop condition after active transfer has completed.
+/// @param i2c_handle pointer to I2C Interface
+inline void generate_stop_condition(I2C_TypeDef &i2c_handle) { i2c_handle.CR2 = i2c_handle.CR2 | (I2C_CR2_STOP); }
+
+namespace detail
+{
+
+// The address phase has finished when NACKF is set (address not recognised) or the transfer
+// has moved on: TXIS/RXNE for the first data byte, TC/TCR if NBYTES is zero, STOPF for PROBE.
+inline Status wait_for_address_phase(I2C_TypeDef &i2c_handle, uint32_t timeout_us)
+{
+  stm32::Deadline deadline(timeout_us);
+  do
+  {
+    const uint32_t isr = i2c_handle.ISR;
+    if ((isr & I2C_ISR_NACKF) == I2C_ISR_NACKF) { return Status::NACK; }
+    if ((isr & (I2C_ISR_TXIS | I2C_ISR_RXNE | I2C_ISR_TC | I2C_ISR_TCR | I2C_ISR_STOPF)) != 0) { return Status::ACK; }
+  } while (!deadline.expired());
+
+  return Status::TIMEOUT;
+}
+
+} // namespace detail
+
+/// @brief Send the address byte to the I2C slave device and use start_type to generate a start condition.
+/// Returns as soon as the address phase has finished, i.e. the slave responded or the deadline expired.
 /// @param i2c_handle The unique_ptr to the CMSIS memory-mapped I2C device
 /// @param addr The address byte to send to the slave device
 /// @param start_type PROBE: send STOP after adddress, WRITE: r/w bit low and keep open, READ: r/w bit high + repeated START
-/// @return Status The I2C slave device response
-Status initialise_slave_device(I2C_TypeDef &i2c_handle, uint8_t addr, StartType start_type);
+/// @param timeout_us The deadline for the slave device to respond, in microseconds
+/// @return Status ACK/NACK from the I2C slave device, or TIMEOUT if there was no response before the deadline
+inline Status initialise_slave_device(I2C_TypeDef &i2c_handle, uint8_t addr, StartType start_type, uint32_t timeout_us = 1000)
+{
+  // clear any flags left over from the previous transaction
+  i2c_handle.ICR = I2C_ICR_NACKCF | I2C_ICR_STOPCF;
+
+  // Configure the transfer and generate the start/restart condition in a single CR2 write:
+  // - 7-bit addressing mode (ADD10). SADD bits[7:1] hold the address, SADD[9], SADD[8] and SADD[0] are don't care.
+  // - PROBE: write transfer, AUTOEND sends a STOP automatically when NBYTES data are transferred.
+  // - WRITE/READ: write or read transfer, RELOAD and AUTOEND disabled so TC is set when NBYTES data are
+  //   transferred, stretching SCL low until STOP or RESTART follows.
+  if (start_type == StartType::PROBE)
+  {
+    reg::modify(i2c_handle.CR2, cr2::ADD10(0), cr2::SADD(addr), cr2::RD_WRN(0), cr2::AUTOEND(1), cr2::START(1));
+  }
+  else
+  {
+    const uint32_t read = (start_type == StartType::READ) ? 1 : 0;
+    reg::modify(i2c_handle.CR2, cr2::ADD10(0), cr2::SADD(addr), cr2::RD_WRN(read), cr2::RELOAD(0), cr2::AUTOEND(0),
+                cr2::START(1));
+  }
+
+  // wait for the slave to respond, no longer than the deadline
+  return detail::wait_for_address_phase(i2c_handle, timeout_us);
+}
 
 /// @brief Write single data byte to I2C_TXDR register (transmit to the I2C slave device)
 /// @param i2c_handle The unique_ptr to the CMSIS memory-mapped I2C device
 /// @param buffer_byte Data byte to transmit
 /// @return Status The I2C slave device response
-Status send_byte(I2C_TypeDef &i2c_handle, uint8_t tx_byte);
+inline Status send_byte(I2C_TypeDef &i2c_handle, uint8_t tx_byte)
+{
+  i2c_handle.TXDR = tx_byte;
+
+  // wait for I2C_ISR_TXE (Transmit data register empty) before continuing
+  while (((i2c_handle.ISR & I2C_ISR_TXE) != I2C_ISR_TXE))
+  {
+    // do nothing
+    stm32::TimerManager::delay_microsecond(10);
+  }
+  // check if slave device responded with NACK
+  if (((i2c_handle.ISR & I2C_ISR_NACKF) == I2C_ISR_NACKF))
+  {
+    return Status::NACK;
+  }
+  return Status::ACK;
+}
 
 /// @brief Read single byte from I2C_RXDR register (Received from the I2C slave device)
 /// @param i2c_handle The unique_ptr to the CMSIS memory-mapped I2C device
 /// @param buffer_byte Data byte to receive
 /// @return Status The I2C slave device response
-Status receive_byte(I2C_TypeDef &i2c_handle, uint8_t &rx_byte);
-
-/// @brief Generation restart/start condition now
-/// The type of generated start condition will depend on the start_type argument used with initialise_slave_device()
-/// @param i2c_handle pointer to I2C Interface
-void generate_start_condition(I2C_TypeDef &i2c_handle);
+inline Status receive_byte(I2C_TypeDef &i2c_handle, uint8_t &rx_byte)
+{
+  rx_byte = i2c_handle.RXDR & I2C_RXDR_RXDATA;
 
-/// @brief Generate a stop condition after active transfer has completed.
-/// @param i2c_handle pointer to I2C Interface
-void generate_stop_condition(I2C_TypeDef &i2c_handle);
+  return Status::ACK;
+}
 
 /// @brief Set the number of bytes for the tx/rx transaction
 /// Changing these bits when the START bit is set is not allowed.
 /// @param i2c_handle pointer to I2C Interface
 /// @param nbytes The number of bytes to be transmitted/received. This field is don’t care in slave mode
-void set_numbytes(I2C_TypeDef &i2c_handle, uint32_t nbytes);
+inline void set_numbytes(I2C_TypeDef &i2c_handle, uint32_t nbytes)
+{
+  reg::modify(i2c_handle.CR2, cr2::NBYTES(nbytes));
+}
+
+inline void send_ack(I2C_TypeDef &i2c_handle) { i2c_handle.CR2 = i2c_handle.CR2 & ~(I2C_CR2_NACK); }
+inline void send_nack(I2C_TypeDef &i2c_handle) { i2c_handle.CR2 = i2c_handle.CR2 | (I2C_CR2_NACK); }
+
+/// @brief Polled I2C driver bound to its peripheral at compile time.
+/// @tparam PERIPHERAL Accessor type with a static get() returning I2C_TypeDef&. See stm32::MmioPeripheral.
+template <typename PERIPHERAL>
+struct I2cDevice
+{
+  static Status initialise_slave_device(uint8_t addr, StartType start_type, uint32_t timeout_us = 1000)
+  {
+    return i2c_ref::initialise_slave_device(PERIPHERAL::get(), addr, start_type, timeout_us);
+  }
+
+  static Status send_byte(uint8_t tx_byte) { return i2c_ref::send_byte(PERIPHERAL::get(), tx_byte); }
+
+  static Status receive_byte(uint8_t &rx_byte) { return i2c_ref::receive_byte(PERIPHERAL::get(), rx_byte); }
+
+  static void generate_start_condition() { i2c_ref::generate_start_condition(PERIPHERAL::get()); }
+
+  static void generate_stop_condition() { i2c_ref::generate_stop_condition(PERIPHERAL::get()); }
+
+  static void set_numbytes(uint32_t nbytes) { i2c_ref::set_numbytes(PERIPHERAL::get(), nbytes); }
+
+  static void send_ack() { i2c_ref::send_ack(PERIPHERAL::get()); }
+
+  static void send_nack() { i2c_ref::send_nack(PERIPHERAL::get()); }
+};
 
-void send_ack(I2C_TypeDef &i2c_handle);
-void send_nack(I2C_TypeDef &i2c_handle);
+/// @brief Polled I2C driver for the peripheral at BASE, e.g. stm32::i2c_ref::I2c<I2C1_BASE>::send_byte(0x00)
+template <std::uintptr_t BASE>
+using I2c = I2cDevice<stm32::MmioPeripheral<I2C_TypeDef, BASE>>;
 
 } // namespace stm32::i2c_ref
 
@@ -0,0 +1,241 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __INTRUSIVE_HEAP_HPP__
+#define __INTRUSIVE_HEAP_HPP__
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+namespace noarch::containers
+{
+
+/// @brief The links an object needs to be in an IntrusiveHeap. Derive from it, once per heap the object
+/// can be in at the same time, each with a different TAG. Copying an object doesn't copy its heap membership.
+/// @tparam TAG Any type, to tell the hooks of different heaps apart
+template <typename TAG = void>
+class HeapHook
+{
+public:
+    HeapHook() = default;
+    HeapHook(const HeapHook &) {}
+    HeapHook &operator=(const HeapHook &) { return *this; }
+
+private:
+    template <typename, typename, typename>
+    friend class IntrusiveHeap;
+
+    /// @brief The first child
+    HeapHook *m_child{nullptr};
+    /// @brief The next sibling
+    HeapHook *m_next{nullptr};
+    /// @brief The previous sibling, or the parent for a first child
+    HeapHook *m_prev{nullptr};
+};
+
+/// @brief Priority queue of objects that carry their own links (see HeapHook), so it never allocates.
+/// It is a pairing heap: push() and top() are O(1), pop() and remove() are amortised O(log n).
+/// The heap doesn't own the objects: remove them before they are destroyed.
+///
+/// Usage:
+///   struct Timeout : public noarch::containers::HeapHook<>, public RestrictedBase
+///   {
+///       uint32_t deadline;
+///       bool operator<(const Timeout &other) const { return deadline < other.deadline; }
+///   };
+///   noarch::containers::IntrusiveHeap<Timeout> timeouts;
+///   timeouts.push(timeout);
+///   while (!timeouts.empty() && expired(timeouts.top()->deadline)) { timeouts.pop(); }
+/// @tparam T The object type, derived from HeapHook<TAG>
+/// @tparam COMPARE Orders two objects, top() is the object that compares before all others
+/// @tparam TAG Selects the HeapHook base to use
+template <typename T, typename COMPARE = std::less<T>, typename TAG = void>
+class IntrusiveHeap
+{
+public:
+    using Hook = HeapHook<TAG>;
+
+    explicit IntrusiveHeap(COMPARE compare = COMPARE()) : m_compare(compare) {}
+
+    IntrusiveHeap(const IntrusiveHeap &) = delete;
+    IntrusiveHeap &operator=(const IntrusiveHeap &) = delete;
+
+    bool empty() const { return m_root == nullptr; }
+
+    std::size_t size() const { return m_size; }
+
+    /// @brief Add an object. It must not already be in this heap.
+    void push(T &item);
+
+    /// @brief Get the first object in COMPARE order, or nullptr if the heap is empty
+    T *top() const { return empty() ? nullptr : &static_cast<T &>(*m_root); }
+
+    /// @brief Remove and return the first object, or nullptr if the heap is empty
+    T *pop();
+
+    /// @brief Remove an object from anywhere in the heap
+    /// @return false if the object isn't in the heap
+    bool remove(T &item);
+
+    /// @brief Check if an object is in the heap
+    bool contains(const T &item) const
+    {
+        const Hook &hook = static_cast<const Hook &>(item);
+        return (&hook == m_root) || (hook.m_prev != nullptr);
+    }
+
+    /// @brief Reposition an object after its ordering key has changed
+    void update(T &item)
+    {
+        remove(item);
+        push(item);
+    }
+
+    /// @brief Empty the heap. The objects' links are not reset, so don't use it with objects still in use.
+    void clear()
+    {
+        m_root = nullptr;
+        m_size = 0;
+    }
+
+private:
+    /// @brief Make the later-ordered root the first child of the other. Both must be detached roots.
+    Hook *meld(Hook *first, Hook *second);
+
+    /// @brief Two-pass pairing of a sibling list into one tree
+    Hook *merge_pairs(Hook *first);
+
+    static void detach(Hook &hook)
+    {
+        hook.m_child = nullptr;
+        hook.m_next = nullptr;
+        hook.m_prev = nullptr;
+    }
+
+    COMPARE m_compare;
+    Hook *m_root{nullptr};
+    std::size_t m_size{0};
+};
+
+template <typename T, typename COMPARE, typename TAG>
+void IntrusiveHeap<T, COMPARE, TAG>::push(T &item)
+{
+    Hook &hook = static_cast<Hook &>(item);
+    detach(hook);
+    m_root = (m_root == nullptr) ? &hook : meld(m_root, &hook);
+    m_size++;
+}
+
+template <typename T, typename COMPARE, typename TAG>
+T *IntrusiveHeap<T, COMPARE, TAG>::pop()
+{
+    if (empty()) { return nullptr; }
+
+    Hook *top = m_root;
+    m_root = merge_pairs(top->m_child);
+    detach(*top);
+    m_size--;
+    return &static_cast<T &>(*top);
+}
+
+template <typename T, typename COMPARE, typename TAG>
+bool IntrusiveHeap<T, COMPARE, TAG>::remove(T &item)
+{
+    if (!contains(item)) { return false; }
+
+    Hook &hook = static_cast<Hook &>(item);
+    if (&hook == m_root)
+    {
+        pop();
+        return true;
+    }
+
+    // cut the subtree out of its sibling list, then merge its children back in at the root
+    if (hook.m_prev->m_child == &hook) { hook.m_prev->m_child = hook.m_next; }
+    else { hook.m_prev->m_next = hook.m_next; }
+    if (hook.m_next != nullptr) { hook.m_next->m_prev = hook.m_prev; }
+
+    Hook *children = merge_pairs(hook.m_child);
+    if (children != nullptr) { m_root = meld(m_root, children); }
+    detach(hook);
+    m_size--;
+    return true;
+}
+
+template <typename T, typename COMPARE, typename TAG>
+typename IntrusiveHeap<T, COMPARE, TAG>::Hook *IntrusiveHeap<T, COMPARE, TAG>::meld(Hook *first, Hook *second)
+{
+    if (m_compare(static_cast<T &>(*second), static_cast<T &>(*first))) { std::swap(first, second); }
+
+    second->m_prev = first;
+    second->m_next = first->m_child;
+    if (first->m_child != nullptr) { first->m_child->m_prev = second; }
+    first->m_child = second;
+    return first;
+}
+
+template <typename T, typename COMPARE, typename TAG>
+typename IntrusiveHeap<T, COMPARE, TAG>::Hook *IntrusiveHeap<T, COMPARE, TAG>::merge_pairs(Hook *first)
+{
+    if (first == nullptr) { return nullptr; }
+
+    // first pass: meld siblings in pairs, left to right, stacking the results on m_next
+    Hook *pairs = nullptr;
+    while (first != nullptr)
+    {
+        Hook *left = first;
+        Hook *right = left->m_next;
+        first = (right != nullptr) ? right->m_next : nullptr;
+
+        left->m_next = nullptr;
+        left->m_prev = nullptr;
+        Hook *tree = left;
+        if (right != nullptr)
+        {
+            right->m_next = nullptr;
+            right->m_prev = nullptr;
+            tree = meld(left, right);
+        }
+        tree->m_next = pairs;
+        pairs = tree;
+    }
+
+    // second pass: meld the pairs right to left into one tree
+    Hook *root = pairs;
+    pairs = pairs->m_next;
+    root->m_next = nullptr;
+    while (pairs != nullptr)
+    {
+        Hook *tree = pairs;
+        pairs = pairs->m_next;
+        tree->m_next = nullptr;
+        root = meld(root, tree);
+    }
+    root->m_prev = nullptr;
+    return root;
+}
+
+} // namespace noarch::containers
+
+#endif // __INTRUSIVE_HEAP_HPP__
@@ -0,0 +1,224 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __INTRUSIVE_LIST_HPP__
+#define __INTRUSIVE_LIST_HPP__
+
+#include <cstddef>
+#include <iterator>
+
+namespace noarch::containers
+{
+
+/// @brief The links an object needs to be in an IntrusiveList. Derive from it, once per list the object
+/// can be in at the same time, each with a different TAG. A hook unlinks itself when it is destroyed.
+/// Copying an object doesn't copy its list membership.
+/// @tparam TAG Any type, to tell the hooks of different lists apart
+template <typename TAG = void>
+class ListHook
+{
+public:
+    ListHook() = default;
+    ListHook(const ListHook &) {}
+    ListHook &operator=(const ListHook &) { return *this; }
+    ~ListHook() { unlink(); }
+
+    /// @brief Check if the object is in a list
+    bool linked() const { return m_next != nullptr; }
+
+    /// @brief Remove the object from whichever list it is in. O(1). Does nothing if it isn't in a list.
+    void unlink()
+    {
+        if (!linked()) { return; }
+        m_prev->m_next = m_next;
+        m_next->m_prev = m_prev;
+        m_prev = nullptr;
+        m_next = nullptr;
+    }
+
+private:
+    template <typename, typename>
+    friend class IntrusiveList;
+
+    ListHook *m_prev{nullptr};
+    ListHook *m_next{nullptr};
+};
+
+/// @brief Doubly-linked list of objects that carry their own links (see ListHook), so adding and removing
+/// never allocates and is O(1). The list doesn't own the objects: they must outlive their membership,
+/// or be destroyed while linked, which unlinks them.
+///
+/// Usage:
+///   struct Job : public noarch::containers::ListHook<>, public RestrictedBase { ... };
+///   noarch::containers::IntrusiveList<Job> pending;
+///   pending.push_back(job);
+///   for (Job &job : pending) { ... }
+/// @tparam T The object type, derived from ListHook<TAG>
+/// @tparam TAG Selects the ListHook base to use
+template <typename T, typename TAG = void>
+class IntrusiveList
+{
+public:
+    using Hook = ListHook<TAG>;
+
+    /// @brief Iterates the objects in list order
+    template <typename VALUE>
+    class Iterator
+    {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = VALUE *;
+        using reference = VALUE &;
+
+        Iterator() = default;
+        explicit Iterator(Hook *hook) : m_hook(hook) {}
+
+        reference operator*() const { return static_cast<reference>(*m_hook); }
+        pointer operator->() const { return &static_cast<reference>(*m_hook); }
+        Iterator &operator++()
+        {
+            m_hook = m_hook->m_next;
+            return *this;
+        }
+        Iterator operator++(int)
+        {
+            Iterator previous = *this;
+            m_hook = m_hook->m_next;
+            return previous;
+        }
+        Iterator &operator--()
+        {
+            m_hook = m_hook->m_prev;
+            return *this;
+        }
+        Iterator operator--(int)
+        {
+            Iterator previous = *this;
+            m_hook = m_hook->m_prev;
+            return previous;
+        }
+        bool operator==(const Iterator &other) const { return m_hook == other.m_hook; }
+
+    private:
+        friend class IntrusiveList;
+
+        Hook *m_hook{nullptr};
+    };
+
+    using iterator = Iterator<T>;
+    using const_iterator = Iterator<const T>;
+
+    IntrusiveList()
+    {
+        m_sentinel.m_prev = &m_sentinel;
+        m_sentinel.m_next = &m_sentinel;
+    }
+
+    /// @brief Unlinks every object
+    ~IntrusiveList() { clear(); }
+
+    IntrusiveList(const IntrusiveList &) = delete;
+    IntrusiveList &operator=(const IntrusiveList &) = delete;
+
+    bool empty() const { return m_sentinel.m_next == &m_sentinel; }
+
+    /// @brief Count the objects. O(n): objects can unlink themselves, so there is no stored count.
+    std::size_t size() const { return static_cast<std::size_t>(std::distance(begin(), end())); }
+
+    /// @brief Add an object at the front. It must not already be in a list.
+    void push_front(T &item) { link_before(*m_sentinel.m_next, item); }
+
+    /// @brief Add an object at the back. It must not already be in a list.
+    void push_back(T &item) { link_before(m_sentinel, item); }
+
+    /// @brief Add an object before another. It must not already be in a list.
+    /// @param position An object in this list, or end()
+    void insert(iterator position, T &item) { link_before(*position.m_hook, item); }
+
+    /// @brief Remove an object from the list. O(1).
+    static void remove(T &item) { static_cast<Hook &>(item).unlink(); }
+
+    /// @brief Get the first object, or nullptr if the list is empty
+    T *front() { return empty() ? nullptr : &static_cast<T &>(*m_sentinel.m_next); }
+
+    /// @brief Get the last object, or nullptr if the list is empty
+    T *back() { return empty() ? nullptr : &static_cast<T &>(*m_sentinel.m_prev); }
+
+    /// @brief Remove and return the first object, or nullptr if the list is empty
+    T *pop_front();
+
+    /// @brief Remove and return the last object, or nullptr if the list is empty
+    T *pop_back();
+
+    /// @brief Unlink every object
+    void clear();
+
+    iterator begin() { return iterator(m_sentinel.m_next); }
+    iterator end() { return iterator(&m_sentinel); }
+    const_iterator begin() const { return const_iterator(m_sentinel.m_next); }
+    const_iterator end() const { return const_iterator(const_cast<Hook *>(&m_sentinel)); }
+
+private:
+    void link_before(Hook &position, T &item);
+
+    /// @brief Circular list head: its next is the front and its prev is the back
+    Hook m_sentinel;
+};
+
+template <typename T, typename TAG>
+T *IntrusiveList<T, TAG>::pop_front()
+{
+    T *item = front();
+    if (item != nullptr) { remove(*item); }
+    return item;
+}
+
+template <typename T, typename TAG>
+T *IntrusiveList<T, TAG>::pop_back()
+{
+    T *item = back();
+    if (item != nullptr) { remove(*item); }
+    return item;
+}
+
+template <typename T, typename TAG>
+void IntrusiveList<T, TAG>::clear()
+{
+    while (!empty()) { m_sentinel.m_next->unlink(); }
+}
+
+template <typename T, typename TAG>
+void IntrusiveList<T, TAG>::link_before(Hook &position, T &item)
+{
+    Hook &hook = static_cast<Hook &>(item);
+    hook.m_prev = position.m_prev;
+    hook.m_next = &position;
+    position.m_prev->m_next = &hook;
+    position.m_prev = &hook;
+}
+
+} // namespace noarch::containers
+
+#endif // __INTRUSIVE_LIST_HPP__
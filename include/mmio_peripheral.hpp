@@ -0,0 +1,49 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __MMIO_PERIPHERAL_HPP__
+#define __MMIO_PERIPHERAL_HPP__
+
+#include <cstdint>
+
+namespace stm32
+{
+
+/// @brief Compile-time accessor for a memory-mapped peripheral.
+/// The register block address is a template argument so drivers bound to it
+/// (e.g. stm32::spi_ref::Spi<SPI1_BASE>) compile to absolute-address loads and
+/// stores with no handle to pass around and no null check.
+/// Unit tests can't dereference the real bus addresses, so they bind the device
+/// templates to their own accessor instead: any type with a static get() that
+/// returns a reference to the register block will do.
+/// @tparam TYPEDEF The CMSIS register struct, e.g. SPI_TypeDef
+/// @tparam BASE The peripheral base address, e.g. SPI1_BASE
+template <typename TYPEDEF, std::uintptr_t BASE>
+struct MmioPeripheral
+{
+  static TYPEDEF &get() { return *reinterpret_cast<TYPEDEF *>(BASE); }
+};
+
+} // namespace stm32
+
+#endif // __MMIO_PERIPHERAL_HPP__
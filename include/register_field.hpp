@@ -0,0 +1,109 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __REGISTER_FIELD_HPP__
+#define __REGISTER_FIELD_HPP__
+
+#include <bit>
+#include <cstdint>
+
+namespace stm32
+{
+
+/// @brief A value for one bit field of a memory-mapped register. The field's position is part of the type,
+/// so a group of fields can be combined into a single register write at compile time, see reg::modify().
+///
+/// Usage:
+///   using SADD = stm32::RegisterField<I2C_CR2_SADD, I2C_CR2_SADD_Pos>;
+///   using AUTOEND = stm32::RegisterField<I2C_CR2_AUTOEND, I2C_CR2_AUTOEND_Pos>;
+///   stm32::reg::modify(i2c_handle.CR2, SADD(addr), AUTOEND(1));
+/// @tparam MASK The CMSIS field mask, e.g. I2C_CR2_SADD
+/// @tparam POS The CMSIS field position, e.g. I2C_CR2_SADD_Pos
+template <uint32_t MASK, uint32_t POS>
+struct RegisterField
+{
+  static_assert(MASK != 0, "empty field mask");
+  static_assert(((MASK >> POS) << POS) == MASK, "field mask starts below its position");
+
+  static constexpr uint32_t mask{MASK};
+  static constexpr uint32_t pos{POS};
+
+  /// @brief The field value, shifted into position. Bits that don't fit in the field are dropped.
+  uint32_t bits;
+
+  /// @param value The unshifted field value
+  constexpr explicit RegisterField(uint32_t value) : bits((value << POS) & MASK) {}
+
+  /// @brief Extract this field from a register value
+  /// @return The unshifted field value
+  static constexpr uint32_t get(uint32_t reg) { return (reg & MASK) >> POS; }
+};
+
+namespace reg
+{
+
+/// @brief Update several fields of a register with one volatile read and one volatile write.
+/// The fields to clear are known at compile time; only the new values are combined at runtime.
+/// This replaces a chain of `REG = REG & ~A; REG = REG | B; ...` statements, each of which is a separate
+/// volatile read-modify-write, with a single one. It is still a read-modify-write: an interrupt that writes
+/// the same register needs the usual protection.
+/// @tparam REGISTER volatile uint32_t, or the register type of the host mocks
+/// @tparam FIELDS RegisterField types. Their masks must not overlap.
+/// @param reg The register
+/// @param fields The new field values. Bits outside the fields keep their current value.
+template <typename REGISTER, typename... FIELDS>
+inline void modify(REGISTER &reg, FIELDS... fields)
+{
+  constexpr uint32_t clear = (FIELDS::mask | ...);
+  static_assert((std::popcount(FIELDS::mask) + ...) == std::popcount(clear), "register fields overlap");
+
+  reg = (reg & ~clear) | (fields.bits | ...);
+}
+
+/// @brief Set a register to the given fields, with every other bit zero. No read: one volatile write.
+/// @tparam REGISTER volatile uint32_t, or the register type of the host mocks
+/// @tparam FIELDS RegisterField types. Their masks must not overlap.
+/// @param reg The register
+/// @param fields The field values
+template <typename REGISTER, typename... FIELDS>
+inline void write(REGISTER &reg, FIELDS... fields)
+{
+  static_assert((std::popcount(FIELDS::mask) + ...) == std::popcount((FIELDS::mask | ...)), "register fields overlap");
+
+  reg = (fields.bits | ...);
+}
+
+/// @brief Read one field of a register
+/// @tparam FIELD A RegisterField type
+/// @return The unshifted field value
+template <typename FIELD, typename REGISTER>
+inline uint32_t read(const REGISTER &reg)
+{
+  return FIELD::get(reg);
+}
+
+} // namespace reg
+
+} // namespace stm32
+
+#endif // __REGISTER_FIELD_HPP__
@@ -23,6 +23,8 @@
 #ifndef __RESTRICTED_BASE_HPP__
 #define __RESTRICTED_BASE_HPP__
 
+#include <cstddef>
+#include <cstdint>
 #include <new>
 
 // All dyanmic allocation is disabled
@@ -54,12 +56,83 @@ public:
 // so it can be caught by debugger
 void invalid_allocation_error_handler();
 
+#if defined(TRACE_ALLOCATIONS)
+// @brief Allocation tracing, enabled by defining TRACE_ALLOCATIONS.
+// Every global operator new call is recorded with its caller, size and TimerManager count in a fixed ring,
+// so the trap in invalid_allocation_error_handler() can be traced back to the code that allocated.
+// On the host build, operator new is replaced by one that only records while an allocation_trace::Guard
+// is in scope on the calling thread, and prints a stack trace for each allocation it sees.
+namespace allocation_trace
+{
+
+// @brief One call to the global operator new
+struct Record
+{
+    // @brief The return address of the operator new call
+    const void *caller;
+    // @brief The requested size in bytes
+    std::size_t size;
+    // @brief stm32::TimerManager::get_count() at the time of the call
+    uint32_t timestamp;
+};
+
+// @brief The number of most recent records kept
+inline constexpr std::size_t DEPTH{16};
+
+// @brief Add a record, overwriting the oldest when the ring is full
+void record(const void *caller, std::size_t size);
+
+// @brief Get the number of allocations recorded since startup or reset(), including any overwritten
+std::size_t count();
+
+// @brief Get a record
+// @param idx 0 is the most recent allocation
+// @param out The record
+// @return false if there is no record at idx
+bool get(std::size_t idx, Record &out);
+
+// @brief Discard all records
+void reset();
+
+#if defined(X86_UNIT_TESTING_ONLY)
+// @brief Record allocations made by this thread while in scope. Use it to turn hidden STL allocations
+// into test failures: REQUIRE(guard.allocations() == 0) once the code under test has run.
+class Guard
+{
+public:
+    // @param print_stack_trace Write a stack trace to stderr for each allocation
+    explicit Guard(bool print_stack_trace = true);
+    ~Guard();
+
+    Guard(const Guard&) = delete;
+    Guard &operator=(const Guard&) = delete;
+
+    // @brief The number of allocations made by this thread since the guard was constructed
+    std::size_t allocations() const { return m_allocations; }
+
+    // @brief Called by the host operator new. Not for use in tests.
+    static void on_allocation(const void *caller, std::size_t size);
+
+private:
+    bool m_print_stack_trace;
+    std::size_t m_allocations{0};
+    Guard *m_previous;
+};
+#endif
+
+}   // namespace allocation_trace
+#endif
+
 #ifndef X86_UNIT_TESTING_ONLY
 // This definition must be in header so it can be seen 
 // (and must be inline to prevent multiple definition linker errors)
-inline void * operator new (std::size_t)  
+// Not inlined into the caller, so the return address is the allocating code.
+[[gnu::noinline]] inline void * operator new (std::size_t size [[maybe_unused]])  
 {
     void *p = nullptr;
+#if defined(TRACE_ALLOCATIONS)
+    allocation_trace::record(__builtin_return_address(0), size);
+#endif
     invalid_allocation_error_handler();
     return p;
 }
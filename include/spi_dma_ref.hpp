@@ -0,0 +1,163 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __SPI_DMA_REF_HPP__
+#define __SPI_DMA_REF_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <restricted_base.hpp>
+#include <span>
+#include <spi_utils_ref.hpp>
+
+namespace stm32::spi_ref
+{
+
+/// @brief The DMA transmit events reported by DmaTransmitter
+enum class DmaEvent
+{
+  /// @brief The first half of the buffer has been sent and can be refilled (circular mode only)
+  HALF_COMPLETE,
+  /// @brief The whole buffer has been sent. In circular mode the second half can now be refilled.
+  COMPLETE,
+  /// @brief The DMA channel reported a transfer error. The channel has been stopped.
+  ERROR,
+};
+
+/// @brief Called from the DMA interrupt when a transmit event occurs
+/// @param event The event that occurred
+/// @param context The user pointer passed when the transmission was started
+using DmaCallback = void (*)(DmaEvent event, void *context);
+
+/// @brief Zero-copy SPI transmitter using a DMA channel.
+/// The DMA reads directly from the caller's buffer, which must remain valid (and, in one-shot mode,
+/// unmodified) until COMPLETE. In circular mode the buffer is sent repeatedly: after HALF_COMPLETE
+/// the first half may be rewritten while the second half is sent, and vice versa after COMPLETE.
+/// Completion is reported via the optional callback, busy() and last_event().
+///
+/// The DMAMUX request line for the SPI TX (e.g. DMAMUX1_Channel0->CCR = 17 for SPI1_TX) and the
+/// NVIC are configured by the application, as with the rest of the peripheral initialisation.
+///
+/// Usage:
+///   static stm32::spi_ref::DmaTransmitter spi1_dma(*SPI1, *DMA1, *DMA1_Channel1, 1);
+///   extern "C" void DMA1_Channel1_IRQHandler() { spi1_dma.irq_handler(); }
+class DmaTransmitter : public RestrictedBase
+{
+public:
+  /// @brief Construct the transmitter. The SPI peripheral must already be configured and enabled.
+  /// @param spi_handle The CMSIS memory-mapped SPI device
+  /// @param dma_handle The CMSIS memory-mapped DMA controller, used for the interrupt flags
+  /// @param channel_handle The CMSIS memory-mapped DMA channel routed to the SPI TX request
+  /// @param channel_number The number of the DMA channel (1-7), used to locate its flags in ISR/IFCR.
+  /// Out of range, the transmitter is left unusable, see valid().
+  DmaTransmitter(SPI_TypeDef &spi_handle, DMA_TypeDef &dma_handle, DMA_Channel_TypeDef &channel_handle, uint8_t channel_number)
+      : m_spi_handle(spi_handle), m_dma_handle(dma_handle), m_channel_handle(channel_handle),
+        m_valid((channel_number >= 1U) && (channel_number <= m_max_channels)),
+        m_flag_shift(m_valid ? static_cast<uint8_t>(4U * (channel_number - 1U)) : 0U)
+  {
+  }
+
+  /// @brief Check the channel number given to the constructor was in range
+  /// @return false if it wasn't, in which case nothing is sent and the DMA flags are never touched
+  bool valid() const { return m_valid; }
+
+  /// @brief Send a buffer of 8-bit frames once
+  /// @param buffer The frames to send. Must remain valid until COMPLETE.
+  /// @param callback Optional event callback, called from irq_handler()
+  /// @param context Optional user pointer passed to the callback
+  /// @return false if a transmission is in progress, the buffer is empty or larger than 65535 frames, or !valid()
+  bool send(std::span<const uint8_t> buffer, DmaCallback callback = nullptr, void *context = nullptr);
+
+  /// @brief Send a buffer of 16-bit frames once. The SPI must be configured for 16-bit frames (CR2 DS).
+  /// @param buffer The frames to send. Must remain valid until COMPLETE.
+  /// @param callback Optional event callback, called from irq_handler()
+  /// @param context Optional user pointer passed to the callback
+  /// @return false if a transmission is in progress, the buffer is empty or larger than 65535 frames, or !valid()
+  bool send(std::span<const uint16_t> buffer, DmaCallback callback = nullptr, void *context = nullptr);
+
+  /// @brief Send a buffer of 8-bit frames repeatedly until stop() is called
+  /// @param buffer The frames to send, treated as two halves. Must remain valid until stop().
+  /// @param callback Optional event callback, called from irq_handler() after each half
+  /// @param context Optional user pointer passed to the callback
+  /// @return false if a transmission is in progress, the buffer is empty or larger than 65535 frames, or !valid()
+  bool start_circular(std::span<const uint8_t> buffer, DmaCallback callback = nullptr, void *context = nullptr);
+
+  /// @brief Send a buffer of 16-bit frames repeatedly until stop() is called.
+  /// The SPI must be configured for 16-bit frames (CR2 DS).
+  /// @param buffer The frames to send, treated as two halves. Must remain valid until stop().
+  /// @param callback Optional event callback, called from irq_handler() after each half
+  /// @param context Optional user pointer passed to the callback
+  /// @return false if a transmission is in progress, the buffer is empty or larger than 65535 frames, or !valid()
+  bool start_circular(std::span<const uint16_t> buffer, DmaCallback callback = nullptr, void *context = nullptr);
+
+  /// @brief Stop the DMA channel immediately. Frames already in the SPI TX FIFO are still sent.
+  void stop();
+
+  /// @brief Check if a transmission is in progress
+  /// @return true until a one-shot transmission completes, or until stop() in circular mode
+  bool busy() const { return m_busy; }
+
+  /// @brief Pollable alternative to the callback
+  /// @return The most recent event reported by irq_handler()
+  DmaEvent last_event() const { return m_last_event; }
+
+  /// @brief Handle the DMA channel interrupt. Must be called from the DMAx_Channelx_IRQHandler.
+  void irq_handler();
+
+private:
+  /// @brief Program the DMA channel and enable the SPI TX DMA request
+  bool start(const void *buffer, std::size_t frames, uint32_t frame_size_bits, bool circular, DmaCallback callback, void *context);
+
+  /// @brief The CMSIS memory-mapped SPI device
+  SPI_TypeDef &m_spi_handle;
+
+  /// @brief The CMSIS memory-mapped DMA controller and channel
+  DMA_TypeDef &m_dma_handle;
+  DMA_Channel_TypeDef &m_channel_handle;
+
+  /// @brief The channels with flags in DMA_ISR/DMA_IFCR, four bits each
+  static constexpr uint8_t m_max_channels{7};
+
+  /// @brief False if the channel number was out of range
+  bool m_valid;
+
+  /// @brief The position of this channel's flags in DMA_ISR/DMA_IFCR
+  uint8_t m_flag_shift;
+
+  /// @brief True if the buffer is being sent repeatedly
+  bool m_circular{false};
+
+  /// @brief Written by irq_handler()
+  volatile bool m_busy{false};
+  volatile DmaEvent m_last_event{DmaEvent::COMPLETE};
+
+  DmaCallback m_callback{nullptr};
+  void *m_callback_context{nullptr};
+
+  /// @brief The maximum value of DMA_CNDTR
+  static constexpr std::size_t m_max_frames{0xFFFF};
+};
+
+} // namespace stm32::spi_ref
+
+#endif // __SPI_DMA_REF_HPP__
@@ -23,39 +23,82 @@
 #ifndef __SPI_UTILS_HPP__
 #define __SPI_UTILS_HPP__
 
-// add groups for device family
-#if defined (STM32G071xx) || defined (STM32G081xx) || defined (STM32G070xx) \
-|| defined (STM32G030xx) || defined (STM32G031xx) || defined (STM32G041xx) \
-|| defined (STM32G0B0xx) || defined (STM32G0B1xx) || defined (STM32G0C1xx) \
-|| defined (STM32G050xx) || defined (STM32G051xx) || defined (STM32G061xx)		
-	#include <stm32g0xx.h>
-#endif
+#include <spi_utils_ref.hpp>
 
+// Null-checking wrappers for callers that hold the handle as a pointer. See stm32::spi_ref for the implementation.
 
 namespace stm32::spi
 {
 
-bool enable_spi(SPI_TypeDef *spi_handle, bool enable = true);
+inline bool enable_spi(SPI_TypeDef *spi_handle, bool enable = true)
+{
+  if (spi_handle == nullptr) { return false; }
+  return stm32::spi_ref::enable_spi(*spi_handle, enable);
+}
 
-bool send_byte(SPI_TypeDef *spi_handle, uint8_t byte);
+inline bool send_byte(SPI_TypeDef *spi_handle, uint8_t byte, uint32_t timeout_us = 1000)
+{
+  if (spi_handle == nullptr) { return false; }
+  return stm32::spi_ref::send_byte(*spi_handle, byte, timeout_us);
+}
 
-// @brief Check and retry (with timeout) the SPIx_SR TXE register.
-// @param spi_handle Pointer to the CMSIS mem-mapped SPI device
-// @param delay_us The timeout
-// @return true if TX FIFO is empty, false if TX FIFO is full
-bool wait_for_txe_flag(SPI_TypeDef *spi_handle, uint32_t delay_us = 100);
+/// @brief See stm32::spi_ref::send()
+/// @return false if spi_handle is null
+inline bool send(SPI_TypeDef *spi_handle, std::span<const uint8_t> tx, uint32_t timeout_us = 1000)
+{
+  if (spi_handle == nullptr) { return false; }
+  return stm32::spi_ref::send(*spi_handle, tx, timeout_us);
+}
 
-// @brief Check and retry (with timeout) the SPIx_SR BSY register.
-// @param spi_handle Pointer to the CMSIS mem-mapped SPI device
-// @param delay_us The timeout
-// @return true if SPI bus is busy, false if SPI bus is not busy.
-bool wait_for_bsy_flag(SPI_TypeDef *spi_handle, uint32_t delay_us = 100);
+/// @brief See stm32::spi_ref::send()
+/// @return false if spi_handle is null
+inline bool send(SPI_TypeDef *spi_handle, std::span<const uint16_t> tx, uint32_t timeout_us = 1000)
+{
+  if (spi_handle == nullptr) { return false; }
+  return stm32::spi_ref::send(*spi_handle, tx, timeout_us);
+}
+
+/// @brief See stm32::spi_ref::transfer()
+/// @return false if spi_handle is null
+inline bool transfer(SPI_TypeDef *spi_handle, std::span<const uint8_t> tx, std::span<uint8_t> rx, uint32_t timeout_us = 1000)
+{
+  if (spi_handle == nullptr) { return false; }
+  return stm32::spi_ref::transfer(*spi_handle, tx, rx, timeout_us);
+}
+
+/// @brief See stm32::spi_ref::transfer()
+/// @return false if spi_handle is null
+inline bool transfer(SPI_TypeDef *spi_handle, std::span<const uint16_t> tx, std::span<uint16_t> rx, uint32_t timeout_us = 1000)
+{
+  if (spi_handle == nullptr) { return false; }
+  return stm32::spi_ref::transfer(*spi_handle, tx, rx, timeout_us);
+}
+
+/// @brief See stm32::spi_ref::wait_for_txe_flag()
+/// @return ERROR if spi_handle is null
+inline WaitStatus wait_for_txe_flag(SPI_TypeDef *spi_handle, uint32_t timeout_us = 100)
+{
+  if (spi_handle == nullptr) { return WaitStatus::ERROR; }
+  return stm32::spi_ref::wait_for_txe_flag(*spi_handle, timeout_us);
+}
+
+/// @brief See stm32::spi_ref::wait_for_bsy_flag()
+/// @return ERROR if spi_handle is null
+inline WaitStatus wait_for_bsy_flag(SPI_TypeDef *spi_handle, uint32_t timeout_us = 100)
+{
+  if (spi_handle == nullptr) { return WaitStatus::ERROR; }
+  return stm32::spi_ref::wait_for_bsy_flag(*spi_handle, timeout_us);
+}
 
 /// @brief Set the prescaler value
 /// @param spi_handle Pointer to the CMSIS mem-mapped SPI device
 /// @param new_value Must be a bitwise-OR of SPI_CR1_BR_2 (0x20), SPI_CR1_BR_1 (0x10), SPI_CR1_BR_0 (0x08)
 /// @return false if spi_handle is null, else true
-bool set_prescaler(SPI_TypeDef *spi_handle, uint32_t new_value);
+inline bool set_prescaler(SPI_TypeDef *spi_handle, uint32_t new_value)
+{
+  if (spi_handle == nullptr) { return false; }
+  return stm32::spi_ref::set_prescaler(*spi_handle, new_value);
+}
 
 } // namespace stm32::spi
 
@@ -29,30 +29,227 @@
   #include <stm32g0xx.h>
 #endif
 
+#include <cstddef>
+#include <mmio_peripheral.hpp>
+#include <span>
+#include <timer_manager.hpp>
+#include <wait_utils.hpp>
+
+// The functions below are the only implementation of the SPI driver. They are defined inline so that the
+// compile-time bound device template and the pointer wrappers collapse into the same code at the call site.
+
 namespace stm32::spi_ref
 {
 
-bool enable_spi(SPI_TypeDef &spi_handle, bool enable = true);
+inline bool enable_spi(SPI_TypeDef &spi_handle, bool enable = true)
+{
+
+  if (enable)
+  {
+    spi_handle.CR1 = spi_handle.CR1 | SPI_CR1_SPE;
+  }
+  else
+  {
+    spi_handle.CR1 = spi_handle.CR1 & ~SPI_CR1_SPE;
+  }
+
+  return true;
+}
+
+namespace detail
+{
+
+// A mode fault disables the SPI, so TXE/BSY will not change until it is reconfigured
+inline bool mode_fault(SPI_TypeDef &spi_handle) { return (spi_handle.SR & SPI_SR_MODF) == SPI_SR_MODF; }
+
+} // namespace detail
+
+/// @brief Wait for the SPIx_SR TXE flag, i.e. the TX FIFO has room for another frame.
+/// @param spi_handle The CMSIS mem-mapped SPI device
+/// @param timeout_us The overall deadline, see stm32::wait_until()
+/// @return READY if TXE is set, ERROR on mode fault, TIMEOUT if TXE was not set before the deadline
+inline WaitStatus wait_for_txe_flag(SPI_TypeDef &spi_handle, uint32_t timeout_us = 100)
+{
+  return stm32::wait_until([&spi_handle] { return (spi_handle.SR & SPI_SR_TXE) == SPI_SR_TXE; },
+                           [&spi_handle] { return detail::mode_fault(spi_handle); }, timeout_us);
+}
+
+/// @brief Wait for the SPIx_SR BSY flag to clear, i.e. the SPI has finished the current transfer.
+/// @param spi_handle The CMSIS mem-mapped SPI device
+/// @param timeout_us The overall deadline, see stm32::wait_until()
+/// @return READY if BSY is clear, ERROR on mode fault, TIMEOUT if BSY was still set at the deadline
+inline WaitStatus wait_for_bsy_flag(SPI_TypeDef &spi_handle, uint32_t timeout_us = 100)
+{
+  return stm32::wait_until([&spi_handle] { return (spi_handle.SR & SPI_SR_BSY) != SPI_SR_BSY; },
+                           [&spi_handle] { return detail::mode_fault(spi_handle); }, timeout_us);
+}
+
+/// @brief Transmit a single frame and wait for the SPI to finish sending it
+/// @param spi_handle The CMSIS mem-mapped SPI device
+/// @param byte The frame to send
+/// @param timeout_us The deadline for each of the BSY and TXE waits
+/// @return false if the SPI did not become ready before the deadline or reported a mode fault
+inline bool send_byte(SPI_TypeDef &spi_handle, uint8_t byte, uint32_t timeout_us = 1000)
+{
+
+  volatile uint8_t *spidr = ((volatile uint8_t *)&spi_handle.DR);
+  *spidr                  = byte;
+  // wait for SPI periph ready-state
+  if (stm32::spi_ref::wait_for_bsy_flag(spi_handle, timeout_us) != WaitStatus::READY) { return false; }
+  return stm32::spi_ref::wait_for_txe_flag(spi_handle, timeout_us) == WaitStatus::READY;
+}
+
+namespace detail
+{
+
+// Access DR at the frame width. Byte writes are packed into the TX FIFO, word writes would send two frames.
+template <typename FRAME> volatile FRAME &data_register(SPI_TypeDef &spi_handle)
+{
+  return *reinterpret_cast<volatile FRAME *>(&spi_handle.DR);
+}
 
-bool send_byte(SPI_TypeDef &spi_handle, uint8_t byte);
+// Frames that can be in flight before the 32-bit RX FIFO would overrun
+template <typename FRAME> constexpr std::size_t rx_fifo_frames = 4 / sizeof(FRAME);
+
+template <typename FRAME> bool send(SPI_TypeDef &spi_handle, std::span<const FRAME> tx, uint32_t timeout_us)
+{
+  for (const FRAME frame : tx)
+  {
+    // only TXE is checked between frames, so the TX FIFO stays full
+    if (stm32::spi_ref::wait_for_txe_flag(spi_handle, timeout_us) != WaitStatus::READY) { return false; }
+    data_register<FRAME>(spi_handle) = frame;
+  }
+
+  // BSY is checked once, after the last frame has been queued
+  if (stm32::spi_ref::wait_for_bsy_flag(spi_handle, timeout_us) != WaitStatus::READY) { return false; }
+
+  // discard whatever was clocked in, then read SR to clear a pending overrun
+  while ((spi_handle.SR & SPI_SR_FRLVL) != 0)
+  {
+    [[maybe_unused]] const uint8_t discarded = data_register<uint8_t>(spi_handle);
+  }
+  [[maybe_unused]] const uint32_t sr = spi_handle.SR;
+  return true;
+}
+
+template <typename FRAME> bool transfer(SPI_TypeDef &spi_handle, std::span<const FRAME> tx, std::span<FRAME> rx, uint32_t timeout_us)
+{
+  if (tx.size() != rx.size()) { return false; }
 
-// @brief Check and retry (with timeout) the SPIx_SR TXE register.
-// @param spi_handle Pointer to the CMSIS mem-mapped SPI device
-// @param delay_us The timeout
-// @return true if TX FIFO is empty, false if TX FIFO is full
-bool wait_for_txe_flag(SPI_TypeDef &spi_handle, uint32_t delay_us = 100);
+  // RXNE must be raised per frame: 8-bit threshold for byte frames, 16-bit otherwise
+  if constexpr (sizeof(FRAME) == 1) { spi_handle.CR2 = spi_handle.CR2 | SPI_CR2_FRXTH; }
+  else { spi_handle.CR2 = spi_handle.CR2 & ~SPI_CR2_FRXTH; }
 
-// @brief Check and retry (with timeout) the SPIx_SR BSY register.
-// @param spi_handle Pointer to the CMSIS mem-mapped SPI device
-// @param delay_us The timeout
-// @return true if SPI bus is busy, false if SPI bus is not busy.
-bool wait_for_bsy_flag(SPI_TypeDef &spi_handle, uint32_t delay_us = 100);
+  std::size_t tx_count{0};
+  std::size_t rx_count{0};
+  while (rx_count < rx.size())
+  {
+    const bool can_read  = (rx_count < tx_count);
+    const bool can_write = (tx_count < tx.size()) && ((tx_count - rx_count) < rx_fifo_frames<FRAME>);
+
+    // wait for whichever flag lets the transfer make progress
+    const auto progress = [&spi_handle, can_read, can_write] {
+      const uint32_t sr = spi_handle.SR;
+      return (can_read && ((sr & SPI_SR_RXNE) == SPI_SR_RXNE)) || (can_write && ((sr & SPI_SR_TXE) == SPI_SR_TXE));
+    };
+    if (stm32::wait_until(progress, [&spi_handle] { return mode_fault(spi_handle); }, timeout_us) != WaitStatus::READY) { return false; }
+
+    if (can_read && ((spi_handle.SR & SPI_SR_RXNE) == SPI_SR_RXNE)) { rx[rx_count++] = data_register<FRAME>(spi_handle); }
+    if (can_write && ((spi_handle.SR & SPI_SR_TXE) == SPI_SR_TXE)) { data_register<FRAME>(spi_handle) = tx[tx_count++]; }
+  }
+
+  return stm32::spi_ref::wait_for_bsy_flag(spi_handle, timeout_us) == WaitStatus::READY;
+}
+
+} // namespace detail
+
+/// @brief Transmit a buffer of 8-bit frames, keeping the TX FIFO full. Received data is discarded.
+/// @param spi_handle The CMSIS mem-mapped SPI device, configured for 8-bit frames (CR2 DS)
+/// @param tx The frames to send
+/// @param timeout_us The deadline for the SPI to accept each frame
+/// @return true once the last frame has left the shift register, false on timeout or mode fault
+inline bool send(SPI_TypeDef &spi_handle, std::span<const uint8_t> tx, uint32_t timeout_us = 1000)
+{
+  return detail::send(spi_handle, tx, timeout_us);
+}
+
+/// @brief Transmit a buffer of 16-bit frames, keeping the TX FIFO full. Received data is discarded.
+/// @param spi_handle The CMSIS mem-mapped SPI device, configured for 16-bit frames (CR2 DS)
+/// @param tx The frames to send
+/// @param timeout_us The deadline for the SPI to accept each frame
+/// @return true once the last frame has left the shift register, false on timeout or mode fault
+inline bool send(SPI_TypeDef &spi_handle, std::span<const uint16_t> tx, uint32_t timeout_us = 1000)
+{
+  return detail::send(spi_handle, tx, timeout_us);
+}
+
+/// @brief Full-duplex transfer of 8-bit frames. Up to four frames are kept in flight.
+/// @param spi_handle The CMSIS mem-mapped SPI device, configured for 8-bit frames (CR2 DS)
+/// @param tx The frames to send
+/// @param rx Receives one frame per transmitted frame
+/// @param timeout_us The deadline for the SPI to accept or return each frame
+/// @return false if tx and rx are different sizes, on timeout or on mode fault, else true
+inline bool transfer(SPI_TypeDef &spi_handle, std::span<const uint8_t> tx, std::span<uint8_t> rx, uint32_t timeout_us = 1000)
+{
+  return detail::transfer(spi_handle, tx, rx, timeout_us);
+}
+
+/// @brief Full-duplex transfer of 16-bit frames. Up to two frames are kept in flight.
+/// @param spi_handle The CMSIS mem-mapped SPI device, configured for 16-bit frames (CR2 DS)
+/// @param tx The frames to send
+/// @param rx Receives one frame per transmitted frame
+/// @param timeout_us The deadline for the SPI to accept or return each frame
+/// @return false if tx and rx are different sizes, on timeout or on mode fault, else true
+inline bool transfer(SPI_TypeDef &spi_handle, std::span<const uint16_t> tx, std::span<uint16_t> rx, uint32_t timeout_us = 1000)
+{
+  return detail::transfer(spi_handle, tx, rx, timeout_us);
+}
 
 /// @brief Set the prescaler value
 /// @param spi_handle Pointer to the CMSIS mem-mapped SPI device
 /// @param new_value Must be a bitwise-OR of SPI_CR1_BR_2 (0x20), SPI_CR1_BR_1 (0x10), SPI_CR1_BR_0 (0x08)
 /// @return false if spi_handle is null, else true
-bool set_prescaler(SPI_TypeDef &spi_handle, uint32_t new_value);
+inline bool set_prescaler(SPI_TypeDef &spi_handle, uint32_t new_value)
+{
+
+  spi_handle.CR1 = spi_handle.CR1 & ~(SPI_CR1_BR_2 | SPI_CR1_BR_1 | SPI_CR1_BR_0);
+  spi_handle.CR1 = spi_handle.CR1 | (new_value);
+  return true;
+}
+
+/// @brief SPI driver bound to its peripheral at compile time.
+/// @tparam PERIPHERAL Accessor type with a static get() returning SPI_TypeDef&. See stm32::MmioPeripheral.
+template <typename PERIPHERAL>
+struct SpiDevice
+{
+  static bool enable_spi(bool enable = true) { return spi_ref::enable_spi(PERIPHERAL::get(), enable); }
+
+  static bool send_byte(uint8_t byte, uint32_t timeout_us = 1000) { return spi_ref::send_byte(PERIPHERAL::get(), byte, timeout_us); }
+
+  static bool send(std::span<const uint8_t> tx, uint32_t timeout_us = 1000) { return spi_ref::send(PERIPHERAL::get(), tx, timeout_us); }
+
+  static bool send(std::span<const uint16_t> tx, uint32_t timeout_us = 1000) { return spi_ref::send(PERIPHERAL::get(), tx, timeout_us); }
+
+  static bool transfer(std::span<const uint8_t> tx, std::span<uint8_t> rx, uint32_t timeout_us = 1000)
+  {
+    return spi_ref::transfer(PERIPHERAL::get(), tx, rx, timeout_us);
+  }
+
+  static bool transfer(std::span<const uint16_t> tx, std::span<uint16_t> rx, uint32_t timeout_us = 1000)
+  {
+    return spi_ref::transfer(PERIPHERAL::get(), tx, rx, timeout_us);
+  }
+
+  static WaitStatus wait_for_txe_flag(uint32_t timeout_us = 100) { return spi_ref::wait_for_txe_flag(PERIPHERAL::get(), timeout_us); }
+
+  static WaitStatus wait_for_bsy_flag(uint32_t timeout_us = 100) { return spi_ref::wait_for_bsy_flag(PERIPHERAL::get(), timeout_us); }
+
+  static bool set_prescaler(uint32_t new_value) { return spi_ref::set_prescaler(PERIPHERAL::get(), new_value); }
+};
+
+/// @brief SPI driver for the peripheral at BASE, e.g. stm32::spi_ref::Spi<SPI1_BASE>::send_byte(0xFF)
+template <std::uintptr_t BASE>
+using Spi = SpiDevice<stm32::MmioPeripheral<SPI_TypeDef, BASE>>;
 
 } // namespace stm32::spi_ref
 
@@ -0,0 +1,195 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __STATIC_ARENA_HPP__
+#define __STATIC_ARENA_HPP__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory_resource>
+#include <utility>
+
+namespace noarch::memory
+{
+
+/// @brief A std::pmr::memory_resource with nothing to give: allocate() stops the program where it was called,
+/// with std::abort() on the host and a trap instruction on the target. Unlike std::pmr::null_memory_resource()
+/// it doesn't need exceptions, and unlike nothrow_null_resource() it never hands a pmr container a nullptr.
+/// @return The resource, shared by all its users
+inline std::pmr::memory_resource *trapping_null_resource() noexcept
+{
+    class TrappingNullResource : public std::pmr::memory_resource
+    {
+        void *do_allocate(std::size_t, std::size_t) override
+        {
+#if defined(X86_UNIT_TESTING_ONLY)
+            std::abort();
+#else
+            __builtin_trap();
+#endif
+        }
+        void do_deallocate(void *, std::size_t, std::size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+    };
+    static TrappingNullResource resource;
+    return &resource;
+}
+
+/// @brief A std::pmr::memory_resource with nothing to give: allocate() returns nullptr. This breaks the
+/// std::pmr::memory_resource contract and the std::pmr containers don't check for it, so it is only for code that
+/// calls StaticArena::allocate() itself and checks the result. Never the default.
+/// @return The resource, shared by all its users
+inline std::pmr::memory_resource *nothrow_null_resource() noexcept
+{
+    class NothrowNullResource : public std::pmr::memory_resource
+    {
+        void *do_allocate(std::size_t, std::size_t) override { return nullptr; }
+        void do_deallocate(void *, std::size_t, std::size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+    };
+    static NothrowNullResource resource;
+    return &resource;
+}
+
+/// @brief Statically allocated monotonic arena. Allocation bumps a pointer, individual frees do nothing,
+/// and reset() releases everything at once. Use it directly with create(), or as a std::pmr::memory_resource
+/// to give pmr containers and algorithms deterministic scratch space without the heap.
+/// Not thread-safe: guard it if it's used from an interrupt and the main loop.
+///
+/// Usage:
+///   static noarch::memory::StaticArena<1024> scratch;
+///   std::pmr::vector<uint16_t> samples(&scratch);
+///   samples.reserve(256);
+///   ...
+///   scratch.reset(); // once nothing refers to the arena any more
+/// @tparam SIZE The arena size in bytes
+template <std::size_t SIZE>
+class StaticArena : public std::pmr::memory_resource
+{
+public:
+    // Not a RestrictedBase: its deleted operator delete conflicts with memory_resource's virtual destructor.
+    // Copying would duplicate live allocations, so that is prevented here instead.
+    StaticArena(const StaticArena &) = delete;
+    StaticArena &operator=(const StaticArena &) = delete;
+
+    /// @brief Construct an empty arena
+    /// @param upstream What a std::pmr::memory_resource allocation falls back to when the arena is exhausted.
+    /// The default, trapping_null_resource(), stops the program at the failed allocation. Pass
+    /// std::pmr::null_memory_resource() for std::bad_alloc when exceptions are enabled, or nothrow_null_resource()
+    /// to get nullptr back when every allocation is checked by the caller.
+    explicit StaticArena(std::pmr::memory_resource *upstream = trapping_null_resource()) : m_upstream(upstream) {}
+
+    /// @brief Get uninitialised storage. Never falls back to the upstream resource.
+    /// @param bytes The size of the storage
+    /// @param alignment The alignment of the storage, a power of two
+    /// @return The storage, or nullptr if the arena doesn't have room
+    void *try_allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t));
+
+    /// @brief Allocate and construct an object in place. Its destructor is not called by reset().
+    /// @param args The constructor arguments
+    /// @return The object, or nullptr if the arena doesn't have room
+    template <typename T, typename... ARGS>
+    T *create(ARGS &&...args)
+    {
+        void *storage = try_allocate(sizeof(T), alignof(T));
+        if (storage == nullptr) { return nullptr; }
+        return ::new (storage) T(std::forward<ARGS>(args)...);
+    }
+
+    /// @brief Release everything allocated from the arena
+    void reset() { m_used = 0; }
+
+    /// @brief Get the size of the arena in bytes
+    static constexpr std::size_t capacity() { return SIZE; }
+
+    /// @brief The number of bytes allocated, including alignment padding
+    std::size_t used() const { return m_used; }
+
+    /// @brief The most bytes allocated at once since construction or reset_statistics()
+    std::size_t high_watermark() const { return m_high_watermark; }
+
+    /// @brief The number of allocations the arena didn't have room for, since construction or reset_statistics()
+    std::size_t failed() const { return m_failed; }
+
+    /// @brief Clear the high watermark and failed counters
+    void reset_statistics()
+    {
+        m_high_watermark = m_used;
+        m_failed = 0;
+    }
+
+private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+    /// @brief Individual frees from the arena are ignored, see reset(). Upstream allocations are returned upstream.
+    void do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment) override;
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+    alignas(std::max_align_t) std::byte m_storage[SIZE];
+
+    std::pmr::memory_resource *m_upstream;
+
+    std::size_t m_used{0};
+    std::size_t m_high_watermark{0};
+    std::size_t m_failed{0};
+};
+
+template <std::size_t SIZE>
+void *StaticArena<SIZE>::try_allocate(std::size_t bytes, std::size_t alignment)
+{
+    const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(m_storage);
+    const std::uintptr_t start = (base + m_used + (alignment - 1)) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+    const std::size_t offset = start - base;
+    if ((offset > SIZE) || (bytes > SIZE - offset))
+    {
+        m_failed++;
+        return nullptr;
+    }
+
+    m_used = offset + bytes;
+    m_high_watermark = std::max(m_high_watermark, m_used);
+    return m_storage + offset;
+}
+
+template <std::size_t SIZE>
+void *StaticArena<SIZE>::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    void *storage = try_allocate(bytes, alignment);
+    if (storage == nullptr) { return m_upstream->allocate(bytes, alignment); }
+    return storage;
+}
+
+template <std::size_t SIZE>
+void StaticArena<SIZE>::do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment)
+{
+    const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(ptr);
+    const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(m_storage);
+    if ((address < base) || (address >= base + SIZE)) { m_upstream->deallocate(ptr, bytes, alignment); }
+}
+
+} // namespace noarch::memory
+
+#endif // __STATIC_ARENA_HPP__
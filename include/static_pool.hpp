@@ -0,0 +1,181 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __STATIC_POOL_HPP__
+#define __STATIC_POOL_HPP__
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <restricted_base.hpp>
+#include <utility>
+
+namespace noarch::memory
+{
+
+/// @brief Statically allocated pool of CAPACITY objects of type T, for creating a varying number of objects
+/// at runtime without the heap. Free slots are kept in an intrusive free list, so allocate() and deallocate()
+/// are O(1) and deterministic. Not thread-safe: guard it if it's used from an interrupt and the main loop.
+///
+/// Usage:
+///   static noarch::memory::StaticPool<Message, 16> message_pool;
+///   Message *msg = message_pool.create(id, payload);
+///   if (msg == nullptr) { /* pool exhausted */ }
+///   message_pool.destroy(msg);
+/// @tparam T The object type
+/// @tparam CAPACITY The number of objects the pool can hold
+template <typename T, std::size_t CAPACITY>
+class StaticPool : public RestrictedBase
+{
+    static_assert(CAPACITY > 0, "CAPACITY must not be zero");
+
+public:
+    /// @brief Construct the pool with every slot free
+    StaticPool();
+
+    /// @brief Get uninitialised storage for one T
+    /// @return The storage, or nullptr if the pool is exhausted
+    void *allocate();
+
+    /// @brief Return storage from allocate(). The object must already have been destroyed.
+    /// @param ptr The storage. Ignored if it is nullptr or doesn't belong to this pool.
+    void deallocate(void *ptr);
+
+    /// @brief Allocate and construct an object in place
+    /// @param args The constructor arguments
+    /// @return The object, or nullptr if the pool is exhausted
+    template <typename... ARGS>
+    T *create(ARGS &&...args);
+
+    /// @brief Destroy an object from create() and return its storage
+    /// @param object The object. Ignored if it is nullptr or doesn't belong to this pool.
+    void destroy(T *object);
+
+    /// @brief Check if ptr is the start of one of this pool's slots
+    bool owns(const void *ptr) const;
+
+    /// @brief Get the number of objects the pool can hold
+    static constexpr std::size_t capacity() { return CAPACITY; }
+
+    /// @brief The number of slots currently allocated
+    std::size_t in_use() const { return m_in_use; }
+
+    /// @brief The most slots allocated at once since construction or reset_statistics()
+    std::size_t high_watermark() const { return m_high_watermark; }
+
+    /// @brief The number of allocations refused because the pool was exhausted, since construction or reset_statistics()
+    std::size_t failed() const { return m_failed; }
+
+    /// @brief Clear the high watermark and failed counters
+    void reset_statistics()
+    {
+        m_high_watermark = m_in_use;
+        m_failed = 0;
+    }
+
+private:
+    /// @brief A free slot holds the link to the next free slot, an allocated slot holds the object
+    union Slot
+    {
+        Slot *next;
+        alignas(T) std::byte object[sizeof(T)];
+    };
+
+    std::array<Slot, CAPACITY> m_slots;
+
+    /// @brief Head of the free list, nullptr when the pool is exhausted
+    Slot *m_free{nullptr};
+
+    std::size_t m_in_use{0};
+    std::size_t m_high_watermark{0};
+    std::size_t m_failed{0};
+};
+
+template <typename T, std::size_t CAPACITY>
+StaticPool<T, CAPACITY>::StaticPool()
+{
+    // link the slots in address order, so the first allocations are contiguous
+    for (std::size_t idx = 0; idx < CAPACITY - 1; idx++) { m_slots[idx].next = &m_slots[idx + 1]; }
+    m_slots[CAPACITY - 1].next = nullptr;
+    m_free = &m_slots[0];
+}
+
+template <typename T, std::size_t CAPACITY>
+void *StaticPool<T, CAPACITY>::allocate()
+{
+    if (m_free == nullptr)
+    {
+        m_failed++;
+        return nullptr;
+    }
+
+    Slot *slot = m_free;
+    m_free = slot->next;
+    m_in_use++;
+    m_high_watermark = std::max(m_high_watermark, m_in_use);
+    return slot->object;
+}
+
+template <typename T, std::size_t CAPACITY>
+void StaticPool<T, CAPACITY>::deallocate(void *ptr)
+{
+    if (!owns(ptr)) { return; }
+
+    Slot *slot = reinterpret_cast<Slot *>(ptr);
+    slot->next = m_free;
+    m_free = slot;
+    m_in_use--;
+}
+
+template <typename T, std::size_t CAPACITY>
+template <typename... ARGS>
+T *StaticPool<T, CAPACITY>::create(ARGS &&...args)
+{
+    void *storage = allocate();
+    if (storage == nullptr) { return nullptr; }
+    return ::new (storage) T(std::forward<ARGS>(args)...);
+}
+
+template <typename T, std::size_t CAPACITY>
+void StaticPool<T, CAPACITY>::destroy(T *object)
+{
+    if (!owns(object)) { return; }
+
+    std::destroy_at(object);
+    deallocate(object);
+}
+
+template <typename T, std::size_t CAPACITY>
+bool StaticPool<T, CAPACITY>::owns(const void *ptr) const
+{
+    const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(ptr);
+    const std::uintptr_t first = reinterpret_cast<std::uintptr_t>(m_slots.data());
+    if ((address < first) || (address >= first + sizeof(m_slots))) { return false; }
+    return ((address - first) % sizeof(Slot)) == 0;
+}
+
+} // namespace noarch::memory
+
+#endif // __STATIC_POOL_HPP__
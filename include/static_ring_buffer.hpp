@@ -0,0 +1,202 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __STATIC_RING_BUFFER_HPP__
+#define __STATIC_RING_BUFFER_HPP__
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <span>
+
+namespace noarch::containers
+{
+
+/// @brief Statically allocated, lock-free single-producer/single-consumer ring buffer.
+/// Safe between one interrupt and the main loop (or two threads): the producer only writes the head index,
+/// the consumer only writes the tail index, and each publishes its side with release ordering.
+/// The indices are free-running and masked on access, so all CAPACITY slots are usable.
+///
+/// Besides copying push()/pop(), the write_region()/commit_write() and read_region()/commit_read() pairs
+/// hand out the contiguous free/used space in place, e.g. as a DMA source or destination.
+/// @tparam T The element type. Copied by assignment.
+/// @tparam CAPACITY The number of elements. Must be a power of two.
+template <typename T, std::size_t CAPACITY>
+class StaticRingBuffer
+{
+    static_assert((CAPACITY != 0) && ((CAPACITY & (CAPACITY - 1)) == 0), "CAPACITY must be a power of two");
+
+public:
+    /// @brief Get the number of elements the buffer can hold
+    static constexpr std::size_t capacity() { return CAPACITY; }
+
+    /// @brief Get the number of elements waiting to be popped. Exact from either side, a lower bound for an observer.
+    std::size_t size() const { return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire); }
+
+    bool empty() const { return size() == 0; }
+
+    bool full() const { return size() == CAPACITY; }
+
+    /// @brief Producer: add one element
+    /// @return false if the buffer is full
+    bool push(const T &item);
+
+    /// @brief Producer: add as many elements as fit, in order
+    /// @return The number of elements added
+    std::size_t push(std::span<const T> items);
+
+    /// @brief Consumer: remove the oldest element
+    /// @return false if the buffer is empty
+    bool pop(T &item);
+
+    /// @brief Consumer: remove up to items.size() of the oldest elements, in order
+    /// @return The number of elements removed
+    std::size_t pop(std::span<T> items);
+
+    /// @brief Producer: get the free space that is contiguous in memory, up to the end of the storage.
+    /// Fill it in place and then publish it with commit_write(). If the free space wraps, a second call
+    /// after commit_write() returns the rest.
+    std::span<T> write_region();
+
+    /// @brief Producer: publish elements written into write_region()
+    /// @param count The number of elements written, no more than write_region().size()
+    void commit_write(std::size_t count);
+
+    /// @brief Consumer: get the oldest elements that are contiguous in memory, up to the end of the storage.
+    /// Use them in place and then free them with commit_read(). If the used space wraps, a second call
+    /// after commit_read() returns the rest.
+    std::span<const T> read_region() const;
+
+    /// @brief Consumer: free elements taken from read_region()
+    /// @param count The number of elements used, no more than read_region().size()
+    void commit_read(std::size_t count);
+
+    /// @brief Discard everything. Not safe while the other side is running.
+    void reset()
+    {
+        m_tail.store(0, std::memory_order_relaxed);
+        m_head.store(0, std::memory_order_release);
+    }
+
+private:
+    /// @brief Statically allocated element storage
+    std::array<T, CAPACITY> m_buffer{};
+
+    /// @brief Free-running indices. Head is written only by the producer, tail only by the consumer.
+    std::atomic<std::size_t> m_head{0};
+    std::atomic<std::size_t> m_tail{0};
+
+    static constexpr std::size_t m_mask{CAPACITY - 1};
+};
+
+template <typename T, std::size_t CAPACITY>
+bool StaticRingBuffer<T, CAPACITY>::push(const T &item)
+{
+    const std::size_t head = m_head.load(std::memory_order_relaxed);
+    if (head - m_tail.load(std::memory_order_acquire) == CAPACITY) { return false; }
+
+    m_buffer[head & m_mask] = item;
+    // publish the element last, the consumer may take it from here on
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T, std::size_t CAPACITY>
+std::size_t StaticRingBuffer<T, CAPACITY>::push(std::span<const T> items)
+{
+    std::size_t pushed{0};
+    while (pushed < items.size())
+    {
+        std::span<T> region = write_region();
+        if (region.empty()) { break; }
+
+        const std::size_t count = std::min(region.size(), items.size() - pushed);
+        std::copy_n(items.begin() + pushed, count, region.begin());
+        commit_write(count);
+        pushed += count;
+    }
+    return pushed;
+}
+
+template <typename T, std::size_t CAPACITY>
+bool StaticRingBuffer<T, CAPACITY>::pop(T &item)
+{
+    const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail == m_head.load(std::memory_order_acquire)) { return false; }
+
+    item = m_buffer[tail & m_mask];
+    // free the slot last, the producer may overwrite it from here on
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T, std::size_t CAPACITY>
+std::size_t StaticRingBuffer<T, CAPACITY>::pop(std::span<T> items)
+{
+    std::size_t popped{0};
+    while (popped < items.size())
+    {
+        std::span<const T> region = read_region();
+        if (region.empty()) { break; }
+
+        const std::size_t count = std::min(region.size(), items.size() - popped);
+        std::copy_n(region.begin(), count, items.begin() + popped);
+        commit_read(count);
+        popped += count;
+    }
+    return popped;
+}
+
+template <typename T, std::size_t CAPACITY>
+std::span<T> StaticRingBuffer<T, CAPACITY>::write_region()
+{
+    const std::size_t head = m_head.load(std::memory_order_relaxed);
+    const std::size_t space = CAPACITY - (head - m_tail.load(std::memory_order_acquire));
+    const std::size_t offset = head & m_mask;
+    return std::span<T>(m_buffer.data() + offset, std::min(space, CAPACITY - offset));
+}
+
+template <typename T, std::size_t CAPACITY>
+void StaticRingBuffer<T, CAPACITY>::commit_write(std::size_t count)
+{
+    m_head.store(m_head.load(std::memory_order_relaxed) + count, std::memory_order_release);
+}
+
+template <typename T, std::size_t CAPACITY>
+std::span<const T> StaticRingBuffer<T, CAPACITY>::read_region() const
+{
+    const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+    const std::size_t used = m_head.load(std::memory_order_acquire) - tail;
+    const std::size_t offset = tail & m_mask;
+    return std::span<const T>(m_buffer.data() + offset, std::min(used, CAPACITY - offset));
+}
+
+template <typename T, std::size_t CAPACITY>
+void StaticRingBuffer<T, CAPACITY>::commit_read(std::size_t count)
+{
+    m_tail.store(m_tail.load(std::memory_order_relaxed) + count, std::memory_order_release);
+}
+
+} // namespace noarch::containers
+
+#endif // __STATIC_RING_BUFFER_HPP__
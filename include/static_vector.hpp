@@ -0,0 +1,183 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __STATIC_VECTOR_HPP__
+#define __STATIC_VECTOR_HPP__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace noarch::containers
+{
+
+/// @brief Statically allocated vector. The storage for CAPACITY elements is part of the object,
+/// but elements are only constructed when they are added, so T doesn't need a default constructor.
+/// Nothing throws: adding to a full vector fails and reports it in the return value.
+/// Copies and appends of trivially copyable element types are done with a single memcpy.
+/// @tparam T The element type
+/// @tparam CAPACITY The most elements the vector can hold
+template <typename T, std::size_t CAPACITY>
+class StaticVector
+{
+public:
+    using value_type = T;
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    StaticVector() = default;
+
+    StaticVector(const StaticVector &other) { append(other); }
+
+    StaticVector &operator=(const StaticVector &other)
+    {
+        if (this != &other)
+        {
+            clear();
+            append(other);
+        }
+        return *this;
+    }
+
+    ~StaticVector() { clear(); }
+
+    /// @brief Get the number of elements the vector can hold
+    static constexpr std::size_t capacity() { return CAPACITY; }
+
+    std::size_t size() const { return m_size; }
+
+    bool empty() const { return m_size == 0; }
+
+    bool full() const { return m_size == CAPACITY; }
+
+    /// @brief Access an element. Not bounds checked.
+    T &operator[](std::size_t idx) { return data()[idx]; }
+    const T &operator[](std::size_t idx) const { return data()[idx]; }
+
+    T *data() { return std::launder(reinterpret_cast<T *>(m_storage)); }
+    const T *data() const { return std::launder(reinterpret_cast<const T *>(m_storage)); }
+
+    iterator begin() { return data(); }
+    iterator end() { return data() + m_size; }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + m_size; }
+
+    /// @brief View the elements as a span
+    operator std::span<T>() { return std::span<T>(data(), m_size); }
+    operator std::span<const T>() const { return std::span<const T>(data(), m_size); }
+
+    /// @brief Construct a new element in place at the end
+    /// @param args The constructor arguments
+    /// @return The new element, or nullptr if the vector is full
+    template <typename... ARGS>
+    T *emplace_back(ARGS &&...args);
+
+    /// @brief Copy an element to the end
+    /// @return false if the vector is full
+    bool push_back(const T &item) { return emplace_back(item) != nullptr; }
+
+    /// @brief Copy as many elements as fit to the end, in order
+    /// @return The number of elements added
+    std::size_t append(std::span<const T> items);
+
+    /// @brief Destroy the last element. Does nothing if the vector is empty.
+    void pop_back();
+
+    /// @brief Remove an element by moving the last element into its place. O(1), but doesn't keep the order.
+    /// @param idx The position of the element to remove
+    /// @return false if idx is out of range
+    bool erase_unordered(std::size_t idx);
+
+    /// @brief Destroy all the elements
+    void clear();
+
+private:
+    /// @brief Uninitialised storage, elements are constructed in place
+    alignas(T) std::byte m_storage[sizeof(T) * CAPACITY];
+
+    std::size_t m_size{0};
+};
+
+template <typename T, std::size_t CAPACITY>
+template <typename... ARGS>
+T *StaticVector<T, CAPACITY>::emplace_back(ARGS &&...args)
+{
+    if (full()) { return nullptr; }
+
+    T *item = std::construct_at(data() + m_size, std::forward<ARGS>(args)...);
+    m_size++;
+    return item;
+}
+
+template <typename T, std::size_t CAPACITY>
+std::size_t StaticVector<T, CAPACITY>::append(std::span<const T> items)
+{
+    const std::size_t count = std::min(items.size(), CAPACITY - m_size);
+    if constexpr (std::is_trivially_copyable_v<T>)
+    {
+        if (count > 0) { std::memcpy(data() + m_size, items.data(), count * sizeof(T)); }
+        m_size += count;
+    }
+    else
+    {
+        for (std::size_t idx = 0; idx < count; idx++) { emplace_back(items[idx]); }
+    }
+    return count;
+}
+
+template <typename T, std::size_t CAPACITY>
+void StaticVector<T, CAPACITY>::pop_back()
+{
+    if (empty()) { return; }
+
+    m_size--;
+    std::destroy_at(data() + m_size);
+}
+
+template <typename T, std::size_t CAPACITY>
+bool StaticVector<T, CAPACITY>::erase_unordered(std::size_t idx)
+{
+    if (idx >= m_size) { return false; }
+
+    const std::size_t last = m_size - 1;
+    // a single element, so plain assignment: it compiles to the same copy as memcpy for trivial types
+    if (idx != last) { data()[idx] = std::move(data()[last]); }
+    pop_back();
+    return true;
+}
+
+template <typename T, std::size_t CAPACITY>
+void StaticVector<T, CAPACITY>::clear()
+{
+    if constexpr (!std::is_trivially_destructible_v<T>) { std::destroy(begin(), end()); }
+    m_size = 0;
+}
+
+} // namespace noarch::containers
+
+#endif // __STATIC_VECTOR_HPP__
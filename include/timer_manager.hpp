@@ -49,13 +49,30 @@ public:
     static bool initialise(TIM_TypeDef *timer);
 
     // @brief wait for a microsecond delay
-    // @param delay_us the delay to wait in microseconds
+    // This resets the timer count, so it must not be used while a Deadline or has_elapsed() timeout is pending:
+    // the pending deadline would see the count jump and expire at the wrong time.
+    // @param delay_us the delay to wait in microseconds, at most 0xFFFE
     static bool delay_microsecond(uint32_t delay_us);
 
     // @brief Get the current count of the timer
     // @param value_usecs The count value returned
     static uint32_t get_count();
-    
+
+    // @brief Check if a timeout has expired without resetting the timer. Use this to poll with a deadline.
+    // The count wraps after 0xFFFE, so longer timeouts are clamped to that. Use stm32::Deadline for longer timeouts.
+    // @param start_count The count returned by get_count() when the timeout started
+    // @param timeout_us The timeout in microseconds, at most 0xFFFE
+    // @return true if timeout_us has elapsed since start_count or the timer is not initialised
+    static bool has_elapsed(uint32_t start_count, uint32_t timeout_us);
+
+    // @brief Check if the timer has been set up with initialise()
+    static bool is_initialised() { return m_timer != nullptr; }
+
+    // @brief The microseconds counted from start_count to count, allowing for the count wrapping after ARR
+    // @param start_count An earlier count returned by get_count()
+    // @param count A later count returned by get_count()
+    static uint32_t elapsed_us(uint32_t start_count, uint32_t count);
+
 private:
     // @brief Reset the timer. Should only be called by stm32::TimerManager::initialise()
     static void reset();
@@ -66,6 +83,29 @@ private:
     static inline TIM_TypeDef* m_timer;
 };
 
+// @brief A timeout measured against the TimerManager count, without resetting the timer.
+// Each call to expired() adds the time since the previous call, so the timeout can be longer than the
+// range of the count as long as expired() is called at least once per wrap (65ms).
+// TimerManager::delay_microsecond() must not be used while a Deadline is pending, it resets the count.
+class Deadline
+{
+public:
+    // @brief Start the timeout now
+    // @param timeout_us The timeout in microseconds
+    explicit Deadline(uint32_t timeout_us);
+
+    // @brief Check if the timeout has expired
+    // @return true if timeout_us has elapsed since the Deadline was started or the timer is not initialised
+    bool expired();
+
+private:
+    uint32_t m_timeout_us;
+    // @brief The count when expired() was last called
+    uint32_t m_last_count;
+    // @brief The microseconds counted up to m_last_count
+    uint32_t m_elapsed_us{0};
+};
+
 } // namespace stm32
 
 #endif // __TIMER_MANAGER_HPP__
\ No newline at end of file
@@ -0,0 +1,152 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __USART_RX_REF_HPP__
+#define __USART_RX_REF_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <restricted_base.hpp>
+#include <span>
+#include <usart_utils_ref.hpp>
+
+namespace stm32::usart_ref
+{
+
+/// @brief Called from the interrupts when received data is available
+/// @param data The new bytes, pointing straight into the receive buffer. Only valid during the callback.
+/// @param end_of_frame True if the line went idle after these bytes, i.e. the sender finished a frame.
+/// A frame that wraps around the end of the buffer is delivered as two calls, only the second has end_of_frame set.
+/// data may be empty if the frame ended exactly where the previous chunk was delivered.
+/// @param context The user pointer passed to the constructor
+using ReceiveCallback = void (*)(std::span<const uint8_t> data, bool end_of_frame, void *context);
+
+/// @brief USART receiver using a circular DMA buffer and the IDLE-line interrupt.
+/// The DMA copies every byte out of RDR as soon as it arrives, so no bytes are lost to interrupt latency
+/// at high baud rates. Received data is handed to the callback in place when the line goes idle (end of frame)
+/// and when the DMA reaches the half/end of the buffer, so the buffer only needs to hold what can arrive
+/// while the callback for the other half runs.
+///
+/// The DMAMUX request line for the USART RX and the NVIC are configured by the application.
+///
+/// Usage:
+///   static std::array<uint8_t, 256> rx_buffer;
+///   static stm32::usart_ref::DmaReceiver usart5_rx(*USART5, *DMA1, *DMA1_Channel2, 2, rx_buffer, on_rx);
+///   extern "C" void DMA1_Channel2_3_IRQHandler() { usart5_rx.dma_irq_handler(); }
+///   extern "C" void USART3_4_5_6_LPUART1_IRQHandler() { usart5_rx.usart_irq_handler(); }
+class DmaReceiver : public RestrictedBase
+{
+public:
+  /// @brief Construct the receiver. The USART must already be configured with RE and UE set.
+  /// @param usart_handle The CMSIS memory-mapped USART device
+  /// @param dma_handle The CMSIS memory-mapped DMA controller, used for the interrupt flags
+  /// @param channel_handle The CMSIS memory-mapped DMA channel routed to the USART RX request
+  /// @param channel_number The number of the DMA channel (1-7), used to locate its flags in ISR/IFCR.
+  /// Out of range, the receiver is left unusable, see valid().
+  /// @param buffer The receive buffer. Must remain valid while the receiver is running. At most 65535 bytes.
+  /// @param callback Called from the interrupts with each chunk of received data
+  /// @param context Optional user pointer passed to the callback
+  DmaReceiver(USART_TypeDef &usart_handle, DMA_TypeDef &dma_handle, DMA_Channel_TypeDef &channel_handle, uint8_t channel_number,
+              std::span<uint8_t> buffer, ReceiveCallback callback, void *context = nullptr)
+      : m_usart_handle(usart_handle), m_dma_handle(dma_handle), m_channel_handle(channel_handle),
+        m_valid((channel_number >= 1U) && (channel_number <= m_max_channels)),
+        m_flag_shift(m_valid ? static_cast<uint8_t>(4U * (channel_number - 1U)) : 0U), m_buffer(buffer), m_callback(callback),
+        m_callback_context(context)
+  {
+  }
+
+  /// @brief Check the channel number given to the constructor was in range
+  /// @return false if it wasn't, in which case nothing is received and the DMA flags are never touched
+  bool valid() const { return m_valid; }
+
+  /// @brief Start receiving into the buffer from the beginning and clear the error counters
+  /// @return false if the buffer is empty or larger than 65535 bytes, or !valid()
+  bool start();
+
+  /// @brief Stop the DMA channel and the USART RX interrupts. Undelivered data is discarded.
+  void stop();
+
+  /// @brief Handle the half/complete/error interrupts. Must be called from the DMAx_Channelx_IRQHandler.
+  void dma_irq_handler();
+
+  /// @brief Handle the IDLE and error interrupts. Must be called from the USARTx_IRQHandler.
+  void usart_irq_handler();
+
+  /// @brief The number of overrun errors (ORE) since start(). Non-zero means the DMA couldn't keep up.
+  uint32_t overrun_errors() const { return m_overrun_errors; }
+
+  /// @brief The number of framing errors (FE) since start(), e.g. a baud rate mismatch or line break
+  uint32_t framing_errors() const { return m_framing_errors; }
+
+  /// @brief The number of noise errors (NE) since start()
+  uint32_t noise_errors() const { return m_noise_errors; }
+
+  /// @brief The number of DMA transfer errors since start(). The receiver is restarted after each one.
+  uint32_t dma_errors() const { return m_dma_errors; }
+
+private:
+  /// @brief Program the DMA channel and enable the USART DMA request and interrupts
+  void arm();
+
+  /// @brief Hand everything between the last delivered position and the DMA write position to the callback
+  void deliver(bool end_of_frame);
+
+  /// @brief The CMSIS memory-mapped USART device
+  USART_TypeDef &m_usart_handle;
+
+  /// @brief The CMSIS memory-mapped DMA controller and channel
+  DMA_TypeDef &m_dma_handle;
+  DMA_Channel_TypeDef &m_channel_handle;
+
+  /// @brief The channels with flags in DMA_ISR/DMA_IFCR, four bits each
+  static constexpr uint8_t m_max_channels{7};
+
+  /// @brief False if the channel number was out of range
+  bool m_valid;
+
+  /// @brief The position of this channel's flags in DMA_ISR/DMA_IFCR
+  uint8_t m_flag_shift;
+
+  std::span<uint8_t> m_buffer;
+
+  ReceiveCallback m_callback;
+  void *m_callback_context;
+
+  /// @brief The buffer position up to which data has been delivered
+  std::size_t m_read_pos{0};
+
+  /// @brief True if data has been delivered since the last end of frame
+  bool m_frame_open{false};
+
+  volatile uint32_t m_overrun_errors{0};
+  volatile uint32_t m_framing_errors{0};
+  volatile uint32_t m_noise_errors{0};
+  volatile uint32_t m_dma_errors{0};
+
+  /// @brief The maximum value of DMA_CNDTR
+  static constexpr std::size_t m_max_size{0xFFFF};
+};
+
+} // namespace stm32::usart_ref
+
+#endif // __USART_RX_REF_HPP__
@@ -0,0 +1,199 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __USART_TX_REF_HPP__
+#define __USART_TX_REF_HPP__
+
+#include <cstdint>
+#include <restricted_base.hpp>
+#include <span>
+#include <static_ring_buffer.hpp>
+#include <usart_utils_ref.hpp>
+
+namespace stm32::usart_ref
+{
+
+/// @brief What TransmitBuffer::write() does when the buffer is full
+enum class OverflowPolicy
+{
+  /// @brief Discard the new bytes that don't fit
+  DROP,
+  /// @brief Wait for the interrupt to make room. Don't use this from an interrupt.
+  BLOCK,
+  /// @brief Discard the oldest unsent bytes to make room for the new ones
+  OVERWRITE,
+};
+
+/// @brief Interrupt-driven USART transmitter with a lock-free single-producer/single-consumer ring buffer
+/// (noarch::containers::StaticRingBuffer).
+/// write() copies into the ring and returns straight away, the TXE interrupt drains it into TDR.
+/// The main loop is the only producer and irq_handler() the only consumer: each side owns one index,
+/// so neither needs a lock. OVERWRITE is the exception, it moves the consumer index and masks the
+/// TXE interrupt while doing so.
+///
+/// Usage:
+///   static stm32::usart_ref::TransmitBuffer<256> usart5_tx(*USART5);
+///   extern "C" void USART3_4_5_6_LPUART1_IRQHandler() { usart5_tx.irq_handler(); }
+/// @tparam CAPACITY The size of the ring buffer in bytes. Must be a power of two.
+template <std::size_t CAPACITY>
+class TransmitBuffer : public RestrictedBase
+{
+  static_assert((CAPACITY != 0) && ((CAPACITY & (CAPACITY - 1)) == 0), "CAPACITY must be a power of two");
+
+public:
+  /// @brief Construct the transmitter. The USART must already be configured with TE and UE set.
+  /// @param usart_handle The CMSIS memory-mapped USART device
+  /// @param policy What write() does when the buffer is full
+  explicit TransmitBuffer(USART_TypeDef &usart_handle, OverflowPolicy policy = OverflowPolicy::DROP)
+      : m_usart_handle(usart_handle), m_policy(policy)
+  {
+  }
+
+  /// @brief Queue data for transmission and start the TXE interrupt
+  /// @param data The bytes to send. They are copied, so the caller's buffer can be reused immediately.
+  /// @return The number of bytes queued. Less than data.size() only with DROP, or BLOCK if the USART is disabled.
+  std::size_t write(std::span<const uint8_t> data);
+
+  /// @brief Move queued bytes into TDR. Must be called from the USARTx_IRQHandler.
+  /// One byte is sent per TXE event, or as many as fit when the TX FIFO is enabled (FIFOEN).
+  void irq_handler();
+
+  /// @brief Get the size of the ring buffer in bytes
+  static constexpr std::size_t capacity() { return CAPACITY; }
+
+  /// @brief Get the number of bytes waiting to be sent
+  std::size_t size() const { return m_ring.size(); }
+
+  /// @brief Check if everything has been handed to the USART
+  bool empty() const { return size() == 0; }
+
+  /// @brief The most bytes that have been waiting at once since construction or reset_statistics()
+  std::size_t high_watermark() const { return m_high_watermark; }
+
+  /// @brief The number of bytes discarded by DROP or OVERWRITE since construction or reset_statistics()
+  std::size_t dropped() const { return m_dropped; }
+
+  /// @brief Clear the high watermark and dropped counters
+  void reset_statistics()
+  {
+    m_high_watermark = size();
+    m_dropped        = 0;
+  }
+
+private:
+  /// @brief Make room for one byte according to the overflow policy
+  /// @return false if the byte can't be queued
+  bool make_room();
+
+  void enable_interrupt() { m_usart_handle.CR1 = m_usart_handle.CR1 | USART_CR1_TXEIE_TXFNFIE; }
+
+  /// @brief The CMSIS memory-mapped USART device
+  USART_TypeDef &m_usart_handle;
+
+  OverflowPolicy m_policy;
+
+  /// @brief The queued bytes. write() is the producer, irq_handler() the consumer.
+  noarch::containers::StaticRingBuffer<uint8_t, CAPACITY> m_ring;
+
+  std::size_t m_high_watermark{0};
+  std::size_t m_dropped{0};
+};
+
+template <std::size_t CAPACITY>
+std::size_t TransmitBuffer<CAPACITY>::write(std::span<const uint8_t> data)
+{
+  std::size_t written{0};
+  while (written < data.size())
+  {
+    if (m_ring.full() && !make_room())
+    {
+      if (m_policy == OverflowPolicy::DROP) { m_dropped += data.size() - written; }
+      break;
+    }
+
+    // the interrupt may send the bytes as soon as they are pushed
+    written += m_ring.push(data.subspan(written));
+    m_high_watermark = std::max(m_high_watermark, size());
+  }
+
+  if (written > 0) { enable_interrupt(); }
+  return written;
+}
+
+template <std::size_t CAPACITY>
+bool TransmitBuffer<CAPACITY>::make_room()
+{
+  switch (m_policy)
+  {
+    case OverflowPolicy::BLOCK:
+      // the interrupt must be running to drain the buffer
+      enable_interrupt();
+      while (m_ring.full())
+      {
+        if (detail::disabled(m_usart_handle)) { return false; }
+      }
+      return true;
+
+    case OverflowPolicy::OVERWRITE:
+      // the tail belongs to the interrupt, keep it out while the oldest byte is discarded
+      m_usart_handle.CR1 = m_usart_handle.CR1 & ~USART_CR1_TXEIE_TXFNFIE;
+      if (m_ring.full())
+      {
+        m_ring.commit_read(1);
+        m_dropped++;
+      }
+      enable_interrupt();
+      return true;
+
+    case OverflowPolicy::DROP:
+    default:
+      return false;
+  }
+}
+
+template <std::size_t CAPACITY>
+void TransmitBuffer<CAPACITY>::irq_handler()
+{
+  if ((m_usart_handle.CR1 & USART_CR1_TXEIE_TXFNFIE) != USART_CR1_TXEIE_TXFNFIE) { return; }
+
+  const bool fifo_enabled = (m_usart_handle.CR1 & USART_CR1_FIFOEN) == USART_CR1_FIFOEN;
+  uint8_t byte{0};
+  while (((m_usart_handle.ISR & USART_ISR_TXE_TXFNF) == USART_ISR_TXE_TXFNF) && m_ring.pop(byte))
+  {
+    m_usart_handle.TDR = byte;
+    // without the FIFO, TXE is only set again once TDR has moved to the shift register
+    if (!fifo_enabled) { break; }
+  }
+
+  // stop the interrupt when there is nothing left, write() restarts it
+  if (m_ring.empty())
+  {
+    m_usart_handle.CR1 = m_usart_handle.CR1 & ~USART_CR1_TXEIE_TXFNFIE;
+    // don't strand a byte queued between the check and the clear
+    if (!m_ring.empty()) { enable_interrupt(); }
+  }
+}
+
+} // namespace stm32::usart_ref
+
+#endif // __USART_TX_REF_HPP__
@@ -23,32 +23,65 @@
 #ifndef __USART_UTILS_HPP__
 #define __USART_UTILS_HPP__
 
-// add groups for device family
-#if defined (STM32G071xx) || defined (STM32G081xx) || defined (STM32G070xx) \
-|| defined (STM32G030xx) || defined (STM32G031xx) || defined (STM32G041xx) \
-|| defined (STM32G0B0xx) || defined (STM32G0B1xx) || defined (STM32G0C1xx) \
-|| defined (STM32G050xx) || defined (STM32G051xx) || defined (STM32G061xx)		
-	#include <stm32g0xx.h>	
-#endif
+#include <usart_utils_ref.hpp>
+
+// Null-checking wrappers for callers that hold the handle as a pointer. See stm32::usart_ref for the implementation.
 
 namespace stm32::usart
 {
 
-bool enable_usart(USART_TypeDef *usart_handle);
+inline bool enable_usart(USART_TypeDef *usart_handle)
+{
+  if (usart_handle == nullptr) { return false; }
+  return stm32::usart_ref::enable_usart(*usart_handle);
+}
+
+inline bool transmit_byte(USART_TypeDef *usart_handle, uint8_t byte, uint32_t timeout_us = stm32::usart_ref::BAUD_RATE_TIMEOUT)
+{
+  if (usart_handle == nullptr) { return false; }
+  return stm32::usart_ref::transmit_byte(*usart_handle, byte, timeout_us);
+}
 
-bool transmit_byte(USART_TypeDef *usart_handle, uint8_t byte);
+/// @brief See stm32::usart_ref::enable_fifo()
+/// @return false if usart_handle is null
+inline bool enable_fifo(USART_TypeDef *usart_handle, bool enable = true)
+{
+  if (usart_handle == nullptr) { return false; }
+  return stm32::usart_ref::enable_fifo(*usart_handle, enable);
+}
 
-// @brief Check and retry (with timeout) the SPIx_SR TXE register.
-// @param spi_handle Pointer to the CMSIS mem-mapped SPI device
-// @param delay_us The timeout
-// @return true if TX FIFO is empty, false if TX FIFO is full
-bool wait_for_tc_flag(USART_TypeDef *usart_handle, uint32_t delay_us = 100);
+/// @brief See stm32::usart_ref::transmit()
+/// @return false if usart_handle is null
+inline bool transmit(USART_TypeDef *usart_handle, std::span<const uint8_t> data, bool wait_for_completion = false,
+                     uint32_t timeout_us = stm32::usart_ref::BAUD_RATE_TIMEOUT)
+{
+  if (usart_handle == nullptr) { return false; }
+  return stm32::usart_ref::transmit(*usart_handle, data, wait_for_completion, timeout_us);
+}
 
-// @brief Check and retry (with timeout) the SPIx_SR BSY register.
-// @param spi_handle Pointer to the CMSIS mem-mapped SPI device
-// @param delay_us The timeout
-// @return true if SPI bus is busy, false if SPI bus is not busy.
-bool wait_for_bsy_flag(USART_TypeDef *usart_handle, uint32_t delay_us = 100);
+/// @brief See stm32::usart_ref::wait_for_txfnf_flag()
+/// @return ERROR if usart_handle is null
+inline WaitStatus wait_for_txfnf_flag(USART_TypeDef *usart_handle, uint32_t timeout_us = stm32::usart_ref::BAUD_RATE_TIMEOUT)
+{
+  if (usart_handle == nullptr) { return WaitStatus::ERROR; }
+  return stm32::usart_ref::wait_for_txfnf_flag(*usart_handle, timeout_us);
+}
+
+/// @brief See stm32::usart_ref::wait_for_tc_flag()
+/// @return ERROR if usart_handle is null
+inline WaitStatus wait_for_tc_flag(USART_TypeDef *usart_handle, uint32_t timeout_us = stm32::usart_ref::BAUD_RATE_TIMEOUT)
+{
+  if (usart_handle == nullptr) { return WaitStatus::ERROR; }
+  return stm32::usart_ref::wait_for_tc_flag(*usart_handle, timeout_us);
+}
+
+/// @brief See stm32::usart_ref::wait_for_bsy_flag()
+/// @return ERROR if usart_handle is null
+inline WaitStatus wait_for_bsy_flag(USART_TypeDef *usart_handle, uint32_t timeout_us = stm32::usart_ref::BAUD_RATE_TIMEOUT)
+{
+  if (usart_handle == nullptr) { return WaitStatus::ERROR; }
+  return stm32::usart_ref::wait_for_bsy_flag(*usart_handle, timeout_us);
+}
 
 } // namespace stm32::usart
 
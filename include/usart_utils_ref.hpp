@@ -0,0 +1,201 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __USART_UTILS_REF_HPP__
+#define __USART_UTILS_REF_HPP__
+
+// add groups for device family
+#if defined(STM32G071xx) || defined(STM32G081xx) || defined(STM32G070xx) || defined(STM32G030xx) || defined(STM32G031xx) || defined(STM32G041xx) ||  \
+    defined(STM32G0B0xx) || defined(STM32G0B1xx) || defined(STM32G0C1xx) || defined(STM32G050xx) || defined(STM32G051xx) || defined(STM32G061xx)
+  #include <stm32g0xx.h>
+#endif
+
+#include <algorithm>
+#include <mmio_peripheral.hpp>
+#include <span>
+#include <wait_utils.hpp>
+
+// The functions below are the only implementation of the USART driver. They are defined inline so that the
+// compile-time bound device template and the pointer wrappers collapse into the same code at the call site.
+
+namespace stm32::usart_ref
+{
+
+inline bool enable_usart(USART_TypeDef &usart_handle)
+{
+  usart_handle.CR1 = usart_handle.CR1 | USART_CR1_UE;
+  return true;
+}
+
+/// @brief Pass as timeout_us to wait for TIMEOUT_CHARACTERS at the configured baud rate
+inline constexpr uint32_t BAUD_RATE_TIMEOUT{0};
+
+/// @brief The number of character times a BAUD_RATE_TIMEOUT deadline allows: a full 8-byte TX FIFO and the
+/// shift register draining before TC, with some to spare
+inline constexpr uint32_t TIMEOUT_CHARACTERS{12};
+
+namespace detail
+{
+
+// ISR flags will not change while the USART is disabled
+inline bool disabled(USART_TypeDef &usart_handle) { return (usart_handle.CR1 & USART_CR1_UE) != USART_CR1_UE; }
+
+// TIMEOUT_CHARACTERS of the longest frame (start, 9 data and 2 stop bits) at the baud rate set by BRR, PRESC and
+// OVER8, assuming the USART is clocked at SystemCoreClock. Never less than 100us.
+inline uint32_t character_timeout_us(USART_TypeDef &usart_handle)
+{
+  constexpr uint64_t FRAME_BITS{12};
+  constexpr uint64_t PRESCALER[] = {1, 2, 4, 6, 8, 10, 12, 16, 32, 64, 128, 256};
+  const uint64_t presc = PRESCALER[std::min<uint32_t>(usart_handle.PRESC & USART_PRESC_PRESCALER, 11)];
+
+  // with OVER8 BRR[2:0] holds USARTDIV[3:1] and baud = 2 * f_CK / USARTDIV, otherwise baud = f_CK / USARTDIV
+  const uint64_t brr = usart_handle.BRR & 0xFFFF;
+  uint64_t half_clocks_per_bit = 2 * brr;
+  if ((usart_handle.CR1 & USART_CR1_OVER8) == USART_CR1_OVER8) { half_clocks_per_bit = (brr & 0xFFF0) | ((brr & 0x7) << 1); }
+
+  const uint64_t timeout_us = (TIMEOUT_CHARACTERS * FRAME_BITS * half_clocks_per_bit * presc * 1000000ULL) / (2ULL * SystemCoreClock);
+  return static_cast<uint32_t>(std::max<uint64_t>(timeout_us + 1, 100));
+}
+
+// Resolve a BAUD_RATE_TIMEOUT argument
+inline uint32_t resolve_timeout(USART_TypeDef &usart_handle, uint32_t timeout_us)
+{
+  return (timeout_us == BAUD_RATE_TIMEOUT) ? character_timeout_us(usart_handle) : timeout_us;
+}
+
+} // namespace detail
+
+/// @brief Wait for the USARTx_ISR TC flag, i.e. the previous transmission has completed.
+/// @param usart_handle The CMSIS mem-mapped USART device
+/// @param timeout_us The overall deadline, see stm32::wait_until(). BAUD_RATE_TIMEOUT allows TIMEOUT_CHARACTERS.
+/// @return READY if TC is set, ERROR if the USART is disabled, TIMEOUT if TC was not set before the deadline
+inline WaitStatus wait_for_tc_flag(USART_TypeDef &usart_handle, uint32_t timeout_us = BAUD_RATE_TIMEOUT)
+{
+  return stm32::wait_until([&usart_handle] { return (usart_handle.ISR & USART_ISR_TC) == USART_ISR_TC; },
+                           [&usart_handle] { return detail::disabled(usart_handle); },
+                           detail::resolve_timeout(usart_handle, timeout_us));
+}
+
+/// @brief Wait for the USARTx_ISR BUSY flag to clear, i.e. no character is being received.
+/// BUSY only reflects the receiver, so the transmit functions don't check it.
+/// @param usart_handle The CMSIS mem-mapped USART device
+/// @param timeout_us The overall deadline, see stm32::wait_until(). BAUD_RATE_TIMEOUT allows TIMEOUT_CHARACTERS.
+/// @return READY if BUSY is clear, ERROR if the USART is disabled, TIMEOUT if BUSY was still set at the deadline
+inline WaitStatus wait_for_bsy_flag(USART_TypeDef &usart_handle, uint32_t timeout_us = BAUD_RATE_TIMEOUT)
+{
+  return stm32::wait_until([&usart_handle] { return (usart_handle.ISR & USART_ISR_BUSY) != USART_ISR_BUSY; },
+                           [&usart_handle] { return detail::disabled(usart_handle); },
+                           detail::resolve_timeout(usart_handle, timeout_us));
+}
+
+/// @brief Wait for the previous transmission to complete, then transmit a single byte
+/// @param usart_handle The CMSIS mem-mapped USART device
+/// @param byte The byte to send
+/// @param timeout_us The deadline for the TC wait. BAUD_RATE_TIMEOUT allows TIMEOUT_CHARACTERS.
+/// @return false if the USART did not become ready before the deadline or is disabled
+inline bool transmit_byte(USART_TypeDef &usart_handle, uint8_t byte, uint32_t timeout_us = BAUD_RATE_TIMEOUT)
+{
+  if (wait_for_tc_flag(usart_handle, timeout_us) != WaitStatus::READY) { return false; }
+
+  usart_handle.TDR = byte;
+  return true;
+}
+
+/// @brief Enable or disable the TX/RX FIFOs. FIFOEN can only be changed while the USART is disabled,
+/// so UE is cleared for the change and then restored.
+/// @param usart_handle The CMSIS mem-mapped USART device
+/// @param enable true to enable the FIFOs, false to disable them
+/// @return true
+inline bool enable_fifo(USART_TypeDef &usart_handle, bool enable = true)
+{
+  const uint32_t ue = usart_handle.CR1 & USART_CR1_UE;
+  usart_handle.CR1  = usart_handle.CR1 & ~USART_CR1_UE;
+  if (enable) { usart_handle.CR1 = usart_handle.CR1 | USART_CR1_FIFOEN; }
+  else { usart_handle.CR1 = usart_handle.CR1 & ~USART_CR1_FIFOEN; }
+  usart_handle.CR1 = usart_handle.CR1 | ue;
+  return true;
+}
+
+/// @brief Wait for the USARTx_ISR TXE/TXFNF flag, i.e. TDR (or the TX FIFO when FIFOEN is set) can take another byte.
+/// @param usart_handle The CMSIS mem-mapped USART device
+/// @param timeout_us The overall deadline, see stm32::wait_until(). BAUD_RATE_TIMEOUT allows TIMEOUT_CHARACTERS.
+/// @return READY if TXE/TXFNF is set, ERROR if the USART is disabled, TIMEOUT if it was not set before the deadline
+inline WaitStatus wait_for_txfnf_flag(USART_TypeDef &usart_handle, uint32_t timeout_us = BAUD_RATE_TIMEOUT)
+{
+  return stm32::wait_until([&usart_handle] { return (usart_handle.ISR & USART_ISR_TXE_TXFNF) == USART_ISR_TXE_TXFNF; },
+                           [&usart_handle] { return detail::disabled(usart_handle); },
+                           detail::resolve_timeout(usart_handle, timeout_us));
+}
+
+/// @brief Stream a buffer back-to-back. Only TXE/TXFNF is checked between bytes, so the line doesn't go idle
+/// between characters. Enable the FIFO with enable_fifo() to queue up to 8 bytes ahead.
+/// @param usart_handle The CMSIS mem-mapped USART device
+/// @param data The bytes to send
+/// @param wait_for_completion Wait once for TC after the last byte, e.g. before switching an RS-485 driver to receive
+/// @param timeout_us The deadline for each byte, and for TC. BAUD_RATE_TIMEOUT allows TIMEOUT_CHARACTERS.
+/// @return false if the USART did not become ready before the deadline or is disabled
+inline bool transmit(USART_TypeDef &usart_handle, std::span<const uint8_t> data, bool wait_for_completion = false,
+                     uint32_t timeout_us = BAUD_RATE_TIMEOUT)
+{
+  timeout_us = detail::resolve_timeout(usart_handle, timeout_us);
+
+  for (const uint8_t byte : data)
+  {
+    if (wait_for_txfnf_flag(usart_handle, timeout_us) != WaitStatus::READY) { return false; }
+    usart_handle.TDR = byte;
+  }
+
+  if (!wait_for_completion) { return true; }
+  return wait_for_tc_flag(usart_handle, timeout_us) == WaitStatus::READY;
+}
+
+/// @brief USART driver bound to its peripheral at compile time.
+/// @tparam PERIPHERAL Accessor type with a static get() returning USART_TypeDef&. See stm32::MmioPeripheral.
+template <typename PERIPHERAL>
+struct UsartDevice
+{
+  static bool enable_usart() { return usart_ref::enable_usart(PERIPHERAL::get()); }
+
+  static bool enable_fifo(bool enable = true) { return usart_ref::enable_fifo(PERIPHERAL::get(), enable); }
+
+  static bool transmit_byte(uint8_t byte, uint32_t timeout_us = BAUD_RATE_TIMEOUT) { return usart_ref::transmit_byte(PERIPHERAL::get(), byte, timeout_us); }
+
+  static bool transmit(std::span<const uint8_t> data, bool wait_for_completion = false, uint32_t timeout_us = BAUD_RATE_TIMEOUT)
+  {
+    return usart_ref::transmit(PERIPHERAL::get(), data, wait_for_completion, timeout_us);
+  }
+
+  static WaitStatus wait_for_txfnf_flag(uint32_t timeout_us = BAUD_RATE_TIMEOUT) { return usart_ref::wait_for_txfnf_flag(PERIPHERAL::get(), timeout_us); }
+
+  static WaitStatus wait_for_tc_flag(uint32_t timeout_us = BAUD_RATE_TIMEOUT) { return usart_ref::wait_for_tc_flag(PERIPHERAL::get(), timeout_us); }
+
+  static WaitStatus wait_for_bsy_flag(uint32_t timeout_us = BAUD_RATE_TIMEOUT) { return usart_ref::wait_for_bsy_flag(PERIPHERAL::get(), timeout_us); }
+};
+
+/// @brief USART driver for the peripheral at BASE, e.g. stm32::usart_ref::Usart<USART5_BASE>::transmit_byte(0x00)
+template <std::uintptr_t BASE>
+using Usart = UsartDevice<stm32::MmioPeripheral<USART_TypeDef, BASE>>;
+
+} // namespace stm32::usart_ref
+
+#endif // __USART_UTILS_REF_HPP__
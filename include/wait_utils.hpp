@@ -0,0 +1,91 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __WAIT_UTILS_HPP__
+#define __WAIT_UTILS_HPP__
+
+#include <algorithm>
+#include <cstdint>
+#include <timer_manager.hpp>
+
+namespace stm32
+{
+
+/// @brief The result of waiting for a peripheral flag
+enum class WaitStatus
+{
+  /// @brief The flag reached the expected state
+  READY,
+  /// @brief The deadline expired first
+  TIMEOUT,
+  /// @brief The peripheral reported a condition that means the flag will never be ready
+  ERROR,
+};
+
+/// @brief Polls of the flag before backing off. Covers flags that change within a few bus clocks.
+inline constexpr uint32_t WAIT_SPIN_COUNT{64};
+
+/// @brief The longest interval between polls once backing off, in microseconds
+inline constexpr uint32_t WAIT_MAX_BACKOFF_US{64};
+
+/// @brief Wait for a peripheral condition under an overall deadline.
+/// The condition is polled in a tight loop for WAIT_SPIN_COUNT iterations, then at intervals that double
+/// from 1us up to WAIT_MAX_BACKOFF_US. The backoff watches the TimerManager count rather than calling
+/// TimerManager::delay_microsecond(), which would reset the count and lose the deadline.
+/// The deadline needs an initialised TimerManager. Without one there is no deadline: the condition is polled
+/// until it is met or fails.
+/// @param ready Returns true when the condition is met
+/// @param failed Returns true if the peripheral is in a state where the condition can't be met
+/// @param timeout_us The overall deadline in microseconds
+/// @return READY, ERROR, or TIMEOUT if neither happened before the deadline
+template <typename READY, typename FAILED> WaitStatus wait_until(READY ready, FAILED failed, uint32_t timeout_us)
+{
+  stm32::Deadline deadline(timeout_us);
+
+  for (uint32_t spin = 0; spin < WAIT_SPIN_COUNT; spin++)
+  {
+    if (failed()) { return WaitStatus::ERROR; }
+    if (ready()) { return WaitStatus::READY; }
+  }
+
+  uint32_t backoff_us{1};
+  while (true)
+  {
+    if (failed()) { return WaitStatus::ERROR; }
+    if (ready()) { return WaitStatus::READY; }
+    if (!stm32::TimerManager::is_initialised()) { continue; }
+    if (deadline.expired()) { return WaitStatus::TIMEOUT; }
+
+    // leave the peripheral alone until the next poll is due, or the deadline whichever comes first
+    stm32::Deadline next_poll(backoff_us);
+    while (!next_poll.expired() && !deadline.expired())
+    {
+      // do nothing
+    }
+    backoff_us = std::min(backoff_us * 2, WAIT_MAX_BACKOFF_US);
+  }
+}
+
+} // namespace stm32
+
+#endif // __WAIT_UTILS_HPP__
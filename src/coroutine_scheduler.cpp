@@ -0,0 +1,99 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <coroutine_scheduler.hpp>
+
+namespace stm32::coro
+{
+
+void Awaiter::await_suspend(std::coroutine_handle<> handle)
+{
+  m_handle      = handle;
+  m_deadline    = stm32::Deadline(m_timeout_us);
+  m_scheduler.m_waiting.push_back(*this);
+}
+
+bool Awaiter::poll()
+{
+  if (ready())
+  {
+    m_result = WaitStatus::READY;
+    return true;
+  }
+  if ((m_timeout_us != NO_TIMEOUT) && m_deadline.expired())
+  {
+    m_result = WaitStatus::TIMEOUT;
+    return true;
+  }
+  return false;
+}
+
+bool SchedulerBase::spawn(Task &&task)
+{
+  if (!task.valid()) { return false; }
+
+  m_active++;
+  task.m_handle.promise().spawned_by = this;
+  // the frame frees itself when the coroutine finishes, the Task no longer owns it
+  std::coroutine_handle<> handle = std::exchange(task.m_handle, nullptr);
+  handle.resume();
+  return true;
+}
+
+std::size_t SchedulerBase::run_once()
+{
+  std::size_t resumed{0};
+
+  // only poll the tasks that were waiting at the start of the pass, a resumed task may wait again
+  Awaiter *last = m_waiting.back();
+  for (auto it = m_waiting.begin(); last != nullptr && it != m_waiting.end();)
+  {
+    Awaiter &awaiter = *it++;
+    const bool final_awaiter = (&awaiter == last);
+    if (awaiter.poll())
+    {
+      awaiter.unlink();
+      awaiter.m_handle.resume();
+      resumed++;
+    }
+    if (final_awaiter) { break; }
+  }
+  return resumed;
+}
+
+void *SchedulerBase::allocate_frame(std::size_t size)
+{
+  void *block = allocate_block(sizeof(FrameHeader) + size);
+  if (block == nullptr) { return nullptr; }
+
+  FrameHeader *header = ::new (block) FrameHeader{this};
+  return header + 1;
+}
+
+void SchedulerBase::free_frame(void *frame)
+{
+  FrameHeader *header = static_cast<FrameHeader *>(frame) - 1;
+  header->scheduler->free_block(header);
+}
+
+} // namespace stm32::coro
@@ -0,0 +1,163 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <i2c_scanner_ref.hpp>
+#include <timer_manager.hpp>
+
+namespace stm32::i2c_ref
+{
+
+bool BusScanner::set_probe_timing(uint32_t timingr)
+{
+  if ((timingr != 0) && (scl_period_ns(timingr) < m_min_scl_period_ns)) { return false; }
+  m_probe_timingr = timingr;
+  return true;
+}
+
+bool BusScanner::start_scan()
+{
+  if (m_scanning || m_engine.busy()) { return false; }
+
+  // TIMINGR zero is the reset value, far faster than any device supports
+  const uint32_t probe_timingr = (m_probe_timingr != 0) ? m_probe_timingr : m_engine.timing();
+  if (scl_period_ns(probe_timingr) < m_min_scl_period_ns) { return false; }
+
+  m_bus_timingr = m_engine.timing();
+  if (!m_engine.set_timing(probe_timingr)) { return false; }
+
+  m_scanning  = true;
+  m_scan_addr = m_first_addr;
+  // address-only write: START, addr+W, STOP
+  if (!m_engine.transfer(m_scan_addr, {}, {}, on_probe_complete, this))
+  {
+    end_scan();
+    return false;
+  }
+  return true;
+}
+
+void BusScanner::cancel_scan()
+{
+  if (!m_scanning) { return; }
+
+  // the probe in progress finishes with TIMEOUT, which on_probe_complete() ignores once the scan has stopped
+  const uint32_t enables = m_engine.mask_irq();
+  m_scanning             = false;
+  m_engine.unmask_irq(enables);
+  m_engine.abort();
+  m_engine.set_timing(m_bus_timingr);
+}
+
+bool BusScanner::scan(uint32_t timeout_us)
+{
+  if (!start_scan()) { return false; }
+  if (timeout_us == TIMINGR_TIMEOUT)
+  {
+    timeout_us = (((m_last_addr - m_first_addr) / 2) + 1) * m_engine.transfer_timeout_us(0);
+  }
+
+  // no deadline without the timer, as with stm32::wait_until()
+  stm32::Deadline deadline(timeout_us);
+  while (m_scanning)
+  {
+    if (stm32::TimerManager::is_initialised() && deadline.expired())
+    {
+      cancel_scan();
+      return false;
+    }
+  }
+  return true;
+}
+
+void BusScanner::end_scan()
+{
+  m_scanning = false;
+  m_engine.set_timing(m_bus_timingr);
+}
+
+void BusScanner::on_probe_complete(Status status, void *context)
+{
+  auto *scanner = static_cast<BusScanner *>(context);
+  if (!scanner->m_scanning) { return; }
+  scanner->update(scanner->m_scan_addr, status);
+
+  // step to the next address byte, the r/w bit is always zero
+  scanner->m_scan_addr = scanner->m_scan_addr + 2;
+  if ((scanner->m_scan_addr > m_last_addr) || !scanner->m_engine.transfer(scanner->m_scan_addr, {}, {}, on_probe_complete, scanner))
+  {
+    scanner->end_scan();
+  }
+}
+
+bool BusScanner::is_present(uint8_t addr)
+{
+  if (!is_valid(addr)) { return false; }
+
+  const std::size_t idx = addr >> 1;
+  const bool recheck    = (m_policy == CachePolicy::RECHECK_ABSENT) && !m_present[idx];
+  if ((m_valid[idx] && !recheck) || m_scanning) { return m_present[idx]; }
+
+  // no valid cached result, probe the device now. BUSY and TIMEOUT leave the cache as it was.
+  update(addr, write(m_engine, addr, {}));
+  return m_present[idx];
+}
+
+void BusScanner::update(uint8_t addr, Status status)
+{
+  if (!is_valid(addr)) { return; }
+
+  // The background scan updates the bitsets from the interrupt, keep it out of the read-modify-write.
+  // Don't use std::bitset.set(), this will force exception handling to bloat the linked .elf
+  const std::size_t idx  = addr >> 1;
+  const uint32_t enables = m_engine.mask_irq();
+  if (status == Status::ACK)
+  {
+    m_present[idx] = true;
+    m_valid[idx]   = true;
+  }
+  else if (status == Status::NACK)
+  {
+    m_present[idx] = false;
+    m_valid[idx]   = true;
+  }
+  m_engine.unmask_irq(enables);
+}
+
+void BusScanner::invalidate()
+{
+  const uint32_t enables = m_engine.mask_irq();
+  m_valid.reset();
+  m_present.reset();
+  m_engine.unmask_irq(enables);
+}
+
+void BusScanner::invalidate(uint8_t addr)
+{
+  if (!is_valid(addr)) { return; }
+
+  const uint32_t enables = m_engine.mask_irq();
+  m_valid[addr >> 1]     = false;
+  m_engine.unmask_irq(enables);
+}
+
+} // namespace stm32::i2c_ref
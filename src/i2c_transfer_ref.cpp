@@ -0,0 +1,250 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <algorithm>
+#include <array>
+#include <i2c_transfer_ref.hpp>
+#include <timer_manager.hpp>
+
+namespace stm32::i2c_ref
+{
+
+namespace
+{
+
+// wait for the interrupt to complete the transfer, aborting it at the deadline
+Status wait_for_completion(TransferEngine &engine, std::size_t bytes, uint32_t timeout_us)
+{
+  if (timeout_us == TIMINGR_TIMEOUT) { timeout_us = engine.transfer_timeout_us(bytes); }
+
+  // no deadline without the timer, as with stm32::wait_until()
+  stm32::Deadline deadline(timeout_us);
+  while (engine.busy())
+  {
+    if (stm32::TimerManager::is_initialised() && deadline.expired()) { engine.abort(); }
+  }
+  return engine.status();
+}
+
+} // namespace
+
+bool TransferEngine::write(uint8_t addr, std::span<const uint8_t> tx_buffer, TransferCallback callback, void *context)
+{
+  return transfer(addr, tx_buffer, std::span<uint8_t>{}, callback, context);
+}
+
+bool TransferEngine::read(uint8_t addr, std::span<uint8_t> rx_buffer, TransferCallback callback, void *context)
+{
+  return transfer(addr, std::span<const uint8_t>{}, rx_buffer, callback, context);
+}
+
+bool TransferEngine::transfer(uint8_t addr, std::span<const uint8_t> tx_buffer, std::span<uint8_t> rx_buffer, TransferCallback callback,
+                              void *context)
+{
+  if (busy()) { return false; }
+
+  m_addr             = addr;
+  m_tx_buffer        = tx_buffer;
+  m_tx_idx           = 0;
+  m_rx_buffer        = rx_buffer;
+  m_rx_idx           = 0;
+  m_result           = Status::ACK;
+  m_callback         = callback;
+  m_callback_context = context;
+  m_status           = Status::BUSY;
+
+  // clear any stale flags from a previous transaction
+  m_i2c_handle.ICR = I2C_ICR_NACKCF | I2C_ICR_STOPCF | I2C_ICR_BERRCF | I2C_ICR_ARLOCF | I2C_ICR_OVRCF;
+
+  // the rest of the transfer is driven by irq_handler()
+  m_i2c_handle.CR1 = m_i2c_handle.CR1 | m_irq_mask;
+
+  // skip straight to the read phase if there is nothing to write
+  start_phase(m_tx_buffer.empty() && !m_rx_buffer.empty());
+  return true;
+}
+
+void TransferEngine::start_phase(bool read_phase)
+{
+  m_read_phase = read_phase;
+  m_unloaded   = read_phase ? m_rx_buffer.size() : m_tx_buffer.size();
+
+  // Send STOP automatically at the end, unless a write phase must be followed by a RESTART for the read phase.
+  // Stay in control of the bus (TC) so the direction can change without releasing it.
+  const uint32_t autoend = (read_phase || m_rx_buffer.empty()) ? 1 : 0;
+
+  // TCR will be set after the first chunk so that NBYTES can be reloaded
+  const std::size_t chunk = next_chunk();
+
+  // 7-bit addressing, address, direction, first chunk size and START in one CR2 write
+  reg::modify(m_i2c_handle.CR2, cr2::ADD10(0), cr2::SADD(m_addr), cr2::RD_WRN(read_phase ? 1 : 0), cr2::AUTOEND(autoend),
+              cr2::NBYTES(chunk), cr2::RELOAD((m_unloaded > 0) ? 1 : 0), cr2::START(1));
+}
+
+std::size_t TransferEngine::next_chunk()
+{
+  const std::size_t chunk = std::min(m_unloaded, m_max_nbytes);
+  m_unloaded -= chunk;
+  return chunk;
+}
+
+void TransferEngine::load_next_chunk()
+{
+  const std::size_t chunk = next_chunk();
+
+  // TCR will be set after this chunk so that NBYTES can be reloaded
+  reg::modify(m_i2c_handle.CR2, cr2::NBYTES(chunk), cr2::RELOAD((m_unloaded > 0) ? 1 : 0));
+}
+
+void TransferEngine::irq_handler()
+{
+  // masked by mask_irq() or finish(), the flags are serviced once unmasked
+  if ((m_i2c_handle.CR1 & m_irq_mask) == 0) { return; }
+
+  const uint32_t isr = m_i2c_handle.ISR;
+
+  // bus error, arbitration lost or overrun: abandon the transfer
+  if ((isr & (I2C_ISR_BERR | I2C_ISR_ARLO | I2C_ISR_OVR)) != 0)
+  {
+    m_i2c_handle.ICR = I2C_ICR_BERRCF | I2C_ICR_ARLOCF | I2C_ICR_OVRCF;
+    finish(Status::ERROR);
+    return;
+  }
+
+  // The slave refused the address or data. STOP is sent automatically, so wait for STOPF to finish.
+  if ((isr & I2C_ISR_NACKF) == I2C_ISR_NACKF)
+  {
+    m_i2c_handle.ICR = I2C_ICR_NACKCF;
+    m_result         = Status::NACK;
+  }
+
+  // reading RXDR clears RXNE
+  if ((isr & I2C_ISR_RXNE) == I2C_ISR_RXNE)
+  {
+    const uint8_t rx_byte = m_i2c_handle.RXDR & I2C_RXDR_RXDATA;
+    if (m_rx_idx < m_rx_buffer.size()) { m_rx_buffer[m_rx_idx++] = rx_byte; }
+  }
+
+  // writing TXDR clears TXIS
+  if ((isr & I2C_ISR_TXIS) == I2C_ISR_TXIS)
+  {
+    m_i2c_handle.TXDR = (m_tx_idx < m_tx_buffer.size()) ? m_tx_buffer[m_tx_idx++] : 0;
+  }
+
+  // NBYTES chunk finished, more to come
+  if ((isr & I2C_ISR_TCR) == I2C_ISR_TCR) { load_next_chunk(); }
+  // write phase finished without AUTOEND, change direction with a RESTART
+  else if ((isr & I2C_ISR_TC) == I2C_ISR_TC) { start_phase(true); }
+
+  if ((isr & I2C_ISR_STOPF) == I2C_ISR_STOPF)
+  {
+    m_i2c_handle.ICR = I2C_ICR_STOPCF;
+    finish(m_result);
+  }
+}
+
+bool TransferEngine::abort()
+{
+  if (!busy()) { return false; }
+
+  // with the interrupts disabled irq_handler() can't finish the transfer under us
+  m_i2c_handle.CR1 = m_i2c_handle.CR1 & ~m_irq_mask;
+  if (!busy()) { return false; }
+
+  // software reset: PE must stay low for at least 3 APB clock cycles, each read back takes at least one
+  m_i2c_handle.CR1 = m_i2c_handle.CR1 & ~I2C_CR1_PE;
+  for (uint32_t cycle = 0; cycle < 3; cycle++)
+  {
+    [[maybe_unused]] const uint32_t cr1 = m_i2c_handle.CR1;
+  }
+  m_i2c_handle.CR1 = m_i2c_handle.CR1 | I2C_CR1_PE;
+
+  finish(Status::TIMEOUT);
+  return true;
+}
+
+uint32_t TransferEngine::mask_irq()
+{
+  const uint32_t enables = m_i2c_handle.CR1 & m_irq_mask;
+  if (enables != 0) { m_i2c_handle.CR1 = m_i2c_handle.CR1 & ~m_irq_mask; }
+  return enables;
+}
+
+void TransferEngine::unmask_irq(uint32_t enables)
+{
+  // nothing to restore if the transfer was aborted meanwhile
+  if ((enables != 0) && busy()) { m_i2c_handle.CR1 = m_i2c_handle.CR1 | enables; }
+}
+
+bool TransferEngine::set_timing(uint32_t timingr)
+{
+  if (busy()) { return false; }
+  if (m_i2c_handle.TIMINGR == timingr) { return true; }
+
+  const uint32_t pe    = m_i2c_handle.CR1 & I2C_CR1_PE;
+  m_i2c_handle.CR1     = m_i2c_handle.CR1 & ~I2C_CR1_PE;
+  m_i2c_handle.TIMINGR = timingr;
+  m_i2c_handle.CR1     = m_i2c_handle.CR1 | pe;
+  return true;
+}
+
+uint32_t TransferEngine::transfer_timeout_us(std::size_t bytes) const
+{
+  constexpr uint64_t SMBUS_TIMEOUT_US{25000};
+  constexpr uint64_t SCL_PERIODS_PER_BYTE{9};
+
+  // the data and up to two address bytes, each with its ACK
+  const uint64_t bus_ns = (bytes + 2) * SCL_PERIODS_PER_BYTE * scl_period_ns(m_i2c_handle.TIMINGR);
+  return static_cast<uint32_t>(std::min<uint64_t>((2 * (bus_ns / 1000)) + SMBUS_TIMEOUT_US, UINT32_MAX));
+}
+
+void TransferEngine::finish(Status result)
+{
+  m_i2c_handle.CR1 = m_i2c_handle.CR1 & ~m_irq_mask;
+  m_status         = result;
+
+  // the callback is free to start the next transfer
+  if (m_callback != nullptr) { m_callback(result, m_callback_context); }
+}
+
+Status write(TransferEngine &engine, uint8_t addr, std::span<const uint8_t> tx_buffer, uint32_t timeout_us)
+{
+  if (!engine.write(addr, tx_buffer)) { return Status::BUSY; }
+  return wait_for_completion(engine, tx_buffer.size(), timeout_us);
+}
+
+Status read(TransferEngine &engine, uint8_t addr, std::span<uint8_t> rx_buffer, uint32_t timeout_us)
+{
+  if (!engine.read(addr, rx_buffer)) { return Status::BUSY; }
+  return wait_for_completion(engine, rx_buffer.size(), timeout_us);
+}
+
+Status write_then_read(TransferEngine &engine, uint8_t addr, uint8_t reg, std::span<uint8_t> rx_buffer, uint32_t timeout_us)
+{
+  // safe on the stack, we don't return until the transfer has finished with it or been aborted
+  const std::array<uint8_t, 1> tx_buffer{reg};
+  if (!engine.transfer(addr, tx_buffer, rx_buffer)) { return Status::BUSY; }
+  return wait_for_completion(engine, tx_buffer.size() + rx_buffer.size(), timeout_us);
+}
+
+} // namespace stm32::i2c_ref
@@ -22,6 +22,17 @@
 
 #include <restricted_base.hpp>
 
+#if defined(TRACE_ALLOCATIONS)
+    #include <array>
+    #include <timer_manager.hpp>
+    #if defined(X86_UNIT_TESTING_ONLY)
+        #include <cstdlib>
+        #include <execinfo.h>
+        #include <iostream>
+        #include <unistd.h>
+    #endif
+#endif
+
 #ifndef X86_UNIT_TESTING_ONLY
 void invalid_allocation_error_handler()
 {
@@ -32,6 +43,97 @@ void invalid_allocation_error_handler()
 }
 #endif 
 
+#if defined(TRACE_ALLOCATIONS)
+namespace allocation_trace
+{
+
+// fixed storage, recording must not allocate
+static std::array<Record, DEPTH> records;
+static std::size_t total{0};
+
+void record(const void *caller, std::size_t size)
+{
+    records[total % DEPTH] = Record{caller, size, stm32::TimerManager::get_count()};
+    total++;
+}
+
+std::size_t count()
+{
+    return total;
+}
+
+bool get(std::size_t idx, Record &out)
+{
+    if ((idx >= total) || (idx >= DEPTH)) { return false; }
+    out = records[(total - 1 - idx) % DEPTH];
+    return true;
+}
+
+void reset()
+{
+    total = 0;
+}
+
+#if defined(X86_UNIT_TESTING_ONLY)
+// the innermost guard on each thread, other threads (e.g. the peripheral mocks) are not traced
+static thread_local Guard *active_guard{nullptr};
+// set while handling an allocation, in case backtrace() allocates
+static thread_local bool in_handler{false};
+
+Guard::Guard(bool print_stack_trace) : m_print_stack_trace(print_stack_trace), m_previous(active_guard)
+{
+    active_guard = this;
+}
+
+Guard::~Guard()
+{
+    active_guard = m_previous;
+}
+
+void Guard::on_allocation(const void *caller, std::size_t size)
+{
+    if ((active_guard == nullptr) || in_handler) { return; }
+    in_handler = true;
+
+    record(caller, size);
+    active_guard->m_allocations++;
+    if (active_guard->m_print_stack_trace)
+    {
+        std::array<void *, 32> frames;
+        const int depth = backtrace(frames.data(), frames.size());
+        std::cerr << "allocation_trace: operator new(" << std::dec << size << ") inside a Guard" << std::endl;
+        backtrace_symbols_fd(frames.data(), depth, STDERR_FILENO);
+    }
+
+    in_handler = false;
+}
+#endif
+
+}   // namespace allocation_trace
+
+#if defined(X86_UNIT_TESTING_ONLY)
+// Host replacement for the global operator new/delete: allocate as normal, but let a Guard see the call.
+// operator new[] and the nothrow forms call these by default.
+void *operator new(std::size_t size)
+{
+    allocation_trace::Guard::on_allocation(__builtin_return_address(0), size);
+    void *p = std::malloc((size == 0) ? 1 : size);
+    if (p == nullptr) { throw std::bad_alloc(); }
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+#endif
+#endif
+
 
 
 // void* RestrictedBase::operator new(size_t size [[maybe_unused]]) noexcept
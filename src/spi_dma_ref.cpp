@@ -0,0 +1,119 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <spi_dma_ref.hpp>
+
+namespace stm32::spi_ref
+{
+
+bool DmaTransmitter::send(std::span<const uint8_t> buffer, DmaCallback callback, void *context)
+{
+  return start(buffer.data(), buffer.size(), 0, false, callback, context);
+}
+
+bool DmaTransmitter::send(std::span<const uint16_t> buffer, DmaCallback callback, void *context)
+{
+  return start(buffer.data(), buffer.size(), DMA_CCR_PSIZE_0 | DMA_CCR_MSIZE_0, false, callback, context);
+}
+
+bool DmaTransmitter::start_circular(std::span<const uint8_t> buffer, DmaCallback callback, void *context)
+{
+  return start(buffer.data(), buffer.size(), 0, true, callback, context);
+}
+
+bool DmaTransmitter::start_circular(std::span<const uint16_t> buffer, DmaCallback callback, void *context)
+{
+  return start(buffer.data(), buffer.size(), DMA_CCR_PSIZE_0 | DMA_CCR_MSIZE_0, true, callback, context);
+}
+
+bool DmaTransmitter::start(const void *buffer, std::size_t frames, uint32_t frame_size_bits, bool circular, DmaCallback callback,
+                           void *context)
+{
+  if (!m_valid || m_busy) { return false; }
+  if ((frames == 0) || (frames > m_max_frames)) { return false; }
+
+  m_busy             = true;
+  m_circular         = circular;
+  m_callback         = callback;
+  m_callback_context = context;
+
+  // the channel must be disabled while it is reprogrammed
+  m_channel_handle.CCR = m_channel_handle.CCR & ~DMA_CCR_EN;
+  m_dma_handle.IFCR    = DMA_IFCR_CGIF1 << m_flag_shift;
+
+  // memory-to-peripheral, straight from the caller's buffer into SPI_DR
+  m_channel_handle.CPAR  = static_cast<uint32_t>(reinterpret_cast<std::uintptr_t>(&m_spi_handle.DR));
+  m_channel_handle.CMAR  = static_cast<uint32_t>(reinterpret_cast<std::uintptr_t>(buffer));
+  m_channel_handle.CNDTR = static_cast<uint32_t>(frames);
+
+  uint32_t ccr = DMA_CCR_DIR | DMA_CCR_MINC | frame_size_bits | DMA_CCR_TCIE | DMA_CCR_TEIE;
+  // half-transfer tells the application when the first half of the buffer is free again
+  if (circular) { ccr = ccr | DMA_CCR_CIRC | DMA_CCR_HTIE; }
+  m_channel_handle.CCR = ccr;
+
+  m_spi_handle.CR2     = m_spi_handle.CR2 | SPI_CR2_TXDMAEN;
+  m_channel_handle.CCR = m_channel_handle.CCR | DMA_CCR_EN;
+  return true;
+}
+
+void DmaTransmitter::stop()
+{
+  // the flags at shift zero belong to channel 1
+  if (!m_valid) { return; }
+  m_channel_handle.CCR = m_channel_handle.CCR & ~(DMA_CCR_EN | DMA_CCR_TCIE | DMA_CCR_HTIE | DMA_CCR_TEIE);
+  m_spi_handle.CR2     = m_spi_handle.CR2 & ~SPI_CR2_TXDMAEN;
+  m_dma_handle.IFCR    = DMA_IFCR_CGIF1 << m_flag_shift;
+  m_busy               = false;
+}
+
+void DmaTransmitter::irq_handler()
+{
+  if (!m_valid) { return; }
+  const uint32_t isr = m_dma_handle.ISR >> m_flag_shift;
+
+  if ((isr & DMA_ISR_TEIF1) == DMA_ISR_TEIF1)
+  {
+    stop();
+    m_last_event = DmaEvent::ERROR;
+    if (m_callback != nullptr) { m_callback(DmaEvent::ERROR, m_callback_context); }
+    return;
+  }
+
+  if ((isr & DMA_ISR_HTIF1) == DMA_ISR_HTIF1)
+  {
+    m_dma_handle.IFCR = DMA_IFCR_CHTIF1 << m_flag_shift;
+    m_last_event      = DmaEvent::HALF_COMPLETE;
+    if (m_callback != nullptr) { m_callback(DmaEvent::HALF_COMPLETE, m_callback_context); }
+  }
+
+  if ((isr & DMA_ISR_TCIF1) == DMA_ISR_TCIF1)
+  {
+    m_dma_handle.IFCR = DMA_IFCR_CTCIF1 << m_flag_shift;
+    // the last frame has been handed to the SPI, check BSY before releasing chip select
+    if (!m_circular) { stop(); }
+    m_last_event = DmaEvent::COMPLETE;
+    if (m_callback != nullptr) { m_callback(DmaEvent::COMPLETE, m_callback_context); }
+  }
+}
+
+} // namespace stm32::spi_ref
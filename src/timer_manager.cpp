@@ -36,13 +36,15 @@ void delay_millisecond(uint32_t delay_ms)
 
     while (delay_ms  != 0U)
     {
-        if ((SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk) != 0U)
+        const uint32_t ctrl = SysTick->CTRL;
+        if ((ctrl & SysTick_CTRL_COUNTFLAG_Msk) != 0U)
         {
             delay_ms --;
         }
         // simulate the "Clear on read by application or debugger."
+        // Clear from the value already read: a second read could see (and lose) the next tick
         #ifdef X86_UNIT_TESTING_ONLY
-            SysTick->CTRL = SysTick->CTRL & ~SysTick_CTRL_COUNTFLAG_Msk;
+            SysTick->CTRL = ctrl & ~SysTick_CTRL_COUNTFLAG_Msk;
         #endif
     }
 }
@@ -102,9 +104,47 @@ bool TimerManager::delay_microsecond(uint32_t delay_us)
 
 uint32_t TimerManager::get_count()
 {
+    if (m_timer == nullptr) { return 0; }
     return m_timer->CNT;
 }
 
+bool TimerManager::has_elapsed(uint32_t start_count, uint32_t timeout_us)
+{
+    // can't measure the timeout if not initialised
+    if (m_timer == nullptr) { return true; }
+
+    // a longer timeout would never be reached before the count wraps, clamp it like delay_microsecond()
+    if (timeout_us > 0xFFFE) { timeout_us = 0xFFFE; }
+
+    return elapsed_us(start_count, m_timer->CNT) >= timeout_us;
+}
+
+uint32_t TimerManager::elapsed_us(uint32_t start_count, uint32_t count)
+{
+    if (m_timer == nullptr) { return 0; }
+
+    // the counter wraps to zero after ARR
+    return (count >= start_count) ? (count - start_count) : ((m_timer->ARR + 1) - start_count + count);
+}
+
+Deadline::Deadline(uint32_t timeout_us)
+: m_timeout_us(timeout_us), m_last_count(TimerManager::get_count())
+{
+}
+
+bool Deadline::expired()
+{
+    // can't measure the timeout if not initialised
+    if (!TimerManager::is_initialised()) { return true; }
+
+    // accumulate since the last call, so the wraps of the count are counted
+    const uint32_t count = TimerManager::get_count();
+    const uint32_t step_us = TimerManager::elapsed_us(m_last_count, count);
+    m_last_count = count;
+    m_elapsed_us = (m_elapsed_us > (UINT32_MAX - step_us)) ? UINT32_MAX : (m_elapsed_us + step_us);
+    return m_elapsed_us >= m_timeout_us;
+}
+
 // bool TimerManager::error_handler()
 // {
 //     #ifdef X86_UNIT_TESTING_ONLY
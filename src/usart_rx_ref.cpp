@@ -0,0 +1,158 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <usart_rx_ref.hpp>
+
+namespace stm32::usart_ref
+{
+
+bool DmaReceiver::start()
+{
+  if (!m_valid || m_buffer.empty() || (m_buffer.size() > m_max_size)) { return false; }
+
+  m_overrun_errors = 0;
+  m_framing_errors = 0;
+  m_noise_errors   = 0;
+  m_dma_errors     = 0;
+  arm();
+  return true;
+}
+
+void DmaReceiver::arm()
+{
+  stop();
+  m_read_pos   = 0;
+  m_frame_open = false;
+
+  // peripheral-to-memory, from USART_RDR into the caller's buffer, wrapping at the end
+  m_channel_handle.CPAR  = static_cast<uint32_t>(reinterpret_cast<std::uintptr_t>(&m_usart_handle.RDR));
+  m_channel_handle.CMAR  = static_cast<uint32_t>(reinterpret_cast<std::uintptr_t>(m_buffer.data()));
+  m_channel_handle.CNDTR = static_cast<uint32_t>(m_buffer.size());
+  m_channel_handle.CCR   = DMA_CCR_MINC | DMA_CCR_CIRC | DMA_CCR_HTIE | DMA_CCR_TCIE | DMA_CCR_TEIE;
+
+  // clear anything left over from before, then let the USART raise DMA requests, IDLE and errors
+  m_usart_handle.ICR   = USART_ICR_IDLECF | USART_ICR_ORECF | USART_ICR_FECF | USART_ICR_NECF;
+  m_usart_handle.CR3   = m_usart_handle.CR3 | USART_CR3_DMAR | USART_CR3_EIE;
+  m_usart_handle.CR1   = m_usart_handle.CR1 | USART_CR1_IDLEIE;
+  m_channel_handle.CCR = m_channel_handle.CCR | DMA_CCR_EN;
+}
+
+void DmaReceiver::stop()
+{
+  // the flags at shift zero belong to channel 1
+  if (!m_valid) { return; }
+  m_usart_handle.CR1   = m_usart_handle.CR1 & ~USART_CR1_IDLEIE;
+  m_usart_handle.CR3   = m_usart_handle.CR3 & ~(USART_CR3_DMAR | USART_CR3_EIE);
+  m_channel_handle.CCR = m_channel_handle.CCR & ~(DMA_CCR_EN | DMA_CCR_HTIE | DMA_CCR_TCIE | DMA_CCR_TEIE);
+  m_dma_handle.IFCR    = DMA_IFCR_CGIF1 << m_flag_shift;
+}
+
+void DmaReceiver::dma_irq_handler()
+{
+  if (!m_valid) { return; }
+  const uint32_t isr = m_dma_handle.ISR >> m_flag_shift;
+
+  if ((isr & DMA_ISR_TEIF1) == DMA_ISR_TEIF1)
+  {
+    // the channel has been disabled by hardware, start again from the top of the buffer
+    m_dma_errors = m_dma_errors + 1;
+    arm();
+    return;
+  }
+
+  // half and full buffer: hand over what has arrived so far before the DMA wraps round onto it
+  if ((isr & DMA_ISR_HTIF1) == DMA_ISR_HTIF1)
+  {
+    m_dma_handle.IFCR = DMA_IFCR_CHTIF1 << m_flag_shift;
+    deliver(false);
+  }
+  if ((isr & DMA_ISR_TCIF1) == DMA_ISR_TCIF1)
+  {
+    m_dma_handle.IFCR = DMA_IFCR_CTCIF1 << m_flag_shift;
+    deliver(false);
+  }
+}
+
+void DmaReceiver::usart_irq_handler()
+{
+  if (!m_valid) { return; }
+  const uint32_t isr = m_usart_handle.ISR;
+
+  // the DMA has already taken the byte, just count the error and clear it
+  if ((isr & USART_ISR_ORE) == USART_ISR_ORE)
+  {
+    m_usart_handle.ICR = USART_ICR_ORECF;
+    m_overrun_errors   = m_overrun_errors + 1;
+  }
+  if ((isr & USART_ISR_FE) == USART_ISR_FE)
+  {
+    m_usart_handle.ICR = USART_ICR_FECF;
+    m_framing_errors   = m_framing_errors + 1;
+  }
+  if ((isr & USART_ISR_NE) == USART_ISR_NE)
+  {
+    m_usart_handle.ICR = USART_ICR_NECF;
+    m_noise_errors     = m_noise_errors + 1;
+  }
+
+  if (((isr & USART_ISR_IDLE) == USART_ISR_IDLE) && ((m_usart_handle.CR1 & USART_CR1_IDLEIE) == USART_CR1_IDLEIE))
+  {
+    m_usart_handle.ICR = USART_ICR_IDLECF;
+    deliver(true);
+  }
+}
+
+void DmaReceiver::deliver(bool end_of_frame)
+{
+  // CNDTR counts down the bytes left before the DMA wraps
+  std::size_t write_pos = m_buffer.size() - m_channel_handle.CNDTR;
+  if (write_pos == m_buffer.size()) { write_pos = 0; }
+
+  if (write_pos == m_read_pos)
+  {
+    // nothing new, but a frame that was delivered in chunks has now ended
+    if (end_of_frame && m_frame_open)
+    {
+      m_frame_open = false;
+      m_callback(std::span<const uint8_t>{}, true, m_callback_context);
+    }
+    return;
+  }
+
+  if (write_pos < m_read_pos)
+  {
+    // the data wraps round the end of the buffer
+    const bool ends_here = end_of_frame && (write_pos == 0);
+    m_callback(std::span<const uint8_t>(m_buffer).subspan(m_read_pos), ends_here, m_callback_context);
+    m_read_pos = 0;
+  }
+  if (write_pos > m_read_pos)
+  {
+    m_callback(std::span<const uint8_t>(m_buffer).subspan(m_read_pos, write_pos - m_read_pos), end_of_frame, m_callback_context);
+  }
+
+  m_read_pos   = write_pos;
+  m_frame_open = !end_of_frame;
+}
+
+} // namespace stm32::usart_ref
@@ -0,0 +1,79 @@
+#include <catch2/catch_all.hpp>
+#include <restricted_base.hpp>
+#include <static_ring_buffer.hpp>
+#include <static_vector.hpp>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Record and check outside the Guard: Catch itself allocates inside REQUIRE
+
+TEST_CASE("allocation_trace - hidden STL allocations are caught", "[allocation_trace]")
+{
+    std::cout << "allocation_trace - hidden STL allocations are caught" << std::endl;
+    allocation_trace::reset();
+    std::size_t allocations{0};
+    {
+        allocation_trace::Guard guard;
+        std::vector<uint32_t> values;
+        values.push_back(1);
+        allocations = guard.allocations();
+    }
+    REQUIRE(allocations == 1);
+    REQUIRE(allocation_trace::count() == 1);
+
+    allocation_trace::Record record;
+    REQUIRE(allocation_trace::get(0, record));
+    REQUIRE(record.size == sizeof(uint32_t));
+    REQUIRE(record.caller != nullptr);
+    REQUIRE_FALSE(allocation_trace::get(1, record));
+}
+
+TEST_CASE("allocation_trace - static containers don't allocate", "[allocation_trace]")
+{
+    std::cout << "allocation_trace - static containers don't allocate" << std::endl;
+    std::size_t allocations{0};
+    {
+        allocation_trace::Guard guard;
+        noarch::containers::StaticVector<uint32_t, 8> vector;
+        noarch::containers::StaticRingBuffer<uint32_t, 8> ring;
+        for (uint32_t idx = 0; idx < 8; idx++)
+        {
+            vector.push_back(idx);
+            ring.push(idx);
+        }
+        allocations = guard.allocations();
+    }
+    REQUIRE(allocations == 0);
+}
+
+TEST_CASE("allocation_trace - only the guarded thread is traced", "[allocation_trace]")
+{
+    std::cout << "allocation_trace - only the guarded thread is traced" << std::endl;
+    std::thread mock_peripheral;
+    std::size_t allocations{0};
+    {
+        allocation_trace::Guard guard(false);
+        mock_peripheral = std::thread([] { std::vector<uint8_t> scratch(64); });
+        mock_peripheral.join();
+        allocations = guard.allocations();
+    }
+    // the std::thread state is allocated by this thread, the vector by the other
+    REQUIRE(allocations == 1);
+}
+
+TEST_CASE("allocation_trace - ring keeps the most recent records", "[allocation_trace]")
+{
+    std::cout << "allocation_trace - ring keeps the most recent records" << std::endl;
+    allocation_trace::reset();
+    for (std::size_t size = 1; size <= allocation_trace::DEPTH + 4; size++) { allocation_trace::record(nullptr, size); }
+    REQUIRE(allocation_trace::count() == allocation_trace::DEPTH + 4);
+
+    allocation_trace::Record record;
+    REQUIRE(allocation_trace::get(0, record));
+    REQUIRE(record.size == allocation_trace::DEPTH + 4);
+    REQUIRE(allocation_trace::get(allocation_trace::DEPTH - 1, record));
+    REQUIRE(record.size == 5);
+    REQUIRE_FALSE(allocation_trace::get(allocation_trace::DEPTH, record));
+    allocation_trace::reset();
+}
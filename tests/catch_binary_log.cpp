@@ -0,0 +1,185 @@
+#include <catch2/catch_all.hpp>
+
+#include <binary_log.hpp>
+#include <mock.hpp>
+#include <static_ring_buffer.hpp>
+#include <usart_tx_ref.hpp>
+#include <vector>
+
+namespace
+{
+
+enum class Channel : uint8_t
+{
+  ADC_IN0 = 0,
+  ADC_IN1 = 1,
+};
+
+// mock the NVIC: service the TXE interrupt until it is disabled, collecting each byte written to TDR
+std::vector<uint8_t>
+drain (USART_TypeDef &usart, stm32::usart_ref::TransmitBuffer<32> &tx)
+{
+  std::vector<uint8_t> sent;
+  while ((usart.CR1 & USART_CR1_TXEIE_TXFNFIE) == USART_CR1_TXEIE_TXFNFIE)
+    {
+      usart.TDR = 0xFFFF;
+      tx.irq_handler ();
+      if (usart.TDR != 0xFFFF)
+        {
+          sent.push_back (static_cast<uint8_t> (usart.TDR));
+        }
+    }
+  return sent;
+}
+
+std::string
+text (std::array<char, 32> &chars)
+{
+  return std::string (chars.begin (), chars.end ());
+}
+
+} // namespace
+
+TEST_CASE ("binary_log - log site IDs", "[binary_log]")
+{
+  std::cout << "binary_log - log site IDs" << std::endl;
+
+  // published FNV-1a test vectors
+  STATIC_REQUIRE (noarch::binary_log::fnv1a_32 ("") == 0x811C9DC5);
+  STATIC_REQUIRE (noarch::binary_log::fnv1a_32 ("a") == 0xE40C292C);
+  STATIC_REQUIRE (noarch::binary_log::fnv1a_32 ("foobar") == 0xBF9CF968);
+}
+
+TEST_CASE ("binary_log - encode", "[binary_log]")
+{
+  std::cout << "binary_log - encode" << std::endl;
+  noarch::binary_log::Frame frame{};
+
+  SECTION ("no arguments")
+  {
+    REQUIRE (noarch::binary_log::encode (frame, 0x12345678) == 5);
+    REQUIRE (frame[0] == 0xA0);
+    REQUIRE (frame[1] == 0x78);
+    REQUIRE (frame[4] == 0x12);
+  }
+
+  SECTION ("arguments are promoted to 32 bits")
+  {
+    const std::size_t size = noarch::binary_log::encode (frame, 0, int8_t{ -2 }, uint16_t{ 0xBEEF }, 1.0f,
+                                                         Channel::ADC_IN1, true);
+    REQUIRE (size == 25);
+    REQUIRE (frame[0] == 0xA5);
+    const std::vector<uint8_t> args (frame.begin () + 5, frame.begin () + size);
+    REQUIRE (args
+             == std::vector<uint8_t>{ 0xFE, 0xFF, 0xFF, 0xFF, 0xEF, 0xBE, 0x00, 0x00, 0x00, 0x00,
+                                      0x80, 0x3F, 0x01, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00 });
+  }
+}
+
+TEST_CASE ("binary_log - logger", "[binary_log]")
+{
+  std::cout << "binary_log - logger" << std::endl;
+
+  USART_TypeDef usart;
+  usart.CR1 = USART_CR1_UE | USART_CR1_TE;
+  usart.ISR = USART_ISR_TXE_TXFNF;
+  stm32::usart_ref::TransmitBuffer<32> tx (usart);
+  noarch::binary_log::Logger logger (tx);
+
+  SECTION ("frames are written to the USART transmit buffer")
+  {
+    REQUIRE (BINARY_LOG (logger, "boot"));
+    REQUIRE (BINARY_LOG (logger, "adc {} read {:x}", Channel::ADC_IN0, uint16_t{ 0x0ABC }));
+
+    constexpr uint32_t boot = noarch::binary_log::fnv1a_32 ("boot");
+    constexpr uint32_t adc = noarch::binary_log::fnv1a_32 ("adc {} read {:x}");
+    const std::vector<uint8_t> expected{ 0xA0,
+                                         static_cast<uint8_t> (boot),
+                                         static_cast<uint8_t> (boot >> 8),
+                                         static_cast<uint8_t> (boot >> 16),
+                                         static_cast<uint8_t> (boot >> 24),
+                                         0xA2,
+                                         static_cast<uint8_t> (adc),
+                                         static_cast<uint8_t> (adc >> 8),
+                                         static_cast<uint8_t> (adc >> 16),
+                                         static_cast<uint8_t> (adc >> 24),
+                                         0x00,
+                                         0x00,
+                                         0x00,
+                                         0x00,
+                                         0xBC,
+                                         0x0A,
+                                         0x00,
+                                         0x00 };
+    REQUIRE (drain (usart, tx) == expected);
+  }
+
+  SECTION ("a frame that doesn't fit is dropped whole")
+  {
+    // 3 x 9 bytes fit in 32, the fourth doesn't
+    for (uint32_t count = 0; count < 3; count++)
+      {
+        REQUIRE (BINARY_LOG (logger, "count {}", count));
+      }
+    REQUIRE_FALSE (BINARY_LOG (logger, "count {}", 3));
+    REQUIRE (logger.dropped () == 1);
+    REQUIRE (tx.size () == 27);
+    REQUIRE (tx.dropped () == 0);
+
+    // room again once the interrupt has sent the queued frames
+    REQUIRE (drain (usart, tx).size () == 27);
+    REQUIRE (BINARY_LOG (logger, "count {}", 4));
+    logger.reset_statistics ();
+    REQUIRE (logger.dropped () == 0);
+  }
+}
+
+TEST_CASE ("binary_log - render", "[binary_log]")
+{
+  std::cout << "binary_log - render" << std::endl;
+  noarch::binary_log::Frame frame{};
+
+  SECTION ("render on the target")
+  {
+    noarch::containers::StaticString<32> output;
+    const std::size_t size = noarch::binary_log::encode (frame, 0x00C0FFEE, 0, 42u, -1);
+    REQUIRE (noarch::binary_log::render (std::span<const uint8_t> (frame.data (), size), output));
+    REQUIRE (text (output.array ()) == "#00c0ffee 0 42 4294967295       ");
+  }
+
+  SECTION ("fall back to the raw bytes if it doesn't fit")
+  {
+    noarch::containers::StaticString<12> output;
+    const std::size_t size = noarch::binary_log::encode (frame, 1, 12345u);
+    REQUIRE_FALSE (noarch::binary_log::render (std::span<const uint8_t> (frame.data (), size), output));
+    REQUIRE (noarch::byte_manip::print_bytes (frame));
+  }
+
+  SECTION ("invalid frames")
+  {
+    noarch::containers::StaticString<32> output;
+    const std::size_t size = noarch::binary_log::encode (frame, 1, 1);
+    REQUIRE_FALSE (noarch::binary_log::render (std::span<const uint8_t> (frame.data (), size - 1), output));
+    frame[0] = 0x01;
+    REQUIRE_FALSE (noarch::binary_log::render (std::span<const uint8_t> (frame.data (), size), output));
+  }
+}
+
+TEST_CASE ("binary_log - ring buffer sink", "[binary_log]")
+{
+  std::cout << "binary_log - ring buffer sink" << std::endl;
+
+  noarch::containers::StaticRingBuffer<uint8_t, 16> ring;
+  noarch::binary_log::Logger logger (ring);
+
+  REQUIRE (BINARY_LOG (logger, "value {}", 0x11223344u));
+  REQUIRE_FALSE (BINARY_LOG (logger, "value {}", 0x55667788u));
+  REQUIRE (logger.dropped () == 1);
+
+  // e.g. the DMA source for the next transfer
+  std::span<const uint8_t> region = ring.read_region ();
+  REQUIRE (region.size () == 9);
+  REQUIRE (region[0] == 0xA1);
+  REQUIRE (region[5] == 0x44);
+  REQUIRE (region[8] == 0x11);
+}
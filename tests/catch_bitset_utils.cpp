@@ -160,4 +160,17 @@ TEST_CASE("bitset_to_bytearray - param size mismatch: bytes > bits ZERO PADDING"
     // noarch::byte_manip::print_bytes(output_2byte);
     // noarch::byte_manip::print_bytes(expected_2byte);
     REQUIRE(output_2byte == expected_2byte);
-}
\ No newline at end of file
+}
+
+// Not run by default. Run with: ./build/test_suite "[bitset_utils_benchmark]"
+// Compared against tests/bench_baseline.json by tools/bench_compare.py, see tests/README.md
+TEST_CASE("bitset_utils - benchmark", "[.][benchmark][bitset_utils_benchmark]")
+{
+    std::bitset<256> pattern;
+    for (std::size_t idx = 0; idx < pattern.size(); idx += 3) { pattern.set(idx); }
+    std::array<uint8_t, 32> bytes;
+    const std::bitset<16> field{0xA5C3};
+
+    BENCHMARK("bitset_to_bytearray 256 bits") { return noarch::bit_manip::bitset_to_bytearray(bytes, pattern); };
+    BENCHMARK("insert_bitset_at_offset 16 into 256 bits") { return noarch::bit_manip::insert_bitset_at_offset(pattern, field, 240); };
+}
@@ -0,0 +1,309 @@
+#include <catch2/catch_all.hpp>
+
+#include <coroutine_drivers.hpp>
+#include <mock.hpp>
+#include <numeric>
+#include <vector>
+
+using stm32::WaitStatus;
+
+namespace
+{
+
+using stm32::coro::SchedulerBase;
+using stm32::coro::Task;
+
+
+Task
+wait_for_flag (SchedulerBase &scheduler, bool &flag, std::vector<int> &log, int id)
+{
+  log.push_back (id);
+  co_await scheduler.wait_until ([&flag] { return flag; });
+  log.push_back (id + 10);
+}
+
+Task
+count_steps (SchedulerBase &scheduler, int &steps, int total)
+{
+  for (int i = 0; i < total; i++)
+    {
+      steps++;
+      co_await scheduler.yield ();
+    }
+}
+
+Task
+sleep_then_set (SchedulerBase &scheduler, uint32_t delay_us, WaitStatus &result, bool &done)
+{
+  result = co_await scheduler.sleep (delay_us);
+  done = true;
+}
+
+Task
+wait_with_timeout (SchedulerBase &scheduler, bool &flag, uint32_t timeout_us, WaitStatus &result)
+{
+  result = co_await scheduler.wait_until ([&flag] { return flag; }, timeout_us);
+}
+
+template <std::size_t CAPACITY>
+Task
+send_messages (SchedulerBase &, stm32::coro::UsartTx<CAPACITY> &usart, std::span<const uint8_t> first,
+               std::span<const uint8_t> second, bool &done)
+{
+  co_await usart.write (first);
+  co_await usart.write (second);
+  co_await usart.flush ();
+  done = true;
+}
+
+// a timer that only moves when the test moves it
+TIM_TypeDef &
+frozen_timer ()
+{
+  static TIM_TypeDef timer;
+  stm32::TimerManager::initialise (&timer);
+  timer.CNT = 0;
+  return timer;
+}
+
+} // namespace
+
+TEST_CASE ("coroutine - tasks interleave on one scheduler", "[coroutine]")
+{
+  std::cout << "coroutine - tasks interleave on one scheduler" << std::endl;
+
+  stm32::coro::Scheduler<256, 4> scheduler;
+  std::vector<int> log;
+  bool flag_a = false;
+  bool flag_b = false;
+
+  SECTION ("tasks run until their first wait, then resume in any order")
+  {
+    REQUIRE (scheduler.spawn (wait_for_flag (scheduler, flag_a, log, 1)));
+    REQUIRE (scheduler.spawn (wait_for_flag (scheduler, flag_b, log, 2)));
+    REQUIRE (log == std::vector<int>{ 1, 2 });
+    REQUIRE (scheduler.active () == 2);
+    REQUIRE (scheduler.frames_in_use () == 2);
+
+    REQUIRE (scheduler.run_once () == 0);
+
+    flag_b = true;
+    REQUIRE (scheduler.run_once () == 1);
+    REQUIRE (log == std::vector<int>{ 1, 2, 12 });
+    REQUIRE (scheduler.active () == 1);
+
+    flag_a = true;
+    REQUIRE (scheduler.run_once () == 1);
+    REQUIRE (log == std::vector<int>{ 1, 2, 12, 11 });
+    REQUIRE (scheduler.active () == 0);
+    REQUIRE (scheduler.frames_in_use () == 0);
+    REQUIRE (scheduler.frames_high_watermark () == 2);
+  }
+
+  SECTION ("a ready condition doesn't suspend")
+  {
+    flag_a = true;
+    REQUIRE (scheduler.spawn (wait_for_flag (scheduler, flag_a, log, 1)));
+    REQUIRE (log == std::vector<int>{ 1, 11 });
+    REQUIRE (scheduler.active () == 0);
+  }
+
+  SECTION ("a task that waits again is resumed once per pass")
+  {
+    int steps_a = 0;
+    int steps_b = 0;
+    REQUIRE (scheduler.spawn (count_steps (scheduler, steps_a, 5)));
+    REQUIRE (scheduler.spawn (count_steps (scheduler, steps_b, 3)));
+
+    // each task yields to the other between steps
+    REQUIRE (steps_a == 1);
+    REQUIRE (steps_b == 1);
+    REQUIRE (scheduler.run_once () == 2);
+    REQUIRE (steps_a == 2);
+    REQUIRE (steps_b == 2);
+
+    scheduler.run ();
+    REQUIRE (steps_a == 5);
+    REQUIRE (steps_b == 3);
+    REQUIRE (scheduler.frames_in_use () == 0);
+  }
+}
+
+TEST_CASE ("coroutine - frames come from the fixed pool", "[coroutine]")
+{
+  std::cout << "coroutine - frames come from the fixed pool" << std::endl;
+
+  stm32::coro::Scheduler<256, 2> scheduler;
+  std::vector<int> log;
+  bool flag = false;
+
+  SECTION ("an exhausted pool gives an invalid task")
+  {
+    Task first = wait_for_flag (scheduler, flag, log, 1);
+    Task second = wait_for_flag (scheduler, flag, log, 2);
+    Task third = wait_for_flag (scheduler, flag, log, 3);
+    REQUIRE (first.valid ());
+    REQUIRE (second.valid ());
+    REQUIRE_FALSE (third.valid ());
+    REQUIRE (scheduler.frames_in_use () == 2);
+
+    REQUIRE (scheduler.spawn (std::move (first)));
+    REQUIRE (scheduler.spawn (std::move (second)));
+    REQUIRE_FALSE (scheduler.spawn (std::move (third)));
+    REQUIRE (log == std::vector<int>{ 1, 2 });
+
+    flag = true;
+    scheduler.run ();
+    REQUIRE (scheduler.frames_in_use () == 0);
+
+    // frames are reused once the tasks finish
+    REQUIRE (scheduler.spawn (wait_for_flag (scheduler, flag, log, 4)));
+    REQUIRE (log == std::vector<int>{ 1, 2, 11, 12, 4, 14 });
+  }
+
+  SECTION ("a task that is never spawned returns its frame")
+  {
+    {
+      Task unused = wait_for_flag (scheduler, flag, log, 1);
+      REQUIRE (unused.valid ());
+      REQUIRE (scheduler.frames_in_use () == 1);
+    }
+    REQUIRE (scheduler.frames_in_use () == 0);
+    REQUIRE (log.empty ());
+
+    // it was never counted as active, so run() has nothing to wait for
+    REQUIRE (scheduler.active () == 0);
+    scheduler.run ();
+  }
+
+  SECTION ("destroying unspawned and invalid tasks leaves the count alone")
+  {
+    REQUIRE (scheduler.spawn (wait_for_flag (scheduler, flag, log, 1)));
+    REQUIRE (scheduler.active () == 1);
+    {
+      Task unused = wait_for_flag (scheduler, flag, log, 2);
+      Task exhausted = wait_for_flag (scheduler, flag, log, 3);
+      REQUIRE (unused.valid ());
+      REQUIRE_FALSE (exhausted.valid ());
+    }
+    REQUIRE (scheduler.active () == 1);
+    REQUIRE (scheduler.frames_in_use () == 1);
+
+    flag = true;
+    scheduler.run ();
+    REQUIRE (scheduler.active () == 0);
+    REQUIRE (scheduler.frames_in_use () == 0);
+    REQUIRE (log == std::vector<int>{ 1, 11 });
+  }
+
+  SECTION ("a frame that is too big is refused")
+  {
+    stm32::coro::Scheduler<8, 2> tiny;
+    REQUIRE_FALSE (wait_for_flag (tiny, flag, log, 1).valid ());
+    REQUIRE (tiny.frames_in_use () == 0);
+  }
+}
+
+TEST_CASE ("coroutine - sleep and timeout", "[coroutine]")
+{
+  std::cout << "coroutine - sleep and timeout" << std::endl;
+
+  TIM_TypeDef &timer = frozen_timer ();
+  stm32::coro::Scheduler<256, 4> scheduler;
+
+  SECTION ("sleep resumes once the delay has passed")
+  {
+    WaitStatus result = WaitStatus::ERROR;
+    bool done = false;
+    REQUIRE (scheduler.spawn (sleep_then_set (scheduler, 100, result, done)));
+
+    timer.CNT = 99;
+    REQUIRE (scheduler.run_once () == 0);
+    REQUIRE_FALSE (done);
+
+    timer.CNT = 100;
+    REQUIRE (scheduler.run_once () == 1);
+    REQUIRE (done);
+    REQUIRE (result == WaitStatus::TIMEOUT);
+  }
+
+  SECTION ("sleeping tasks wake in order of their deadlines")
+  {
+    WaitStatus result_long = WaitStatus::ERROR;
+    WaitStatus result_short = WaitStatus::ERROR;
+    bool done_long = false;
+    bool done_short = false;
+    REQUIRE (scheduler.spawn (sleep_then_set (scheduler, 500, result_long, done_long)));
+    REQUIRE (scheduler.spawn (sleep_then_set (scheduler, 200, result_short, done_short)));
+
+    timer.CNT = 250;
+    scheduler.run_once ();
+    REQUIRE (done_short);
+    REQUIRE_FALSE (done_long);
+
+    timer.CNT = 500;
+    scheduler.run_once ();
+    REQUIRE (done_long);
+  }
+
+  SECTION ("wait_until reports the deadline")
+  {
+    bool flag = false;
+    WaitStatus result_timeout = WaitStatus::ERROR;
+    WaitStatus result_ready = WaitStatus::ERROR;
+    REQUIRE (scheduler.spawn (wait_with_timeout (scheduler, flag, 50, result_timeout)));
+
+    timer.CNT = 50;
+    scheduler.run_once ();
+    REQUIRE (result_timeout == WaitStatus::TIMEOUT);
+
+    REQUIRE (scheduler.spawn (wait_with_timeout (scheduler, flag, 50, result_ready)));
+    flag = true;
+    scheduler.run_once ();
+    REQUIRE (result_ready == WaitStatus::READY);
+  }
+
+  REQUIRE (scheduler.active () == 0);
+}
+
+TEST_CASE ("coroutine - usart awaitable", "[coroutine]")
+{
+  std::cout << "coroutine - usart awaitable" << std::endl;
+
+  USART_TypeDef usart;
+  usart.CR1 = USART_CR1_UE | USART_CR1_TE;
+  usart.ISR = USART_ISR_TXE_TXFNF;
+
+  stm32::coro::Scheduler<512, 2> scheduler;
+  stm32::usart_ref::TransmitBuffer<8> buffer (usart);
+  stm32::coro::UsartTx<8> usart_tx (scheduler, buffer);
+
+  std::vector<uint8_t> first (6);
+  std::iota (first.begin (), first.end (), 0x10);
+  std::vector<uint8_t> second (10);
+  std::iota (second.begin (), second.end (), 0x20);
+  bool done = false;
+
+  // more than the buffer holds, so the task waits for the interrupt instead of dropping
+  REQUIRE (scheduler.spawn (send_messages (scheduler, usart_tx, first, second, done)));
+  REQUIRE (buffer.size () == buffer.capacity ());
+  REQUIRE (buffer.dropped () == 0);
+
+  // mock the NVIC: one TXE interrupt per pass of the main loop
+  std::vector<uint8_t> sent;
+  while (!done)
+    {
+      if ((usart.CR1 & USART_CR1_TXEIE_TXFNFIE) == USART_CR1_TXEIE_TXFNFIE)
+        {
+          buffer.irq_handler ();
+          sent.push_back (static_cast<uint8_t> (usart.TDR));
+        }
+      scheduler.run_once ();
+    }
+
+  std::vector<uint8_t> expected (first);
+  expected.insert (expected.end (), second.begin (), second.end ());
+  REQUIRE (sent == expected);
+  REQUIRE (buffer.dropped () == 0);
+  REQUIRE (scheduler.frames_in_use () == 0);
+}
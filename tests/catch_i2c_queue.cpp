@@ -0,0 +1,222 @@
+#include <catch2/catch_all.hpp>
+
+#include <array>
+#include <i2c_queue_ref.hpp>
+#include <mock.hpp>
+#include <vector>
+
+namespace
+{
+
+// records the order in which transactions complete
+struct CompletionLog
+{
+  std::vector<int> order;
+  std::vector<stm32::i2c_ref::Status> results;
+  int completed{ 0 };
+};
+
+struct Tag
+{
+  CompletionLog *log;
+  int id;
+};
+
+void
+log_completion (stm32::i2c_ref::Status status, void *context)
+{
+  auto *tag = static_cast<Tag *> (context);
+  tag->log->order.push_back (tag->id);
+  tag->log->results.push_back (status);
+  tag->log->completed++;
+}
+
+} // namespace
+
+TEST_CASE ("i2c_queue - scheduling", "[i2c_queue]")
+{
+  std::cout << "i2c_queue - scheduling" << std::endl;
+
+  stm32::mock::I2C mock_i2c;
+  I2C_TypeDef &i2c = *mock_i2c.get_handle ();
+  stm32::i2c_ref::TransferEngine engine (i2c);
+  stm32::i2c_ref::TransactionQueue<4> queue (engine);
+
+  CompletionLog log;
+  std::array<Tag, 5> tags{ { { &log, 0 },
+                             { &log, 1 },
+                             { &log, 2 },
+                             { &log, 3 },
+                             { &log, 4 } } };
+
+  // zero-length transactions so a single STOPF completes each one
+  auto make = [&] (uint8_t addr, int id, uint8_t priority) {
+    return stm32::i2c_ref::Transaction{ addr,    {}, {}, log_completion,
+                                        &tags[id], priority };
+  };
+
+  // first transaction starts immediately
+  REQUIRE (queue.submit (make (0x10, 0, 0)));
+  REQUIRE (engine.busy ());
+  REQUIRE ((i2c.CR2 & I2C_CR2_SADD) == 0x10);
+
+  // the rest wait for the bus
+  REQUIRE (queue.submit (make (0x20, 1, 0)));
+  REQUIRE (queue.submit (make (0x10, 2, 0)));
+  REQUIRE (queue.submit (make (0x20, 3, 1)));
+  REQUIRE (queue.size () == 4);
+
+  // queue is full
+  REQUIRE_FALSE (queue.submit (make (0x30, 4, 0)));
+
+  // complete each transaction from the "interrupt"
+  while (!queue.empty ())
+  {
+    i2c.ISR = I2C_ISR_STOPF;
+    engine.irq_handler ();
+  }
+
+  // 0 first, then the high priority 3, then 1 is batched with 3 (same
+  // device), 2 last
+  REQUIRE (log.order == std::vector<int>{ 0, 3, 1, 2 });
+  REQUIRE (std::all_of (log.results.begin (), log.results.end (), [] (auto s) {
+    return s == stm32::i2c_ref::Status::ACK;
+  }));
+  REQUIRE_FALSE (engine.busy ());
+}
+
+TEST_CASE ("i2c_queue - batch limit", "[i2c_queue]")
+{
+  std::cout << "i2c_queue - batch limit" << std::endl;
+
+  stm32::mock::I2C mock_i2c;
+  I2C_TypeDef &i2c = *mock_i2c.get_handle ();
+  stm32::i2c_ref::TransferEngine engine (i2c);
+  stm32::i2c_ref::TransactionQueue<4, 2> queue (engine);
+
+  CompletionLog log;
+  std::array<Tag, 4> tags{
+    { { &log, 0 }, { &log, 1 }, { &log, 2 }, { &log, 3 } }
+  };
+
+  REQUIRE (queue.submit ({ 0x10, {}, {}, log_completion, &tags[0] }));
+  REQUIRE (queue.submit ({ 0x20, {}, {}, log_completion, &tags[1] }));
+  REQUIRE (queue.submit ({ 0x10, {}, {}, log_completion, &tags[2] }));
+  REQUIRE (queue.submit ({ 0x10, {}, {}, log_completion, &tags[3] }));
+
+  while (!queue.empty ())
+  {
+    i2c.ISR = I2C_ISR_STOPF;
+    engine.irq_handler ();
+  }
+
+  // two in a row to 0x10, then 0x20 gets a turn
+  REQUIRE (log.order == std::vector<int>{ 0, 2, 1, 3 });
+}
+
+TEST_CASE ("i2c_queue - shared bus", "[i2c_queue]")
+{
+  std::cout << "i2c_queue - shared bus" << std::endl;
+
+  const uint8_t EXPECTED_ADDRESS{ 0x45 };
+  std::array<uint8_t, 16> slave_memory{};
+  for (std::size_t idx = 0; idx < slave_memory.size (); idx++)
+  {
+    slave_memory[idx] = idx;
+  }
+
+  stm32::mock::Simulation sim;
+  stm32::mock::I2C mock_i2c;
+  stm32::i2c_ref::TransferEngine engine (*mock_i2c.get_handle ());
+  stm32::i2c_ref::TransactionQueue<4> queue (engine);
+  mock_i2c.init_i2c_slave_device (sim, engine, EXPECTED_ADDRESS,
+                                  slave_memory);
+
+  CompletionLog log;
+  std::array<Tag, 3> tags{ { { &log, 0 }, { &log, 1 }, { &log, 2 } } };
+
+  const std::array<uint8_t, 1> reg_a{ 0x02 };
+  const std::array<uint8_t, 1> reg_b{ 0x08 };
+  std::array<uint8_t, 2> rx_a{};
+  std::array<uint8_t, 2> rx_b{};
+  std::array<uint8_t, 1> rx_absent{};
+
+  REQUIRE (queue.submit (
+      { EXPECTED_ADDRESS, reg_a, rx_a, log_completion, &tags[0] }));
+  REQUIRE (queue.submit ({ 0x65, {}, rx_absent, log_completion, &tags[1] }));
+  REQUIRE (queue.submit (
+      { EXPECTED_ADDRESS, reg_b, rx_b, log_completion, &tags[2] }));
+
+  // the main loop is free, the mock interrupt runs the queue
+  REQUIRE (sim.run_until ([&] { return log.completed == 3; }));
+  REQUIRE (queue.empty ());
+
+  REQUIRE (log.order.size () == 3);
+  REQUIRE (rx_a == std::array<uint8_t, 2>{ 0x02, 0x03 });
+  REQUIRE (rx_b == std::array<uint8_t, 2>{ 0x08, 0x09 });
+  for (std::size_t idx = 0; idx < log.order.size (); idx++)
+  {
+    const auto expected = (log.order[idx] == 1)
+                              ? stm32::i2c_ref::Status::NACK
+                              : stm32::i2c_ref::Status::ACK;
+    REQUIRE (log.results[idx] == expected);
+  }
+}
+
+TEST_CASE ("i2c_queue - engine shared with another driver", "[i2c_queue]")
+{
+  std::cout << "i2c_queue - engine shared with another driver" << std::endl;
+
+  stm32::mock::I2C mock_i2c;
+  I2C_TypeDef &i2c = *mock_i2c.get_handle ();
+  stm32::i2c_ref::TransferEngine engine (i2c);
+  stm32::i2c_ref::TransactionQueue<4> queue (engine);
+
+  CompletionLog log;
+  std::array<Tag, 2> tags{ { { &log, 0 }, { &log, 1 } } };
+  auto complete = [&] {
+    i2c.ISR = I2C_ISR_STOPF;
+    engine.irq_handler ();
+  };
+
+  // another driver has the engine, so the transaction waits
+  REQUIRE (engine.write (0x50, {}));
+  REQUIRE (queue.submit ({ 0x10, {}, {}, log_completion, &tags[0] }));
+  REQUIRE (queue.size () == 1);
+  complete ();
+  REQUIRE (log.completed == 0);
+
+  // and starts once the engine is free
+  queue.poll ();
+  REQUIRE ((i2c.CR2 & I2C_CR2_SADD) == 0x10);
+
+  // the other driver takes the engine from a completion callback, before the
+  // queue can start its next transaction
+  REQUIRE (queue.submit ({ 0x20, {}, {}, log_completion, &tags[1] }));
+  struct Intruder
+  {
+    stm32::i2c_ref::TransferEngine *engine;
+    Tag *tag;
+  } intruder{ &engine, &tags[0] };
+  REQUIRE (queue.submit (
+      { 0x30, {}, {},
+        [] (stm32::i2c_ref::Status status, void *context) {
+          auto *self = static_cast<Intruder *> (context);
+          log_completion (status, self->tag);
+          self->engine->write (0x50, {});
+        },
+        &intruder, 1 }));
+  complete ();
+  complete ();
+  REQUIRE (log.completed == 2);
+  REQUIRE ((i2c.CR2 & I2C_CR2_SADD) == 0x50);
+
+  // the queue isn't stuck with a transaction it never started
+  REQUIRE (queue.size () == 1);
+  complete ();
+  queue.poll ();
+  REQUIRE ((i2c.CR2 & I2C_CR2_SADD) == 0x20);
+  complete ();
+  REQUIRE (queue.empty ());
+  REQUIRE (log.order == std::vector<int>{ 0, 0, 1 });
+}
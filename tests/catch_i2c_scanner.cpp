@@ -0,0 +1,186 @@
+#include <catch2/catch_all.hpp>
+
+#include <array>
+#include <i2c_scanner_ref.hpp>
+#include <mock.hpp>
+
+namespace
+{
+
+// 400kHz and 100kHz from 64MHz
+constexpr uint32_t TIMINGR_400KHZ{ (7U << I2C_TIMINGR_PRESC_Pos)
+                                   | (6U << I2C_TIMINGR_SCLH_Pos)
+                                   | (12U << I2C_TIMINGR_SCLL_Pos) };
+constexpr uint32_t TIMINGR_100KHZ{ (1U << I2C_TIMINGR_PRESC_Pos)
+                                   | (159U << I2C_TIMINGR_SCLH_Pos)
+                                   | (159U << I2C_TIMINGR_SCLL_Pos) };
+
+// mock the peripheral raising an interrupt with the given ISR flags
+void
+raise_irq (I2C_TypeDef &i2c, stm32::i2c_ref::TransferEngine &engine,
+           uint32_t isr_flags)
+{
+  i2c.ISR = isr_flags;
+  engine.irq_handler ();
+}
+
+} // namespace
+
+TEST_CASE ("i2c_scanner - scan and presence cache", "[i2c_scanner]")
+{
+  std::cout << "i2c_scanner - scan and presence cache" << std::endl;
+
+  const uint8_t EXPECTED_ADDRESS{ 0x44 };
+  std::array<uint8_t, 1> slave_memory{};
+
+  // the blocking scan and probes poll the timer, which lets the slave model
+  // run
+  stm32::mock::Simulation sim;
+  stm32::mock::Timer mt (sim);
+  TIM_TypeDef *timer = mt.init_timer ();
+
+  stm32::mock::I2C mock_i2c;
+  mock_i2c.get_handle ()->TIMINGR = TIMINGR_400KHZ;
+  stm32::i2c_ref::TransferEngine engine (*mock_i2c.get_handle ());
+  mock_i2c.init_i2c_slave_device (sim, engine, EXPECTED_ADDRESS,
+                                  slave_memory);
+
+  SECTION ("Full scan")
+  {
+    stm32::i2c_ref::BusScanner scanner (engine);
+    REQUIRE (scanner.scan ());
+    REQUIRE (scanner.scan_complete ());
+    REQUIRE (scanner.count () == 1);
+    REQUIRE (scanner.is_present (EXPECTED_ADDRESS));
+    REQUIRE_FALSE (scanner.is_present (0x46));
+
+    // reserved addresses are never present
+    REQUIRE_FALSE (scanner.is_present (0x00));
+    REQUIRE_FALSE (scanner.is_present (0xF0));
+
+    // cache is discarded
+    scanner.invalidate ();
+    REQUIRE (scanner.count () == 0);
+  }
+
+  SECTION ("Probe on demand without a scan")
+  {
+    stm32::i2c_ref::BusScanner scanner (engine);
+    REQUIRE (scanner.is_present (EXPECTED_ADDRESS));
+    REQUIRE_FALSE (scanner.is_present (0x50));
+    REQUIRE (scanner.count () == 1);
+  }
+
+  SECTION ("PERSISTENT policy keeps cached results")
+  {
+    stm32::i2c_ref::BusScanner scanner (engine);
+    // driver saw a NACK from the device
+    scanner.update (EXPECTED_ADDRESS, stm32::i2c_ref::Status::NACK);
+    REQUIRE_FALSE (scanner.is_present (EXPECTED_ADDRESS));
+
+    // until invalidated
+    scanner.invalidate (EXPECTED_ADDRESS);
+    REQUIRE (scanner.is_present (EXPECTED_ADDRESS));
+  }
+
+  SECTION ("RECHECK_ABSENT policy re-probes absent devices")
+  {
+    stm32::i2c_ref::BusScanner scanner (
+        engine, stm32::i2c_ref::BusScanner::CachePolicy::RECHECK_ABSENT);
+    scanner.update (EXPECTED_ADDRESS, stm32::i2c_ref::Status::NACK);
+    REQUIRE (scanner.is_present (EXPECTED_ADDRESS));
+  }
+
+  SECTION ("Background scan")
+  {
+    stm32::i2c_ref::BusScanner scanner (engine);
+    REQUIRE (scanner.start_scan ());
+    REQUIRE (sim.run_until ([&] { return scanner.scan_complete (); }));
+    REQUIRE_FALSE (engine.busy ());
+    REQUIRE (scanner.count () == 1);
+
+    // 112 address phases at 400kHz
+    REQUIRE (sim.now_ns () >= 112 * 10 * mock_i2c.scl_period_ns ());
+  }
+
+  SECTION ("Scan deadline")
+  {
+    stm32::i2c_ref::BusScanner scanner (engine);
+    REQUIRE_FALSE (scanner.scan (1000));
+    REQUIRE (scanner.scan_complete ());
+    REQUIRE_FALSE (engine.busy ());
+    REQUIRE (sim.now_ns () < 1100 * stm32::mock::Simulation::NS_PER_US);
+  }
+
+  timer->CR1 = 0;
+}
+
+TEST_CASE ("i2c_scanner - probe timing and cancel", "[i2c_scanner]")
+{
+  std::cout << "i2c_scanner - probe timing and cancel" << std::endl;
+
+  stm32::mock::I2C mock_i2c;
+  I2C_TypeDef &i2c = *mock_i2c.get_handle ();
+  stm32::i2c_ref::TransferEngine engine (i2c);
+  stm32::i2c_ref::BusScanner scanner (engine);
+
+  SECTION ("Unconfigured bus timing is refused")
+  {
+    REQUIRE_FALSE (scanner.start_scan ());
+    REQUIRE_FALSE (scanner.scan ());
+    REQUIRE_FALSE (engine.busy ());
+  }
+
+  SECTION ("Probe timing faster than Fast-mode Plus is refused")
+  {
+    // 16 clocks per SCL period: 4MHz
+    REQUIRE_FALSE (scanner.set_probe_timing ((9U << I2C_TIMINGR_SCLL_Pos)
+                                             | (5U << I2C_TIMINGR_SCLH_Pos)));
+    REQUIRE (scanner.set_probe_timing (TIMINGR_400KHZ));
+    REQUIRE (scanner.set_probe_timing (0));
+  }
+
+  SECTION ("Scan at the probe timing, then restore the bus timing")
+  {
+    i2c.TIMINGR = TIMINGR_100KHZ;
+    REQUIRE (scanner.set_probe_timing (TIMINGR_400KHZ));
+    REQUIRE (scanner.start_scan ());
+    REQUIRE (i2c.TIMINGR == TIMINGR_400KHZ);
+    REQUIRE ((i2c.CR1 & I2C_CR1_PE) == I2C_CR1_PE);
+
+    // every address acknowledges
+    int probes{ 0 };
+    while (!scanner.scan_complete ())
+      {
+        raise_irq (i2c, engine, I2C_ISR_STOPF);
+        probes++;
+      }
+    REQUIRE (probes == 112);
+    REQUIRE (scanner.count () == 112);
+    REQUIRE (i2c.TIMINGR == TIMINGR_100KHZ);
+  }
+
+  SECTION ("Cancel a background scan")
+  {
+    i2c.TIMINGR = TIMINGR_100KHZ;
+    REQUIRE (scanner.set_probe_timing (TIMINGR_400KHZ));
+    REQUIRE (scanner.start_scan ());
+    raise_irq (i2c, engine, I2C_ISR_STOPF);
+    raise_irq (i2c, engine, I2C_ISR_NACKF | I2C_ISR_STOPF);
+
+    scanner.cancel_scan ();
+    REQUIRE (scanner.scan_complete ());
+    REQUIRE_FALSE (engine.busy ());
+    REQUIRE (engine.status () == stm32::i2c_ref::Status::TIMEOUT);
+    REQUIRE (i2c.TIMINGR == TIMINGR_100KHZ);
+
+    // the two probes that finished are cached
+    REQUIRE (scanner.count () == 1);
+    REQUIRE (scanner.is_present (0x08 << 1));
+
+    // a late interrupt doesn't restart the scan
+    raise_irq (i2c, engine, I2C_ISR_STOPF);
+    REQUIRE (scanner.scan_complete ());
+    REQUIRE_FALSE (engine.busy ());
+  }
+}
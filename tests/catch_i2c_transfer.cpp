@@ -0,0 +1,312 @@
+#include <catch2/catch_all.hpp>
+
+#include <array>
+#include <i2c_transfer_ref.hpp>
+#include <mock.hpp>
+
+namespace
+{
+
+struct CallbackRecord
+{
+  int count{ 0 };
+  stm32::i2c_ref::Status status{ stm32::i2c_ref::Status::BUSY };
+};
+
+void
+record_callback (stm32::i2c_ref::Status status, void *context)
+{
+  auto *record = static_cast<CallbackRecord *> (context);
+  record->count++;
+  record->status = status;
+}
+
+// mock the peripheral raising an interrupt with the given ISR flags
+void
+raise_irq (I2C_TypeDef &i2c, stm32::i2c_ref::TransferEngine &engine,
+           uint32_t isr_flags)
+{
+  i2c.ISR = isr_flags;
+  engine.irq_handler ();
+}
+
+uint32_t
+get_nbytes (I2C_TypeDef &i2c)
+{
+  return (i2c.CR2 & I2C_CR2_NBYTES) >> I2C_CR2_NBYTES_Pos;
+}
+
+} // namespace
+
+TEST_CASE ("i2c_transfer - write", "[i2c_transfer]")
+{
+  std::cout << "i2c_transfer - write" << std::endl;
+
+  stm32::mock::I2C mock_i2c;
+  I2C_TypeDef &i2c = *mock_i2c.get_handle ();
+  stm32::i2c_ref::TransferEngine engine (i2c);
+  CallbackRecord record;
+
+  const std::array<uint8_t, 3> tx_data{ 0x11, 0x22, 0x33 };
+  REQUIRE (engine.status () == stm32::i2c_ref::Status::ACK);
+  REQUIRE (engine.write (0x45, tx_data, record_callback, &record));
+
+  // transfer is configured and started, interrupts are enabled
+  REQUIRE (engine.busy ());
+  REQUIRE ((i2c.CR2 & I2C_CR2_SADD) == 0x45);
+  REQUIRE (get_nbytes (i2c) == tx_data.size ());
+  REQUIRE ((i2c.CR2 & I2C_CR2_START) == I2C_CR2_START);
+  REQUIRE ((i2c.CR2 & I2C_CR2_AUTOEND) == I2C_CR2_AUTOEND);
+  REQUIRE ((i2c.CR2 & I2C_CR2_RD_WRN) == 0);
+  REQUIRE ((i2c.CR2 & I2C_CR2_RELOAD) == 0);
+  REQUIRE ((i2c.CR1 & (I2C_CR1_TXIE | I2C_CR1_STOPIE | I2C_CR1_NACKIE)));
+
+  // cannot start another transfer while busy
+  REQUIRE_FALSE (engine.write (0x45, tx_data));
+
+  SECTION ("Slave returns ACK")
+  {
+    for (const uint8_t expected : tx_data)
+    {
+      raise_irq (i2c, engine, I2C_ISR_TXIS);
+      REQUIRE (i2c.TXDR == expected);
+    }
+    REQUIRE (engine.busy ());
+    REQUIRE (record.count == 0);
+
+    raise_irq (i2c, engine, I2C_ISR_STOPF);
+    REQUIRE (engine.status () == stm32::i2c_ref::Status::ACK);
+    REQUIRE (record.count == 1);
+    REQUIRE (record.status == stm32::i2c_ref::Status::ACK);
+    REQUIRE ((i2c.CR1 & I2C_CR1_TXIE) == 0);
+  }
+
+  SECTION ("Slave returns NACK")
+  {
+    raise_irq (i2c, engine, I2C_ISR_NACKF);
+    REQUIRE (engine.busy ());
+    raise_irq (i2c, engine, I2C_ISR_STOPF);
+    REQUIRE (engine.status () == stm32::i2c_ref::Status::NACK);
+    REQUIRE (record.status == stm32::i2c_ref::Status::NACK);
+  }
+
+  SECTION ("Bus error")
+  {
+    raise_irq (i2c, engine, I2C_ISR_BERR);
+    REQUIRE (engine.status () == stm32::i2c_ref::Status::ERROR);
+    REQUIRE (record.status == stm32::i2c_ref::Status::ERROR);
+    // engine is ready for the next transfer
+    REQUIRE (engine.write (0x45, tx_data));
+  }
+}
+
+TEST_CASE ("i2c_transfer - read", "[i2c_transfer]")
+{
+  std::cout << "i2c_transfer - read" << std::endl;
+
+  stm32::mock::I2C mock_i2c;
+  I2C_TypeDef &i2c = *mock_i2c.get_handle ();
+  stm32::i2c_ref::TransferEngine engine (i2c);
+
+  std::array<uint8_t, 2> rx_data{ 0, 0 };
+  REQUIRE (engine.read (0x45, rx_data));
+  REQUIRE ((i2c.CR2 & I2C_CR2_RD_WRN) == I2C_CR2_RD_WRN);
+  REQUIRE ((i2c.CR2 & I2C_CR2_AUTOEND) == I2C_CR2_AUTOEND);
+  REQUIRE (get_nbytes (i2c) == rx_data.size ());
+
+  i2c.RXDR = 0xAB;
+  raise_irq (i2c, engine, I2C_ISR_RXNE);
+  i2c.RXDR = 0xCD;
+  raise_irq (i2c, engine, I2C_ISR_RXNE);
+  raise_irq (i2c, engine, I2C_ISR_STOPF);
+
+  REQUIRE (engine.status () == stm32::i2c_ref::Status::ACK);
+  REQUIRE (rx_data == std::array<uint8_t, 2>{ 0xAB, 0xCD });
+}
+
+TEST_CASE ("i2c_transfer - write then read", "[i2c_transfer]")
+{
+  std::cout << "i2c_transfer - write then read" << std::endl;
+
+  stm32::mock::I2C mock_i2c;
+  I2C_TypeDef &i2c = *mock_i2c.get_handle ();
+  stm32::i2c_ref::TransferEngine engine (i2c);
+
+  const std::array<uint8_t, 1> reg{ 0x10 };
+  std::array<uint8_t, 1> rx_data{ 0 };
+  REQUIRE (engine.transfer (0x45, reg, rx_data));
+
+  // write phase keeps the bus for the RESTART
+  REQUIRE ((i2c.CR2 & I2C_CR2_RD_WRN) == 0);
+  REQUIRE ((i2c.CR2 & I2C_CR2_AUTOEND) == 0);
+  raise_irq (i2c, engine, I2C_ISR_TXIS);
+  REQUIRE (i2c.TXDR == 0x10);
+
+  // TC switches to the read phase
+  i2c.CR2 = i2c.CR2 & ~I2C_CR2_START;
+  raise_irq (i2c, engine, I2C_ISR_TC);
+  REQUIRE ((i2c.CR2 & I2C_CR2_RD_WRN) == I2C_CR2_RD_WRN);
+  REQUIRE ((i2c.CR2 & I2C_CR2_AUTOEND) == I2C_CR2_AUTOEND);
+  REQUIRE ((i2c.CR2 & I2C_CR2_START) == I2C_CR2_START);
+  REQUIRE (get_nbytes (i2c) == 1);
+
+  i2c.RXDR = 0x5A;
+  raise_irq (i2c, engine, I2C_ISR_RXNE | I2C_ISR_STOPF);
+  REQUIRE (engine.status () == stm32::i2c_ref::Status::ACK);
+  REQUIRE (rx_data[0] == 0x5A);
+}
+
+TEST_CASE ("i2c_transfer - reload beyond 255 bytes", "[i2c_transfer]")
+{
+  std::cout << "i2c_transfer - reload beyond 255 bytes" << std::endl;
+
+  stm32::mock::I2C mock_i2c;
+  I2C_TypeDef &i2c = *mock_i2c.get_handle ();
+  stm32::i2c_ref::TransferEngine engine (i2c);
+
+  std::array<uint8_t, 600> tx_data;
+  for (std::size_t idx = 0; idx < tx_data.size (); idx++)
+  {
+    tx_data[idx] = idx & 0xFF;
+  }
+  REQUIRE (engine.write (0x45, tx_data));
+  REQUIRE (get_nbytes (i2c) == 255);
+  REQUIRE ((i2c.CR2 & I2C_CR2_RELOAD) == I2C_CR2_RELOAD);
+
+  std::size_t sent{ 0 };
+  auto send_chunk = [&] (std::size_t count) {
+    for (std::size_t idx = 0; idx < count; idx++)
+    {
+      raise_irq (i2c, engine, I2C_ISR_TXIS);
+      REQUIRE (i2c.TXDR == tx_data[sent++]);
+    }
+  };
+
+  send_chunk (255);
+  raise_irq (i2c, engine, I2C_ISR_TCR);
+  REQUIRE (get_nbytes (i2c) == 255);
+  REQUIRE ((i2c.CR2 & I2C_CR2_RELOAD) == I2C_CR2_RELOAD);
+
+  send_chunk (255);
+  raise_irq (i2c, engine, I2C_ISR_TCR);
+  REQUIRE (get_nbytes (i2c) == 90);
+  REQUIRE ((i2c.CR2 & I2C_CR2_RELOAD) == 0);
+
+  send_chunk (90);
+  raise_irq (i2c, engine, I2C_ISR_STOPF);
+  REQUIRE (engine.status () == stm32::i2c_ref::Status::ACK);
+  REQUIRE (sent == tx_data.size ());
+}
+
+TEST_CASE ("i2c_transfer - blocking burst transactions", "[i2c_transfer]")
+{
+  std::cout << "i2c_transfer - blocking burst transactions" << std::endl;
+
+  const uint8_t EXPECTED_ADDRESS{ 0x45 };
+
+  // mocked EEPROM, larger than a single NBYTES transfer
+  std::array<uint8_t, 1024> eeprom{};
+
+  // the blocking transfers poll the timer, which lets the slave model run
+  stm32::mock::Simulation sim;
+  stm32::mock::Timer mt (sim);
+  TIM_TypeDef *timer = mt.init_timer ();
+
+  stm32::mock::I2C mock_i2c;
+  stm32::i2c_ref::TransferEngine engine (*mock_i2c.get_handle ());
+  mock_i2c.init_i2c_slave_device (sim, engine, EXPECTED_ADDRESS, eeprom);
+
+  SECTION ("write then read back several KB")
+  {
+    // register pointer followed by the data
+    std::array<uint8_t, 601> tx_data;
+    tx_data[0] = 0x00;
+    for (std::size_t idx = 1; idx < tx_data.size (); idx++)
+    {
+      tx_data[idx] = (idx * 7) & 0xFF;
+    }
+    REQUIRE (stm32::i2c_ref::write (engine, EXPECTED_ADDRESS, tx_data)
+             == stm32::i2c_ref::Status::ACK);
+    REQUIRE (std::equal (tx_data.begin () + 1, tx_data.end (),
+                         eeprom.begin ()));
+
+    std::array<uint8_t, 600> rx_data{};
+    REQUIRE (stm32::i2c_ref::write_then_read (engine, EXPECTED_ADDRESS, 0x00,
+                                              rx_data)
+             == stm32::i2c_ref::Status::ACK);
+    REQUIRE (std::equal (rx_data.begin (), rx_data.end (),
+                         tx_data.begin () + 1));
+  }
+
+  SECTION ("read continues from the register pointer")
+  {
+    eeprom[0x10] = 0xAA;
+    eeprom[0x11] = 0xBB;
+    std::array<uint8_t, 1> rx_data{};
+    REQUIRE (stm32::i2c_ref::write_then_read (engine, EXPECTED_ADDRESS, 0x10,
+                                              rx_data)
+             == stm32::i2c_ref::Status::ACK);
+    REQUIRE (rx_data[0] == 0xAA);
+    REQUIRE (stm32::i2c_ref::read (engine, EXPECTED_ADDRESS, rx_data)
+             == stm32::i2c_ref::Status::ACK);
+    REQUIRE (rx_data[0] == 0xBB);
+  }
+
+  SECTION ("wrong address is NACKed")
+  {
+    std::array<uint8_t, 4> rx_data{};
+    REQUIRE (stm32::i2c_ref::read (engine, 0x65, rx_data)
+             == stm32::i2c_ref::Status::NACK);
+  }
+
+  timer->CR1 = 0;
+}
+
+TEST_CASE ("i2c_transfer - blocking transaction timeout", "[i2c_transfer]")
+{
+  std::cout << "i2c_transfer - blocking transaction timeout" << std::endl;
+
+  // no slave model and no interrupts, as if SCL were held low
+  stm32::mock::Simulation sim;
+  stm32::mock::Timer mt (sim);
+  TIM_TypeDef *timer = mt.init_timer ();
+
+  stm32::mock::I2C mock_i2c;
+  I2C_TypeDef &i2c = *mock_i2c.get_handle ();
+  stm32::i2c_ref::TransferEngine engine (i2c);
+  const std::array<uint8_t, 3> tx_data{ 0x11, 0x22, 0x33 };
+
+  SECTION ("explicit deadline")
+  {
+    REQUIRE (stm32::i2c_ref::write (engine, 0x45, tx_data, 500)
+             == stm32::i2c_ref::Status::TIMEOUT);
+    REQUIRE (sim.now_ns () >= 500 * stm32::mock::Simulation::NS_PER_US);
+    REQUIRE (sim.now_ns () < 600 * stm32::mock::Simulation::NS_PER_US);
+  }
+
+  SECTION ("deadline from TIMINGR")
+  {
+    // 100kHz from 64MHz: 640 clocks per SCL period
+    i2c.TIMINGR = (1U << I2C_TIMINGR_PRESC_Pos) | (159U << I2C_TIMINGR_SCLL_Pos)
+                  | (159U << I2C_TIMINGR_SCLH_Pos);
+    REQUIRE (engine.transfer_timeout_us (tx_data.size ()) == 25000 + 900);
+    REQUIRE (stm32::i2c_ref::write (engine, 0x45, tx_data)
+             == stm32::i2c_ref::Status::TIMEOUT);
+    REQUIRE (sim.now_ns () >= 25900 * stm32::mock::Simulation::NS_PER_US);
+  }
+
+  // the peripheral was reset and the engine is free for the next transfer
+  REQUIRE_FALSE (engine.busy ());
+  REQUIRE ((i2c.CR1 & I2C_CR1_PE) == I2C_CR1_PE);
+  REQUIRE ((i2c.CR1 & (I2C_CR1_TXIE | I2C_CR1_STOPIE | I2C_CR1_ERRIE)) == 0);
+  REQUIRE_FALSE (engine.abort ());
+
+  CallbackRecord record;
+  REQUIRE (engine.write (0x45, tx_data, record_callback, &record));
+  REQUIRE (engine.abort ());
+  REQUIRE (engine.status () == stm32::i2c_ref::Status::TIMEOUT);
+  REQUIRE (record.count == 1);
+  REQUIRE (record.status == stm32::i2c_ref::Status::TIMEOUT);
+
+  timer->CR1 = 0;
+}
@@ -1,6 +1,7 @@
 #include <catch2/catch_all.hpp>
 
 #include <filesystem>
+#include <i2c_utils.hpp>
 #include <i2c_utils_ref.hpp>
 #include <mock.hpp>
 #include <mock_fuse.hpp>
@@ -9,6 +10,11 @@
 #include <thread>
 #include <timer_manager.hpp>
 
+// 400kHz SCL from a 64MHz kernel clock: (13 + 7) periods of 125ns
+static constexpr uint32_t TIMINGR_400KHZ{ (7U << I2C_TIMINGR_PRESC_Pos)
+                                          | (6U << I2C_TIMINGR_SCLH_Pos)
+                                          | (12U << I2C_TIMINGR_SCLL_Pos) };
+
 TEST_CASE ("test_fuse", "[fuse]")
 {
   stm32::mock::MockFuse mf;
@@ -80,82 +86,66 @@ TEST_CASE ("i2c_utils - Receive Bytes", "[i2c_utils")
 
 TEST_CASE ("i2c_utils - send_bytes", "[i2c_utils]")
 {
-  // Enable timer test fixture and start it in a new thread
-  stm32::mock::Timer mt;
-  std::future<bool> tim_result;
-  TIM_TypeDef *timer = nullptr;
-  timer = mt.init_timer (tim_result);
+  // simulated timer, used by send_byte() between polls
+  stm32::mock::Simulation sim;
+  stm32::mock::Timer mt (sim);
+  TIM_TypeDef *timer = mt.init_timer ();
 
   SECTION ("Bytes sent - Slave returns ACK")
   {
     std::cout << "i2c_utils - send_byte: Slave returns ACK" << std::endl;
-    // Start mock I2C peripheral in a new thread. Simulate ACK slave return
-    // status
+    // Simulate the TX FIFO with an ACK slave return status
     stm32::mock::I2C mock_i2c;
-    std::future<bool> tx_fifo_future;
-    mock_i2c.init_i2c_tx_fifo (tx_fifo_future, stm32::mock::SlaveStatus::ACK);
+    mock_i2c.init_i2c_tx_fifo (sim, stm32::mock::SlaveStatus::ACK);
+
+    // 400kHz SCL
+    mock_i2c.get_handle ()->TIMINGR = TIMINGR_400KHZ;
+    REQUIRE (mock_i2c.scl_period_ns () == 2500);
 
     // Call the SUT function
     REQUIRE (stm32::i2c_ref::send_byte (*mock_i2c.get_handle (), 0xFF)
              == stm32::i2c_ref::Status::ACK);
 
-    // Success! Now disable the mock periphs and allow their threads to end
-    timer->CR1 = 0;
-    mock_i2c.get_handle ()->CR1
-        = mock_i2c.get_handle ()->CR1 & ~I2C_CR1_PE_Msk;
-
-    // yield to the async threads until they return
-    REQUIRE (tim_result.get ());
-    REQUIRE (tx_fifo_future.get ());
+    // the byte left the TX FIFO after 9 SCL periods
+    REQUIRE (mock_i2c.get_handle ()->TXDR == 0);
+    REQUIRE (sim.now_ns () >= 9 * 2500);
+    REQUIRE (mock_i2c.bus_stats ().wire_time_ns == 9 * 2500);
   }
 
   SECTION ("Bytes sent - Slave returns NACK")
   {
     std::cout << "i2c_utils - send_byte: Slave returns NACK" << std::endl;
 
-    // Start mock I2C peripheral in a new thread. Simulate NACK slave return
-    // status
+    // Simulate the TX FIFO with a NACK slave return status
     stm32::mock::I2C mock_i2c;
-    std::future<bool> tx_fifo_future;
-    mock_i2c.init_i2c_tx_fifo (tx_fifo_future, stm32::mock::SlaveStatus::NACK);
+    mock_i2c.init_i2c_tx_fifo (sim, stm32::mock::SlaveStatus::NACK);
 
     // Call the SUT function
     REQUIRE (stm32::i2c_ref::send_byte (*mock_i2c.get_handle (), 0xFF)
              == stm32::i2c_ref::Status::NACK);
-
-    // Success! Now disable the mock periphs and allow their threads to end
-    timer->CR1 = 0;
-    mock_i2c.get_handle ()->CR1
-        = mock_i2c.get_handle ()->CR1 & ~I2C_CR1_PE_Msk;
-
-    // make sure the mocks returned success
-    REQUIRE (tim_result.get ());
-    REQUIRE (tx_fifo_future.get ());
   }
+
+  timer->CR1 = 0;
 }
 
 TEST_CASE ("i2c_utils - initialise_slave_device function", "[i2c_utils]")
 {
   const uint8_t EXPECTED_ADDRESS{ 0x45 };
 
-  // Enable timer test fixture and start it in a new thread
-  stm32::mock::Timer mt;
-  std::future<bool> timer_future;
-  TIM_TypeDef *timer = nullptr;
-  timer = mt.init_timer (timer_future);
+  // simulated timer and I2C address phase
+  stm32::mock::Simulation sim;
+  stm32::mock::Timer mt (sim);
+  TIM_TypeDef *timer = mt.init_timer ();
 
   const uint8_t INVALID_ADDRESS{ 0x65 };
 
-  // start test fixture thread
   stm32::mock::I2C mock_i2c;
-  std::future<bool> start_condition_future;
 
   SECTION ("PROBE: Invalid Address")
   {
     std::cout << "i2c_utils - initialise_slave_device: PROBE/Invalid Address"
               << std::endl;
-    mock_i2c.init_i2c_start_condition (start_condition_future,
-                                       EXPECTED_ADDRESS);
+    mock_i2c.init_i2c_start_condition (sim, EXPECTED_ADDRESS);
     REQUIRE (stm32::i2c_ref::initialise_slave_device (
                  *mock_i2c.get_handle (), INVALID_ADDRESS,
                  stm32::i2c_ref::StartType::PROBE)
@@ -164,10 +154,8 @@ TEST_CASE ("i2c_utils - initialise_slave_device function", "[i2c_utils]")
     // SUT has returned so simulate disabling of the HW Timer
     timer->CR1 = 0;
 
-    REQUIRE (timer_future.get ());
-
-    // returns false with valid address
-    REQUIRE_FALSE (start_condition_future.get ());
+    // the mock saw the wrong address
+    REQUIRE_FALSE (mock_i2c.address_matched ());
 
     // Confirm we enabled AUTOEND Mode
     REQUIRE ((mock_i2c.get_handle ()->CR1 & (I2C_CR1_PE_Msk)));
@@ -179,8 +167,7 @@ TEST_CASE ("i2c_utils - initialise_slave_device function", "[i2c_utils]")
   {
     std::cout << "i2c_utils - initialise_slave_device: PROBE/Valid Address"
               << std::endl;
-    mock_i2c.init_i2c_start_condition (start_condition_future,
-                                       EXPECTED_ADDRESS);
+    mock_i2c.init_i2c_start_condition (sim, EXPECTED_ADDRESS);
     REQUIRE (stm32::i2c_ref::initialise_slave_device (
                  *mock_i2c.get_handle (), EXPECTED_ADDRESS,
                  stm32::i2c_ref::StartType::PROBE)
@@ -189,10 +176,8 @@ TEST_CASE ("i2c_utils - initialise_slave_device function", "[i2c_utils]")
     // SUT has returned so simulate disabling of the HW Timer
     timer->CR1 = 0;
 
-    REQUIRE (timer_future.get ());
-
-    // returns true with valid address
-    REQUIRE (start_condition_future.get ());
+    // the mock saw the expected address
+    REQUIRE (mock_i2c.address_matched ());
 
     // Confirm we enabled AUTOEND Mode
     REQUIRE ((mock_i2c.get_handle ()->CR1 & (I2C_CR1_PE_Msk)));
@@ -204,8 +189,7 @@ TEST_CASE ("i2c_utils - initialise_slave_device function", "[i2c_utils]")
   {
     std::cout << "i2c_utils - initialise_slave_device: WRITE/Invalid Address"
               << std::endl;
-    mock_i2c.init_i2c_start_condition (start_condition_future,
-                                       EXPECTED_ADDRESS);
+    mock_i2c.init_i2c_start_condition (sim, EXPECTED_ADDRESS);
     REQUIRE (stm32::i2c_ref::initialise_slave_device (
                  *mock_i2c.get_handle (), INVALID_ADDRESS,
                  stm32::i2c_ref::StartType::WRITE)
@@ -214,10 +198,8 @@ TEST_CASE ("i2c_utils - initialise_slave_device function", "[i2c_utils]")
     // SUT has returned so simulate disabling of the HW Timer
     timer->CR1 = 0;
 
-    REQUIRE (timer_future.get ());
-
-    // returns false with valid address
-    REQUIRE_FALSE (start_condition_future.get ());
+    // the mock saw the wrong address
+    REQUIRE_FALSE (mock_i2c.address_matched ());
 
     // Confirm we disabled AUTOEND Mode
     REQUIRE ((mock_i2c.get_handle ()->CR1 & (I2C_CR1_PE_Msk)));
@@ -228,8 +210,7 @@ TEST_CASE ("i2c_utils - initialise_slave_device function", "[i2c_utils]")
   {
     std::cout << "i2c_utils - initialise_slave_device: WRITE/Valid Address"
               << std::endl;
-    mock_i2c.init_i2c_start_condition (start_condition_future,
-                                       EXPECTED_ADDRESS);
+    mock_i2c.init_i2c_start_condition (sim, EXPECTED_ADDRESS);
     REQUIRE (stm32::i2c_ref::initialise_slave_device (
                  *mock_i2c.get_handle (), EXPECTED_ADDRESS,
                  stm32::i2c_ref::StartType::WRITE)
@@ -238,10 +219,8 @@ TEST_CASE ("i2c_utils - initialise_slave_device function", "[i2c_utils]")
     // SUT has returned so simulate disabling of the HW Timer
     timer->CR1 = 0;
 
-    REQUIRE (timer_future.get ());
-
-    // returns true with valid address
-    REQUIRE (start_condition_future.get ());
+    // the mock saw the expected address
+    REQUIRE (mock_i2c.address_matched ());
 
     // Confirm we disabled AUTOEND Mode
     REQUIRE ((mock_i2c.get_handle ()->CR1 & (I2C_CR1_PE_Msk)));
@@ -252,8 +231,7 @@ TEST_CASE ("i2c_utils - initialise_slave_device function", "[i2c_utils]")
   {
     std::cout << "i2c_utils - initialise_slave_device: READ/Invalid Address"
               << std::endl;
-    mock_i2c.init_i2c_start_condition (start_condition_future,
-                                       EXPECTED_ADDRESS);
+    mock_i2c.init_i2c_start_condition (sim, EXPECTED_ADDRESS);
     REQUIRE (stm32::i2c_ref::initialise_slave_device (
                  *mock_i2c.get_handle (), INVALID_ADDRESS,
                  stm32::i2c_ref::StartType::READ)
@@ -262,10 +240,8 @@ TEST_CASE ("i2c_utils - initialise_slave_device function", "[i2c_utils]")
     // SUT has returned so simulate disabling of the HW Timer
     timer->CR1 = 0;
 
-    REQUIRE (timer_future.get ());
-
-    // returns false with valid address
-    REQUIRE_FALSE (start_condition_future.get ());
+    // the mock saw the wrong address
+    REQUIRE_FALSE (mock_i2c.address_matched ());
 
     // confirm we requested a read operation
     REQUIRE ((mock_i2c.get_handle ()->CR1 & (I2C_CR1_PE_Msk)));
@@ -276,8 +252,7 @@ TEST_CASE ("i2c_utils - initialise_slave_device function", "[i2c_utils]")
   {
     std::cout << "i2c_utils - initialise_slave_device: READ/Valid Address"
               << std::endl;
-    mock_i2c.init_i2c_start_condition (start_condition_future,
-                                       EXPECTED_ADDRESS);
+    mock_i2c.init_i2c_start_condition (sim, EXPECTED_ADDRESS);
     REQUIRE (stm32::i2c_ref::initialise_slave_device (
                  *mock_i2c.get_handle (), EXPECTED_ADDRESS,
                  stm32::i2c_ref::StartType::READ)
@@ -286,10 +261,8 @@ TEST_CASE ("i2c_utils - initialise_slave_device function", "[i2c_utils]")
     // SUT has returned so simulate disabling of the HW Timer
     timer->CR1 = 0;
 
-    REQUIRE (timer_future.get ());
-
-    // returns true with valid address
-    REQUIRE (start_condition_future.get ());
+    // the mock saw the expected address
+    REQUIRE (mock_i2c.address_matched ());
 
     // confirm we requested a read operation
     REQUIRE ((mock_i2c.get_handle ()->CR1 & (I2C_CR1_PE_Msk)));
@@ -308,3 +281,125 @@ TEST_CASE ("i2c_utils - set_numbytes", "[i2c_utils]")
   // read back the value
   REQUIRE ((mock_i2c.get_handle ()->CR2 & (2 << I2C_CR2_NBYTES_Pos)));
 }
+
+// Binds stm32::i2c_ref::I2cDevice to a mock register block. Target code uses stm32::i2c_ref::I2c<I2C1_BASE> instead.
+struct MockI2cPeripheral
+{
+  static I2C_TypeDef &get ()
+  {
+    static I2C_TypeDef i2c;
+    return i2c;
+  }
+};
+
+TEST_CASE ("i2c_utils - compile-time bound device", "[i2c_utils]")
+{
+  std::cout << "i2c_utils - compile-time bound device" << std::endl;
+
+  using I2c = stm32::i2c_ref::I2cDevice<MockI2cPeripheral>;
+  I2C_TypeDef &i2c_handle = MockI2cPeripheral::get ();
+
+  I2c::set_numbytes (3);
+  REQUIRE ((i2c_handle.CR2 & I2C_CR2_NBYTES) == (3 << I2C_CR2_NBYTES_Pos));
+
+  I2c::send_nack ();
+  REQUIRE ((i2c_handle.CR2 & I2C_CR2_NACK) == I2C_CR2_NACK);
+  I2c::send_ack ();
+  REQUIRE ((i2c_handle.CR2 & I2C_CR2_NACK) != I2C_CR2_NACK);
+
+  I2c::generate_stop_condition ();
+  REQUIRE ((i2c_handle.CR2 & I2C_CR2_STOP) == I2C_CR2_STOP);
+
+  i2c_handle.RXDR = 0x42;
+  uint8_t rx_byte{0};
+  REQUIRE (I2c::receive_byte (rx_byte) == stm32::i2c_ref::Status::ACK);
+  REQUIRE (rx_byte == 0x42);
+
+  SECTION ("pointer wrappers reject null handles")
+  {
+    I2C_TypeDef *null_handle = nullptr;
+    REQUIRE (stm32::i2c::initialise_slave_device (null_handle, 0x10, stm32::i2c::StartType::PROBE)
+             == stm32::i2c::Status::ERROR);
+    REQUIRE (stm32::i2c::send_byte (null_handle, 0x00) == stm32::i2c::Status::ERROR);
+    REQUIRE (stm32::i2c::receive_byte (null_handle, rx_byte) == stm32::i2c::Status::ERROR);
+  }
+
+  SECTION ("pointer wrappers forward to the same implementation")
+  {
+    stm32::i2c::set_numbytes (&i2c_handle, 5);
+    REQUIRE ((i2c_handle.CR2 & I2C_CR2_NBYTES) == (5 << I2C_CR2_NBYTES_Pos));
+  }
+}
+
+TEST_CASE ("i2c_utils - initialise_slave_device timeout", "[i2c_utils]")
+{
+  std::cout << "i2c_utils - initialise_slave_device: no response" << std::endl;
+
+  // simulated timer, so the deadline takes no real time
+  stm32::mock::Simulation sim;
+  stm32::mock::Timer mt (sim);
+  TIM_TypeDef *timer = mt.init_timer ();
+
+  // no slave model, so the slave never responds
+  stm32::mock::I2C mock_i2c;
+  REQUIRE (stm32::i2c_ref::initialise_slave_device (
+               *mock_i2c.get_handle (), 0x45,
+               stm32::i2c_ref::StartType::WRITE, 5)
+           == stm32::i2c_ref::Status::TIMEOUT);
+  REQUIRE (sim.now_ns () >= 5 * stm32::mock::Simulation::NS_PER_US);
+
+  timer->CR1 = 0;
+}
+
+/// @brief Compare the transaction rate of the event-driven address phase with
+/// the fixed 1ms sleep it replaced. Rates are measured in simulated time, so
+/// they are those of the target. Run with: ./test_suite "[i2c_benchmark]"
+TEST_CASE ("i2c_utils - address phase benchmark", "[.][i2c_benchmark]")
+{
+  const uint8_t EXPECTED_ADDRESS{ 0x45 };
+  const int TRANSACTIONS{ 5 };
+
+  stm32::mock::Simulation sim;
+  stm32::mock::Timer mt (sim);
+  TIM_TypeDef *timer = mt.init_timer ();
+
+  stm32::mock::I2C mock_i2c;
+  I2C_TypeDef &i2c = *mock_i2c.get_handle ();
+  i2c.TIMINGR = TIMINGR_400KHZ;
+  mock_i2c.init_i2c_responsive_slave (sim, EXPECTED_ADDRESS);
+
+  // run the transactions and return the rate in transactions per target second
+  auto measure = [&] (auto transaction) {
+    mock_i2c.restart_bus_stats ();
+    const uint64_t start_ns = sim.now_ns ();
+    for (int count = 0; count < TRANSACTIONS; count++)
+    {
+      i2c.ISR = 0;
+      REQUIRE (transaction () == stm32::i2c_ref::Status::ACK);
+    }
+    const uint64_t elapsed_ns = sim.now_ns () - start_ns;
+    std::cout << "  bus: " << mock_i2c.bus_stats () << std::endl;
+    return (1e9 * TRANSACTIONS) / static_cast<double> (elapsed_ns);
+  };
+
+  // the previous implementation: PROBE setup, START then a fixed 1ms sleep
+  const double before = measure ([&] () {
+    i2c.CR2 = (i2c.CR2 & ~I2C_CR2_SADD) | EXPECTED_ADDRESS | I2C_CR2_AUTOEND;
+    stm32::i2c_ref::generate_start_condition (i2c);
+    stm32::TimerManager::delay_microsecond (1000);
+    return ((i2c.ISR & I2C_ISR_NACKF) == I2C_ISR_NACKF)
+               ? stm32::i2c_ref::Status::NACK
+               : stm32::i2c_ref::Status::ACK;
+  });
+
+  const double after = measure ([&] () {
+    return stm32::i2c_ref::initialise_slave_device (
+        i2c, EXPECTED_ADDRESS, stm32::i2c_ref::StartType::PROBE);
+  });
+
+  std::cout << "address phase transactions/s - before: " << before
+            << ", after: " << after << std::endl;
+  REQUIRE (after > before);
+
+  timer->CR1 = 0;
+}
@@ -0,0 +1,143 @@
+#include <catch2/catch_all.hpp>
+#include <intrusive_heap.hpp>
+#include <restricted_base.hpp>
+#include <chrono>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <vector>
+
+using namespace noarch::containers;
+
+namespace
+{
+
+struct Timeout : public HeapHook<>, public RestrictedBase
+{
+    explicit Timeout(uint32_t deadline) : m_deadline(deadline) {}
+    bool operator<(const Timeout &other) const { return m_deadline < other.m_deadline; }
+    uint32_t m_deadline;
+};
+
+struct Sample : public HeapHook<>
+{
+    uint32_t m_value{0};
+    bool operator<(const Sample &other) const { return m_value < other.m_value; }
+    bool operator>(const Sample &other) const { return m_value > other.m_value; }
+};
+
+} // namespace
+
+// enforce code coverage with explicit instances of class templates so that linker does not drop references
+template class noarch::containers::IntrusiveHeap<Timeout>;
+
+TEST_CASE("intrusive_heap - push and pop in order", "[intrusive_heap]")
+{
+    std::cout << "intrusive_heap - push and pop in order" << std::endl;
+    IntrusiveHeap<Timeout> heap;
+    REQUIRE(heap.empty());
+    REQUIRE(heap.top() == nullptr);
+    REQUIRE(heap.pop() == nullptr);
+
+    Timeout a(30), b(10), c(20), d(10);
+    heap.push(a);
+    heap.push(b);
+    heap.push(c);
+    heap.push(d);
+    REQUIRE(heap.size() == 4);
+    REQUIRE(heap.top()->m_deadline == 10);
+
+    std::vector<uint32_t> popped;
+    while (!heap.empty()) { popped.push_back(heap.pop()->m_deadline); }
+    REQUIRE(popped == std::vector<uint32_t>{10, 10, 20, 30});
+    REQUIRE_FALSE(heap.contains(a));
+}
+
+TEST_CASE("intrusive_heap - remove and update", "[intrusive_heap]")
+{
+    std::cout << "intrusive_heap - remove and update" << std::endl;
+    IntrusiveHeap<Timeout> heap;
+    Timeout a(5), b(15), c(25), d(35), outside(1);
+    for (Timeout *timeout : {&a, &b, &c, &d}) { heap.push(*timeout); }
+
+    REQUIRE_FALSE(heap.remove(outside));
+    REQUIRE(heap.remove(c));
+    REQUIRE(heap.remove(a));
+    REQUIRE(heap.size() == 2);
+    REQUIRE(heap.top() == &b);
+
+    d.m_deadline = 2;
+    heap.update(d);
+    REQUIRE(heap.pop() == &d);
+    REQUIRE(heap.pop() == &b);
+    REQUIRE(heap.empty());
+}
+
+TEST_CASE("intrusive_heap - randomised against std::priority_queue", "[intrusive_heap]")
+{
+    std::cout << "intrusive_heap - randomised against std::priority_queue" << std::endl;
+    std::mt19937 random(1234);
+    std::vector<Sample> samples(500);
+    IntrusiveHeap<Sample, std::greater<Sample>> heap;
+    std::vector<uint32_t> expected;
+
+    for (Sample &sample : samples)
+    {
+        sample.m_value = random() % 1000;
+        heap.push(sample);
+    }
+    // remove a third from anywhere, then check the rest come out in order
+    for (std::size_t idx = 0; idx < samples.size(); idx++)
+    {
+        if (idx % 3 == 0) { heap.remove(samples[idx]); }
+        else { expected.push_back(samples[idx].m_value); }
+    }
+    std::sort(expected.begin(), expected.end(), std::greater<uint32_t>());
+
+    std::vector<uint32_t> popped;
+    while (Sample *sample = heap.pop()) { popped.push_back(sample->m_value); }
+    REQUIRE(popped == expected);
+}
+
+// Not run by default. Run with: ./build/test_suite "[intrusive_heap_benchmark]"
+TEST_CASE("intrusive_heap - benchmark", "[.][intrusive_heap_benchmark]")
+{
+    for (std::size_t count : {10, 100, 1000, 10000})
+    {
+        std::mt19937 random(count);
+        std::vector<Sample> samples(count);
+        for (Sample &sample : samples) { sample.m_value = random(); }
+        const std::size_t rounds = 1000000 / count;
+        uint64_t checksum{0};
+
+        IntrusiveHeap<Sample> heap;
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t round = 0; round < rounds; round++)
+        {
+            for (Sample &sample : samples) { heap.push(sample); }
+            // remove every fourth from the middle, pop the rest
+            for (std::size_t idx = 0; idx < count; idx += 4) { heap.remove(samples[idx]); }
+            while (Sample *sample = heap.pop()) { checksum += sample->m_value; }
+        }
+        const std::chrono::duration<double, std::nano> intrusive = std::chrono::steady_clock::now() - start;
+
+        std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t>> queue;
+        start = std::chrono::steady_clock::now();
+        for (std::size_t round = 0; round < rounds; round++)
+        {
+            // std::priority_queue can't remove from the middle, so it only pushes and pops
+            for (const Sample &sample : samples) { queue.push(sample.m_value); }
+            while (!queue.empty())
+            {
+                checksum += queue.top();
+                queue.pop();
+            }
+        }
+        const std::chrono::duration<double, std::nano> standard = std::chrono::steady_clock::now() - start;
+
+        const double operations = static_cast<double>(rounds * count);
+        std::cout << count << " elements, push+pop per element: IntrusiveHeap " << (intrusive.count() / operations)
+                  << " ns, std::priority_queue " << (standard.count() / operations) << " ns (checksum " << checksum
+                  << ")" << std::endl;
+    }
+}
@@ -0,0 +1,143 @@
+#include <catch2/catch_all.hpp>
+#include <intrusive_list.hpp>
+#include <restricted_base.hpp>
+#include <chrono>
+#include <iostream>
+#include <list>
+#include <random>
+#include <vector>
+
+using namespace noarch::containers;
+
+namespace
+{
+
+struct PendingTag;
+struct ActiveTag;
+
+// can be in two lists at once, and can't be copied or heap allocated
+struct Job : public ListHook<PendingTag>, public ListHook<ActiveTag>, public RestrictedBase
+{
+    explicit Job(int id) : m_id(id) {}
+    int m_id;
+};
+
+template <typename TAG>
+std::vector<int> ids(const IntrusiveList<Job, TAG> &list)
+{
+    std::vector<int> result;
+    for (const Job &job : list) { result.push_back(job.m_id); }
+    return result;
+}
+
+} // namespace
+
+// enforce code coverage with explicit instances of class templates so that linker does not drop references
+template class noarch::containers::IntrusiveList<Job, PendingTag>;
+
+TEST_CASE("intrusive_list - insert and remove", "[intrusive_list]")
+{
+    std::cout << "intrusive_list - insert and remove" << std::endl;
+    Job a(1), b(2), c(3), d(4);
+    IntrusiveList<Job, PendingTag> pending;
+    REQUIRE(pending.empty());
+    REQUIRE(pending.front() == nullptr);
+    REQUIRE(pending.pop_front() == nullptr);
+
+    pending.push_back(b);
+    pending.push_front(a);
+    pending.push_back(d);
+    pending.insert(std::next(pending.begin(), 2), c);
+    REQUIRE(ids(pending) == std::vector<int>{1, 2, 3, 4});
+    REQUIRE(pending.size() == 4);
+
+    // O(1) removal from the middle, through the object
+    IntrusiveList<Job, PendingTag>::remove(b);
+    REQUIRE_FALSE(static_cast<ListHook<PendingTag> &>(b).linked());
+    REQUIRE(ids(pending) == std::vector<int>{1, 3, 4});
+
+    REQUIRE(pending.pop_back() == &d);
+    REQUIRE(pending.pop_front() == &a);
+    REQUIRE(pending.front() == &c);
+    REQUIRE(pending.back() == &c);
+
+    // reverse iteration
+    pending.push_front(b);
+    auto last = pending.end();
+    REQUIRE((--last)->m_id == 3);
+    REQUIRE((--last)->m_id == 2);
+
+    pending.clear();
+    REQUIRE(pending.empty());
+    REQUIRE_FALSE(static_cast<ListHook<PendingTag> &>(c).linked());
+}
+
+TEST_CASE("intrusive_list - membership of several lists", "[intrusive_list]")
+{
+    std::cout << "intrusive_list - membership of several lists" << std::endl;
+    IntrusiveList<Job, PendingTag> pending;
+    IntrusiveList<Job, ActiveTag> active;
+    Job a(1), b(2);
+
+    pending.push_back(a);
+    pending.push_back(b);
+    active.push_back(b);
+    REQUIRE(ids(pending) == std::vector<int>{1, 2});
+    REQUIRE(ids(active) == std::vector<int>{2});
+
+    pending.remove(b);
+    REQUIRE(ids(pending) == std::vector<int>{1});
+    REQUIRE(ids(active) == std::vector<int>{2});
+
+    // a destroyed object takes itself out of its lists
+    {
+        Job temporary(3);
+        pending.push_back(temporary);
+        active.push_back(temporary);
+        REQUIRE(pending.size() == 2);
+    }
+    REQUIRE(ids(pending) == std::vector<int>{1});
+    REQUIRE(ids(active) == std::vector<int>{2});
+}
+
+// Not run by default. Run with: ./build/test_suite "[intrusive_list_benchmark]"
+TEST_CASE("intrusive_list - benchmark", "[.][intrusive_list_benchmark]")
+{
+    struct Item : public ListHook<>
+    {
+        uint32_t m_value{0};
+    };
+
+    for (std::size_t count : {10, 100, 1000, 10000})
+    {
+        // remove in a shuffled order, so removal is by node and not from the ends
+        std::vector<std::size_t> order(count);
+        std::iota(order.begin(), order.end(), 0);
+        std::shuffle(order.begin(), order.end(), std::mt19937(count));
+        const std::size_t rounds = 1000000 / count;
+
+        std::vector<Item> items(count);
+        IntrusiveList<Item> list;
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t round = 0; round < rounds; round++)
+        {
+            for (Item &item : items) { list.push_back(item); }
+            for (std::size_t idx : order) { list.remove(items[idx]); }
+        }
+        const std::chrono::duration<double, std::nano> intrusive = std::chrono::steady_clock::now() - start;
+
+        std::list<uint32_t> std_list;
+        std::vector<std::list<uint32_t>::iterator> positions(count);
+        start = std::chrono::steady_clock::now();
+        for (std::size_t round = 0; round < rounds; round++)
+        {
+            for (std::size_t idx = 0; idx < count; idx++) { positions[idx] = std_list.insert(std_list.end(), idx); }
+            for (std::size_t idx : order) { std_list.erase(positions[idx]); }
+        }
+        const std::chrono::duration<double, std::nano> standard = std::chrono::steady_clock::now() - start;
+
+        const double operations = static_cast<double>(rounds * count);
+        std::cout << count << " elements, insert+remove: IntrusiveList " << (intrusive.count() / operations)
+                  << " ns, std::list " << (standard.count() / operations) << " ns" << std::endl;
+    }
+}
@@ -0,0 +1,56 @@
+#include <catch2/catch_all.hpp>
+
+#include <mock.hpp>
+#include <i2c_utils_ref.hpp>
+#include <register_field.hpp>
+
+namespace
+{
+
+using LOW  = stm32::RegisterField<0x000000FF, 0>;
+using MID  = stm32::RegisterField<0x00000F00, 8>;
+using FLAG = stm32::RegisterField<0x80000000, 31>;
+
+} // namespace
+
+TEST_CASE ("register_field - modify several fields in one write", "[register_field]")
+{
+  std::cout << "register_field - modify several fields in one write" << std::endl;
+  volatile uint32_t reg = 0x12345678;
+
+  SECTION ("fields are replaced, other bits are kept")
+  {
+    stm32::reg::modify (reg, LOW (0xAB), FLAG (1));
+    REQUIRE (reg == 0x923456AB);
+    stm32::reg::modify (reg, FLAG (0));
+    REQUIRE (reg == 0x123456AB);
+  }
+
+  SECTION ("values are truncated to the field")
+  {
+    stm32::reg::modify (reg, MID (0x1F));
+    REQUIRE (reg == 0x12345F78);
+    REQUIRE (stm32::reg::read<MID> (reg) == 0xF);
+  }
+
+  SECTION ("write doesn't keep any other bits")
+  {
+    stm32::reg::write (reg, MID (3), FLAG (1));
+    REQUIRE (reg == 0x80000300);
+  }
+
+  STATIC_REQUIRE (LOW::get (0x1234) == 0x34);
+  STATIC_REQUIRE (MID (0xFFFF).bits == 0xF00);
+}
+
+TEST_CASE ("register_field - I2C CR2 fields", "[register_field]")
+{
+  std::cout << "register_field - I2C CR2 fields" << std::endl;
+  I2C_TypeDef i2c;
+  i2c.CR2 = I2C_CR2_NACK | I2C_CR2_ADD10 | I2C_CR2_RD_WRN | I2C_CR2_SADD;
+
+  stm32::reg::modify (i2c.CR2, stm32::i2c_ref::cr2::ADD10 (0), stm32::i2c_ref::cr2::SADD (0x42),
+                      stm32::i2c_ref::cr2::RD_WRN (0), stm32::i2c_ref::cr2::AUTOEND (1));
+  REQUIRE (i2c.CR2 == (I2C_CR2_NACK | I2C_CR2_AUTOEND | 0x42));
+  REQUIRE (stm32::reg::read<stm32::i2c_ref::cr2::SADD> (i2c.CR2) == 0x42);
+}
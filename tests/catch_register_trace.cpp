@@ -0,0 +1,171 @@
+#include <catch2/catch_all.hpp>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <i2c_utils_ref.hpp>
+#include <mock.hpp>
+#include <mock_trace.hpp>
+#include <spi_utils_ref.hpp>
+#include <sstream>
+#include <usart_utils_ref.hpp>
+
+TEST_CASE ("register_trace - records the driver's accesses", "[register_trace]")
+{
+  std::cout << "register_trace - records the driver's accesses" << std::endl;
+
+  stm32::mock::Simulation sim;
+  stm32::mock::Timer mt (sim);
+  TIM_TypeDef *timer = mt.init_timer ();
+
+  stm32::mock::RegisterTrace trace (sim);
+  trace.name (*timer, "TIM6");
+
+  SECTION ("SPI send_byte")
+  {
+    SPI_TypeDef *spi_handle = new SPI_TypeDef;
+    stm32::mock::SPI mock_spi (sim, *spi_handle);
+    trace.name (*spi_handle, "SPI1");
+    stm32::spi_ref::enable_spi (*spi_handle, true);
+
+    trace.mark ("send_byte");
+    REQUIRE (stm32::spi_ref::send_byte (*spi_handle, 0xFF));
+    REQUIRE (trace.marks ().size () == 1);
+    REQUIRE (trace.marks ()[0].position == 2);
+
+    // the 8-bit DR write is recorded, the BSY and TXE waits poll SR
+    REQUIRE (trace.count ("SPI1.DR", true) == 1);
+    const auto &dr_write = trace.accesses ()[trace.marks ()[0].position];
+    REQUIRE (trace.name_of (dr_write.id) == "SPI1.DR");
+    REQUIRE (dr_write.write);
+    REQUIRE (dr_write.value == 0xFF);
+    REQUIRE (trace.count ("SPI1.SR", false) >= 2);
+    REQUIRE (trace.count ("TIM6.CNT", false) >= 1);
+
+    // timestamps are in virtual time
+    const auto &accesses = trace.accesses ();
+    REQUIRE (std::is_sorted (accesses.begin (), accesses.end (), [] (const auto &a, const auto &b) {
+      return a.time_ns < b.time_ns;
+    }));
+    REQUIRE (accesses.back ().time_ns == sim.now_ns ());
+    REQUIRE (accesses.back ().time_ns >= mock_spi.frame_time_ns ());
+  }
+
+  SECTION ("I2C address phase")
+  {
+    stm32::mock::I2C mock_i2c;
+    I2C_TypeDef &i2c = *mock_i2c.get_handle ();
+    mock_i2c.init_i2c_responsive_slave (sim, 0x45);
+    trace.name (i2c, "I2C1");
+
+    REQUIRE (stm32::i2c_ref::initialise_slave_device (i2c, 0x45, stm32::i2c_ref::StartType::PROBE)
+             == stm32::i2c_ref::Status::ACK);
+
+    // CR2 is configured in one read-modify-write
+    REQUIRE (trace.count ("I2C1.CR2", false) == 1);
+    REQUIRE (trace.count ("I2C1.CR2", true) == 1);
+    REQUIRE (trace.count ("I2C1.ICR", true) == 1);
+
+    // the slave model sets the ISR flags as the hardware, which isn't traced
+    REQUIRE (trace.count ("I2C1.ISR", true) == 0);
+    REQUIRE (trace.count ("I2C1.ISR", false) >= 1);
+  }
+
+  timer->CR1 = 0;
+}
+
+TEST_CASE ("register_trace - naming and saving", "[register_trace]")
+{
+  std::cout << "register_trace - naming and saving" << std::endl;
+
+  // without a simulation each access is timestamped with its index
+  stm32::mock::RegisterTrace trace;
+  SPI_TypeDef spi;
+  GPIO_TypeDef gpio;
+  USART_TypeDef usart;
+  trace.name (spi, "SPI2");
+  trace.name (gpio, "GPIOA");
+
+  spi.CR1 = SPI_CR1_SPE;
+  [[maybe_unused]] const uint32_t sr = spi.SR;
+  trace.mark ("gpio");
+  gpio.ODR = 1;
+  usart.CR1 = USART_CR1_UE;
+
+  const auto &accesses = trace.accesses ();
+  REQUIRE (accesses.size () == 4);
+  REQUIRE (trace.name_of (accesses[0].id) == "SPI2.CR1");
+  REQUIRE (accesses[0].write);
+  REQUIRE (accesses[0].value == SPI_CR1_SPE);
+  REQUIRE (trace.name_of (accesses[1].id) == "SPI2.SR");
+  REQUIRE_FALSE (accesses[1].write);
+  REQUIRE (accesses[1].time_ns == 1);
+
+  // types without register names are traced by offset, unnamed registers by address
+  REQUIRE (trace.name_of (accesses[2].id) == "GPIOA+0x14");
+  REQUIRE (trace.name_of (accesses[3].id).starts_with ("0x"));
+
+  // naming it later names the earlier accesses too
+  trace.name (usart, "USART2");
+  REQUIRE (trace.name_of (accesses[3].id) == "USART2.CR1");
+
+  std::ostringstream stream;
+  trace.save (stream);
+  const std::string saved = stream.str ();
+  REQUIRE (saved.starts_with ("RTRC\x01"));
+  REQUIRE (saved[5] == static_cast<char> (stm32::mock::RegisterTrace::Tag::NAME));
+  REQUIRE (saved.find ("SPI2.CR1") != std::string::npos);
+  REQUIRE (saved.find ("gpio") != std::string::npos);
+
+  // the last entry: WRITE, delta time 1, USART2.CR1's ID, UE
+  const std::string last{ static_cast<char> (stm32::mock::RegisterTrace::Tag::WRITE), 1,
+                          static_cast<char> (accesses[3].id), 1 };
+  REQUIRE (saved.ends_with (last));
+
+  trace.clear ();
+  REQUIRE (trace.accesses ().empty ());
+  REQUIRE (trace.marks ().empty ());
+}
+
+/// @brief Save traces of some driver paths for tools/register_trace.py, to $REGISTER_TRACE_DIR or else the
+/// system's temporary directory, e.g.
+///   REGISTER_TRACE_DIR=. ./test_suite "[register_trace_dump]"
+///   tools/register_trace.py stats usart_transmit.trace
+///   tools/register_trace.py vcd usart_transmit.trace > usart_transmit.vcd
+TEST_CASE ("register_trace - save driver paths", "[.][register_trace_dump]")
+{
+  stm32::mock::Simulation sim;
+  stm32::mock::Timer mt (sim);
+  TIM_TypeDef *timer = mt.init_timer ();
+
+  USART_TypeDef usart_handle;
+  stm32::mock::USART mock_usart (sim, usart_handle);
+  usart_handle.BRR = 556;
+
+  stm32::mock::RegisterTrace trace (sim);
+  trace.name (*timer, "TIM6");
+  trace.name (usart_handle, "USART2");
+
+  const std::array<uint8_t, 4> message{ 'a', 'b', 'c', 'd' };
+  trace.mark ("enable_usart");
+  REQUIRE (stm32::usart_ref::enable_usart (usart_handle));
+  trace.mark ("transmit_byte");
+  for (const uint8_t byte : message)
+    {
+      REQUIRE (stm32::usart_ref::transmit_byte (usart_handle, byte));
+    }
+  trace.mark ("transmit");
+  REQUIRE (stm32::usart_ref::transmit (usart_handle, message, true));
+
+  const char *trace_dir = std::getenv ("REGISTER_TRACE_DIR");
+  const std::filesystem::path path
+      = ((trace_dir != nullptr) ? std::filesystem::path (trace_dir)
+                                : std::filesystem::temp_directory_path ())
+        / "usart_transmit.trace";
+  std::ofstream file (path, std::ios::binary);
+  REQUIRE (file.is_open ());
+  trace.save (file);
+  std::cout << std::dec << "saved " << trace.accesses ().size () << " accesses to " << path.string () << std::endl;
+
+  timer->CR1 = 0;
+}
@@ -0,0 +1,177 @@
+#include <catch2/catch_all.hpp>
+
+#include <array>
+#include <mock.hpp>
+#include <spi_dma_ref.hpp>
+#include <vector>
+
+namespace
+{
+
+struct EventRecord
+{
+  std::vector<stm32::spi_ref::DmaEvent> events;
+};
+
+void
+record_event (stm32::spi_ref::DmaEvent event, void *context)
+{
+  static_cast<EventRecord *> (context)->events.push_back (event);
+}
+
+// channel 3 flags start at bit 8 of DMA_ISR/DMA_IFCR
+constexpr uint8_t CHANNEL_NUMBER{ 3 };
+constexpr uint32_t FLAG_SHIFT{ 4 * (CHANNEL_NUMBER - 1) };
+
+// mock the DMA controller raising the channel interrupt with the given flags
+void
+raise_irq (DMA_TypeDef &dma, stm32::spi_ref::DmaTransmitter &transmitter,
+           uint32_t channel_flags)
+{
+  dma.ISR = channel_flags << FLAG_SHIFT;
+  transmitter.irq_handler ();
+}
+
+uint32_t
+address_of (const volatile void *ptr)
+{
+  return static_cast<uint32_t> (reinterpret_cast<std::uintptr_t> (ptr));
+}
+
+} // namespace
+
+TEST_CASE ("spi_dma - one-shot transmit", "[spi_dma]")
+{
+  std::cout << "spi_dma - one-shot transmit" << std::endl;
+
+  SPI_TypeDef spi;
+  DMA_TypeDef dma;
+  DMA_Channel_TypeDef channel;
+  stm32::spi_ref::DmaTransmitter transmitter (spi, dma, channel,
+                                              CHANNEL_NUMBER);
+  EventRecord record;
+
+  SECTION ("8-bit frames are sent straight from the caller's buffer")
+  {
+    std::array<uint8_t, 4096> frame{};
+    REQUIRE (transmitter.send (frame, record_event, &record));
+    REQUIRE (transmitter.busy ());
+
+    REQUIRE (channel.CMAR == address_of (frame.data ()));
+    REQUIRE (channel.CPAR == address_of (&spi.DR));
+    REQUIRE (channel.CNDTR == frame.size ());
+    REQUIRE ((channel.CCR & DMA_CCR_EN) == DMA_CCR_EN);
+    REQUIRE ((channel.CCR & DMA_CCR_DIR) == DMA_CCR_DIR);
+    REQUIRE ((channel.CCR & DMA_CCR_MINC) == DMA_CCR_MINC);
+    REQUIRE ((channel.CCR & (DMA_CCR_PSIZE | DMA_CCR_MSIZE)) == 0);
+    REQUIRE ((channel.CCR & (DMA_CCR_CIRC | DMA_CCR_HTIE)) == 0);
+    REQUIRE ((spi.CR2 & SPI_CR2_TXDMAEN) == SPI_CR2_TXDMAEN);
+
+    // only one transmission at a time
+    REQUIRE_FALSE (transmitter.send (frame));
+
+    raise_irq (dma, transmitter, DMA_ISR_GIF1 | DMA_ISR_TCIF1);
+    REQUIRE_FALSE (transmitter.busy ());
+    REQUIRE (transmitter.last_event () == stm32::spi_ref::DmaEvent::COMPLETE);
+    REQUIRE (record.events
+             == std::vector{ stm32::spi_ref::DmaEvent::COMPLETE });
+    REQUIRE ((channel.CCR & DMA_CCR_EN) == 0);
+    REQUIRE ((spi.CR2 & SPI_CR2_TXDMAEN) == 0);
+    REQUIRE (dma.IFCR == (DMA_IFCR_CGIF1 << FLAG_SHIFT));
+  }
+
+  SECTION ("16-bit frames")
+  {
+    std::array<uint16_t, 240> line{};
+    REQUIRE (transmitter.send (line));
+    REQUIRE (channel.CNDTR == line.size ());
+    REQUIRE ((channel.CCR & (DMA_CCR_PSIZE | DMA_CCR_MSIZE))
+             == (DMA_CCR_PSIZE_0 | DMA_CCR_MSIZE_0));
+  }
+
+  SECTION ("transfer error stops the channel")
+  {
+    std::array<uint8_t, 16> frame{};
+    REQUIRE (transmitter.send (frame, record_event, &record));
+    raise_irq (dma, transmitter, DMA_ISR_GIF1 | DMA_ISR_TEIF1);
+    REQUIRE_FALSE (transmitter.busy ());
+    REQUIRE (record.events == std::vector{ stm32::spi_ref::DmaEvent::ERROR });
+    REQUIRE ((channel.CCR & DMA_CCR_EN) == 0);
+  }
+
+  SECTION ("invalid buffer sizes are rejected")
+  {
+    REQUIRE_FALSE (transmitter.send (std::span<const uint8_t>{}));
+    std::vector<uint8_t> too_big (0x10000);
+    REQUIRE_FALSE (transmitter.send (too_big));
+    REQUIRE_FALSE (transmitter.busy ());
+  }
+}
+
+TEST_CASE ("spi_dma - circular double buffer", "[spi_dma]")
+{
+  std::cout << "spi_dma - circular double buffer" << std::endl;
+
+  SPI_TypeDef spi;
+  DMA_TypeDef dma;
+  DMA_Channel_TypeDef channel;
+  stm32::spi_ref::DmaTransmitter transmitter (spi, dma, channel,
+                                              CHANNEL_NUMBER);
+  EventRecord record;
+
+  std::array<uint16_t, 512> frames{};
+  REQUIRE (transmitter.start_circular (frames, record_event, &record));
+  REQUIRE ((channel.CCR & (DMA_CCR_CIRC | DMA_CCR_HTIE))
+           == (DMA_CCR_CIRC | DMA_CCR_HTIE));
+
+  // each half is reported as free while the other is being sent
+  for (int loop = 0; loop < 3; loop++)
+    {
+      raise_irq (dma, transmitter, DMA_ISR_GIF1 | DMA_ISR_HTIF1);
+      REQUIRE (transmitter.last_event ()
+               == stm32::spi_ref::DmaEvent::HALF_COMPLETE);
+      raise_irq (dma, transmitter, DMA_ISR_GIF1 | DMA_ISR_TCIF1);
+      REQUIRE (transmitter.last_event ()
+               == stm32::spi_ref::DmaEvent::COMPLETE);
+      REQUIRE (transmitter.busy ());
+    }
+  REQUIRE (record.events.size () == 6);
+  REQUIRE ((channel.CCR & DMA_CCR_EN) == DMA_CCR_EN);
+
+  transmitter.stop ();
+  REQUIRE_FALSE (transmitter.busy ());
+  REQUIRE ((channel.CCR & DMA_CCR_EN) == 0);
+  REQUIRE ((spi.CR2 & SPI_CR2_TXDMAEN) == 0);
+}
+
+TEST_CASE ("spi_dma - channel number out of range", "[spi_dma]")
+{
+  std::cout << "spi_dma - channel number out of range" << std::endl;
+
+  SPI_TypeDef spi;
+  DMA_TypeDef dma;
+  DMA_Channel_TypeDef channel;
+  std::array<uint8_t, 16> frames{};
+
+  for (const uint8_t channel_number : { 0, 8, 255 })
+    {
+      stm32::spi_ref::DmaTransmitter transmitter (spi, dma, channel,
+                                                  channel_number);
+      REQUIRE_FALSE (transmitter.valid ());
+      REQUIRE_FALSE (transmitter.send (frames));
+      REQUIRE_FALSE (transmitter.start_circular (frames));
+      REQUIRE_FALSE (transmitter.busy ());
+
+      // another channel's flags are left alone
+      dma.ISR = DMA_ISR_GIF1 | DMA_ISR_TCIF1;
+      transmitter.irq_handler ();
+      transmitter.stop ();
+      REQUIRE (dma.IFCR == 0);
+      REQUIRE (channel.CCR == 0);
+      REQUIRE ((spi.CR2 & SPI_CR2_TXDMAEN) == 0);
+    }
+
+  // the full range is accepted
+  REQUIRE (stm32::spi_ref::DmaTransmitter (spi, dma, channel, 1).valid ());
+  REQUIRE (stm32::spi_ref::DmaTransmitter (spi, dma, channel, 7).valid ());
+}
@@ -1,104 +1,102 @@
 #include <catch2/catch_all.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <mock.hpp>
+#include <spi_utils.hpp>
 #include <spi_utils_ref.hpp>
 #include <timer_manager.hpp>
+#include <vector>
 
 TEST_CASE ("spi_utils - send_bytes")
 {
   std::cout << "spi_utils - send_bytes" << std::endl;
 
-  // Enable timer test fixture and start it in a new thread
-  stm32::mock::Timer mt;
-  std::future<bool> tim_res;
-  TIM_TypeDef *timer = nullptr;
-  timer = mt.init_timer (tim_res);
+  // simulated timer and SPI peripheral
+  stm32::mock::Simulation sim;
+  stm32::mock::Timer mt (sim);
+  mt.init_timer ();
 
   // mocked SPI periph
   SPI_TypeDef *spi_handle = new SPI_TypeDef;
+  stm32::mock::SPI mock_spi (sim, *spi_handle);
 
   // setup the periph
   stm32::spi_ref::enable_spi (*spi_handle, true);
   REQUIRE (spi_handle->CR1 & SPI_CR1_SPE_Msk);
 
-  std::future<bool> spi_res
-      = std::async (std::launch::async, mock_spi_data_register, spi_handle);
+  REQUIRE (stm32::spi_ref::send_byte (*spi_handle, 0xFF));
 
-  stm32::spi_ref::send_byte (*spi_handle, 0xFF);
+  // the frame reached the wire, and send_byte() waited for it
+  REQUIRE (mock_spi.frames_sent () == 1);
+  REQUIRE (mock_spi.last_frame () == 0xFF);
+  REQUIRE (sim.now_ns () >= mock_spi.frame_time_ns ());
+  REQUIRE (mock_spi.bus_stats ().wire_time_ns == mock_spi.frame_time_ns ());
 
-  // send_byte should have returned so disable the mock periph to let the
-  // mock_spi_data_register thread end
-  spi_handle->SR = 0;
   stm32::spi_ref::enable_spi (*spi_handle, false);
   REQUIRE_FALSE (spi_handle->CR1 & SPI_CR1_SPE_Msk);
-
-  // check the mock_spi_data_register function returned true
-  REQUIRE (spi_res.get ());
-
-  // don't forget to disable the timer for each SECTION test
-  timer->CR1 = 0;
 }
 
 TEST_CASE ("spi_utils - wait_for_bsy_flag")
 {
   std::cout << "spi_utils - wait_for_bsy_flag" << std::endl;
 
-  // Enable timer test fixture and start it in a new thread
-  stm32::mock::Timer mt;
-  std::future<bool> tim_res;
-  TIM_TypeDef *timer = nullptr;
-  timer = mt.init_timer (tim_res);
+  // simulated timer, so the timeouts take no real time
+  stm32::mock::Simulation sim;
+  stm32::mock::Timer mt (sim);
+  TIM_TypeDef *timer = mt.init_timer ();
 
   SECTION ("wait_for_bsy_flag - SPI_SR_BSY not set")
   {
     SPI_TypeDef *spi_handle = new SPI_TypeDef;
     spi_handle->SR = spi_handle->SR & ~SPI_SR_BSY;
-    REQUIRE (stm32::spi_ref::wait_for_bsy_flag (*spi_handle));
+    REQUIRE (stm32::spi_ref::wait_for_bsy_flag (*spi_handle) == stm32::WaitStatus::READY);
   }
 
   SECTION ("wait_for_bsy_flag - SPI_SR_BSY is set")
   {
     SPI_TypeDef *spi_handle = new SPI_TypeDef;
     spi_handle->SR = spi_handle->SR | SPI_SR_BSY;
-    REQUIRE_FALSE (stm32::spi_ref::wait_for_bsy_flag (*spi_handle));
+    REQUIRE (stm32::spi_ref::wait_for_bsy_flag (*spi_handle) == stm32::WaitStatus::TIMEOUT);
+  }
+
+  SECTION ("wait_for_bsy_flag - SPI_SR_MODF is set")
+  {
+    SPI_TypeDef *spi_handle = new SPI_TypeDef;
+    spi_handle->SR = SPI_SR_BSY | SPI_SR_MODF;
+    REQUIRE (stm32::spi_ref::wait_for_bsy_flag (*spi_handle) == stm32::WaitStatus::ERROR);
+    REQUIRE_FALSE (stm32::spi_ref::send_byte (*spi_handle, 0xFF));
   }
 
   // don't forget to disable the timer for each SECTION test
   timer->CR1 = 0;
-
-  // check the mock_spi_data_register function returned true
-  REQUIRE (tim_res.get ());
 }
 
 TEST_CASE ("spi_utils - wait_for_txe_flag")
 {
   std::cout << "spi_utils - wait_for_txe_flag" << std::endl;
 
-  // Enable timer test fixture and start it in a new thread
-  stm32::mock::Timer mt;
-  std::future<bool> tim_res;
-  TIM_TypeDef *timer = nullptr;
-  timer = mt.init_timer (tim_res);
+  // simulated timer, so the timeouts take no real time
+  stm32::mock::Simulation sim;
+  stm32::mock::Timer mt (sim);
+  TIM_TypeDef *timer = mt.init_timer ();
 
   SECTION ("wait_for_txe_flag - SPI_SR_TXE not set")
   {
     SPI_TypeDef *spi_handle = new SPI_TypeDef;
     spi_handle->SR = spi_handle->SR & ~SPI_SR_TXE;
-    REQUIRE_FALSE (stm32::spi_ref::wait_for_txe_flag (*spi_handle));
+    REQUIRE (stm32::spi_ref::wait_for_txe_flag (*spi_handle) == stm32::WaitStatus::TIMEOUT);
   }
 
   SECTION ("wait_for_txe_flag - SPI_SR_TXE is set")
   {
     SPI_TypeDef *spi_handle = new SPI_TypeDef;
     spi_handle->SR = spi_handle->SR | SPI_SR_TXE;
-    REQUIRE (stm32::spi_ref::wait_for_txe_flag (*spi_handle));
+    REQUIRE (stm32::spi_ref::wait_for_txe_flag (*spi_handle) == stm32::WaitStatus::READY);
   }
 
   // don't forget to disable the timer for each SECTION test
   timer->CR1 = 0;
-
-  // check the mock_spi_data_register function returned true
-  REQUIRE (tim_res.get ());
 }
 
 TEST_CASE ("spi_utils - set_prescaler")
@@ -128,4 +126,250 @@ TEST_CASE ("spi_utils - set_prescaler")
   REQUIRE (stm32::spi_ref::set_prescaler (
       *spi_handle, (SPI_CR1_BR_2 | SPI_CR1_BR_1 | SPI_CR1_BR_0)));
   REQUIRE (spi_handle->CR1 == 56);
-}
\ No newline at end of file
+}
+
+/// @brief The wire time follows the prescaler and data size, so host runs
+/// estimate the bus time of a driver on the target
+TEST_CASE ("spi_utils - bus timing")
+{
+  std::cout << "spi_utils - bus timing" << std::endl;
+
+  stm32::mock::Simulation sim;
+  stm32::mock::Timer mt (sim);
+  TIM_TypeDef *timer = mt.init_timer ();
+
+  SPI_TypeDef *spi_handle = new SPI_TypeDef;
+  stm32::mock::SPI mock_spi (sim, *spi_handle);
+  stm32::spi_ref::enable_spi (*spi_handle, true);
+
+  SECTION ("8-bit frames")
+  {
+    std::vector<uint8_t> tx (16, 0xA5);
+
+    // f_PCLK / 2 after reset: 8 bits at 32MHz
+    REQUIRE (mock_spi.frame_time_ns () == 250);
+    REQUIRE (stm32::spi_ref::send (*spi_handle, tx));
+    stm32::mock::BusStats stats = mock_spi.bus_stats ();
+    std::cout << "  f_PCLK/2: " << stats << std::endl;
+    REQUIRE (stats.bytes == tx.size ());
+    REQUIRE (stats.wire_time_ns == tx.size () * 250);
+    REQUIRE (stats.elapsed_ns >= stats.wire_time_ns);
+
+    // f_PCLK / 16
+    REQUIRE (stm32::spi_ref::set_prescaler (*spi_handle,
+                                            (SPI_CR1_BR_1 | SPI_CR1_BR_0)));
+    REQUIRE (mock_spi.frame_time_ns () == 2000);
+    mock_spi.restart_bus_stats ();
+    REQUIRE (stm32::spi_ref::send (*spi_handle, tx));
+    stats = mock_spi.bus_stats ();
+    std::cout << "  f_PCLK/16: " << stats << std::endl;
+    REQUIRE (stats.wire_time_ns == tx.size () * 2000);
+    REQUIRE (stats.elapsed_ns >= stats.wire_time_ns);
+  }
+
+  SECTION ("16-bit frames")
+  {
+    const std::vector<uint16_t> tx (4, 0x1234);
+    spi_handle->CR2 = (spi_handle->CR2 & ~SPI_CR2_DS) | (0xFU << SPI_CR2_DS_Pos);
+
+    REQUIRE (mock_spi.frame_time_ns () == 500);
+    REQUIRE (stm32::spi_ref::send (*spi_handle, tx));
+    const stm32::mock::BusStats stats = mock_spi.bus_stats ();
+    REQUIRE (stats.bytes == 2 * tx.size ());
+    REQUIRE (stats.wire_time_ns == tx.size () * 500);
+  }
+
+  timer->CR1 = 0;
+}
+
+/// @brief Each frame-width DR write is one frame on the wire, whatever its
+/// value, and frames queued in the TX FIFO are sent in order
+TEST_CASE ("spi_utils - every frame reaches the wire")
+{
+  std::cout << "spi_utils - every frame reaches the wire" << std::endl;
+
+  stm32::mock::Simulation sim;
+  stm32::mock::Timer mt (sim);
+  TIM_TypeDef *timer = mt.init_timer ();
+
+  SPI_TypeDef *spi_handle = new SPI_TypeDef;
+  stm32::mock::SPI mock_spi (sim, *spi_handle);
+  stm32::spi_ref::enable_spi (*spi_handle, true);
+
+  SECTION ("8-bit frames")
+  {
+    const std::vector<uint8_t> tx{ 0x00, 0xA5, 0x00, 0x00, 0x5A, 0x00 };
+    REQUIRE (stm32::spi_ref::send (*spi_handle, tx));
+    REQUIRE (mock_spi.frames () == std::vector<uint32_t>{ 0x00, 0xA5, 0x00, 0x00, 0x5A, 0x00 });
+    REQUIRE (mock_spi.bus_stats ().bytes == tx.size ());
+    REQUIRE (sim.now_ns () >= tx.size () * mock_spi.frame_time_ns ());
+
+    REQUIRE (stm32::spi_ref::send_byte (*spi_handle, 0x00));
+    REQUIRE (mock_spi.frames_sent () == tx.size () + 1);
+    REQUIRE (mock_spi.last_frame () == 0x00);
+
+    // repeats, complements and counts
+    const std::vector<uint8_t> patterns{ 0x55, 0xAA, 0x55, 0xFF, 0x00, 0x01, 0x02, 0x01, 0x01 };
+    REQUIRE (stm32::spi_ref::send (*spi_handle, patterns));
+    REQUIRE (std::equal (patterns.begin (), patterns.end (), mock_spi.frames ().end () - patterns.size ()));
+  }
+
+  SECTION ("16-bit frames")
+  {
+    spi_handle->CR2 = (spi_handle->CR2 & ~SPI_CR2_DS) | (0xFU << SPI_CR2_DS_Pos);
+    const std::vector<uint16_t> tx{ 0x0000, 0x1200, 0x0034, 0x0000 };
+    REQUIRE (stm32::spi_ref::send (*spi_handle, tx));
+    REQUIRE (mock_spi.frames () == std::vector<uint32_t>{ 0x0000, 0x1200, 0x0034, 0x0000 });
+    REQUIRE (mock_spi.bus_stats ().bytes == 2 * tx.size ());
+  }
+
+  timer->CR1 = 0;
+}
+
+// Binds stm32::spi_ref::SpiDevice to a mock register block. Target code uses stm32::spi_ref::Spi<SPI1_BASE> instead.
+struct MockSpiPeripheral
+{
+  static SPI_TypeDef &get ()
+  {
+    static SPI_TypeDef spi;
+    return spi;
+  }
+};
+
+TEST_CASE ("spi_utils - compile-time bound device")
+{
+  std::cout << "spi_utils - compile-time bound device" << std::endl;
+
+  // the fixed-address accessor resolves to the CMSIS peripheral without dereferencing it
+  REQUIRE (&stm32::MmioPeripheral<SPI_TypeDef, SPI1_BASE>::get () == SPI1);
+
+  using Spi = stm32::spi_ref::SpiDevice<MockSpiPeripheral>;
+  SPI_TypeDef &spi_handle = MockSpiPeripheral::get ();
+
+  REQUIRE (Spi::enable_spi ());
+  REQUIRE (spi_handle.CR1 & SPI_CR1_SPE_Msk);
+  REQUIRE (Spi::enable_spi (false));
+  REQUIRE_FALSE (spi_handle.CR1 & SPI_CR1_SPE_Msk);
+
+  REQUIRE (Spi::set_prescaler (SPI_CR1_BR_2 | SPI_CR1_BR_0));
+  REQUIRE (spi_handle.CR1 == 40);
+
+  spi_handle.SR = SPI_SR_TXE;
+  REQUIRE (Spi::wait_for_txe_flag () == stm32::WaitStatus::READY);
+  REQUIRE (Spi::wait_for_bsy_flag () == stm32::WaitStatus::READY);
+
+  SECTION ("pointer wrappers reject null handles")
+  {
+    SPI_TypeDef *null_handle = nullptr;
+    REQUIRE_FALSE (stm32::spi::enable_spi (null_handle));
+    REQUIRE_FALSE (stm32::spi::send_byte (null_handle, 0xFF));
+    REQUIRE (stm32::spi::wait_for_txe_flag (null_handle) == stm32::WaitStatus::ERROR);
+    REQUIRE (stm32::spi::wait_for_bsy_flag (null_handle) == stm32::WaitStatus::ERROR);
+    REQUIRE_FALSE (stm32::spi::set_prescaler (null_handle, SPI_CR1_BR_0));
+  }
+
+  SECTION ("pointer wrappers forward to the same implementation")
+  {
+    REQUIRE (stm32::spi::set_prescaler (&spi_handle, SPI_CR1_BR_1));
+    REQUIRE (spi_handle.CR1 == 16);
+  }
+}
+
+TEST_CASE ("spi_utils - send and transfer buffers")
+{
+  std::cout << "spi_utils - send and transfer buffers" << std::endl;
+
+  // mocked SPI periph: TX FIFO never full, RX FIFO never empty. DR is plain memory so
+  // every frame read back is the frame just written, i.e. MOSI is looped back to MISO.
+  SPI_TypeDef spi_handle;
+  spi_handle.SR = SPI_SR_TXE | SPI_SR_RXNE;
+
+  SECTION ("send 8-bit frames")
+  {
+    const std::array<uint8_t, 5> tx{0x11, 0x22, 0x33, 0x44, 0x55};
+    REQUIRE (stm32::spi_ref::send (spi_handle, tx));
+    REQUIRE (spi_handle.DR == 0x55);
+    REQUIRE (stm32::spi_ref::send (spi_handle, std::span<const uint8_t>{}));
+  }
+
+  SECTION ("send 16-bit frames")
+  {
+    const std::array<uint16_t, 3> tx{0x1234, 0x5678, 0x9ABC};
+    REQUIRE (stm32::spi::send (&spi_handle, tx));
+    REQUIRE (spi_handle.DR == 0x9ABC);
+  }
+
+  SECTION ("transfer 8-bit frames")
+  {
+    const std::array<uint8_t, 9> tx{1, 2, 3, 4, 5, 6, 7, 8, 9};
+    std::array<uint8_t, 9> rx{};
+    REQUIRE (stm32::spi_ref::transfer (spi_handle, tx, rx));
+    REQUIRE (rx == tx);
+    REQUIRE ((spi_handle.CR2 & SPI_CR2_FRXTH) == SPI_CR2_FRXTH);
+  }
+
+  SECTION ("transfer 16-bit frames")
+  {
+    const std::array<uint16_t, 4> tx{0xA1A2, 0xB1B2, 0xC1C2, 0xD1D2};
+    std::array<uint16_t, 4> rx{};
+    REQUIRE (stm32::spi::transfer (&spi_handle, tx, rx));
+    REQUIRE (rx == tx);
+    REQUIRE ((spi_handle.CR2 & SPI_CR2_FRXTH) == 0);
+  }
+
+  SECTION ("transfer rejects mismatched buffers")
+  {
+    const std::array<uint8_t, 2> tx{1, 2};
+    std::array<uint8_t, 3> rx{};
+    REQUIRE_FALSE (stm32::spi_ref::transfer (spi_handle, tx, rx));
+  }
+
+  SECTION ("pointer wrappers reject null handles")
+  {
+    const std::array<uint8_t, 1> tx{1};
+    std::array<uint8_t, 1> rx{};
+    REQUIRE_FALSE (stm32::spi::send (nullptr, tx));
+    REQUIRE_FALSE (stm32::spi::transfer (nullptr, tx, rx));
+  }
+}
+
+TEST_CASE ("spi_utils - wait latency distribution", "[.][wait_latency]")
+{
+  std::cout << "spi_utils - wait latency distribution" << std::endl;
+
+  // simulated timer, so the timeouts take no real time
+  stm32::mock::Simulation sim;
+  stm32::mock::Timer mt (sim);
+  TIM_TypeDef *timer = mt.init_timer ();
+
+  // The mock clears BSY after a varying delay and records the virtual time when it did.
+  // The latency is the time from the flag clearing to wait_for_bsy_flag() returning, in timer ticks.
+  SPI_TypeDef spi_handle;
+  std::vector<uint64_t> latencies;
+  for (uint32_t trial = 0; trial < 40; trial++)
+    {
+      spi_handle.SR = SPI_SR_BSY;
+      uint64_t cleared_at{ 0 };
+      sim.schedule ((trial % 20) * stm32::mock::Timer::m_tick_period_ns, [&] {
+        cleared_at = sim.now_ns ();
+        spi_handle.SR = 0;
+      });
+
+      const stm32::WaitStatus status
+          = stm32::spi_ref::wait_for_bsy_flag (spi_handle, 5000);
+      REQUIRE (status == stm32::WaitStatus::READY);
+      latencies.push_back ((sim.now_ns () - cleared_at)
+                           / stm32::mock::Timer::m_tick_period_ns);
+    }
+
+  std::sort (latencies.begin (), latencies.end ());
+  std::cout << "latency (ticks): min " << latencies.front () << ", median "
+            << latencies[latencies.size () / 2] << ", p90 "
+            << latencies[latencies.size () * 9 / 10] << ", max "
+            << latencies.back () << std::endl;
+
+  // the backoff never leaves more than WAIT_MAX_BACKOFF_US between polls
+  REQUIRE (latencies.back () <= stm32::WAIT_MAX_BACKOFF_US + 1);
+
+  timer->CR1 = 0;
+}
@@ -0,0 +1,119 @@
+#include <catch2/catch_all.hpp>
+#include <static_arena.hpp>
+#include <csignal>
+#include <iostream>
+#include <memory_resource>
+#include <numeric>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace noarch::memory;
+
+// enforce code coverage with explicit instances of class templates so that linker does not drop references
+template class noarch::memory::StaticArena<8>;
+
+TEST_CASE("static_arena - placement allocation", "[static_arena]")
+{
+    std::cout << "static_arena - placement allocation" << std::endl;
+    StaticArena<64> arena;
+
+    uint8_t *byte = arena.create<uint8_t>(uint8_t{0x55});
+    REQUIRE(*byte == 0x55);
+    REQUIRE(arena.used() == 1);
+
+    // padded up to the alignment of the next object
+    uint32_t *word = arena.create<uint32_t>(0xDEADBEEFu);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(word) % alignof(uint32_t) == 0);
+    REQUIRE(arena.used() == 8);
+
+    REQUIRE(arena.try_allocate(56, 1) != nullptr);
+    REQUIRE(arena.try_allocate(1, 1) == nullptr);
+    REQUIRE(arena.failed() == 1);
+    REQUIRE(arena.high_watermark() == 64);
+
+    arena.reset();
+    REQUIRE(arena.used() == 0);
+    REQUIRE(arena.try_allocate(64, 1) != nullptr);
+
+    arena.reset();
+    arena.reset_statistics();
+    REQUIRE(arena.high_watermark() == 0);
+    REQUIRE(arena.failed() == 0);
+}
+
+TEST_CASE("static_arena - memory resource", "[static_arena]")
+{
+    std::cout << "static_arena - memory resource" << std::endl;
+
+    SECTION("pmr containers use the arena")
+    {
+        StaticArena<1024> arena;
+        {
+            std::pmr::vector<uint16_t> samples(&arena);
+            samples.reserve(256);
+            samples.resize(256);
+            std::iota(samples.begin(), samples.end(), 0);
+            std::pmr::vector<uint16_t> sorted(samples.rbegin(), samples.rend(), &arena);
+            std::sort(sorted.begin(), sorted.end());
+            REQUIRE(sorted == samples);
+        }
+        REQUIRE(arena.used() == 1024);
+        REQUIRE(arena.failed() == 0);
+    }
+
+    SECTION("exhaustion aborts by default")
+    {
+        StaticArena<32> arena;
+        std::pmr::memory_resource &resource = arena;
+        REQUIRE(resource.allocate(32, 1) != nullptr);
+        REQUIRE(arena.failed() == 0);
+
+        // the allocation must not return, so make it in a child process
+        pid_t child = fork();
+        REQUIRE(child >= 0);
+        if (child == 0)
+        {
+            // not Catch's handler, which would report the abort as a failure
+            std::signal(SIGABRT, SIG_DFL);
+            [[maybe_unused]] void *unreachable = resource.allocate(1, 1);
+            _exit(0);
+        }
+        int status = 0;
+        REQUIRE(waitpid(child, &status, 0) == child);
+        REQUIRE(WIFSIGNALED(status));
+        REQUIRE(WTERMSIG(status) == SIGABRT);
+        REQUIRE(trapping_null_resource()->is_equal(*trapping_null_resource()));
+    }
+
+    SECTION("exhaustion returns nullptr when opted in")
+    {
+        StaticArena<32> arena(nothrow_null_resource());
+        std::pmr::memory_resource &resource = arena;
+        REQUIRE(resource.allocate(32, 1) != nullptr);
+        REQUIRE(resource.allocate(1, 1) == nullptr);
+        REQUIRE(arena.failed() == 1);
+
+        REQUIRE(nothrow_null_resource()->allocate(1, 1) == nullptr);
+        REQUIRE(nothrow_null_resource()->is_equal(*nothrow_null_resource()));
+    }
+
+    SECTION("exhaustion fails with bad_alloc from the standard null resource")
+    {
+        StaticArena<32> arena(std::pmr::null_memory_resource());
+        std::pmr::vector<uint8_t> buffer(&arena);
+        buffer.reserve(32);
+        REQUIRE_THROWS_AS(buffer.reserve(64), std::bad_alloc);
+        REQUIRE(arena.failed() == 1);
+    }
+
+    SECTION("exhaustion falls back to the upstream resource")
+    {
+        std::pmr::unsynchronized_pool_resource upstream;
+        StaticArena<32> arena(&upstream);
+        std::pmr::vector<uint8_t> buffer(&arena);
+        buffer.resize(64);
+        REQUIRE(arena.failed() == 1);
+        REQUIRE(arena.used() == 0);
+    }
+}
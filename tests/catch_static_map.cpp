@@ -78,3 +78,16 @@ TEST_CASE("Static_map - valid lookup", "[static_map]")
     
 }
 
+
+// Not run by default. Run with: ./build/test_suite "[static_map_benchmark]"
+// Compared against tests/bench_baseline.json by tools/bench_compare.py, see tests/README.md
+TEST_CASE("static_map - benchmark", "[.][benchmark][static_map_benchmark]")
+{
+    // find_key() is a linear search, so the first key is the best case, the last and a missing key the worst
+    StaticMap<int, int, 64> map;
+    for (int idx = 0; idx < 64; idx++) { map.data[idx] = {idx, idx * 10}; }
+
+    BENCHMARK("find_key first of 64") { return map.find_key(0); };
+    BENCHMARK("find_key last of 64") { return map.find_key(63); };
+    BENCHMARK("find_key missing of 64") { return map.find_key(-1); };
+}
@@ -0,0 +1,96 @@
+#include <catch2/catch_all.hpp>
+#include <static_pool.hpp>
+#include <iostream>
+#include <vector>
+
+using namespace noarch::memory;
+
+// enforce code coverage with explicit instances of class templates so that linker does not drop references
+template class noarch::memory::StaticPool<int, 1>;
+
+namespace
+{
+
+struct Message
+{
+    static inline int alive{0};
+
+    Message(uint8_t id, uint32_t payload) : m_id(id), m_payload(payload) { alive++; }
+    ~Message() { alive--; }
+
+    uint8_t m_id;
+    uint32_t m_payload;
+};
+
+} // namespace
+
+TEST_CASE("static_pool - allocate and free", "[static_pool]")
+{
+    std::cout << "static_pool - allocate and free" << std::endl;
+    StaticPool<uint64_t, 4> pool;
+    REQUIRE(pool.capacity() == 4);
+
+    std::vector<void *> slots;
+    for (std::size_t idx = 0; idx < 4; idx++)
+    {
+        void *slot = pool.allocate();
+        REQUIRE(slot != nullptr);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(slot) % alignof(uint64_t) == 0);
+        REQUIRE(pool.owns(slot));
+        slots.push_back(slot);
+    }
+    REQUIRE(pool.in_use() == 4);
+    REQUIRE(pool.allocate() == nullptr);
+    REQUIRE(pool.failed() == 1);
+
+    // the most recently freed slot is reused first
+    pool.deallocate(slots[1]);
+    pool.deallocate(slots[3]);
+    REQUIRE(pool.in_use() == 2);
+    REQUIRE(pool.allocate() == slots[3]);
+    REQUIRE(pool.allocate() == slots[1]);
+    REQUIRE(pool.high_watermark() == 4);
+
+    for (void *slot : slots) { pool.deallocate(slot); }
+    REQUIRE(pool.in_use() == 0);
+    pool.reset_statistics();
+    REQUIRE(pool.high_watermark() == 0);
+    REQUIRE(pool.failed() == 0);
+}
+
+TEST_CASE("static_pool - foreign pointers are ignored", "[static_pool]")
+{
+    std::cout << "static_pool - foreign pointers are ignored" << std::endl;
+    StaticPool<uint32_t, 2> pool;
+    uint32_t local{0};
+    uint8_t *slot = static_cast<uint8_t *>(pool.allocate());
+
+    REQUIRE_FALSE(pool.owns(&local));
+    REQUIRE_FALSE(pool.owns(slot + 1));
+    pool.deallocate(&local);
+    pool.deallocate(slot + 1);
+    pool.deallocate(nullptr);
+    REQUIRE(pool.in_use() == 1);
+}
+
+TEST_CASE("static_pool - create and destroy objects", "[static_pool]")
+{
+    std::cout << "static_pool - create and destroy objects" << std::endl;
+    Message::alive = 0;
+    StaticPool<Message, 2> pool;
+
+    Message *first = pool.create(uint8_t{1}, 0xCAFEu);
+    Message *second = pool.create(uint8_t{2}, 0xBEEFu);
+    REQUIRE(first->m_payload == 0xCAFE);
+    REQUIRE(second->m_id == 2);
+    REQUIRE(pool.create(uint8_t{3}, 0u) == nullptr);
+    REQUIRE(Message::alive == 2);
+
+    pool.destroy(first);
+    REQUIRE(Message::alive == 1);
+    REQUIRE(pool.create(uint8_t{4}, 0u) == first);
+    pool.destroy(first);
+    pool.destroy(second);
+    REQUIRE(Message::alive == 0);
+    REQUIRE(pool.in_use() == 0);
+}
@@ -0,0 +1,197 @@
+#include <catch2/catch_all.hpp>
+#include <static_ring_buffer.hpp>
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <thread>
+
+using namespace noarch::containers;
+
+// enforce code coverage with explicit instances of class templates so that linker does not drop references
+template class noarch::containers::StaticRingBuffer<uint8_t, 1>;
+
+TEST_CASE("static_ring_buffer - single element push and pop", "[static_ring_buffer]")
+{
+    std::cout << "static_ring_buffer - single element push and pop" << std::endl;
+    StaticRingBuffer<int, 4> ring;
+    REQUIRE(ring.empty());
+    REQUIRE(ring.capacity() == 4);
+
+    // run past the end of the storage a few times
+    int expected{0};
+    for (int item = 0; item < 10; item++)
+    {
+        REQUIRE(ring.push(item));
+        if (ring.full())
+        {
+            int popped{-1};
+            REQUIRE(ring.pop(popped));
+            REQUIRE(popped == expected++);
+        }
+    }
+    REQUIRE(ring.size() == 3);
+    REQUIRE(ring.push(10));
+    REQUIRE_FALSE(ring.push(11));
+
+    int popped{-1};
+    while (ring.pop(popped)) { REQUIRE(popped == expected++); }
+    REQUIRE(expected == 11);
+    REQUIRE(ring.empty());
+
+    ring.push(1);
+    ring.reset();
+    REQUIRE(ring.empty());
+}
+
+TEST_CASE("static_ring_buffer - bulk push and pop", "[static_ring_buffer]")
+{
+    std::cout << "static_ring_buffer - bulk push and pop" << std::endl;
+    StaticRingBuffer<uint8_t, 8> ring;
+    std::array<uint8_t, 10> input;
+    std::iota(input.begin(), input.end(), 1);
+    std::array<uint8_t, 10> output{};
+
+    // partial push when there isn't room for everything
+    REQUIRE(ring.push(std::span<const uint8_t>(input.data(), 6)) == 6);
+    REQUIRE(ring.pop(std::span<uint8_t>(output.data(), 4)) == 4);
+    REQUIRE(ring.push(input) == 6);
+    REQUIRE(ring.full());
+
+    // the contents wrap around the end of the storage
+    REQUIRE(ring.pop(output) == 8);
+    REQUIRE(std::vector<uint8_t>(output.begin(), output.begin() + 8) == std::vector<uint8_t>{5, 6, 1, 2, 3, 4, 5, 6});
+    REQUIRE(ring.pop(output) == 0);
+}
+
+TEST_CASE("static_ring_buffer - zero-copy regions", "[static_ring_buffer]")
+{
+    std::cout << "static_ring_buffer - zero-copy regions" << std::endl;
+    StaticRingBuffer<uint8_t, 8> ring;
+
+    // start part way through the storage
+    std::array<uint8_t, 6> skip{};
+    ring.push(skip);
+    ring.pop(std::span<uint8_t>(skip));
+
+    SECTION("write region stops at the end of the storage")
+    {
+        std::span<uint8_t> region = ring.write_region();
+        REQUIRE(region.size() == 2);
+        region[0] = 0xAA;
+        region[1] = 0xBB;
+        ring.commit_write(2);
+
+        region = ring.write_region();
+        REQUIRE(region.size() == 6);
+        region[0] = 0xCC;
+        ring.commit_write(1);
+        REQUIRE(ring.size() == 3);
+
+        uint8_t item{0};
+        REQUIRE((ring.pop(item) && item == 0xAA));
+        REQUIRE((ring.pop(item) && item == 0xBB));
+        REQUIRE((ring.pop(item) && item == 0xCC));
+    }
+
+    SECTION("read region stops at the end of the storage")
+    {
+        const std::array<uint8_t, 5> input{1, 2, 3, 4, 5};
+        ring.push(input);
+
+        std::span<const uint8_t> region = ring.read_region();
+        REQUIRE(std::vector<uint8_t>(region.begin(), region.end()) == std::vector<uint8_t>{1, 2});
+        ring.commit_read(region.size());
+
+        region = ring.read_region();
+        REQUIRE(std::vector<uint8_t>(region.begin(), region.end()) == std::vector<uint8_t>{3, 4, 5});
+        ring.commit_read(1);
+        REQUIRE(ring.size() == 2);
+        // 6 free, but only 5 before the end of the storage
+        REQUIRE(ring.write_region().size() == 5);
+    }
+}
+
+TEST_CASE("static_ring_buffer - concurrent producer and consumer", "[static_ring_buffer]")
+{
+    std::cout << "static_ring_buffer - concurrent producer and consumer" << std::endl;
+    static StaticRingBuffer<uint32_t, 64> ring;
+    ring.reset();
+    constexpr uint32_t total{1000000};
+
+    // the producer mixes single and bulk pushes of varying sizes, the consumer checks nothing is lost or reordered
+    std::thread producer([] {
+        std::array<uint32_t, 13> block;
+        uint32_t next{0};
+        while (next < total)
+        {
+            // yield when full so this also runs on a single core
+            if (ring.full()) { std::this_thread::yield(); }
+            else if (next % 3 == 0) { next += ring.push(next); }
+            else
+            {
+                const std::size_t count = std::min<std::size_t>(1 + (next % block.size()), total - next);
+                std::iota(block.begin(), block.begin() + count, next);
+                next += ring.push(std::span<const uint32_t>(block.data(), count));
+            }
+        }
+    });
+
+    uint32_t expected{0};
+    uint32_t out_of_order{0};
+    std::array<uint32_t, 7> block;
+    while (expected < total)
+    {
+        uint32_t item{0};
+        if (ring.empty()) { std::this_thread::yield(); }
+        else if ((expected % 2 == 0) && ring.pop(item)) { out_of_order += (item != expected++); }
+        else
+        {
+            const std::size_t count = ring.pop(block);
+            for (std::size_t idx = 0; idx < count; idx++) { out_of_order += (block[idx] != expected++); }
+        }
+    }
+    producer.join();
+
+    REQUIRE(out_of_order == 0);
+    REQUIRE(expected == total);
+    REQUIRE(ring.empty());
+}
+
+// Not run by default. Run with: ./build/test_suite "[static_ring_buffer_throughput]"
+TEST_CASE("static_ring_buffer - throughput", "[.][static_ring_buffer_throughput]")
+{
+    static StaticRingBuffer<uint8_t, 1024> ring;
+    constexpr std::size_t total{64 * 1024 * 1024};
+
+    auto run = [](const char *name, std::size_t block_size) {
+        ring.reset();
+        const auto start = std::chrono::steady_clock::now();
+        std::thread producer([block_size] {
+            std::array<uint8_t, 256> block{};
+            std::size_t sent{0};
+            while (sent < total)
+            {
+                if (ring.full()) { std::this_thread::yield(); }
+                else if (block_size == 1) { sent += ring.push(uint8_t{0}); }
+                else { sent += ring.push(std::span<const uint8_t>(block.data(), block_size)); }
+            }
+        });
+        std::array<uint8_t, 256> block{};
+        std::size_t received{0};
+        uint8_t item{0};
+        while (received < total)
+        {
+            if (ring.empty()) { std::this_thread::yield(); }
+            else if (block_size == 1) { received += ring.pop(item); }
+            else { received += ring.pop(std::span<uint8_t>(block.data(), block_size)); }
+        }
+        producer.join();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << name << ": " << (static_cast<double>(total) / elapsed.count() / 1e6) << " MB/s" << std::endl;
+    };
+
+    run("single byte push/pop", 1);
+    run("bulk 32 byte push/pop", 32);
+    run("bulk 256 byte push/pop", 256);
+}
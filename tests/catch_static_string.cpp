@@ -76,3 +76,33 @@ TEST_CASE("static_string - check access operator", "[static_string]")
 
 
 
+
+// Not run by default. Run with: ./build/test_suite "[static_string_benchmark]"
+// Compared against tests/bench_baseline.json by tools/bench_compare.py, see tests/README.md
+TEST_CASE("static_string - benchmark", "[.][benchmark][static_string_benchmark]")
+{
+    StaticString<32> result;
+    StaticString<13> source{"Hello World!"};
+    const std::array<char, 12> source_array{'H', 'e', 'l', 'l', 'o', ' ', 'W', 'o', 'r', 'l', 'd', '!'};
+
+    BENCHMARK("concat string literal")
+    {
+        result.concat(4, "Hello World!");
+        return result[4];
+    };
+    BENCHMARK("concat StaticString")
+    {
+        result.concat(4, source);
+        return result[4];
+    };
+    BENCHMARK("concat std::array")
+    {
+        result.concat(4, source_array);
+        return result[4];
+    };
+    BENCHMARK("concat_int 10 digits")
+    {
+        result.concat_int(4, std::numeric_limits<uint32_t>::max());
+        return result[4];
+    };
+}
@@ -0,0 +1,169 @@
+#include <catch2/catch_all.hpp>
+#include <static_vector.hpp>
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+using namespace noarch::containers;
+
+// enforce code coverage with explicit instances of class templates so that linker does not drop references
+template class noarch::containers::StaticVector<int, 1>;
+
+namespace
+{
+
+// no default constructor, and counts how many instances are alive
+struct Tracked
+{
+    static inline int alive{0};
+
+    explicit Tracked(int value) : m_value(value) { alive++; }
+    Tracked(const Tracked &other) : m_value(other.m_value) { alive++; }
+    Tracked &operator=(const Tracked &other) = default;
+    ~Tracked() { alive--; }
+
+    int m_value;
+};
+
+} // namespace
+
+TEST_CASE("static_vector - elements are only constructed when added", "[static_vector]")
+{
+    std::cout << "static_vector - elements are only constructed when added" << std::endl;
+    Tracked::alive = 0;
+    {
+        StaticVector<Tracked, 4> vector;
+        REQUIRE(vector.empty());
+        REQUIRE(Tracked::alive == 0);
+
+        REQUIRE(vector.emplace_back(1)->m_value == 1);
+        REQUIRE(vector.push_back(Tracked(2)));
+        REQUIRE(vector.emplace_back(3) != nullptr);
+        REQUIRE(vector.emplace_back(4) != nullptr);
+        REQUIRE(vector.full());
+        REQUIRE(vector.emplace_back(5) == nullptr);
+        REQUIRE(Tracked::alive == 4);
+
+        vector.pop_back();
+        REQUIRE(vector.size() == 3);
+        REQUIRE(Tracked::alive == 3);
+
+        StaticVector<Tracked, 4> copy(vector);
+        REQUIRE(copy.size() == 3);
+        REQUIRE(copy[2].m_value == 3);
+        REQUIRE(Tracked::alive == 6);
+
+        copy.clear();
+        REQUIRE(Tracked::alive == 3);
+    }
+    // destroyed with the vector
+    REQUIRE(Tracked::alive == 0);
+}
+
+TEST_CASE("static_vector - erase unordered", "[static_vector]")
+{
+    std::cout << "static_vector - erase unordered" << std::endl;
+
+    SECTION("trivially copyable")
+    {
+        StaticVector<int, 8> vector;
+        const std::array<int, 5> input{10, 11, 12, 13, 14};
+        REQUIRE(vector.append(input) == 5);
+
+        // the last element takes the place of the erased one
+        REQUIRE(vector.erase_unordered(1));
+        REQUIRE(std::vector<int>(vector.begin(), vector.end()) == std::vector<int>{10, 14, 12, 13});
+        REQUIRE(vector.erase_unordered(3));
+        REQUIRE(std::vector<int>(vector.begin(), vector.end()) == std::vector<int>{10, 14, 12});
+        REQUIRE_FALSE(vector.erase_unordered(3));
+    }
+
+    SECTION("non-trivial")
+    {
+        Tracked::alive = 0;
+        StaticVector<Tracked, 4> vector;
+        vector.emplace_back(1);
+        vector.emplace_back(2);
+        vector.emplace_back(3);
+        REQUIRE(vector.erase_unordered(0));
+        REQUIRE(vector[0].m_value == 3);
+        REQUIRE(vector.size() == 2);
+        REQUIRE(Tracked::alive == 2);
+    }
+}
+
+TEST_CASE("static_vector - span conversion", "[static_vector]")
+{
+    std::cout << "static_vector - span conversion" << std::endl;
+    StaticVector<uint8_t, 6> vector;
+
+    // only as many as fit are added
+    const std::array<uint8_t, 8> input{1, 2, 3, 4, 5, 6, 7, 8};
+    REQUIRE(vector.append(input) == 6);
+    REQUIRE(vector.append(input) == 0);
+
+    std::span<uint8_t> view = vector;
+    REQUIRE(view.size() == 6);
+    view[0] = 0xAA;
+    REQUIRE(vector[0] == 0xAA);
+
+    const StaticVector<uint8_t, 6> &const_vector = vector;
+    std::span<const uint8_t> const_view = const_vector;
+    REQUIRE(const_view.data() == vector.data());
+
+    StaticVector<uint8_t, 6> copy;
+    copy = vector;
+    REQUIRE(std::equal(copy.begin(), copy.end(), vector.begin(), vector.end()));
+}
+
+// Not run by default. Run with: ./build/test_suite "[static_vector_benchmark]"
+TEST_CASE("static_vector - benchmark", "[.][static_vector_benchmark]")
+{
+    constexpr std::size_t capacity{256};
+    constexpr std::size_t rounds{20000};
+
+    // fill, sum, then empty by swap-and-pop from the front
+    auto run = [](const char *name, auto &&container_round) {
+        uint64_t checksum{0};
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t round = 0; round < rounds; round++) { checksum += container_round(round); }
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << name << ": " << (elapsed.count() / rounds) << " ns/round (checksum " << checksum << ")" << std::endl;
+    };
+
+    run("StaticVector", [](std::size_t round) {
+        StaticVector<uint32_t, capacity> vector;
+        for (uint32_t idx = 0; idx < capacity; idx++) { vector.push_back(idx + round); }
+        const uint64_t sum = std::accumulate(vector.begin(), vector.end(), uint64_t{0});
+        while (vector.erase_unordered(0)) {}
+        return sum;
+    });
+
+    run("std::array + count", [](std::size_t round) {
+        std::array<uint32_t, capacity> array;
+        std::size_t count{0};
+        for (uint32_t idx = 0; idx < capacity; idx++) { array[count++] = idx + round; }
+        const uint64_t sum = std::accumulate(array.begin(), array.begin() + count, uint64_t{0});
+        while (count > 0)
+        {
+            array[0] = array[count - 1];
+            count--;
+        }
+        return sum;
+    });
+
+    run("std::vector + reserve", [](std::size_t round) {
+        std::vector<uint32_t> vector;
+        vector.reserve(capacity);
+        for (uint32_t idx = 0; idx < capacity; idx++) { vector.push_back(idx + round); }
+        const uint64_t sum = std::accumulate(vector.begin(), vector.end(), uint64_t{0});
+        while (!vector.empty())
+        {
+            vector[0] = vector.back();
+            vector.pop_back();
+        }
+        return sum;
+    });
+}
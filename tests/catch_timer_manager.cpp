@@ -40,58 +40,79 @@ TEST_CASE("Timer Manager - Init and Reset", "[timer_manager]")
     REQUIRE(timer2->CR1 == 1);
 }
 
-/// @brief Thread-based tests for delay_microsecond()
+/// @brief Simulated tests for delay_microsecond()
 TEST_CASE("Timer Manager - microsecond timer", "[timer_manager]")
 {
     std::cout << "timer_manager - microsecond timer" << std::endl;
 
- 
-
     SECTION("Instantiated Input")
     {
-        // start the testfixture that simulates HW timer counter
-        stm32::mock::Timer mt;
-        std::future<bool> tim_res;
-        TIM_TypeDef *timer = nullptr;
-        timer = mt.init_timer(tim_res);
-        
-        // run the SUT; loops until 10ms is reached by timer counter
+        // the timer counter advances with the virtual time of the simulation
+        stm32::mock::Simulation sim;
+        stm32::mock::Timer mt(sim);
+        TIM_TypeDef *timer = mt.init_timer();
+
+        // run the SUT; loops until 10us is reached by timer counter
         REQUIRE(stm32::TimerManager::delay_microsecond(10));
-        
+        REQUIRE(sim.now_ns() == 10 * stm32::mock::Simulation::NS_PER_US);
+
         // SUT has returned so simulate disabling of the HW Timer
         timer->CR1 = 0;
-        
+
         // TIM->CNT should match the time elapsed
         REQUIRE(stm32::TimerManager::get_count() == 10);
-
-        // This will cause the testfixture to also return. Make sure it exited as expected.
-        REQUIRE(tim_res.get());
-    }    
+    }
 }
 
-/// @brief Thread-based tests for delay_millisecond()
+/// @brief Simulated tests for delay_millisecond()
 TEST_CASE("Timer Manager - Systick Delay", "[timer_manager]")
 {
     std::cout << "timer_manager - systick milisecond delay" << std::endl;
 
     // enable the mocked SysTick counter. Systick instance is already declared globally in tests/mocks/stm32g0xx.h
-    stm32::mock::Timer mt;
-    std::future<bool> tim_res;
-    mt.init_timer(tim_res, stm32::mock::TimerType::SYSTICK_TYPE);   
-    
+    stm32::mock::Simulation sim;
+    stm32::mock::Timer mt(sim);
+    mt.init_timer(stm32::mock::TimerType::SYSTICK_TYPE);
+
     // call the SUT function
     SECTION("Zero delay")
     {
         stm32::delay_millisecond(0);
+        REQUIRE(sim.now_ns() == stm32::mock::Timer::m_systick_period_ns);
     }
-    
+
     SECTION("Normal delay")
     {
         stm32::delay_millisecond(10);
-    }    
-    
+        REQUIRE(sim.now_ns() == 10 * stm32::mock::Timer::m_systick_period_ns);
+    }
+
     // disable the mocked SysTick counter
     SysTick->CTRL = SysTick->CTRL & ~(1UL << 0UL);
-    REQUIRE(tim_res.get());
+}
 
-}
\ No newline at end of file
+/// @brief Simulated tests for timeouts longer than the range of the timer count
+TEST_CASE("Timer Manager - Deadline", "[timer_manager]")
+{
+    std::cout << "timer_manager - deadline" << std::endl;
+
+    stm32::mock::Simulation sim;
+    stm32::mock::Timer mt(sim);
+    TIM_TypeDef *timer = mt.init_timer();
+
+    SECTION("has_elapsed clamps to the range of the count")
+    {
+        const uint32_t start_count = stm32::TimerManager::get_count();
+        while (!stm32::TimerManager::has_elapsed(start_count, 100000)) { }
+        REQUIRE(sim.now_ns() == 0xFFFE * stm32::mock::Simulation::NS_PER_US);
+    }
+
+    SECTION("Deadline counts the wraps of the count")
+    {
+        stm32::Deadline deadline(100000);
+        while (!deadline.expired()) { }
+        REQUIRE(sim.now_ns() == 100000 * stm32::mock::Simulation::NS_PER_US);
+    }
+
+    timer->CR1 = 0;
+}
@@ -0,0 +1,219 @@
+#include <catch2/catch_all.hpp>
+
+#include <array>
+#include <cstring>
+#include <mock.hpp>
+#include <string>
+#include <usart_rx_ref.hpp>
+#include <vector>
+
+namespace
+{
+
+struct Chunk
+{
+  const uint8_t *data;
+  std::string text;
+  bool end_of_frame;
+};
+
+void
+record_chunk (std::span<const uint8_t> data, bool end_of_frame, void *context)
+{
+  static_cast<std::vector<Chunk> *> (context)->push_back (
+      { data.data (), std::string (data.begin (), data.end ()),
+        end_of_frame });
+}
+
+constexpr uint8_t CHANNEL_NUMBER{ 2 };
+constexpr uint32_t FLAG_SHIFT{ 4 * (CHANNEL_NUMBER - 1) };
+
+// mock the DMA copying bytes from RDR into the circular buffer
+struct MockDma
+{
+  DMA_Channel_TypeDef &channel;
+  std::span<uint8_t> buffer;
+  std::size_t pos{ 0 };
+
+  void
+  receive (const std::string &bytes)
+  {
+    for (const char c : bytes)
+      {
+        buffer[pos] = static_cast<uint8_t> (c);
+        pos = (pos + 1) % buffer.size ();
+      }
+    channel.CNDTR = static_cast<uint32_t> (buffer.size () - pos);
+  }
+};
+
+} // namespace
+
+TEST_CASE ("usart_rx - DMA circular buffer with idle framing", "[usart_rx]")
+{
+  std::cout << "usart_rx - DMA circular buffer with idle framing"
+            << std::endl;
+
+  USART_TypeDef usart;
+  DMA_TypeDef dma;
+  DMA_Channel_TypeDef channel;
+  std::array<uint8_t, 16> buffer{};
+  std::vector<Chunk> chunks;
+
+  stm32::usart_ref::DmaReceiver rx (usart, dma, channel, CHANNEL_NUMBER,
+                                    buffer, record_chunk, &chunks);
+  REQUIRE (rx.start ());
+  MockDma mock_dma{ channel, buffer };
+
+  REQUIRE (channel.CNDTR == buffer.size ());
+  REQUIRE ((channel.CCR & (DMA_CCR_EN | DMA_CCR_CIRC | DMA_CCR_MINC))
+           == (DMA_CCR_EN | DMA_CCR_CIRC | DMA_CCR_MINC));
+  REQUIRE ((channel.CCR & DMA_CCR_DIR) == 0);
+  REQUIRE ((usart.CR3 & (USART_CR3_DMAR | USART_CR3_EIE))
+           == (USART_CR3_DMAR | USART_CR3_EIE));
+  REQUIRE ((usart.CR1 & USART_CR1_IDLEIE) == USART_CR1_IDLEIE);
+
+  SECTION ("idle line delivers the frame in place")
+  {
+    mock_dma.receive ("hello");
+    usart.ISR = USART_ISR_IDLE;
+    rx.usart_irq_handler ();
+
+    REQUIRE (chunks.size () == 1);
+    REQUIRE (chunks[0].text == "hello");
+    REQUIRE (chunks[0].end_of_frame);
+    REQUIRE (chunks[0].data == buffer.data ());
+    REQUIRE (usart.ICR == USART_ICR_IDLECF);
+
+    mock_dma.receive ("world");
+    rx.usart_irq_handler ();
+    REQUIRE (chunks.size () == 2);
+    REQUIRE (chunks[1].text == "world");
+    REQUIRE (chunks[1].data == buffer.data () + 5);
+  }
+
+  SECTION ("half transfer hands over a long frame before it is overwritten")
+  {
+    mock_dma.receive ("0123456789");
+    dma.ISR = DMA_ISR_HTIF1 << FLAG_SHIFT;
+    rx.dma_irq_handler ();
+    REQUIRE (chunks.size () == 1);
+    REQUIRE (chunks[0].text == "0123456789");
+    REQUIRE_FALSE (chunks[0].end_of_frame);
+
+    // the frame continues round the end of the buffer
+    mock_dma.receive ("ABCDEF");
+    dma.ISR = DMA_ISR_TCIF1 << FLAG_SHIFT;
+    rx.dma_irq_handler ();
+    mock_dma.receive ("GH");
+    usart.ISR = USART_ISR_IDLE;
+    rx.usart_irq_handler ();
+
+    REQUIRE (chunks.size () == 3);
+    REQUIRE (chunks[1].text == "ABCDEF");
+    REQUIRE_FALSE (chunks[1].end_of_frame);
+    REQUIRE (chunks[2].text == "GH");
+    REQUIRE (chunks[2].end_of_frame);
+    REQUIRE (chunks[2].data == buffer.data ());
+  }
+
+  SECTION ("a frame wrapping round between interrupts is split in two")
+  {
+    mock_dma.receive ("0123456789ABCD");
+    usart.ISR = USART_ISR_IDLE;
+    rx.usart_irq_handler ();
+    mock_dma.receive ("wxyz");
+    rx.usart_irq_handler ();
+
+    REQUIRE (chunks.size () == 3);
+    REQUIRE (chunks[1].text == "wx");
+    REQUIRE_FALSE (chunks[1].end_of_frame);
+    REQUIRE (chunks[2].text == "yz");
+    REQUIRE (chunks[2].end_of_frame);
+  }
+
+  SECTION ("idle after everything was delivered closes the frame")
+  {
+    mock_dma.receive ("01234567");
+    dma.ISR = DMA_ISR_HTIF1 << FLAG_SHIFT;
+    rx.dma_irq_handler ();
+    usart.ISR = USART_ISR_IDLE;
+    rx.usart_irq_handler ();
+
+    REQUIRE (chunks.size () == 2);
+    REQUIRE (chunks[1].text.empty ());
+    REQUIRE (chunks[1].end_of_frame);
+
+    // a second idle event has nothing to report
+    rx.usart_irq_handler ();
+    REQUIRE (chunks.size () == 2);
+  }
+
+  SECTION ("line errors are counted and cleared")
+  {
+    usart.ISR = USART_ISR_ORE | USART_ISR_FE;
+    rx.usart_irq_handler ();
+    usart.ISR = USART_ISR_NE | USART_ISR_ORE;
+    rx.usart_irq_handler ();
+
+    REQUIRE (rx.overrun_errors () == 2);
+    REQUIRE (rx.framing_errors () == 1);
+    REQUIRE (rx.noise_errors () == 1);
+    REQUIRE (chunks.empty ());
+  }
+
+  SECTION ("DMA error restarts the receiver")
+  {
+    mock_dma.receive ("abc");
+    dma.ISR = DMA_ISR_TEIF1 << FLAG_SHIFT;
+    channel.CCR = 0;
+    rx.dma_irq_handler ();
+
+    REQUIRE (rx.dma_errors () == 1);
+    REQUIRE ((channel.CCR & DMA_CCR_EN) == DMA_CCR_EN);
+    REQUIRE (channel.CNDTR == buffer.size ());
+  }
+
+  rx.stop ();
+  REQUIRE ((channel.CCR & DMA_CCR_EN) == 0);
+  REQUIRE ((usart.CR3 & USART_CR3_DMAR) == 0);
+}
+
+TEST_CASE ("usart_rx - channel number out of range", "[usart_rx]")
+{
+  std::cout << "usart_rx - channel number out of range" << std::endl;
+
+  USART_TypeDef usart;
+  DMA_TypeDef dma;
+  DMA_Channel_TypeDef channel;
+  std::array<uint8_t, 16> buffer{};
+  std::vector<Chunk> chunks;
+
+  for (const uint8_t channel_number : { 0, 8, 255 })
+    {
+      stm32::usart_ref::DmaReceiver rx (usart, dma, channel, channel_number,
+                                        buffer, record_chunk, &chunks);
+      REQUIRE_FALSE (rx.valid ());
+      REQUIRE_FALSE (rx.start ());
+
+      // another channel's flags are left alone
+      dma.ISR = DMA_ISR_GIF1 | DMA_ISR_HTIF1 | DMA_ISR_TCIF1;
+      usart.ISR = USART_ISR_IDLE | USART_ISR_ORE;
+      rx.dma_irq_handler ();
+      rx.usart_irq_handler ();
+      rx.stop ();
+      REQUIRE (dma.IFCR == 0);
+      REQUIRE (usart.ICR == 0);
+      REQUIRE (channel.CCR == 0);
+      REQUIRE (rx.overrun_errors () == 0);
+      REQUIRE (chunks.empty ());
+    }
+
+  // the full range is accepted
+  REQUIRE (stm32::usart_ref::DmaReceiver (usart, dma, channel, 1, buffer,
+                                          record_chunk, &chunks)
+               .valid ());
+  REQUIRE (stm32::usart_ref::DmaReceiver (usart, dma, channel, 7, buffer,
+                                          record_chunk, &chunks)
+               .valid ());
+}
@@ -0,0 +1,154 @@
+#include <catch2/catch_all.hpp>
+
+#include <atomic>
+#include <mock.hpp>
+#include <numeric>
+#include <thread>
+#include <usart_tx_ref.hpp>
+#include <vector>
+
+namespace
+{
+
+// mock the NVIC: service the TXE interrupt until it is disabled, collecting each byte written to TDR
+std::vector<uint8_t>
+drain (USART_TypeDef &usart, stm32::usart_ref::TransmitBuffer<16> &tx)
+{
+  std::vector<uint8_t> sent;
+  while ((usart.CR1 & USART_CR1_TXEIE_TXFNFIE) == USART_CR1_TXEIE_TXFNFIE)
+    {
+      usart.TDR = 0xFFFF;
+      tx.irq_handler ();
+      if (usart.TDR != 0xFFFF)
+        {
+          sent.push_back (static_cast<uint8_t> (usart.TDR));
+        }
+    }
+  return sent;
+}
+
+std::vector<uint8_t>
+sequence (uint8_t first, std::size_t count)
+{
+  std::vector<uint8_t> data (count);
+  std::iota (data.begin (), data.end (), first);
+  return data;
+}
+
+} // namespace
+
+TEST_CASE ("usart_tx - non-blocking write", "[usart_tx]")
+{
+  std::cout << "usart_tx - non-blocking write" << std::endl;
+
+  USART_TypeDef usart;
+  usart.CR1 = USART_CR1_UE | USART_CR1_TE;
+  usart.ISR = USART_ISR_TXE_TXFNF;
+
+  SECTION ("write returns immediately and the interrupt sends in order")
+  {
+    stm32::usart_ref::TransmitBuffer<16> tx (usart);
+    const std::vector<uint8_t> message = sequence (0x30, 10);
+
+    REQUIRE (tx.write (message) == message.size ());
+    REQUIRE (tx.size () == message.size ());
+    REQUIRE ((usart.CR1 & USART_CR1_TXEIE_TXFNFIE) == USART_CR1_TXEIE_TXFNFIE);
+
+    REQUIRE (drain (usart, tx) == message);
+    REQUIRE (tx.empty ());
+    REQUIRE (tx.high_watermark () == message.size ());
+    REQUIRE (tx.dropped () == 0);
+
+    // the indices wrap around the ring
+    const std::vector<uint8_t> second = sequence (0x50, 12);
+    REQUIRE (tx.write (second) == second.size ());
+    REQUIRE (drain (usart, tx) == second);
+  }
+
+  SECTION ("FIFO mode fills the TX FIFO from one interrupt")
+  {
+    usart.CR1 = usart.CR1 | USART_CR1_FIFOEN;
+    stm32::usart_ref::TransmitBuffer<16> tx (usart);
+    REQUIRE (tx.write (sequence (0, 8)) == 8);
+
+    tx.irq_handler ();
+    REQUIRE (tx.empty ());
+    REQUIRE (usart.TDR == 7);
+    REQUIRE ((usart.CR1 & USART_CR1_TXEIE_TXFNFIE) == 0);
+  }
+
+  SECTION ("DROP discards the bytes that don't fit")
+  {
+    stm32::usart_ref::TransmitBuffer<16> tx (
+        usart, stm32::usart_ref::OverflowPolicy::DROP);
+    REQUIRE (tx.write (sequence (0, 20)) == 16);
+    REQUIRE (tx.dropped () == 4);
+    REQUIRE (tx.high_watermark () == 16);
+    REQUIRE (drain (usart, tx) == sequence (0, 16));
+
+    tx.reset_statistics ();
+    REQUIRE (tx.dropped () == 0);
+    REQUIRE (tx.high_watermark () == 0);
+  }
+
+  SECTION ("OVERWRITE keeps the newest bytes")
+  {
+    stm32::usart_ref::TransmitBuffer<16> tx (
+        usart, stm32::usart_ref::OverflowPolicy::OVERWRITE);
+    REQUIRE (tx.write (sequence (0, 20)) == 20);
+    REQUIRE (tx.dropped () == 4);
+    REQUIRE (drain (usart, tx) == sequence (4, 16));
+  }
+
+  SECTION ("BLOCK gives up if the USART is disabled")
+  {
+    usart.CR1 = 0;
+    stm32::usart_ref::TransmitBuffer<16> tx (
+        usart, stm32::usart_ref::OverflowPolicy::BLOCK);
+    REQUIRE (tx.write (sequence (0, 20)) == 16);
+  }
+}
+
+TEST_CASE ("usart_tx - BLOCK with a concurrent interrupt", "[usart_tx]")
+{
+  std::cout << "usart_tx - BLOCK with a concurrent interrupt" << std::endl;
+
+  USART_TypeDef usart;
+  usart.CR1 = USART_CR1_UE | USART_CR1_TE;
+  usart.ISR = USART_ISR_TXE_TXFNF;
+  stm32::usart_ref::TransmitBuffer<16> tx (
+      usart, stm32::usart_ref::OverflowPolicy::BLOCK);
+
+  const std::vector<uint8_t> message = sequence (0, 200);
+
+  // the mock interrupt runs in its own thread, so write() really has to wait for room
+  std::atomic<bool> done{ false };
+  std::vector<uint8_t> sent;
+  std::thread irq ([&] {
+    while (!done || !tx.empty ())
+      {
+        if ((usart.CR1 & USART_CR1_TXEIE_TXFNFIE) == USART_CR1_TXEIE_TXFNFIE)
+          {
+            usart.TDR = 0xFFFF;
+            tx.irq_handler ();
+            if (usart.TDR != 0xFFFF)
+              {
+                sent.push_back (static_cast<uint8_t> (usart.TDR));
+              }
+          }
+      }
+  });
+
+  std::size_t written{ 0 };
+  for (std::size_t offset = 0; offset < message.size (); offset += 25)
+    {
+      written += tx.write (std::span (message).subspan (offset, 25));
+    }
+  done = true;
+  irq.join ();
+
+  REQUIRE (written == message.size ());
+  REQUIRE (sent == message);
+  REQUIRE (tx.dropped () == 0);
+  REQUIRE (tx.high_watermark () == 16);
+}
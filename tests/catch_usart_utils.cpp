@@ -8,18 +8,17 @@
 TEST_CASE("usart_utils", "[usart_utils]")
 {
     // setup mock TIMER periph (used by usart_utils)
-    stm32::mock::Timer mt;
-    std::future<bool> tim_res;
-    TIM_TypeDef *timer = nullptr;
-    timer = mt.init_timer(tim_res);
+    stm32::mock::Simulation sim;
+    stm32::mock::Timer mt(sim);
+    TIM_TypeDef *timer = mt.init_timer();
 
     
     // setup mock USART periph
     USART_TypeDef *usart_handle = nullptr;
     REQUIRE_FALSE(stm32::usart::enable_usart(usart_handle));
     REQUIRE_FALSE(stm32::usart::transmit_byte(usart_handle, 0));
-    REQUIRE_FALSE(stm32::usart::wait_for_bsy_flag(usart_handle));
-    REQUIRE_FALSE(stm32::usart::wait_for_tc_flag(usart_handle));
+    REQUIRE(stm32::usart::wait_for_bsy_flag(usart_handle) == stm32::WaitStatus::ERROR);
+    REQUIRE(stm32::usart::wait_for_tc_flag(usart_handle) == stm32::WaitStatus::ERROR);
     
     usart_handle = new USART_TypeDef;
     REQUIRE(stm32::usart::enable_usart(usart_handle));
@@ -39,32 +38,191 @@ TEST_CASE("usart_utils", "[usart_utils]")
     {
         std::cout << "usart_utils - wait_for_bsy_flag: USART_ISR_BUSY not set" << std::endl;
         usart_handle->ISR = usart_handle->ISR & ~USART_ISR_BUSY;
-        REQUIRE(stm32::usart::wait_for_bsy_flag(usart_handle));
+        REQUIRE(stm32::usart::wait_for_bsy_flag(usart_handle) == stm32::WaitStatus::READY);
     }
 
     SECTION("usart_utils - wait_for_bsy_flag: USART_ISR_BUSY is set")
     {
         std::cout << "usart_utils - wait_for_bsy_flag: USART_ISR_BUSY is set" << std::endl;
         usart_handle->ISR = usart_handle->ISR | USART_ISR_BUSY;
-        REQUIRE_FALSE(stm32::usart::wait_for_bsy_flag(usart_handle));
+        REQUIRE(stm32::usart::wait_for_bsy_flag(usart_handle) == stm32::WaitStatus::TIMEOUT);
     }
 
     SECTION("usart_utils - wait_for_tc_flag: USART_ISR_TC not set")
     {
         std::cout << "usart_utils - wait_for_tc_flag: USART_ISR_TC not set" << std::endl;
         usart_handle->ISR = usart_handle->ISR & ~USART_ISR_TC;
-        REQUIRE_FALSE(stm32::usart::wait_for_tc_flag(usart_handle));
+        REQUIRE(stm32::usart::wait_for_tc_flag(usart_handle) == stm32::WaitStatus::TIMEOUT);
     }
 
     SECTION("usart_utils - wait_for_tc_flag: USART_ISR_TC is set")
     {
         std::cout << "usart_utils - wait_for_tc_flag: USART_ISR_TC is set" << std::endl;
         usart_handle->ISR = usart_handle->ISR | USART_ISR_TC;
-        REQUIRE(stm32::usart::wait_for_tc_flag(usart_handle));
+        REQUIRE(stm32::usart::wait_for_tc_flag(usart_handle) == stm32::WaitStatus::READY);
     }    
 
+    SECTION("usart_utils - transmit: streams without waiting for TC")
+    {
+        std::cout << "usart_utils - transmit: streams without waiting for TC" << std::endl;
+        const std::array<uint8_t, 4> message {'a', 'b', 'c', 'd'};
+        usart_handle->ISR = USART_ISR_TXE_TXFNF;
+        REQUIRE(stm32::usart::transmit(usart_handle, message));
+        REQUIRE(usart_handle->TDR == 'd');
+
+        // TC is only checked at the end, and only if asked for
+        REQUIRE_FALSE(stm32::usart::transmit(usart_handle, message, true));
+        usart_handle->ISR = USART_ISR_TXE_TXFNF | USART_ISR_TC;
+        REQUIRE(stm32::usart::transmit(usart_handle, message, true));
+    }
+
+    SECTION("usart_utils - transmit: TX FIFO full")
+    {
+        std::cout << "usart_utils - transmit: TX FIFO full" << std::endl;
+        const std::array<uint8_t, 1> message {'a'};
+        usart_handle->ISR = USART_ISR_TC;
+        REQUIRE(stm32::usart::wait_for_txfnf_flag(usart_handle) == stm32::WaitStatus::TIMEOUT);
+        REQUIRE_FALSE(stm32::usart::transmit(usart_handle, message));
+        REQUIRE_FALSE(stm32::usart::transmit(nullptr, message));
+    }
+
+    SECTION("usart_utils - enable_fifo")
+    {
+        std::cout << "usart_utils - enable_fifo" << std::endl;
+        REQUIRE(stm32::usart::enable_fifo(usart_handle));
+        REQUIRE((usart_handle->CR1 & (USART_CR1_FIFOEN | USART_CR1_UE)) == (USART_CR1_FIFOEN | USART_CR1_UE));
+        REQUIRE(stm32::usart::enable_fifo(usart_handle, false));
+        REQUIRE((usart_handle->CR1 & (USART_CR1_FIFOEN | USART_CR1_UE)) == USART_CR1_UE);
+        REQUIRE_FALSE(stm32::usart::enable_fifo(nullptr));
+    }
+
+    SECTION("usart_utils - wait_for_tc_flag: USART disabled")
+    {
+        std::cout << "usart_utils - wait_for_tc_flag: USART disabled" << std::endl;
+        usart_handle->CR1 = usart_handle->CR1 & ~USART_CR1_UE;
+        REQUIRE(stm32::usart::wait_for_tc_flag(usart_handle) == stm32::WaitStatus::ERROR);
+        REQUIRE_FALSE(stm32::usart::transmit_byte(usart_handle, 0));
+    }
+
     // tear down
     timer->CR1 = 0;
-    REQUIRE(tim_res.get());
 }
 
+/// @brief The wire time follows the baud rate and frame format, so host runs
+/// estimate how long the CPU and the line are busy on the target
+TEST_CASE("usart_utils - bus timing", "[usart_utils]")
+{
+    std::cout << "usart_utils - bus timing" << std::endl;
+
+    stm32::mock::Simulation sim;
+    stm32::mock::Timer mt(sim);
+    TIM_TypeDef *timer = mt.init_timer();
+
+    USART_TypeDef *usart_handle = new USART_TypeDef;
+    stm32::mock::USART mock_usart(sim, *usart_handle);
+
+    // 115200 baud from 64MHz, 8N1: 10 bits of 556 clocks
+    usart_handle->BRR = 556;
+    REQUIRE(stm32::usart::enable_usart(usart_handle));
+    REQUIRE(mock_usart.frame_time_ns() == 86875);
+    const std::array<uint8_t, 8> message {'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h'};
+
+    SECTION("transmit without FIFO")
+    {
+        // returns once the last byte is in TDR, with the one before it in the shift register.
+        // Later than the line by however long the backoff in stm32::wait_until() took to see each TXE.
+        REQUIRE(stm32::usart::transmit(usart_handle, message));
+        REQUIRE(sim.now_ns() >= (message.size() - 2) * mock_usart.frame_time_ns());
+
+        REQUIRE(stm32::usart::wait_for_tc_flag(usart_handle, 1000) == stm32::WaitStatus::READY);
+        const stm32::mock::BusStats stats = mock_usart.bus_stats();
+        std::cout << "  8N1 115200: " << stats << std::endl;
+        REQUIRE(mock_usart.bytes_sent() == message.size());
+        REQUIRE(mock_usart.last_byte() == 'h');
+        REQUIRE(stats.wire_time_ns == message.size() * mock_usart.frame_time_ns());
+        REQUIRE(stats.elapsed_ns >= stats.wire_time_ns);
+    }
+
+    SECTION("transmit with FIFO")
+    {
+        // the FIFO and shift register take the whole message, so the CPU is free straight away
+        REQUIRE(stm32::usart::enable_fifo(usart_handle));
+        REQUIRE(stm32::usart::transmit(usart_handle, message));
+        REQUIRE(sim.now_ns() == 0);
+
+        REQUIRE(stm32::usart::transmit(usart_handle, message, true));
+        REQUIRE(sim.now_ns() >= 2 * message.size() * mock_usart.frame_time_ns());
+        REQUIRE(mock_usart.bus_stats().wire_time_ns == 2 * message.size() * mock_usart.frame_time_ns());
+        REQUIRE(mock_usart.bytes_sent() == 2 * message.size());
+    }
+
+    SECTION("transmit_byte at 9600 baud")
+    {
+        // a character takes longer than 1ms, so each wait for TC needs a deadline derived from BRR
+        usart_handle->BRR = 6667;
+        REQUIRE(mock_usart.frame_time_ns() > 1000 * stm32::mock::Simulation::NS_PER_US);
+        REQUIRE(stm32::usart::transmit_byte(usart_handle, 'a'));
+        REQUIRE(stm32::usart::transmit_byte(usart_handle, 'b'));
+        REQUIRE(stm32::usart::transmit_byte(usart_handle, 'c'));
+        REQUIRE(sim.now_ns() >= 2 * mock_usart.frame_time_ns());
+        REQUIRE(stm32::usart::wait_for_tc_flag(usart_handle) == stm32::WaitStatus::READY);
+        REQUIRE(mock_usart.bytes_sent() == 3);
+
+        // the receiver's BUSY flag doesn't hold up the transmitter
+        usart_handle->ISR = usart_handle->ISR | USART_ISR_BUSY;
+        REQUIRE(stm32::usart::transmit_byte(usart_handle, 'd'));
+        REQUIRE(mock_usart.last_byte() == 'd');
+    }
+
+    SECTION("frame format")
+    {
+        // 9 data bits and 2 stop bits: 12 bits
+        usart_handle->CR1 = usart_handle->CR1 | USART_CR1_M0;
+        usart_handle->CR2 = (usart_handle->CR2 & ~USART_CR2_STOP) | USART_CR2_STOP_1;
+        REQUIRE(mock_usart.frame_time_ns() == 104250);
+
+        // oversampling by 8 at the same USARTDIV halves the bit time
+        usart_handle->CR1 = usart_handle->CR1 | USART_CR1_OVER8;
+        usart_handle->BRR = (556 & 0xFFF0) | ((556 & 0xF) >> 1);
+        REQUIRE(mock_usart.frame_time_ns() == 52125);
+    }
+
+    timer->CR1 = 0;
+}
+
+// Binds stm32::usart_ref::UsartDevice to a mock register block. Target code uses stm32::usart_ref::Usart<USART5_BASE> instead.
+struct MockUsartPeripheral
+{
+    static USART_TypeDef &get()
+    {
+        static USART_TypeDef usart;
+        return usart;
+    }
+};
+
+TEST_CASE("usart_utils - compile-time bound device", "[usart_utils]")
+{
+    std::cout << "usart_utils - compile-time bound device" << std::endl;
+
+    // setup mock TIMER periph (used by usart_utils)
+    stm32::mock::Simulation sim;
+    stm32::mock::Timer mt(sim);
+    TIM_TypeDef *timer = mt.init_timer();
+
+    using Usart = stm32::usart_ref::UsartDevice<MockUsartPeripheral>;
+    USART_TypeDef &usart_handle = MockUsartPeripheral::get();
+
+    REQUIRE(Usart::enable_usart());
+    REQUIRE(usart_handle.CR1 & USART_CR1_UE_Msk);
+
+    usart_handle.ISR = USART_ISR_TC;
+    REQUIRE(Usart::transmit_byte(0x5A));
+    REQUIRE(usart_handle.TDR == 0x5A);
+
+    usart_handle.ISR = USART_ISR_BUSY;
+    REQUIRE(Usart::wait_for_bsy_flag() == stm32::WaitStatus::TIMEOUT);
+    REQUIRE(Usart::wait_for_tc_flag() == stm32::WaitStatus::TIMEOUT);
+
+    // tear down
+    timer->CR1 = 0;
+}
@@ -24,9 +24,12 @@
 #ifndef __MOCK_HPP__
 #define __MOCK_HPP__
 
+#include <mock_sim.hpp>
+#include <mock_bus.hpp>
 #include <mock_spi.hpp>
 #include <mock_tim.hpp>
 #include <mock_i2c.hpp>
+#include <mock_usart.hpp>
 
 // misc deps
 #include <iomanip>
@@ -0,0 +1,107 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <mock_bus.hpp>
+
+#include <iomanip>
+
+namespace stm32::mock
+{
+
+namespace
+{
+
+constexpr uint64_t NS_PER_S{1000000000};
+
+} // namespace
+
+uint64_t spi_frame_time_ns(const SPI_TypeDef &spi_handle, uint32_t pclk_hz)
+{
+    // DS below 4 bits is reserved and reads as 8 bits
+    uint64_t bits = ((spi_handle.CR2.raw() & SPI_CR2_DS_Msk) >> SPI_CR2_DS_Pos) + 1;
+    if (bits < 4) { bits = 8; }
+
+    const uint64_t prescaler = 2ULL << ((spi_handle.CR1.raw() & SPI_CR1_BR_Msk) >> SPI_CR1_BR_Pos);
+    return (bits * prescaler * NS_PER_S) / pclk_hz;
+}
+
+uint64_t usart_frame_time_ns(const USART_TypeDef &usart_handle, uint32_t pclk_hz)
+{
+    const uint32_t cr1 = usart_handle.CR1.raw();
+
+    // M[1:0] = 00: 8 bits, 01: 9 bits, 10: 7 bits
+    uint64_t word_bits = 8;
+    if ((cr1 & USART_CR1_M1) == USART_CR1_M1) { word_bits = 7; }
+    else if ((cr1 & USART_CR1_M0) == USART_CR1_M0) { word_bits = 9; }
+
+    // STOP = 00: 1 bit, 01: 0.5 bit, 10: 2 bits, 11: 1.5 bits. Count in half bits.
+    constexpr uint64_t stop_half_bits[] = {2, 1, 4, 3};
+    const uint64_t half_bits = (2 * (1 + word_bits)) + stop_half_bits[(usart_handle.CR2.raw() & USART_CR2_STOP_Msk) >> USART_CR2_STOP_Pos];
+
+    const uint64_t brr = usart_handle.BRR.raw() & 0xFFFF;
+    if ((cr1 & USART_CR1_OVER8) == USART_CR1_OVER8)
+    {
+        // BRR[2:0] holds USARTDIV[3:0] shifted right, baud = 2 * f_CK / USARTDIV
+        const uint64_t usartdiv = (brr & 0xFFF0) | ((brr & 0x7) << 1);
+        return (half_bits * usartdiv * NS_PER_S) / (4ULL * pclk_hz);
+    }
+
+    // baud = f_CK / USARTDIV
+    return (half_bits * brr * NS_PER_S) / (2ULL * pclk_hz);
+}
+
+uint64_t i2c_scl_period_ns(const I2C_TypeDef &i2c_handle, uint32_t i2cclk_hz)
+{
+    const uint32_t timingr = i2c_handle.TIMINGR.raw();
+    const uint64_t presc = ((timingr & I2C_TIMINGR_PRESC_Msk) >> I2C_TIMINGR_PRESC_Pos) + 1;
+    const uint64_t scll = ((timingr & I2C_TIMINGR_SCLL_Msk) >> I2C_TIMINGR_SCLL_Pos) + 1;
+    const uint64_t sclh = ((timingr & I2C_TIMINGR_SCLH_Msk) >> I2C_TIMINGR_SCLH_Pos) + 1;
+    return ((scll + sclh) * presc * NS_PER_S) / i2cclk_hz;
+}
+
+double BusStats::utilization() const
+{
+    if (elapsed_ns == 0) { return 0.0; }
+    return static_cast<double>(wire_time_ns) / static_cast<double>(elapsed_ns);
+}
+
+double BusStats::bytes_per_second() const
+{
+    if (elapsed_ns == 0) { return 0.0; }
+    return (static_cast<double>(bytes) * NS_PER_S) / static_cast<double>(elapsed_ns);
+}
+
+std::ostream &operator<<(std::ostream &os, const BusStats &stats)
+{
+    const std::ios_base::fmtflags flags = os.flags();
+    const std::streamsize precision = os.precision();
+    os << std::dec << std::fixed << std::setprecision(3) << stats.bytes << " bytes, wire time "
+       << (static_cast<double>(stats.wire_time_ns) / 1000.0) << "us of "
+       << (static_cast<double>(stats.elapsed_ns) / 1000.0) << "us (" << std::setprecision(1)
+       << (stats.utilization() * 100.0) << "% utilization)";
+    os.flags(flags);
+    os.precision(precision);
+    return os;
+}
+
+} // namespace stm32::mock
@@ -0,0 +1,107 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __MOCK_BUS_HPP__
+#define __MOCK_BUS_HPP__
+
+#include <stm32g0xx.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace stm32::mock
+{
+
+/// @brief Wire timing of the serial peripherals, derived from their configuration registers the way the
+/// reference manual does. Each takes the kernel clock of the peripheral, e.g. SystemCoreClock when PCLK is
+/// not divided. Synchronisation delays of a few kernel clocks are not modelled.
+/// @{
+
+/// @brief One SPI frame: the data size (CR2 DS) clocked out at f_PCLK / 2^(BR + 1) (CR1 BR, see set_prescaler())
+uint64_t spi_frame_time_ns(const SPI_TypeDef &spi_handle, uint32_t pclk_hz);
+
+/// @brief One USART character: start bit, word length (CR1 M1/M0, including any parity bit) and stop bits
+/// (CR2 STOP) at the baud rate set by BRR, oversampling by 16 or 8 (CR1 OVER8)
+uint64_t usart_frame_time_ns(const USART_TypeDef &usart_handle, uint32_t pclk_hz);
+
+/// @brief One SCL period: SCLL + SCLH low/high periods of the prescaled I2C clock (TIMINGR)
+uint64_t i2c_scl_period_ns(const I2C_TypeDef &i2c_handle, uint32_t i2cclk_hz);
+
+/// @}
+
+/// @brief Bus activity over a measurement window
+struct BusStats
+{
+    /// @brief The bytes put on the wire (address bytes included)
+    std::size_t bytes{0};
+    /// @brief The time the wire was busy
+    uint64_t wire_time_ns{0};
+    /// @brief The length of the measurement window
+    uint64_t elapsed_ns{0};
+
+    /// @brief The fraction of the window the wire was busy, 0 to 1
+    double utilization() const;
+
+    /// @brief The bytes sent per second of the window
+    double bytes_per_second() const;
+};
+
+/// @brief e.g. "12 bytes, wire time 96.000us of 120.000us (80.0% utilization)"
+std::ostream &operator<<(std::ostream &os, const BusStats &stats);
+
+/// @brief Accumulates the wire time of a peripheral model. The models only put one frame on the wire at a
+/// time, so the busy periods never overlap.
+class BusMonitor
+{
+public:
+    /// @brief Count a frame of bytes that keeps the wire busy for duration_ns
+    void record(uint64_t duration_ns, std::size_t bytes)
+    {
+        m_stats.wire_time_ns += duration_ns;
+        m_stats.bytes += bytes;
+    }
+
+    /// @brief Forget the activity so far and start a new window at now_ns
+    void restart(uint64_t now_ns)
+    {
+        m_stats = BusStats{};
+        m_start_ns = now_ns;
+    }
+
+    /// @brief The activity from the start of the window to now_ns
+    BusStats stats(uint64_t now_ns) const
+    {
+        BusStats result{m_stats};
+        result.elapsed_ns = now_ns - m_start_ns;
+        return result;
+    }
+
+private:
+    BusStats m_stats;
+    uint64_t m_start_ns{0};
+};
+
+} // namespace stm32::mock
+
+#endif // __MOCK_BUS_HPP__
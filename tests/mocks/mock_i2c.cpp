@@ -23,102 +23,211 @@
 #include <mock_i2c.hpp>
 
 #include <iostream>
-#include <chrono>
 #include <array>
 #include <string>
-#include <thread>
 
 #include <mock_fuse.hpp>
+#include <mock_tim.hpp>
 
 
-using namespace std::chrono_literals;
-
 namespace stm32::mock
 {
 
-I2C::I2C()
+I2C::I2C(uint32_t i2cclk_hz) : m_i2cclk_hz(i2cclk_hz)
 {
 
     i2c_handle = new I2C_TypeDef;
     i2c_handle->CR1 = i2c_handle->CR1 | I2C_CR1_PE_Msk;
 }
 
-void I2C::init_i2c_tx_fifo(std::future<bool> &tx_fifo_future, SlaveStatus expected_slave_response)
+void I2C::attach(Simulation &sim)
+{
+    if (m_sim == &sim) { return; }
+    m_sim = &sim;
+    m_bus.restart(sim.now_ns());
+}
+
+void I2C::init_i2c_tx_fifo(Simulation &sim, SlaveStatus expected_slave_response)
+{
+    attach(sim);
+
+    // reset the register to prevent false positive
+    i2c_handle->ISR = i2c_handle->ISR & ~I2C_ISR_TXE;
+
+    sim.on_write(i2c_handle->TXDR, [this, &sim, expected_slave_response](uint32_t) {
+        const uint64_t duration_ns = BYTE_SCL_PERIODS * scl_period_ns();
+        sim.schedule(duration_ns, [this, expected_slave_response, duration_ns] {
+            m_bus.record(duration_ns, 1);
+            // the TX FIFO has emptied
+            i2c_handle->TXDR.raw() = 0;
+            i2c_handle->ISR.raw() = i2c_handle->ISR.raw() | I2C_ISR_TXE;
+            // simulate unhappy slave device, if requested by unit test
+            if (expected_slave_response == SlaveStatus::NACK) { i2c_handle->ISR.raw() = i2c_handle->ISR.raw() | I2C_ISR_NACKF_Msk; }
+        });
+    });
+}
+
+void I2C::init_i2c_start_condition(Simulation &sim, uint8_t expected_address)
 {
-    tx_fifo_future = std::async(std::launch::async, mock_i2c_tx_fifo_empty, i2c_handle, expected_slave_response);
+    sim.on_write(i2c_handle->CR2, [this, expected_address, answered = false](uint32_t value) mutable {
+        if (answered || ((value & I2C_CR2_START_Msk) != I2C_CR2_START_Msk)) { return; }
+        answered = true;
+        answer_address(expected_address);
+    });
 }
 
-void I2C::init_i2c_start_condition(std::future<bool> &start_condition_future, uint8_t expected_address)
+void I2C::init_i2c_slave_device(Simulation &sim, stm32::i2c_ref::TransferEngine &engine, uint8_t expected_address, std::span<uint8_t> slave_memory)
 {
-    start_condition_future = std::async(std::launch::async, mock_i2c_start_condition_generation, i2c_handle, expected_address);
+    attach(sim);
+    m_slave = SlaveDevice{&engine, expected_address, slave_memory};
+
+    sim.on_write(i2c_handle->CR2, [this](uint32_t value) {
+        if ((value & I2C_CR2_START_Msk) != I2C_CR2_START_Msk) { return; }
+
+        // START is cleared by hardware once the address is sent
+        i2c_handle->CR2.raw() = i2c_handle->CR2.raw() & ~I2C_CR2_START_Msk;
+        schedule_slave(ADDRESS_SCL_PERIODS, [this] { slave_address_phase(); });
+    });
+
+    // clearing PE resets the peripheral
+    sim.on_write(i2c_handle->CR1, [this](uint32_t value) {
+        if ((value & I2C_CR1_PE_Msk) == 0) { m_slave.generation++; }
+    });
+}
+
+void I2C::init_i2c_responsive_slave(Simulation &sim, uint8_t expected_address)
+{
+    attach(sim);
+
+    sim.on_write(i2c_handle->CR2, [this, &sim, expected_address](uint32_t value) {
+        if ((value & I2C_CR2_START_Msk) != I2C_CR2_START_Msk) { return; }
+
+        // START is cleared by hardware once the address is sent
+        i2c_handle->CR2.raw() = i2c_handle->CR2.raw() & ~I2C_CR2_START_Msk;
+        const uint64_t duration_ns = ADDRESS_SCL_PERIODS * scl_period_ns();
+        sim.schedule(duration_ns, [this, expected_address, duration_ns] {
+            m_bus.record(duration_ns, 1);
+            answer_address(expected_address);
+        });
+    });
+
+    // each ICR bit clears the ISR flag in the same position
+    sim.on_write(i2c_handle->ICR, [this](uint32_t value) {
+        i2c_handle->ISR.raw() = i2c_handle->ISR.raw() & ~value;
+        i2c_handle->ICR.raw() = 0;
+    });
 }
 
-/// @brief Mock function to test stm32::i2c::initalise_slave_device()
-/// @param i2c_handle The mocked i2c peripheral
-/// @return true if unit test disables the peripheral (upon test completion), false if i2c_handle is null_ptr
-bool inline I2C::mock_i2c_start_condition_generation(I2C_TypeDef *i2c_handle, uint8_t expected_addr)
+void I2C::answer_address(uint8_t expected_address)
 {
-    if (i2c_handle == nullptr)
+    m_address_matched = (i2c_handle->CR2.raw() & I2C_CR2_SADD_Msk) == expected_address;
+    if (m_address_matched) { mock_i2c_address_acknowledged(i2c_handle); }
+    else { i2c_handle->ISR.raw() = i2c_handle->ISR.raw() | I2C_ISR_NACKF_Msk; }
+}
+
+void I2C::mock_i2c_address_acknowledged(I2C_TypeDef *i2c_handle)
+{
+    const uint32_t nbytes = (i2c_handle->CR2 & I2C_CR2_NBYTES_Msk) >> I2C_CR2_NBYTES_Pos;
+    if (nbytes == 0)
     {
-        return false;
+        // nothing to transfer: STOP with AUTOEND, otherwise wait for software with TC
+        if ((i2c_handle->CR2 & I2C_CR2_AUTOEND_Msk) == I2C_CR2_AUTOEND_Msk) { i2c_handle->ISR = i2c_handle->ISR | I2C_ISR_STOPF_Msk; }
+        else { i2c_handle->ISR = i2c_handle->ISR | I2C_ISR_TC_Msk; }
     }
-    // loop while peripheral is enabled
-    while((i2c_handle->CR1 & I2C_CR1_PE_Msk) == I2C_CR1_PE_Msk)
+    else if ((i2c_handle->CR2 & I2C_CR2_RD_WRN_Msk) == I2C_CR2_RD_WRN_Msk)
     {
-        // start condition was generated
-        if ((i2c_handle->CR2 & I2C_CR2_START_Msk) == I2C_CR2_START_Msk)
-        { 
-            if ((i2c_handle->CR2 & I2C_CR2_SADD_Msk) == expected_addr)
-            {
-                // expected address was used
-                return true;
-            }
-            else
-            {
-                // UNexpected address was used
-                i2c_handle->ISR = i2c_handle->ISR | I2C_ISR_NACKF_Msk;
-                return false;
-            }
-        }
+        // first byte received from the slave
+        i2c_handle->ISR = i2c_handle->ISR | I2C_ISR_RXNE_Msk;
+    }
+    else
+    {
+        // ready for the first byte to transmit
+        i2c_handle->ISR = i2c_handle->ISR | I2C_ISR_TXIS_Msk;
     }
+}
 
-    return true;
+void I2C::schedule_slave(uint64_t scl_periods, Simulation::Action action)
+{
+    const uint64_t duration_ns = scl_periods * scl_period_ns();
+    m_sim->schedule(duration_ns, [this, action, duration_ns, generation = m_slave.generation] {
+        if (generation != m_slave.generation) { return; }
+        m_bus.record(duration_ns, 1);
+        action();
+    });
 }
 
-/// @brief Mock function to test stm32::i2c::send_byte()
-/// @param i2c_handle The mocked i2c peripheral
-/// @return true if unit test disables the peripheral (upon test completion), false if i2c_handle is null_ptr
-bool inline I2C::mock_i2c_tx_fifo_empty(I2C_TypeDef *i2c_handle, SlaveStatus slave_status)
+void I2C::slave_raise_irq(uint32_t isr_flags, Simulation::Action then)
 {
+    // the hardware stretches SCL until the interrupt is serviced
+    constexpr uint32_t irq_mask = I2C_CR1_TXIE | I2C_CR1_RXIE | I2C_CR1_TCIE | I2C_CR1_NACKIE | I2C_CR1_STOPIE | I2C_CR1_ERRIE;
+    if ((i2c_handle->CR1.raw() & irq_mask) == 0)
+    {
+        schedule_slave(1, [this, isr_flags, then] { slave_raise_irq(isr_flags, then); });
+        return;
+    }
 
+    i2c_handle->ISR.raw() = isr_flags;
+    m_sim->interrupt([this] { m_slave.engine->irq_handler(); });
+    i2c_handle->ISR.raw() = 0;
+    then();
+}
 
-    // input check
-    if (i2c_handle == nullptr) { return false; }
-    // reset the register to prevent false positive
-    i2c_handle->ISR = i2c_handle->ISR & ~I2C_ISR_TXE;
+void I2C::slave_address_phase()
+{
+    const uint32_t cr2 = i2c_handle->CR2.raw();
+    if ((cr2 & I2C_CR2_SADD_Msk) != m_slave.address)
+    {
+        // NACK is followed by an automatic STOP
+        slave_raise_irq(I2C_ISR_NACKF, [this] { slave_raise_irq(I2C_ISR_STOPF, [] {}); });
+        return;
+    }
+
+    m_slave.reading     = (cr2 & I2C_CR2_RD_WRN_Msk) == I2C_CR2_RD_WRN_Msk;
+    m_slave.first_write = true;
+    m_slave.remaining   = (cr2 & I2C_CR2_NBYTES_Msk) >> I2C_CR2_NBYTES_Pos;
+    slave_next_byte();
+}
 
-    // loop while peripheral is enabled
-    while((i2c_handle->CR1 & I2C_CR1_PE_Msk) == I2C_CR1_PE_Msk)
+void I2C::slave_next_byte()
+{
+    if (m_slave.remaining == 0)
     {
-        // wait test bytes to be copied into TX FIFO
-        if (i2c_handle->TXDR != 0)
+        const uint32_t cr2 = i2c_handle->CR2.raw();
+        if ((cr2 & I2C_CR2_RELOAD_Msk) == I2C_CR2_RELOAD_Msk)
         {
-            
-            std::this_thread::sleep_for(1us);
-            // mock the emptying of the TX FIFO
-            i2c_handle->TXDR = 0;
-            // mock the signaling that the TX FIFO is empty
-            i2c_handle->ISR = i2c_handle->ISR | I2C_ISR_TXE;
-            std::this_thread::sleep_for(1us);
-            // simulate unhappy slave device, if requested by unit test
-            if (slave_status == SlaveStatus::NACK) { i2c_handle->ISR = i2c_handle->ISR | I2C_ISR_NACKF_Msk; }
-            
+            // the engine loads the next NBYTES chunk
+            slave_raise_irq(I2C_ISR_TCR, [this] {
+                m_slave.remaining = (i2c_handle->CR2.raw() & I2C_CR2_NBYTES_Msk) >> I2C_CR2_NBYTES_Pos;
+                slave_next_byte();
+            });
         }
+        // either STOP or wait for the restart
+        else if ((cr2 & I2C_CR2_AUTOEND_Msk) == I2C_CR2_AUTOEND_Msk) { slave_raise_irq(I2C_ISR_STOPF, [] {}); }
+        else { slave_raise_irq(I2C_ISR_TC, [] {}); }
+        return;
     }
 
-    return true;
+    m_slave.remaining--;
+    schedule_slave(BYTE_SCL_PERIODS, [this] {
+        std::span<uint8_t> memory = m_slave.memory;
+        if (m_slave.reading)
+        {
+            i2c_handle->RXDR.raw() = memory[m_slave.mem_idx++ % memory.size()];
+            slave_raise_irq(I2C_ISR_RXNE, [this] { slave_next_byte(); });
+            return;
+        }
+        slave_raise_irq(I2C_ISR_TXIS, [this, memory] {
+            const uint8_t tx_byte = i2c_handle->TXDR.raw() & 0xFF;
+            if (m_slave.first_write)
+            {
+                m_slave.mem_idx     = tx_byte;
+                m_slave.first_write = false;
+            }
+            else { memory[m_slave.mem_idx++ % memory.size()] = tx_byte; }
+            slave_next_byte();
+        });
+    });
 }
 
-
 } // namespace stm32::mock
     
\ No newline at end of file
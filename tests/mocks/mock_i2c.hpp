@@ -23,7 +23,10 @@
 #ifndef __MOCK_I2C_HPP__
 #define __MOCK_I2C_HPP__
 
-#include <future>
+#include <i2c_transfer_ref.hpp>
+#include <mock_bus.hpp>
+#include <mock_sim.hpp>
+#include <span>
 #include <stm32g0xx.h>
 
 namespace stm32::mock
@@ -39,26 +42,73 @@ class I2C
 {
 
 public:
-  I2C ();
-
-  void init_i2c_tx_fifo (std::future<bool> &tx_fifo_future,
-                         SlaveStatus expected_slave_response);
-  void init_i2c_start_condition (std::future<bool> &start_condition_future,
-                                 uint8_t expected_address);
-
-  /// @brief Mock function to test stm32::i2c::initalise_slave_device()
+  /// @brief SCL periods taken by a data byte and its ACK
+  static constexpr uint64_t BYTE_SCL_PERIODS{ 9 };
+  /// @brief SCL periods taken by the START condition, address byte and ACK
+  static constexpr uint64_t ADDRESS_SCL_PERIODS{ 10 };
+
+  /// @param i2cclk_hz The I2C kernel clock, prescaled by TIMINGR to give SCL
+  explicit I2C (uint32_t i2cclk_hz = SystemCoreClock);
+
+  /// @brief Model the transmit data register for stm32::i2c_ref::send_byte().
+  /// A byte written to TXDR is sent over BYTE_SCL_PERIODS of the SCL period
+  /// set by TIMINGR, then TXDR empties and TXE is set, with NACKF if the slave
+  /// refuses the byte.
+  /// @param sim The simulation to run in
+  /// @param expected_slave_response Whether the slave ACKs or NACKs each byte
+  void init_i2c_tx_fifo (Simulation &sim, SlaveStatus expected_slave_response);
+
+  /// @brief Model the address phase for
+  /// stm32::i2c_ref::initialise_slave_device(). The first START sets the flag
+  /// for the first data byte if SADD is the expected address, else NACKF.
+  /// START is left set and later ones are ignored.
+  /// @param sim The simulation to run in
+  /// @param expected_address The address of the slave device
+  void init_i2c_start_condition (Simulation &sim, uint8_t expected_address);
+
+  /// @brief Model a slave device that answers every address phase after
+  /// ADDRESS_SCL_PERIODS of the SCL period set by TIMINGR. Unlike
+  /// init_i2c_start_condition() this serves repeated transactions: START is
+  /// cleared by the hardware once the address is sent, and writes to ICR clear
+  /// the matching ISR flags.
+  /// @param sim The simulation to run in
+  /// @param expected_address The address of the slave device, others are NACKed
+  void init_i2c_responsive_slave (Simulation &sim, uint8_t expected_address);
+
+  /// @brief Model a register-addressed slave device (e.g. EEPROM) driven
+  /// through stm32::i2c_ref::TransferEngine. Acts as the I2C hardware and NVIC:
+  /// each bus event is scheduled after its SCL periods at the timing set by
+  /// TIMINGR, then sets its ISR flags and calls the engine irq_handler() with
+  /// Simulation::interrupt(). SCL is stretched while the engine's interrupts
+  /// are masked, and clearing PE abandons the transaction in progress.
+  /// The first byte of each write sets the register pointer, following bytes
+  /// are written to slave_memory. Reads return slave_memory from the pointer.
+  /// Blocking transfers make progress while they poll the TimerManager
+  /// deadline, so the simulation needs a Timer; otherwise run the simulation
+  /// with Simulation::run_until(), e.g. until the engine is no longer busy.
+  /// @param sim The simulation to run in
+  /// @param engine The transfer engine under test
+  /// @param expected_address The address of the slave device, others are
+  /// NACKed
+  /// @param slave_memory The register contents of the slave device
+  void init_i2c_slave_device (Simulation &sim,
+                              stm32::i2c_ref::TransferEngine &engine,
+                              uint8_t expected_address,
+                              std::span<uint8_t> slave_memory);
+
+  /// @brief Set the ISR flag the hardware raises after the slave ACKs the
+  /// address: TXIS/RXNE for the first data byte, TC/STOPF if NBYTES is zero.
   /// @param i2c_handle The mocked i2c peripheral
-  /// @return true if unit test disables the peripheral (upon test completion),
-  /// false if i2c_handle is null_ptr
-  bool static mock_i2c_start_condition_generation (I2C_TypeDef *i2c_handle,
-                                                   uint8_t expected_addr);
+  void static mock_i2c_address_acknowledged (I2C_TypeDef *i2c_handle);
 
-  /// @brief Mock function to test stm32::i2c::send_byte()
-  /// @param i2c_handle The mocked i2c peripheral
-  /// @return true if unit test disables the peripheral (upon test completion),
-  /// false if i2c_handle is null_ptr
-  bool static mock_i2c_tx_fifo_empty (I2C_TypeDef *i2c_handle,
-                                      SlaveStatus slave_status);
+  /// @brief Whether the last address phase answered by
+  /// init_i2c_start_condition() or init_i2c_responsive_slave() used the
+  /// expected address
+  bool
+  address_matched () const
+  {
+    return m_address_matched;
+  }
 
   I2C_TypeDef *
   get_handle ()
@@ -66,8 +116,74 @@ public:
     return i2c_handle;
   }
 
+  /// @brief The SCL period with the current TIMINGR configuration
+  uint64_t
+  scl_period_ns () const
+  {
+    return i2c_scl_period_ns (*i2c_handle, m_i2cclk_hz);
+  }
+
+  /// @brief The bus activity modelled by init_i2c_tx_fifo() and
+  /// init_i2c_responsive_slave() since they were called, or since the last
+  /// restart_bus_stats()
+  BusStats
+  bus_stats () const
+  {
+    return m_bus.stats ((m_sim != nullptr) ? m_sim->now_ns () : 0);
+  }
+
+  /// @brief Start measuring the bus activity from now
+  void
+  restart_bus_stats ()
+  {
+    m_bus.restart ((m_sim != nullptr) ? m_sim->now_ns () : 0);
+  }
+
 private:
+  /// @brief Answer the address phase: the first data byte flag if SADD is the
+  /// expected address, otherwise NACKF
+  void answer_address (uint8_t expected_address);
+
+  /// @brief Put the bus timing models of this device in the simulation
+  void attach (Simulation &sim);
+
+  /// @brief Run an action of init_i2c_slave_device() after scl_periods, unless
+  /// the peripheral was reset meanwhile
+  void schedule_slave (uint64_t scl_periods, Simulation::Action action);
+
+  /// @brief Raise an interrupt for init_i2c_slave_device(), then continue the
+  /// transaction
+  void slave_raise_irq (uint32_t isr_flags, Simulation::Action then);
+
+  /// @brief Answer the address phase of init_i2c_slave_device()
+  void slave_address_phase ();
+
+  /// @brief Move the data phase of init_i2c_slave_device() on by one byte, or
+  /// end it once NBYTES have been transferred
+  void slave_next_byte ();
+
+  /// @brief The state of the init_i2c_slave_device() model
+  struct SlaveDevice
+  {
+    stm32::i2c_ref::TransferEngine *engine{ nullptr };
+    uint8_t address{ 0 };
+    std::span<uint8_t> memory;
+    /// @brief The register pointer
+    std::size_t mem_idx{ 0 };
+    /// @brief The bytes left of the NBYTES chunk
+    uint32_t remaining{ 0 };
+    bool reading{ false };
+    bool first_write{ true };
+    /// @brief Incremented when PE is cleared, cancelling the scheduled events
+    uint32_t generation{ 0 };
+  };
+
   I2C_TypeDef *i2c_handle{ nullptr };
+  uint32_t m_i2cclk_hz;
+  Simulation *m_sim{ nullptr };
+  BusMonitor m_bus;
+  bool m_address_matched{ false };
+  SlaveDevice m_slave;
 };
 
 } // namespace stm32::mock
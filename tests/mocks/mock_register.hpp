@@ -0,0 +1,165 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __MOCK_REGISTER_HPP__
+#define __MOCK_REGISTER_HPP__
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace stm32::mock
+{
+
+class Register;
+
+/// @brief Sees every CPU access to a mocked peripheral register, see stm32::mock::Simulation.
+/// The observer performs the access itself so it can update the register first (e.g. a timer count).
+class RegisterObserver
+{
+public:
+    virtual uint32_t read(const Register &reg) = 0;
+    virtual void write(Register &reg, uint32_t value) = 0;
+
+protected:
+    ~RegisterObserver() = default;
+};
+
+/// @brief A 32-bit peripheral register in the mocked CMSIS structs (stm32g0xx.h).
+/// Behaves like the volatile uint32_t it replaces, but forwards each access to the installed
+/// RegisterObserver so peripheral models can react to it. Without an observer it is plain memory.
+/// Same size and layout as uint32_t, so the drivers' narrow accesses through a volatile uint8_t * or uint16_t *
+/// (e.g. 8-bit SPI DR writes) reach the value directly. See watch_narrow_writes() to observe them.
+class Register
+{
+public:
+    Register() = default;
+    Register(uint32_t value) : m_value(value) {}
+    Register(const Register &other) : m_value(other.m_value) {}
+
+    operator uint32_t() const
+    {
+        if (m_observer == nullptr) { return m_value; }
+        report_narrow_writes();
+        return m_observer->read(*this);
+    }
+
+    Register &operator=(uint32_t value)
+    {
+        if (m_observer == nullptr)
+        {
+            m_value = value;
+            return *this;
+        }
+        report_narrow_writes();
+        m_observer->write(*this, value);
+        rearm(value);
+        return *this;
+    }
+
+    Register &operator=(const Register &other) { return *this = static_cast<uint32_t>(other); }
+
+    Register &operator|=(uint32_t value) { return *this = *this | value; }
+    Register &operator&=(uint32_t value) { return *this = *this & value; }
+    Register &operator^=(uint32_t value) { return *this = *this ^ value; }
+    Register &operator+=(uint32_t value) { return *this = *this + value; }
+    Register &operator-=(uint32_t value) { return *this = *this - value; }
+
+    /// @brief Observe the CPU's narrow writes to this register, which bypass the operators above.
+    /// The register holds a sentinel instead of its value. The first observed access after the sentinel has
+    /// changed reports the change to the observer as a write of the bytes in access_mask(), before the access
+    /// itself. No virtual time passes in between, so the write keeps its place and time. The sentinel is the
+    /// last value written with the bits of SENTINEL_FLIP inverted, so repeats, complements, counts and the usual
+    /// test patterns (0x00, 0xFF, 0x55, 0xAA...) are all seen, but a write of exactly that value is missed.
+    /// Reads return the sentinel.
+    /// For peripheral models only, e.g. stm32::mock::SPI watches DR.
+    /// @param access_mask The bits of the register that a CPU write sets, e.g. 0xFF for 8-bit SPI frames
+    void watch_narrow_writes(std::function<uint32_t()> access_mask)
+    {
+        unwatch_narrow_writes();
+        m_watches.push_back(NarrowWatch{this, std::move(access_mask), 0});
+        rearm(0);
+    }
+
+    /// @brief Stop observing narrow writes, e.g. when the model watching them goes out of scope
+    void unwatch_narrow_writes()
+    {
+        std::erase_if(m_watches, [this](const NarrowWatch &watch) { return watch.reg == this; });
+    }
+
+    /// @brief Access the register without notifying the observer. For peripheral models only.
+    volatile uint32_t &raw() { return m_value; }
+    const volatile uint32_t &raw() const { return m_value; }
+
+    /// @brief Install the observer for every register, or nullptr to remove it
+    static void set_observer(RegisterObserver *observer) { m_observer = observer; }
+    static RegisterObserver *observer() { return m_observer; }
+
+private:
+    struct NarrowWatch
+    {
+        Register *reg;
+        std::function<uint32_t()> access_mask;
+        uint32_t sentinel;
+    };
+
+    /// @brief Report the watched registers whose sentinel the CPU has overwritten since the last access
+    static void report_narrow_writes()
+    {
+        if (m_reporting) { return; }
+        m_reporting = true;
+        for (NarrowWatch &watch : m_watches)
+        {
+            const uint32_t value = watch.reg->m_value;
+            if (value == watch.sentinel) { continue; }
+            const uint32_t frame = value & watch.access_mask();
+            m_observer->write(*watch.reg, frame);
+            watch.reg->rearm(frame);
+        }
+        m_reporting = false;
+    }
+
+    /// @brief Put the sentinel back after the register has been written, if it is watched
+    void rearm(uint32_t last_value)
+    {
+        auto watch = std::find_if(m_watches.begin(), m_watches.end(),
+                                  [this](const NarrowWatch &candidate) { return candidate.reg == this; });
+        if (watch == m_watches.end()) { return; }
+        watch->sentinel = last_value ^ SENTINEL_FLIP;
+        m_value = watch->sentinel;
+    }
+
+    /// @brief The bits of the last value inverted to make the sentinel. Not a run of low bits, as +1 or -1 flips,
+    /// and no two of 0x00, 0xFF, 0x55, 0xAA, 0xA5 and 0x5A differ by it.
+    static constexpr uint32_t SENTINEL_FLIP{0x96969696};
+
+    volatile uint32_t m_value{0};
+    static inline RegisterObserver *m_observer{nullptr};
+    static inline std::vector<NarrowWatch> m_watches;
+    static inline bool m_reporting{false};
+};
+
+} // namespace stm32::mock
+
+#endif // __MOCK_REGISTER_HPP__
@@ -0,0 +1,148 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <mock_sim.hpp>
+
+#include <algorithm>
+
+namespace stm32::mock
+{
+
+Simulation::Simulation()
+{
+    Register::set_observer(this);
+}
+
+Simulation::~Simulation()
+{
+    Register::set_observer(nullptr);
+}
+
+void Simulation::schedule(uint64_t delay_ns, Action action)
+{
+    m_events.push(Event{m_now_ns + delay_ns, m_sequence++, std::move(action)});
+}
+
+void Simulation::on_write(const Register &reg, WriteHook hook)
+{
+    m_write_hooks[&reg].push_back(std::move(hook));
+}
+
+void Simulation::on_read(const Register &reg, ReadHook hook)
+{
+    m_read_hooks[&reg].push_back(std::move(hook));
+}
+
+void Simulation::advance(uint64_t duration_ns)
+{
+    const uint64_t end_ns = m_now_ns + duration_ns;
+    while (run_next(end_ns))
+    {
+        // run everything that is due
+    }
+    m_now_ns = end_ns;
+}
+
+bool Simulation::run_until(const std::function<bool()> &condition, uint64_t timeout_ns)
+{
+    const uint64_t deadline_ns = (timeout_ns > (UINT64_MAX - m_now_ns)) ? UINT64_MAX : (m_now_ns + timeout_ns);
+    while (!condition())
+    {
+        if (!run_next(deadline_ns)) { return condition(); }
+    }
+    return true;
+}
+
+void Simulation::interrupt(const Action &handler)
+{
+    const bool was_hardware = m_hardware;
+    m_hardware = false;
+    handler();
+    m_hardware = was_hardware;
+}
+
+uint32_t Simulation::read(const Register &reg)
+{
+    if (m_hardware) { return reg.raw(); }
+
+    run_read_hooks(reg);
+    const uint32_t value = reg.raw();
+    if (m_dispatching) { return value; }
+
+    // the driver is polling if it keeps reading the same value, so let time pass before this read completes
+    PollCount &poll = m_polls[&reg];
+    if ((poll.reads > 0) && (poll.value == value)) { poll.reads++; }
+    else { poll = PollCount{value, 1}; }
+    if (poll.reads < m_poll_threshold) { return value; }
+
+    m_polls.clear();
+    idle();
+    run_read_hooks(reg);
+    return reg.raw();
+}
+
+void Simulation::write(Register &reg, uint32_t value)
+{
+    reg.raw() = value;
+    if (m_hardware) { return; }
+
+    // writing another register is progress, e.g. the next byte into TDR between reads of ISR
+    std::erase_if(m_polls, [&reg](const auto &poll) { return poll.first != &reg; });
+
+    if (auto hooks = m_write_hooks.find(&reg); hooks != m_write_hooks.end())
+    {
+        for (WriteHook &hook : hooks->second) { as_hardware(hook, value); }
+    }
+}
+
+void Simulation::run_read_hooks(const Register &reg)
+{
+    if (auto hooks = m_read_hooks.find(&reg); hooks != m_read_hooks.end())
+    {
+        for (ReadHook &hook : hooks->second) { as_hardware(hook); }
+    }
+}
+
+void Simulation::idle()
+{
+    const uint64_t limit_ns = m_now_ns + m_idle_step_ns;
+    if (!run_next(limit_ns)) { m_now_ns = limit_ns; }
+}
+
+bool Simulation::run_next(uint64_t limit_ns)
+{
+    if (m_events.empty() || (m_events.top().time_ns > limit_ns)) { return false; }
+
+    Event event = m_events.top();
+    m_events.pop();
+    m_now_ns = std::max(m_now_ns, event.time_ns);
+
+    // an interrupt raised by the event runs to completion, it isn't polling
+    const bool was_dispatching = m_dispatching;
+    m_dispatching = true;
+    as_hardware(event.action);
+    m_dispatching = was_dispatching;
+    return true;
+}
+
+} // namespace stm32::mock
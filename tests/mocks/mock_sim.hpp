@@ -0,0 +1,168 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __MOCK_SIM_HPP__
+#define __MOCK_SIM_HPP__
+
+#include <mock_register.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+namespace stm32::mock
+{
+
+/// @brief Discrete-event simulation of the peripherals in virtual time, replacing mock threads that sleep.
+/// Everything runs on the test's thread:
+/// - Peripheral models hook the registers the driver writes (on_write) or reads (on_read), and schedule()
+///   what the hardware does later, e.g. set a flag when a byte has been shifted out.
+/// - Time stands still while the driver makes progress. When the driver polls, i.e. reads the same value
+///   from a register several times in a row without writing another register, time jumps to the next event, or by one idle step if that is
+///   sooner so that timer counts keep moving for timeouts.
+/// Runs are deterministic and take no wall-clock time.
+///
+/// Only one Simulation can exist at a time; it observes every mocked register while it does.
+/// Hooks and events run as the hardware: their register accesses are not observed. A model that raises
+/// an interrupt calls interrupt(), whose accesses are observed like the rest of the driver's.
+///
+/// Usage:
+///   stm32::mock::Simulation sim;
+///   stm32::mock::Timer timer(sim);
+///   sim.on_write(spi.DR, [&](uint32_t) { sim.schedule(1000, [&] { spi.SR.raw() |= SPI_SR_TXE; }); });
+class Simulation : public RegisterObserver
+{
+public:
+    using Action = std::function<void()>;
+    using WriteHook = std::function<void(uint32_t value)>;
+    using ReadHook = std::function<void()>;
+
+    static constexpr uint64_t NS_PER_US{1000};
+
+    /// @brief Start observing the mocked registers at virtual time zero
+    Simulation();
+    ~Simulation();
+    Simulation(const Simulation &) = delete;
+    Simulation &operator=(const Simulation &) = delete;
+
+    /// @brief The virtual time in nanoseconds
+    uint64_t now_ns() const { return m_now_ns; }
+
+    /// @brief Run an action after a delay of virtual time. Actions due at the same time run in the order scheduled.
+    void schedule(uint64_t delay_ns, Action action);
+
+    /// @brief Call a hook after each CPU write to the register, with the value written
+    void on_write(const Register &reg, WriteHook hook);
+
+    /// @brief Call a hook before each CPU read of the register, e.g. to bring a counter up to date
+    void on_read(const Register &reg, ReadHook hook);
+
+    /// @brief Run the events due in the next duration_ns of virtual time, then move time on to the end of it
+    void advance(uint64_t duration_ns);
+
+    /// @brief Run events until the condition is met, for drivers that wait on RAM rather than registers
+    /// @return false if the events ran out or the timeout passed first
+    bool run_until(const std::function<bool()> &condition, uint64_t timeout_ns = UINT64_MAX);
+
+    /// @brief Run an interrupt handler from a hook or event. Its register accesses are observed.
+    void interrupt(const Action &handler);
+
+    /// @brief The number of events waiting to run
+    std::size_t pending() const { return m_events.size(); }
+
+    /// @brief true while a hook or event is running, i.e. register accesses now are the hardware's, not the CPU's
+    bool in_hardware() const { return m_hardware; }
+
+    /// @brief The most virtual time one poll can skip when no event is due sooner. Default 1us, one TimerManager tick.
+    void set_idle_step(uint64_t idle_step_ns) { m_idle_step_ns = idle_step_ns; }
+
+    /// @brief The number of identical reads of one register treated as polling. Default 3.
+    void set_poll_threshold(uint32_t reads) { m_poll_threshold = reads; }
+
+    uint32_t read(const Register &reg) override;
+    void write(Register &reg, uint32_t value) override;
+
+private:
+    struct Event
+    {
+        uint64_t time_ns;
+        uint64_t sequence;
+        Action action;
+
+        bool operator>(const Event &other) const
+        {
+            return (time_ns != other.time_ns) ? (time_ns > other.time_ns) : (sequence > other.sequence);
+        }
+    };
+
+    struct PollCount
+    {
+        uint32_t value;
+        uint32_t reads;
+    };
+
+    /// @brief Bring the register up to date before the CPU reads it
+    void run_read_hooks(const Register &reg);
+
+    /// @brief The CPU is polling: run the next event if it's due within an idle step, else skip the step
+    void idle();
+
+    /// @brief Run the next event if it is due by limit_ns
+    /// @return false if no event was due
+    bool run_next(uint64_t limit_ns);
+
+    /// @brief Run a hook or event as the hardware
+    template <typename FUNCTION, typename... ARGS>
+    void as_hardware(FUNCTION &function, ARGS... args)
+    {
+        const bool was_hardware = m_hardware;
+        m_hardware = true;
+        function(args...);
+        m_hardware = was_hardware;
+    }
+
+    uint64_t m_now_ns{0};
+    uint64_t m_sequence{0};
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> m_events;
+
+    std::unordered_map<const Register *, std::vector<WriteHook>> m_write_hooks;
+    std::unordered_map<const Register *, std::vector<ReadHook>> m_read_hooks;
+
+    /// @brief The last value and number of identical reads of each register, for detecting polling
+    std::unordered_map<const Register *, PollCount> m_polls;
+
+    uint64_t m_idle_step_ns{NS_PER_US};
+    uint32_t m_poll_threshold{3};
+
+    /// @brief true while a hook or event runs, so its accesses aren't observed
+    bool m_hardware{false};
+
+    /// @brief true while an event runs, including any interrupt it raises
+    bool m_dispatching{false};
+};
+
+} // namespace stm32::mock
+
+#endif // __MOCK_SIM_HPP__
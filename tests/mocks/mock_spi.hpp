@@ -23,47 +23,170 @@
 #ifndef __MOCK_SPI_HPP__
 #define __MOCK_SPI_HPP__
 
+#include <mock_bus.hpp>
+#include <mock_sim.hpp>
 #include <stm32g0xx.h>
 
-#include <chrono>
-#include <future>
-#include <iostream>
-#include <thread>
-using namespace std::chrono_literals;
+#include <cstddef>
+#include <deque>
+#include <vector>
 
-/// @brief Mock function to test stm32::spi_ref::wait_for_txe_flag() and stm32::spi_ref::wait_for_bsy_flag()
-/// @param i2c_handle The mocked SPI peripheral
-/// @return true if unit test disables the peripheral (upon test completion), false if spi_handle is null_ptr
+namespace stm32::mock
+{
 
-bool inline mock_spi_data_register(SPI_TypeDef *spi_handle)
+/// @brief Models the data register, TX FIFO and flags of an SPI master, e.g. for stm32::spi_ref::send_byte().
+/// Each frame written to DR while the SPI is enabled (SPE) joins the 32-bit TX FIFO, whatever its value. Frames
+/// are sent one after another, each over the wire time given by the data size and baud rate prescaler at the
+/// start of the frame, see spi_frame_time_ns(). BSY is set until the FIFO has drained, and TXE while the FIFO is
+/// at most half full.
+/// The drivers write DR at the frame width through a volatile uint8_t * or uint16_t *, so the model watches DR for
+/// narrow writes (see Register::watch_narrow_writes()) and takes each one as a frame. DR reads are not modelled.
+class SPI
 {
+public:
+  /// @param sim The simulation to run in
+  /// @param spi_handle The mocked SPI peripheral
+  /// @param pclk_hz The peripheral clock, divided by the prescaler to give SCK
+  SPI (Simulation &sim, SPI_TypeDef &spi_handle, uint32_t pclk_hz = SystemCoreClock)
+      : m_sim (sim), m_spi_handle (spi_handle), m_pclk_hz (pclk_hz)
+  {
+    // reset state: TX FIFO empty
+    m_spi_handle.SR.raw () = m_spi_handle.SR.raw () | SPI_SR_TXE;
+    m_sim.on_write (spi_handle.DR,
+                    [this] (uint32_t value) { queue_frame (value); });
+    m_spi_handle.DR.watch_narrow_writes (
+        [this] { return (frame_bytes () == 2) ? 0xFFFFU : 0xFFU; });
+  }
+
+  ~SPI ()
+  {
+    // the register outlives the model
+    m_spi_handle.DR.unwatch_narrow_writes ();
+  }
+
+  SPI (const SPI &) = delete;
+  SPI &operator= (const SPI &) = delete;
 
-  if (spi_handle == nullptr)
+  /// @brief The number of frames sent so far
+  std::size_t
+  frames_sent () const
   {
-    return false;
+    return m_frames.size ();
   }
 
-  // loop while peripheral is enabled
-  while ((spi_handle->CR1 & SPI_CR1_SPE) == SPI_CR1_SPE)
+  /// @brief The frames sent so far, in order
+  const std::vector<uint32_t> &
+  frames () const
   {
+    return m_frames;
+  }
 
-    // wait for test bytes to be copied into SPI FIFO
-    if (spi_handle->DR != 0)
+  /// @brief The last frame taken from DR
+  uint32_t
+  last_frame () const
+  {
+    return m_last_frame;
+  }
+
+  /// @brief The wire time of one frame with the current configuration
+  uint64_t
+  frame_time_ns () const
+  {
+    return spi_frame_time_ns (m_spi_handle, m_pclk_hz);
+  }
+
+  /// @brief The bus activity since construction or the last restart_bus_stats()
+  BusStats
+  bus_stats () const
+  {
+    return m_bus.stats (m_sim.now_ns ());
+  }
+
+  /// @brief Start measuring the bus activity from now
+  void
+  restart_bus_stats ()
+  {
+    m_bus.restart (m_sim.now_ns ());
+  }
+
+private:
+  /// @brief The bytes of the TX FIFO
+  static constexpr std::size_t TX_FIFO_BYTES{ 4 };
+
+  /// @brief The bytes of one frame with the current data size
+  std::size_t
+  frame_bytes () const
+  {
+    return (((m_spi_handle.CR2.raw () & SPI_CR2_DS_Msk) >> SPI_CR2_DS_Pos) > 7)
+               ? 2
+               : 1;
+  }
+
+  void
+  queue_frame (uint32_t value)
+  {
+    if ((m_spi_handle.CR1.raw () & SPI_CR1_SPE) != SPI_CR1_SPE)
+    {
+      return;
+    }
+
+    m_tx_fifo.push_back (value & ((frame_bytes () == 2) ? 0xFFFFU : 0xFFU));
+    m_spi_handle.SR.raw () = m_spi_handle.SR.raw () | SPI_SR_BSY;
+    update_txe ();
+    if (!m_busy)
     {
+      start_frame ();
+    }
+  }
 
-      // exaggerate the delay for MCU to clear the BSY flag so that our SUT has chance to run coverage
-      spi_handle->SR = spi_handle->SR | SPI_SR_BSY_Msk;
-      std::this_thread::sleep_for(500ms);
-      spi_handle->SR = spi_handle->SR & ~SPI_SR_BSY_Msk;
+  void
+  start_frame ()
+  {
+    m_busy = true;
+    m_last_frame = m_tx_fifo.front ();
+    m_tx_fifo.pop_front ();
+    update_txe ();
+
+    const uint64_t duration_ns = frame_time_ns ();
+    const std::size_t bytes = frame_bytes ();
+    m_sim.schedule (duration_ns, [this, duration_ns, bytes] {
+      m_bus.record (duration_ns, bytes);
+      m_frames.push_back (m_last_frame);
+      m_busy = false;
+      if (!m_tx_fifo.empty ())
+      {
+        start_frame ();
+        return;
+      }
+      m_spi_handle.SR.raw () = m_spi_handle.SR.raw () & ~SPI_SR_BSY;
+    });
+  }
 
-      // exaggerate the delay for MCU to set the TXE flag so that our SUT has chance to run coverage
-      std::this_thread::sleep_for(100ms);
-      spi_handle->DR = 0;
-      spi_handle->SR = spi_handle->SR | SPI_SR_TXE_Msk;
+  /// @brief TXE is set while the TX FIFO is at most half full
+  void
+  update_txe ()
+  {
+    if ((m_tx_fifo.size () * frame_bytes ()) <= (TX_FIFO_BYTES / 2))
+    {
+      m_spi_handle.SR.raw () = m_spi_handle.SR.raw () | SPI_SR_TXE;
+    }
+    else
+    {
+      m_spi_handle.SR.raw () = m_spi_handle.SR.raw () & ~SPI_SR_TXE;
     }
   }
 
-  return true;
-}
+  Simulation &m_sim;
+  SPI_TypeDef &m_spi_handle;
+  uint32_t m_pclk_hz;
+  BusMonitor m_bus;
+  /// @brief Frames waiting behind the one on the wire
+  std::deque<uint32_t> m_tx_fifo;
+  bool m_busy{ false };
+  std::vector<uint32_t> m_frames;
+  uint32_t m_last_frame{ 0 };
+};
+
+} // namespace stm32::mock
 
-#endif // __MOCK_SPI_HPP__
\ No newline at end of file
+#endif // __MOCK_SPI_HPP__
@@ -21,67 +21,72 @@
 // SOFTWARE.
 
 
+
 #include <mock_tim.hpp>
 
+#include <algorithm>
+
 namespace stm32::mock
 {
 
-TIM_TypeDef* Timer::init_timer(std::future<bool> &future, TimerType timer_type)
+TIM_TypeDef *Timer::init_timer(TimerType timer_type)
 {
-    TIM_TypeDef* timer = nullptr;
-    switch(timer_type)
-    {   
+    switch (timer_type)
+    {
         case TimerType::SYSTICK_TYPE:
-            SysTick = new SysTick_Type; 
-            SysTick->CTRL = SysTick->CTRL | 1UL << 0UL;
-            future = std::async(std::launch::async, run_systick_counter, SysTick); 
-            break;
-        case TimerType::TIM_TYPEDEF:    
-            timer = new TIM_TypeDef;
+        {
+            SysTick = new SysTick_Type;
+            SysTick->CTRL.raw() = SysTick->CTRL.raw() | SysTick_CTRL_ENABLE_Msk;
+            m_next_systick_ns = m_sim.now_ns() + m_systick_period_ns;
+
+            // the flag is set once per period and cleared by reading CTRL (the driver clears it on the host)
+            SysTick_Type &systick = *SysTick;
+            m_sim.on_read(systick.CTRL, [this, &systick] {
+                if ((systick.CTRL.raw() & SysTick_CTRL_ENABLE_Msk) == 0) { return; }
+                if (m_sim.now_ns() < m_next_systick_ns) { return; }
+                systick.CTRL.raw() = systick.CTRL.raw() | SysTick_CTRL_COUNTFLAG_Msk;
+                m_next_systick_ns += m_systick_period_ns;
+            });
+            m_sim.on_write(systick.CTRL, [this](uint32_t value) {
+                if ((value & SysTick_CTRL_ENABLE_Msk) == 0) { return; }
+                m_next_systick_ns = std::max(m_next_systick_ns, m_sim.now_ns());
+            });
+            return nullptr;
+        }
+        case TimerType::TIM_TYPEDEF:
+        {
+            // never freed: stm32::TimerManager keeps pointing at it after the test
+            TIM_TypeDef *timer = new TIM_TypeDef;
+            m_sim.on_read(timer->CNT, [this, timer] { timer->CNT.raw() = count_now(*timer); });
+            m_sim.on_write(timer->CNT, [this, timer](uint32_t) { rebase(*timer); });
+            m_sim.on_write(timer->CR1, [this, timer](uint32_t value) {
+                // the write has landed, so catch up using whether the counter was running before it
+                timer->CNT.raw() = count_now(*timer);
+                m_running = (value & TIM_CR1_CEN) == TIM_CR1_CEN;
+                rebase(*timer);
+            });
             stm32::TimerManager::initialise(timer);
-            future = std::async(std::launch::async, run_timer_counter, timer); 
-            break;
+            return timer;
+        }
     }
-    return timer;
+    return nullptr;
 }
 
-bool inline Timer::run_systick_counter(SysTick_Type *systick)
+uint32_t Timer::count_now(TIM_TypeDef &timer) const
 {
-    using namespace std::chrono_literals;
-
-    if (systick == nullptr) { return false; }
-
-    auto systick_enabled = (SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk);
-    while ((systick->CTRL & systick_enabled) == systick_enabled)
-    {
-        std::this_thread::sleep_for(1ms);
-        std::cout << std::flush << ".";
-        // simluate the counter by setting the COUNTFLAG
-        systick->CTRL = systick->CTRL | SysTick_CTRL_COUNTFLAG_Msk;
-
+    // a stopped counter keeps its value
+    if (!m_running) { return timer.CNT.raw(); }
 
-    }
-    std::cout << std::endl;
-    return true;
+    // counts up to ARR then wraps to zero
+    const uint64_t ticks = (m_sim.now_ns() - m_base_ns) / m_tick_period_ns;
+    const uint64_t period = static_cast<uint64_t>(timer.ARR.raw()) + 1;
+    return static_cast<uint32_t>((m_base_count + ticks) % period);
 }
 
-bool inline Timer::run_timer_counter(TIM_TypeDef *timer)
+void Timer::rebase(TIM_TypeDef &timer)
 {
-    using namespace std::chrono_literals;
-    if (timer == nullptr)
-    {
-        return false;
-    }
-    // timer enabled
-    while (timer->CR1 == 1) 
-    { 
-        // simulate the 1ms timing
-        std::this_thread::sleep_for(1ms);
-        std::cout << std::flush << ".";
-        timer->CNT = timer->CNT + 1; 
-    }
-    std::cout << std::endl;
-    return true;
+    m_base_count = timer.CNT.raw();
+    m_base_ns = m_sim.now_ns();
 }
 
 } // namespace stm32::mock
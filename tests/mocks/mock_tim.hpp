@@ -21,16 +21,13 @@
 // SOFTWARE.
 
 
+
 #ifndef __MOCK_TIM_HPP__
 #define __MOCK_TIM_HPP__
 
+#include <mock_sim.hpp>
 #include <stm32g0xx.h>
 #include <timer_manager.hpp>
-#include <iostream>
-#include <chrono>
-#include <future>
-#include <thread>
-using namespace std::chrono_literals;
 
 namespace stm32::mock
 {
@@ -42,29 +39,46 @@ enum class TimerType
     SYSTICK_TYPE
 };
 
-class Timer {
+/// @brief Models the TIM counter used by stm32::TimerManager and the SysTick COUNTFLAG in virtual time.
+/// The counter is brought up to date whenever the driver reads it, so a driver polling it sees time pass
+/// at the rate the Simulation advances it.
+class Timer
+{
 public:
-    Timer() = default;
+    /// @brief The virtual time taken by one tick (1us on the target) of the timer counter
+    static constexpr uint64_t m_tick_period_ns{Simulation::NS_PER_US};
+
+    /// @brief The virtual time between SysTick COUNTFLAGs (1ms on the target)
+    static constexpr uint64_t m_systick_period_ns{1000 * Simulation::NS_PER_US};
 
-    /// @brief Initialise and run the mock counter functionality within an asynchronous thread.
-    /// @param future The future result of the async function
-    /// @param timer_type stm32::mock::TimerType::TIM_TYPEDEF (periperhal timer) or stm32::mock::TimerType::SYSTICK_TYPE (global system timer)
+    explicit Timer(Simulation &sim) : m_sim(sim) {}
+
+    /// @brief Create the mocked timer and attach its model to the simulation.
+    /// @param timer_type stm32::mock::TimerType::TIM_TYPEDEF (periperhal timer, given to stm32::TimerManager)
+    /// or stm32::mock::TimerType::SYSTICK_TYPE (global system timer)
     /// @return TIM_TypeDef* Instance of the peripheral timer or nullptr if global system timer
-    TIM_TypeDef* init_timer(std::future<bool> &future, TimerType timer_type = TimerType::TIM_TYPEDEF);
-
-    /// @brief Simulate the SysTick counter (normally done by ARM HW).
-    /// See "Cortex-M0 Technical Ref Man - SysTick Control and Status Register"
-    /// @param systick 
-    /// @return false if null input, return true when fixture has terminated
-    bool static inline run_systick_counter(SysTick_Type *systick);
-
-    /// @brief Simulate the timer counter (normally done by STM32 HW) 
-    /// See STM32 Reference Manal Timer control register 1
-    /// @param timer The mocked STM32 registers
-    /// @return false if timer is null
-    bool static inline run_timer_counter(TIM_TypeDef *timer);
+    TIM_TypeDef *init_timer(TimerType timer_type = TimerType::TIM_TYPEDEF);
+
+private:
+    /// @brief The counter value at the current virtual time
+    uint32_t count_now(TIM_TypeDef &timer) const;
+
+    /// @brief Restart counting from the current value of CNT at the current virtual time
+    void rebase(TIM_TypeDef &timer);
+
+    Simulation &m_sim;
+
+    /// @brief CR1 CEN as last written
+    bool m_running{false};
+
+    /// @brief The counter value and virtual time of the last rebase()
+    uint32_t m_base_count{0};
+    uint64_t m_base_ns{0};
+
+    /// @brief When the next SysTick COUNTFLAG is due
+    uint64_t m_next_systick_ns{0};
 };
 
-} // namespace mock_timer
+} // namespace stm32::mock
 
-#endif // __MOCK_TIM_HPP__
\ No newline at end of file
+#endif // __MOCK_TIM_HPP__
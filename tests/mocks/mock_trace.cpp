@@ -0,0 +1,175 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <mock_trace.hpp>
+
+#include <algorithm>
+#include <cstdio>
+
+namespace stm32::mock
+{
+
+namespace
+{
+
+void put_varint(std::ostream &os, uint64_t value)
+{
+    do
+    {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        if (value != 0) { byte |= 0x80; }
+        os.put(static_cast<char>(byte));
+    } while (value != 0);
+}
+
+void put_text(std::ostream &os, std::string_view text)
+{
+    put_varint(os, text.size());
+    os.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+} // namespace
+
+RegisterTrace::RegisterTrace(const Simulation &sim) : m_sim(&sim), m_next(Register::observer())
+{
+    Register::set_observer(this);
+}
+
+RegisterTrace::RegisterTrace() : m_next(Register::observer())
+{
+    Register::set_observer(this);
+}
+
+RegisterTrace::~RegisterTrace()
+{
+    Register::set_observer(m_next);
+}
+
+void RegisterTrace::name(const Register &reg, std::string text)
+{
+    if (auto found = m_ids.find(&reg); found != m_ids.end())
+    {
+        m_names[found->second] = std::move(text);
+        return;
+    }
+    m_ids.emplace(&reg, static_cast<uint16_t>(m_names.size()));
+    m_names.push_back(std::move(text));
+}
+
+void RegisterTrace::mark(std::string_view label)
+{
+    m_marks.push_back(Mark{now_ns(), m_accesses.size(), std::string(label)});
+}
+
+void RegisterTrace::clear()
+{
+    m_accesses.clear();
+    m_marks.clear();
+}
+
+std::size_t RegisterTrace::count(std::string_view register_name, bool write) const
+{
+    return static_cast<std::size_t>(std::count_if(m_accesses.begin(), m_accesses.end(), [&](const Access &access) {
+        return (access.write == write) && (m_names[access.id] == register_name);
+    }));
+}
+
+void RegisterTrace::save(std::ostream &os) const
+{
+    os.write(MAGIC.data(), static_cast<std::streamsize>(MAGIC.size()));
+    os.put(static_cast<char>(VERSION));
+
+    for (std::size_t id = 0; id < m_names.size(); id++)
+    {
+        os.put(static_cast<char>(Tag::NAME));
+        put_varint(os, id);
+        put_text(os, m_names[id]);
+    }
+
+    // interleave the marks with the accesses they precede
+    uint64_t last_ns{0};
+    auto mark = m_marks.begin();
+    for (std::size_t position = 0; position <= m_accesses.size(); position++)
+    {
+        for (; (mark != m_marks.end()) && (mark->position == position); ++mark)
+        {
+            os.put(static_cast<char>(Tag::MARK));
+            put_varint(os, mark->time_ns - last_ns);
+            put_text(os, mark->label);
+            last_ns = mark->time_ns;
+        }
+        if (position == m_accesses.size()) { break; }
+
+        const Access &access = m_accesses[position];
+        os.put(static_cast<char>(access.write ? Tag::WRITE : Tag::READ));
+        put_varint(os, access.time_ns - last_ns);
+        put_varint(os, access.id);
+        put_varint(os, access.value);
+        last_ns = access.time_ns;
+    }
+}
+
+uint32_t RegisterTrace::read(const Register &reg)
+{
+    // the next observer may let time pass, so the read is timestamped when it completes
+    const uint32_t value = (m_next != nullptr) ? m_next->read(reg) : reg.raw();
+    if (!hidden()) { record(reg, value, false); }
+    return value;
+}
+
+void RegisterTrace::write(Register &reg, uint32_t value)
+{
+    if (!hidden()) { record(reg, value, true); }
+    if (m_next != nullptr) { m_next->write(reg, value); }
+    else { reg.raw() = value; }
+}
+
+std::string RegisterTrace::offset_name(std::string_view prefix, std::size_t offset)
+{
+    char text[16];
+    std::snprintf(text, sizeof(text), "+0x%02zX", offset);
+    return std::string(prefix) + text;
+}
+
+uint16_t RegisterTrace::id_of(const Register &reg)
+{
+    if (auto found = m_ids.find(&reg); found != m_ids.end()) { return found->second; }
+
+    char text[24];
+    std::snprintf(text, sizeof(text), "%p", static_cast<const void *>(&reg));
+    name(reg, text);
+    return m_ids.at(&reg);
+}
+
+uint64_t RegisterTrace::now_ns() const
+{
+    return (m_sim != nullptr) ? m_sim->now_ns() : m_accesses.size();
+}
+
+void RegisterTrace::record(const Register &reg, uint32_t value, bool write)
+{
+    m_accesses.push_back(Access{now_ns(), value, id_of(reg), write});
+}
+
+} // namespace stm32::mock
@@ -0,0 +1,214 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __MOCK_TRACE_HPP__
+#define __MOCK_TRACE_HPP__
+
+#include <mock_register.hpp>
+#include <mock_sim.hpp>
+#include <stm32g0xx.h>
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace stm32::mock
+{
+
+/// @brief The register names of a mocked CMSIS struct, in address order. Types without a specialisation are
+/// traced by offset, e.g. "GPIOA+0x14".
+template <typename PERIPHERAL> struct RegisterNames
+{
+    static constexpr std::array<std::string_view, 0> names{};
+};
+
+template <> struct RegisterNames<SysTick_Type>
+{
+    static constexpr std::array<std::string_view, 4> names{"CTRL", "LOAD", "VAL", "CALIB"};
+};
+
+template <> struct RegisterNames<I2C_TypeDef>
+{
+    static constexpr std::array<std::string_view, 11> names{"CR1", "CR2",  "OAR1", "OAR2", "TIMINGR", "TIMEOUTR",
+                                                            "ISR", "ICR", "PECR", "RXDR", "TXDR"};
+};
+
+template <> struct RegisterNames<SPI_TypeDef>
+{
+    static constexpr std::array<std::string_view, 9> names{"CR1",    "CR2",    "SR",      "DR",   "CRCPR",
+                                                           "RXCRCR", "TXCRCR", "I2SCFGR", "I2SPR"};
+};
+
+template <> struct RegisterNames<TIM_TypeDef>
+{
+    static constexpr std::array<std::string_view, 27> names{
+        "CR1",  "CR2",  "SMCR", "DIER", "SR",   "EGR", "CCMR1", "CCMR2", "CCER", "CNT", "PSC", "ARR",   "RCR", "CCR1",
+        "CCR2", "CCR3", "CCR4", "BDTR", "DCR",  "DMAR", "OR1",  "CCMR3", "CCR5", "CCR6", "AF1", "AF2", "TISEL"};
+};
+
+template <> struct RegisterNames<USART_TypeDef>
+{
+    static constexpr std::array<std::string_view, 12> names{"CR1", "CR2", "CR3", "BRR", "GTPR", "RTOR",
+                                                            "RQR", "ISR", "ICR", "RDR", "TDR",  "PRESC"};
+};
+
+template <> struct RegisterNames<DMA_Channel_TypeDef>
+{
+    static constexpr std::array<std::string_view, 4> names{"CCR", "CNDTR", "CPAR", "CMAR"};
+};
+
+/// @brief Records every CPU access to the mocked registers: which register, read or write, the value and the
+/// virtual time. Accesses made by the peripheral models as the hardware are left out. Narrow writes to a
+/// watched register (e.g. 8-bit SPI DR writes) are recorded with the frame, see Register::watch_narrow_writes().
+///
+/// The trace is saved as a compact binary stream that tools/register_trace.py turns into a VCD for a waveform
+/// viewer, or a count of the redundant accesses and polling reads in each section started by mark().
+///
+/// The recorder sits in front of the installed observer, normally a Simulation, and passes every access on to
+/// it. Construct it after the Simulation and let it go out of scope first.
+///
+/// Usage:
+///   stm32::mock::Simulation sim;
+///   stm32::mock::RegisterTrace trace(sim);
+///   trace.name(*spi_handle, "SPI1");
+///   trace.mark("send_byte");
+///   stm32::spi_ref::send_byte(*spi_handle, 0xFF);
+///   std::ofstream file("send_byte.trace", std::ios::binary);
+///   trace.save(file);
+class RegisterTrace : public RegisterObserver
+{
+public:
+    /// @brief The stream starts with these 4 bytes and a version byte
+    static constexpr std::string_view MAGIC{"RTRC"};
+    static constexpr uint8_t VERSION{1};
+
+    /// @brief Entry tags in the stream. Numbers are unsigned LEB128 varints, times are deltas from the previous
+    /// entry: NAME id, length, text | READ/WRITE delta_ns, id, value | MARK delta_ns, length, text
+    enum class Tag : uint8_t
+    {
+        NAME = 1,
+        READ = 2,
+        WRITE = 3,
+        MARK = 4,
+    };
+
+    struct Access
+    {
+        uint64_t time_ns;
+        uint32_t value;
+        uint16_t id;
+        bool write;
+    };
+
+    struct Mark
+    {
+        uint64_t time_ns;
+        /// @brief The number of accesses recorded before the mark
+        std::size_t position;
+        std::string label;
+    };
+
+    /// @brief Record with the simulation's virtual time
+    explicit RegisterTrace(const Simulation &sim);
+    /// @brief Record without a simulation. Each access is timestamped with its index.
+    RegisterTrace();
+    ~RegisterTrace();
+    RegisterTrace(const RegisterTrace &) = delete;
+    RegisterTrace &operator=(const RegisterTrace &) = delete;
+
+    /// @brief Name the registers of a peripheral in the trace, e.g. "SPI1.SR". Registers that aren't named
+    /// are traced by address.
+    template <typename PERIPHERAL> void name(const PERIPHERAL &peripheral, std::string_view prefix)
+    {
+        static_assert(sizeof(Register) == sizeof(uint32_t));
+        const auto *first = reinterpret_cast<const Register *>(&peripheral);
+        constexpr auto &names = RegisterNames<PERIPHERAL>::names;
+        static_assert(names.empty() || ((names.size() * sizeof(Register)) == sizeof(PERIPHERAL)));
+        if constexpr (names.empty())
+        {
+            for (std::size_t index = 0; index < (sizeof(PERIPHERAL) / sizeof(Register)); index++)
+            {
+                name(first[index], offset_name(prefix, index * sizeof(Register)));
+            }
+        }
+        else
+        {
+            for (std::size_t index = 0; index < names.size(); index++)
+            {
+                name(first[index], std::string(prefix) + "." + std::string(names[index]));
+            }
+        }
+    }
+
+    /// @brief Name a single register
+    void name(const Register &reg, std::string text);
+
+    /// @brief Start a new section of the trace, e.g. before calling the next driver function
+    void mark(std::string_view label);
+
+    /// @brief Forget the accesses and marks so far. Register names are kept.
+    void clear();
+
+    const std::vector<Access> &accesses() const { return m_accesses; }
+    const std::vector<Mark> &marks() const { return m_marks; }
+
+    /// @brief The name of a register ID from accesses()
+    const std::string &name_of(uint16_t id) const { return m_names.at(id); }
+
+    /// @brief The number of accesses to the named register, reads or writes
+    std::size_t count(std::string_view register_name, bool write) const;
+
+    /// @brief Write the trace in the binary format
+    void save(std::ostream &os) const;
+
+    uint32_t read(const Register &reg) override;
+    void write(Register &reg, uint32_t value) override;
+
+private:
+    static std::string offset_name(std::string_view prefix, std::size_t offset);
+
+    /// @brief The register's ID, naming it by address the first time it is seen
+    uint16_t id_of(const Register &reg);
+
+    /// @brief true if the access is made by a peripheral model as the hardware
+    bool hidden() const { return (m_sim != nullptr) && m_sim->in_hardware(); }
+
+    uint64_t now_ns() const;
+
+    void record(const Register &reg, uint32_t value, bool write);
+
+    const Simulation *m_sim{nullptr};
+    RegisterObserver *m_next{nullptr};
+    std::unordered_map<const Register *, uint16_t> m_ids;
+    std::vector<std::string> m_names;
+    std::vector<Access> m_accesses;
+    std::vector<Mark> m_marks;
+};
+
+} // namespace stm32::mock
+
+#endif // __MOCK_TRACE_HPP__
@@ -0,0 +1,148 @@
+// MIT License
+
+// Copyright (c) 2022 Chris Sutton
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __MOCK_USART_HPP__
+#define __MOCK_USART_HPP__
+
+#include <mock_bus.hpp>
+#include <mock_sim.hpp>
+#include <stm32g0xx.h>
+
+#include <cstddef>
+#include <deque>
+
+namespace stm32::mock
+{
+
+/// @brief Models the transmitter of a USART, e.g. for stm32::usart_ref::transmit().
+/// A byte written to TDR while the USART is enabled (UE) moves to the shift register as soon as it is free, so
+/// TXE/TXFNF stays set while TDR, or the 8-byte TX FIFO when FIFOEN is set, has room. Each character takes the
+/// wire time given by BRR, the word length and the stop bits at the time it starts, see usart_frame_time_ns().
+/// TC is cleared by a write to TDR and set when the last character has left the shift register.
+class USART
+{
+public:
+  static constexpr std::size_t FIFO_DEPTH{ 8 };
+
+  /// @param sim The simulation to run in
+  /// @param usart_handle The mocked USART peripheral
+  /// @param pclk_hz The USART kernel clock, divided by BRR to give the baud rate
+  USART (Simulation &sim, USART_TypeDef &usart_handle, uint32_t pclk_hz = SystemCoreClock)
+      : m_sim (sim), m_usart_handle (usart_handle), m_pclk_hz (pclk_hz)
+  {
+    // reset state: nothing to send
+    m_usart_handle.ISR.raw () = m_usart_handle.ISR.raw () | USART_ISR_TXE_TXFNF | USART_ISR_TC;
+    m_sim.on_write (usart_handle.TDR, [this] (uint32_t value) { queue_byte (value); });
+  }
+
+  /// @brief The number of characters sent so far
+  std::size_t
+  bytes_sent () const
+  {
+    return m_bytes_sent;
+  }
+
+  /// @brief The last character shifted out
+  uint32_t
+  last_byte () const
+  {
+    return m_last_byte;
+  }
+
+  /// @brief The wire time of one character with the current configuration
+  uint64_t
+  frame_time_ns () const
+  {
+    return usart_frame_time_ns (m_usart_handle, m_pclk_hz);
+  }
+
+  /// @brief The bus activity since construction or the last restart_bus_stats()
+  BusStats
+  bus_stats () const
+  {
+    return m_bus.stats (m_sim.now_ns ());
+  }
+
+  /// @brief Start measuring the bus activity from now
+  void
+  restart_bus_stats ()
+  {
+    m_bus.restart (m_sim.now_ns ());
+  }
+
+private:
+  std::size_t
+  capacity () const
+  {
+    return ((m_usart_handle.CR1.raw () & USART_CR1_FIFOEN) == USART_CR1_FIFOEN) ? FIFO_DEPTH : 1;
+  }
+
+  void
+  queue_byte (uint32_t value)
+  {
+    if ((m_usart_handle.CR1.raw () & USART_CR1_UE) != USART_CR1_UE) { return; }
+
+    m_pending.push_back (value & USART_TDR_TDR_Msk);
+    m_usart_handle.ISR.raw () = m_usart_handle.ISR.raw () & ~USART_ISR_TC;
+    if (!m_shifting) { shift_next (); }
+    update_txe ();
+  }
+
+  void
+  shift_next ()
+  {
+    m_shifting = true;
+    m_last_byte = m_pending.front ();
+    m_pending.pop_front ();
+
+    const uint64_t duration_ns = frame_time_ns ();
+    m_sim.schedule (duration_ns, [this, duration_ns] {
+      m_bus.record (duration_ns, 1);
+      m_bytes_sent++;
+      m_shifting = false;
+      if (!m_pending.empty ()) { shift_next (); }
+      else { m_usart_handle.ISR.raw () = m_usart_handle.ISR.raw () | USART_ISR_TC; }
+      update_txe ();
+    });
+  }
+
+  void
+  update_txe ()
+  {
+    if (m_pending.size () < capacity ()) { m_usart_handle.ISR.raw () = m_usart_handle.ISR.raw () | USART_ISR_TXE_TXFNF; }
+    else { m_usart_handle.ISR.raw () = m_usart_handle.ISR.raw () & ~USART_ISR_TXE_TXFNF; }
+  }
+
+  Simulation &m_sim;
+  USART_TypeDef &m_usart_handle;
+  uint32_t m_pclk_hz;
+  BusMonitor m_bus;
+  std::deque<uint32_t> m_pending;
+  bool m_shifting{ false };
+  std::size_t m_bytes_sent{ 0 };
+  uint32_t m_last_byte{ 0 };
+};
+
+} // namespace stm32::mock
+
+#endif // __MOCK_USART_HPP__
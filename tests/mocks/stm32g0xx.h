@@ -43,6 +43,7 @@
 #define MODIFY_REG(REG, CLEARMASK, SETMASK)  WRITE_REG((REG), (((READ_REG(REG)) & (~(CLEARMASK))) | (SETMASK)))
 
 #include <cstdint>
+#include <mock_register.hpp>
 
 #ifdef __cplusplus
  extern "C" {
@@ -69,13 +70,16 @@ inline uint32_t SystemCoreClock = 64000000UL;
 #define     __OM     volatile            /*! Defines 'write only' structure member permissions */
 #define     __IOM    volatile            /*! Defines 'read / write' structure member permissions */
 
+/* mocked registers report each access to stm32::mock::Simulation, see mock_register.hpp */
+#define     __IO_REG stm32::mock::Register
+
 
 typedef struct
 {
-  __IOM uint32_t CTRL   {0x00000004}; /*!< Offset: 0x000 (R/W)  SysTick Control and Status Register */
-  __IOM uint32_t LOAD   {0x00000000}; /*!< Offset: 0x004 (R/W)  SysTick Reload Value Register */
-  __IOM uint32_t VAL    {0x00000000}; /*!< Offset: 0x008 (R/W)  SysTick Current Value Register */
-  __IM  uint32_t CALIB  {0x80000000}; /*!< Offset: 0x00C (R/ )  SysTick Calibration Register */
+  __IO_REG CTRL   {0x00000004}; /*!< Offset: 0x000 (R/W)  SysTick Control and Status Register */
+  __IO_REG LOAD   {0x00000000}; /*!< Offset: 0x004 (R/W)  SysTick Reload Value Register */
+  __IO_REG VAL    {0x00000000}; /*!< Offset: 0x008 (R/W)  SysTick Current Value Register */
+  __IO_REG CALIB  {0x80000000}; /*!< Offset: 0x00C (R/ )  SysTick Calibration Register */
 } SysTick_Type;
 
 /* Memory mapping of Core Hardware */
@@ -187,30 +191,30 @@ typedef enum
   */
 typedef struct
 {
-  __IO uint32_t ISR					{0x00000000}; /*!< ADC interrupt and status register,             Address offset: 0x00 */
-  __IO uint32_t IER					{0x00000000}; /*!< ADC interrupt enable register,                 Address offset: 0x04 */
-  __IO uint32_t CR					{0x00000000}; /*!< ADC control register,                          Address offset: 0x08 */
-  __IO uint32_t CFGR1				{0x00000000}; /*!< ADC configuration register 1,                  Address offset: 0x0C */
-  __IO uint32_t CFGR2				{0x00000000}; /*!< ADC configuration register 2,                  Address offset: 0x10 */
-  __IO uint32_t SMPR				{0x00000000}; /*!< ADC sampling time register,                    Address offset: 0x14 */
+  __IO_REG ISR					{0x00000000}; /*!< ADC interrupt and status register,             Address offset: 0x00 */
+  __IO_REG IER					{0x00000000}; /*!< ADC interrupt enable register,                 Address offset: 0x04 */
+  __IO_REG CR					{0x00000000}; /*!< ADC control register,                          Address offset: 0x08 */
+  __IO_REG CFGR1				{0x00000000}; /*!< ADC configuration register 1,                  Address offset: 0x0C */
+  __IO_REG CFGR2				{0x00000000}; /*!< ADC configuration register 2,                  Address offset: 0x10 */
+  __IO_REG SMPR				{0x00000000}; /*!< ADC sampling time register,                    Address offset: 0x14 */
        uint32_t RESERVED1			{0x00000000}; /*!< Reserved,                                                      0x18 */
        uint32_t RESERVED2			{0x00000000}; /*!< Reserved,                                                      0x1C */
-  __IO uint32_t TR1					{0x00000000}; /*!< ADC analog watchdog 1 threshold register,      Address offset: 0x20 */
-  __IO uint32_t TR2					{0x00000000}; /*!< ADC analog watchdog 2 threshold register,      Address offset: 0x24 */
-  __IO uint32_t CHSELR				{0x00000000}; /*!< ADC group regular sequencer register,          Address offset: 0x28 */
-  __IO uint32_t TR3					{0x00000000}; /*!< ADC analog watchdog 3 threshold register,      Address offset: 0x2C */
+  __IO_REG TR1					{0x00000000}; /*!< ADC analog watchdog 1 threshold register,      Address offset: 0x20 */
+  __IO_REG TR2					{0x00000000}; /*!< ADC analog watchdog 2 threshold register,      Address offset: 0x24 */
+  __IO_REG CHSELR				{0x00000000}; /*!< ADC group regular sequencer register,          Address offset: 0x28 */
+  __IO_REG TR3					{0x00000000}; /*!< ADC analog watchdog 3 threshold register,      Address offset: 0x2C */
        uint32_t RESERVED3[4]		{0x00000000}; /*!< Reserved,                                               0x30 - 0x3C */
-  __IO uint32_t DR					{0x00000000}; /*!< ADC group regular data register,               Address offset: 0x40 */
+  __IO_REG DR					{0x00000000}; /*!< ADC group regular data register,               Address offset: 0x40 */
        uint32_t RESERVED4[23]       {0x00000000}; /*!< Reserved,                                               0x44 - 0x9C */
-  __IO uint32_t AWD2CR				{0x00000000}; /*!< ADC analog watchdog 2 configuration register,  Address offset: 0xA0 */
-  __IO uint32_t AWD3CR				{0x00000000}; /*!< ADC analog watchdog 3 configuration register,  Address offset: 0xA4 */
+  __IO_REG AWD2CR				{0x00000000}; /*!< ADC analog watchdog 2 configuration register,  Address offset: 0xA0 */
+  __IO_REG AWD3CR				{0x00000000}; /*!< ADC analog watchdog 3 configuration register,  Address offset: 0xA4 */
        uint32_t RESERVED5[3]		{0x00000000}; /*!< Reserved,                                               0xA8 - 0xB0 */
-  __IO uint32_t CALFACT				{0x00000000}; /*!< ADC Calibration factor register,               Address offset: 0xB4 */
+  __IO_REG CALFACT				{0x00000000}; /*!< ADC Calibration factor register,               Address offset: 0xB4 */
 } ADC_TypeDef;
 
 typedef struct
 {
-  __IO uint32_t CCR					{0x00000000}; /*!< ADC common configuration register,             Address offset: ADC1 base address + 0x308 */
+  __IO_REG CCR					{0x00000000}; /*!< ADC common configuration register,             Address offset: ADC1 base address + 0x308 */
 } ADC_Common_TypeDef;
 
 /**
@@ -219,48 +223,48 @@ typedef struct
 
 typedef struct
 {
-  __IO uint32_t CREL			    {0x00000000}; /*!< FDCAN Core Release register,                                     Address offset: 0x000 */
-  __IO uint32_t ENDN				{0x00000000}; /*!< FDCAN Endian register,                                           Address offset: 0x004 */
+  __IO_REG CREL			    {0x00000000}; /*!< FDCAN Core Release register,                                     Address offset: 0x000 */
+  __IO_REG ENDN				{0x00000000}; /*!< FDCAN Endian register,                                           Address offset: 0x004 */
        uint32_t RESERVED1			{0x00000000}; /*!< Reserved,                                                                        0x008 */
-  __IO uint32_t DBTP			    {0x00000000}; /*!< FDCAN Data Bit Timing & Prescaler register,                      Address offset: 0x00C */
-  __IO uint32_t TEST				{0x00000000}; /*!< FDCAN Test register,                                             Address offset: 0x010 */
-  __IO uint32_t RWD					{0x00000000}; /*!< FDCAN RAM Watchdog register,                                     Address offset: 0x014 */
-  __IO uint32_t CCCR				{0x00000000}; /*!< FDCAN CC Control register,                                       Address offset: 0x018 */
-  __IO uint32_t NBTP				{0x00000000}; /*!< FDCAN Nominal Bit Timing & Prescaler register,                   Address offset: 0x01C */
-  __IO uint32_t TSCC				{0x00000000}; /*!< FDCAN Timestamp Counter Configuration register,                  Address offset: 0x020 */
-  __IO uint32_t TSCV				{0x00000000}; /*!< FDCAN Timestamp Counter Value register,                          Address offset: 0x024 */
-  __IO uint32_t TOCC				{0x00000000}; /*!< FDCAN Timeout Counter Configuration register,                    Address offset: 0x028 */
-  __IO uint32_t TOCV				{0x00000000}; /*!< FDCAN Timeout Counter Value register,                            Address offset: 0x02C */
+  __IO_REG DBTP			    {0x00000000}; /*!< FDCAN Data Bit Timing & Prescaler register,                      Address offset: 0x00C */
+  __IO_REG TEST				{0x00000000}; /*!< FDCAN Test register,                                             Address offset: 0x010 */
+  __IO_REG RWD					{0x00000000}; /*!< FDCAN RAM Watchdog register,                                     Address offset: 0x014 */
+  __IO_REG CCCR				{0x00000000}; /*!< FDCAN CC Control register,                                       Address offset: 0x018 */
+  __IO_REG NBTP				{0x00000000}; /*!< FDCAN Nominal Bit Timing & Prescaler register,                   Address offset: 0x01C */
+  __IO_REG TSCC				{0x00000000}; /*!< FDCAN Timestamp Counter Configuration register,                  Address offset: 0x020 */
+  __IO_REG TSCV				{0x00000000}; /*!< FDCAN Timestamp Counter Value register,                          Address offset: 0x024 */
+  __IO_REG TOCC				{0x00000000}; /*!< FDCAN Timeout Counter Configuration register,                    Address offset: 0x028 */
+  __IO_REG TOCV				{0x00000000}; /*!< FDCAN Timeout Counter Value register,                            Address offset: 0x02C */
        uint32_t RESERVED2[4]		{0x00000000}; /*!< Reserved,                                                                0x030 - 0x03C */
-  __IO uint32_t ECR					{0x00000000}; /*!< FDCAN Error Counter register,                                    Address offset: 0x040 */
-  __IO uint32_t PSR					{0x00000000}; /*!< FDCAN Protocol Status register,                                  Address offset: 0x044 */
-  __IO uint32_t TDCR				{0x00000000}; /*!< FDCAN Transmitter Delay Compensation register,                   Address offset: 0x048 */
+  __IO_REG ECR					{0x00000000}; /*!< FDCAN Error Counter register,                                    Address offset: 0x040 */
+  __IO_REG PSR					{0x00000000}; /*!< FDCAN Protocol Status register,                                  Address offset: 0x044 */
+  __IO_REG TDCR				{0x00000000}; /*!< FDCAN Transmitter Delay Compensation register,                   Address offset: 0x048 */
        uint32_t RESERVED3			{0x00000000}; /*!< Reserved,                                                                        0x04C */
-  __IO uint32_t IR					{0x00000000}; /*!< FDCAN Interrupt register,                                        Address offset: 0x050 */
-  __IO uint32_t IE					{0x00000000}; /*!< FDCAN Interrupt Enable register,                                 Address offset: 0x054 */
-  __IO uint32_t ILS					{0x00000000}; /*!< FDCAN Interrupt Line Select register,                            Address offset: 0x058 */
-  __IO uint32_t ILE					{0x00000000}; /*!< FDCAN Interrupt Line Enable register,                            Address offset: 0x05C */
+  __IO_REG IR					{0x00000000}; /*!< FDCAN Interrupt register,                                        Address offset: 0x050 */
+  __IO_REG IE					{0x00000000}; /*!< FDCAN Interrupt Enable register,                                 Address offset: 0x054 */
+  __IO_REG ILS					{0x00000000}; /*!< FDCAN Interrupt Line Select register,                            Address offset: 0x058 */
+  __IO_REG ILE					{0x00000000}; /*!< FDCAN Interrupt Line Enable register,                            Address offset: 0x05C */
        uint32_t RESERVED4[8]	    {0x00000000}; /*!< Reserved,                                                                0x060 - 0x07C */
-  __IO uint32_t RXGFC				{0x00000000}; /*!< FDCAN Global Filter Configuration register,                      Address offset: 0x080 */
-  __IO uint32_t XIDAM				{0x00000000}; /*!< FDCAN Extended ID AND Mask register,                             Address offset: 0x084 */
-  __IO uint32_t HPMS				{0x00000000}; /*!< FDCAN High Priority Message Status register,                     Address offset: 0x088 */
+  __IO_REG RXGFC				{0x00000000}; /*!< FDCAN Global Filter Configuration register,                      Address offset: 0x080 */
+  __IO_REG XIDAM				{0x00000000}; /*!< FDCAN Extended ID AND Mask register,                             Address offset: 0x084 */
+  __IO_REG HPMS				{0x00000000}; /*!< FDCAN High Priority Message Status register,                     Address offset: 0x088 */
        uint32_t RESERVED5			{0x00000000}; /*!< Reserved,                                                                        0x08C */
-  __IO uint32_t RXF0S				{0x00000000}; /*!< FDCAN Rx FIFO 0 Status register,                                 Address offset: 0x090 */
-  __IO uint32_t RXF0A				{0x00000000}; /*!< FDCAN Rx FIFO 0 Acknowledge register,                            Address offset: 0x094 */
-  __IO uint32_t RXF1S				{0x00000000}; /*!< FDCAN Rx FIFO 1 Status register,                                 Address offset: 0x098 */
-  __IO uint32_t RXF1A				{0x00000000}; /*!< FDCAN Rx FIFO 1 Acknowledge register,                            Address offset: 0x09C */
+  __IO_REG RXF0S				{0x00000000}; /*!< FDCAN Rx FIFO 0 Status register,                                 Address offset: 0x090 */
+  __IO_REG RXF0A				{0x00000000}; /*!< FDCAN Rx FIFO 0 Acknowledge register,                            Address offset: 0x094 */
+  __IO_REG RXF1S				{0x00000000}; /*!< FDCAN Rx FIFO 1 Status register,                                 Address offset: 0x098 */
+  __IO_REG RXF1A				{0x00000000}; /*!< FDCAN Rx FIFO 1 Acknowledge register,                            Address offset: 0x09C */
        uint32_t RESERVED6[8]		{0x00000000}; /*!< Reserved,                                                                0x0A0 - 0x0BC */
-  __IO uint32_t TXBC				{0x00000000}; /*!< FDCAN Tx Buffer Configuration register,                          Address offset: 0x0C0 */
-  __IO uint32_t TXFQS				{0x00000000}; /*!< FDCAN Tx FIFO/Queue Status register,                             Address offset: 0x0C4 */
-  __IO uint32_t TXBRP				{0x00000000}; /*!< FDCAN Tx Buffer Request Pending register,                        Address offset: 0x0C8 */
-  __IO uint32_t TXBAR				{0x00000000}; /*!< FDCAN Tx Buffer Add Request register,                            Address offset: 0x0CC */
-  __IO uint32_t TXBCR				{0x00000000}; /*!< FDCAN Tx Buffer Cancellation Request register,                   Address offset: 0x0D0 */
-  __IO uint32_t TXBTO				{0x00000000}; /*!< FDCAN Tx Buffer Transmission Occurred register,                  Address offset: 0x0D4 */
-  __IO uint32_t TXBCF				{0x00000000}; /*!< FDCAN Tx Buffer Cancellation Finished register,                  Address offset: 0x0D8 */
-  __IO uint32_t TXBTIE				{0x00000000}; /*!< FDCAN Tx Buffer Transmission Interrupt Enable register,          Address offset: 0x0DC */
-  __IO uint32_t TXBCIE				{0x00000000}; /*!< FDCAN Tx Buffer Cancellation Finished Interrupt Enable register, Address offset: 0x0E0 */
-  __IO uint32_t TXEFS				{0x00000000}; /*!< FDCAN Tx Event FIFO Status register,                             Address offset: 0x0E4 */
-  __IO uint32_t TXEFA				{0x00000000}; /*!< FDCAN Tx Event FIFO Acknowledge register,                        Address offset: 0x0E8 */
+  __IO_REG TXBC				{0x00000000}; /*!< FDCAN Tx Buffer Configuration register,                          Address offset: 0x0C0 */
+  __IO_REG TXFQS				{0x00000000}; /*!< FDCAN Tx FIFO/Queue Status register,                             Address offset: 0x0C4 */
+  __IO_REG TXBRP				{0x00000000}; /*!< FDCAN Tx Buffer Request Pending register,                        Address offset: 0x0C8 */
+  __IO_REG TXBAR				{0x00000000}; /*!< FDCAN Tx Buffer Add Request register,                            Address offset: 0x0CC */
+  __IO_REG TXBCR				{0x00000000}; /*!< FDCAN Tx Buffer Cancellation Request register,                   Address offset: 0x0D0 */
+  __IO_REG TXBTO				{0x00000000}; /*!< FDCAN Tx Buffer Transmission Occurred register,                  Address offset: 0x0D4 */
+  __IO_REG TXBCF				{0x00000000}; /*!< FDCAN Tx Buffer Cancellation Finished register,                  Address offset: 0x0D8 */
+  __IO_REG TXBTIE				{0x00000000}; /*!< FDCAN Tx Buffer Transmission Interrupt Enable register,          Address offset: 0x0DC */
+  __IO_REG TXBCIE				{0x00000000}; /*!< FDCAN Tx Buffer Cancellation Finished Interrupt Enable register, Address offset: 0x0E0 */
+  __IO_REG TXEFS				{0x00000000}; /*!< FDCAN Tx Event FIFO Status register,                             Address offset: 0x0E4 */
+  __IO_REG TXEFA				{0x00000000}; /*!< FDCAN Tx Event FIFO Acknowledge register,                        Address offset: 0x0E8 */
 } FDCAN_GlobalTypeDef;
 
 /**
@@ -269,7 +273,7 @@ typedef struct
 
 typedef struct
 {
-  __IO uint32_t CKDIV			    {0x00000000}; /*!< FDCAN clock divider register,                            Address offset: 0x100 + 0x000 */
+  __IO_REG CKDIV			    {0x00000000}; /*!< FDCAN clock divider register,                            Address offset: 0x100 + 0x000 */
 } FDCAN_Config_TypeDef;
 
 /**
@@ -277,12 +281,12 @@ typedef struct
   */
 typedef struct
 {
-  __IO uint32_t CR					{0x00000000}; /*!< CEC control register,                                       Address offset:0x00 */
-  __IO uint32_t CFGR				{0x00000000}; /*!< CEC configuration register,                                 Address offset:0x04 */
-  __IO uint32_t TXDR				{0x00000000}; /*!< CEC Tx data register ,                                      Address offset:0x08 */
-  __IO uint32_t RXDR				{0x00000000}; /*!< CEC Rx Data Register,                                       Address offset:0x0C */
-  __IO uint32_t ISR					{0x00000000}; /*!< CEC Interrupt and Status Register,                          Address offset:0x10 */
-  __IO uint32_t IER					{0x00000000}; /*!< CEC interrupt enable register,                              Address offset:0x14 */
+  __IO_REG CR					{0x00000000}; /*!< CEC control register,                                       Address offset:0x00 */
+  __IO_REG CFGR				{0x00000000}; /*!< CEC configuration register,                                 Address offset:0x04 */
+  __IO_REG TXDR				{0x00000000}; /*!< CEC Tx data register ,                                      Address offset:0x08 */
+  __IO_REG RXDR				{0x00000000}; /*!< CEC Rx Data Register,                                       Address offset:0x0C */
+  __IO_REG ISR					{0x00000000}; /*!< CEC Interrupt and Status Register,                          Address offset:0x10 */
+  __IO_REG IER					{0x00000000}; /*!< CEC interrupt enable register,                              Address offset:0x14 */
 }CEC_TypeDef;
 
 /**
@@ -290,13 +294,13 @@ typedef struct
   */
 typedef struct
 {
-  __IO uint32_t CSR					{0x00000000}; /*!< COMP control and status register,                                                 Address offset: 0x00 */
+  __IO_REG CSR					{0x00000000}; /*!< COMP control and status register,                                                 Address offset: 0x00 */
 } COMP_TypeDef;
 
 typedef struct
 {
-  __IO uint32_t CSR_ODD				{0x00000000}; /*!< COMP control and status register located in register of comparator instance odd (exception for STM32G0 devices featuring ADC3 instance: in common group of COMP2 and COMP3, instances odd and even are inverted), used for bits common to several COMP instances, Address offset: 0x00 */
-  __IO uint32_t CSR_EVEN			{0x00000000}; /*!< COMP control and status register located in register of comparator instance even (exception for STM32G0 devices featuring ADC3 instance: in common group of COMP2 and COMP3, instances odd and even are inverted), used for bits common to several COMP instances, Address offset: 0x04 */
+  __IO_REG CSR_ODD				{0x00000000}; /*!< COMP control and status register located in register of comparator instance odd (exception for STM32G0 devices featuring ADC3 instance: in common group of COMP2 and COMP3, instances odd and even are inverted), used for bits common to several COMP instances, Address offset: 0x00 */
+  __IO_REG CSR_EVEN			{0x00000000}; /*!< COMP control and status register located in register of comparator instance even (exception for STM32G0 devices featuring ADC3 instance: in common group of COMP2 and COMP3, instances odd and even are inverted), used for bits common to several COMP instances, Address offset: 0x04 */
 } COMP_Common_TypeDef;
 
 /**
@@ -304,12 +308,12 @@ typedef struct
   */
 typedef struct
 {
-  __IO uint32_t DR					{0x00000000}; /*!< CRC Data register,                         Address offset: 0x00 */
-  __IO uint32_t IDR					{0x00000000}; /*!< CRC Independent data register,             Address offset: 0x04 */
-  __IO uint32_t CR					{0x00000000}; /*!< CRC Control register,                      Address offset: 0x08 */
+  __IO_REG DR					{0x00000000}; /*!< CRC Data register,                         Address offset: 0x00 */
+  __IO_REG IDR					{0x00000000}; /*!< CRC Independent data register,             Address offset: 0x04 */
+  __IO_REG CR					{0x00000000}; /*!< CRC Control register,                      Address offset: 0x08 */
        uint32_t RESERVED1			{0x00000000}; /*!< Reserved,                                                  0x0C */
-  __IO uint32_t INIT				{0x00000000}; /*!< Initial CRC value register,                Address offset: 0x10 */
-  __IO uint32_t POL					{0x00000000}; /*!< CRC polynomial register,                   Address offset: 0x14 */
+  __IO_REG INIT				{0x00000000}; /*!< Initial CRC value register,                Address offset: 0x10 */
+  __IO_REG POL					{0x00000000}; /*!< CRC polynomial register,                   Address offset: 0x14 */
 } CRC_TypeDef;
 
 /**
@@ -317,36 +321,36 @@ typedef struct
   */
 typedef struct
 {
-__IO uint32_t CR					{0x00000000}; /*!< CRS ccontrol register,              Address offset: 0x00 */
-__IO uint32_t CFGR					{0x00000000}; /*!< CRS configuration register,         Address offset: 0x04 */
-__IO uint32_t ISR					{0x00000000}; /*!< CRS interrupt and status register,  Address offset: 0x08 */
-__IO uint32_t ICR					{0x00000000}; /*!< CRS interrupt flag clear register,  Address offset: 0x0C */
+__IO_REG CR					{0x00000000}; /*!< CRS ccontrol register,              Address offset: 0x00 */
+__IO_REG CFGR					{0x00000000}; /*!< CRS configuration register,         Address offset: 0x04 */
+__IO_REG ISR					{0x00000000}; /*!< CRS interrupt and status register,  Address offset: 0x08 */
+__IO_REG ICR					{0x00000000}; /*!< CRS interrupt flag clear register,  Address offset: 0x0C */
 } CRS_TypeDef;
 /**
   * @brief Digital to Analog Converter
   */
 typedef struct
 {
-  __IO uint32_t CR					{0x00000000}; /*!< DAC control register,                                    Address offset: 0x00 */
-  __IO uint32_t SWTRIGR				{0x00000000}; /*!< DAC software trigger register,                           Address offset: 0x04 */
-  __IO uint32_t DHR12R1				{0x00000000}; /*!< DAC channel1 12-bit right-aligned data holding register, Address offset: 0x08 */
-  __IO uint32_t DHR12L1				{0x00000000}; /*!< DAC channel1 12-bit left aligned data holding register,  Address offset: 0x0C */
-  __IO uint32_t DHR8R1				{0x00000000}; /*!< DAC channel1 8-bit right aligned data holding register,  Address offset: 0x10 */
-  __IO uint32_t DHR12R2				{0x00000000}; /*!< DAC channel2 12-bit right aligned data holding register, Address offset: 0x14 */
-  __IO uint32_t DHR12L2				{0x00000000}; /*!< DAC channel2 12-bit left aligned data holding register,  Address offset: 0x18 */
-  __IO uint32_t DHR8R2				{0x00000000}; /*!< DAC channel2 8-bit right-aligned data holding register,  Address offset: 0x1C */
-  __IO uint32_t DHR12RD				{0x00000000}; /*!< Dual DAC 12-bit right-aligned data holding register,     Address offset: 0x20 */
-  __IO uint32_t DHR12LD				{0x00000000}; /*!< DUAL DAC 12-bit left aligned data holding register,      Address offset: 0x24 */
-  __IO uint32_t DHR8RD				{0x00000000}; /*!< DUAL DAC 8-bit right aligned data holding register,      Address offset: 0x28 */
-  __IO uint32_t DOR1				{0x00000000}; /*!< DAC channel1 data output register,                       Address offset: 0x2C */
-  __IO uint32_t DOR2				{0x00000000}; /*!< DAC channel2 data output register,                       Address offset: 0x30 */
-  __IO uint32_t SR					{0x00000000}; /*!< DAC status register,                                     Address offset: 0x34 */
-  __IO uint32_t CCR					{0x00000000}; /*!< DAC calibration control register,                        Address offset: 0x38 */
-  __IO uint32_t MCR					{0x00000000}; /*!< DAC mode control register,                               Address offset: 0x3C */
-  __IO uint32_t SHSR1				{0x00000000}; /*!< DAC Sample and Hold sample time register 1,              Address offset: 0x40 */
-  __IO uint32_t SHSR2				{0x00000000}; /*!< DAC Sample and Hold sample time register 2,              Address offset: 0x44 */
-  __IO uint32_t SHHR				{0x00000000}; /*!< DAC Sample and Hold hold time register,                  Address offset: 0x48 */
-  __IO uint32_t SHRR				{0x00000000}; /*!< DAC Sample and Hold refresh time register,               Address offset: 0x4C */
+  __IO_REG CR					{0x00000000}; /*!< DAC control register,                                    Address offset: 0x00 */
+  __IO_REG SWTRIGR				{0x00000000}; /*!< DAC software trigger register,                           Address offset: 0x04 */
+  __IO_REG DHR12R1				{0x00000000}; /*!< DAC channel1 12-bit right-aligned data holding register, Address offset: 0x08 */
+  __IO_REG DHR12L1				{0x00000000}; /*!< DAC channel1 12-bit left aligned data holding register,  Address offset: 0x0C */
+  __IO_REG DHR8R1				{0x00000000}; /*!< DAC channel1 8-bit right aligned data holding register,  Address offset: 0x10 */
+  __IO_REG DHR12R2				{0x00000000}; /*!< DAC channel2 12-bit right aligned data holding register, Address offset: 0x14 */
+  __IO_REG DHR12L2				{0x00000000}; /*!< DAC channel2 12-bit left aligned data holding register,  Address offset: 0x18 */
+  __IO_REG DHR8R2				{0x00000000}; /*!< DAC channel2 8-bit right-aligned data holding register,  Address offset: 0x1C */
+  __IO_REG DHR12RD				{0x00000000}; /*!< Dual DAC 12-bit right-aligned data holding register,     Address offset: 0x20 */
+  __IO_REG DHR12LD				{0x00000000}; /*!< DUAL DAC 12-bit left aligned data holding register,      Address offset: 0x24 */
+  __IO_REG DHR8RD				{0x00000000}; /*!< DUAL DAC 8-bit right aligned data holding register,      Address offset: 0x28 */
+  __IO_REG DOR1				{0x00000000}; /*!< DAC channel1 data output register,                       Address offset: 0x2C */
+  __IO_REG DOR2				{0x00000000}; /*!< DAC channel2 data output register,                       Address offset: 0x30 */
+  __IO_REG SR					{0x00000000}; /*!< DAC status register,                                     Address offset: 0x34 */
+  __IO_REG CCR					{0x00000000}; /*!< DAC calibration control register,                        Address offset: 0x38 */
+  __IO_REG MCR					{0x00000000}; /*!< DAC mode control register,                               Address offset: 0x3C */
+  __IO_REG SHSR1				{0x00000000}; /*!< DAC Sample and Hold sample time register 1,              Address offset: 0x40 */
+  __IO_REG SHSR2				{0x00000000}; /*!< DAC Sample and Hold sample time register 2,              Address offset: 0x44 */
+  __IO_REG SHHR				{0x00000000}; /*!< DAC Sample and Hold hold time register,                  Address offset: 0x48 */
+  __IO_REG SHRR				{0x00000000}; /*!< DAC Sample and Hold refresh time register,               Address offset: 0x4C */
 } DAC_TypeDef;
 
 /**
@@ -354,10 +358,10 @@ typedef struct
   */
 typedef struct
 {
-  __IO uint32_t IDCODE				{0x00000000}; /*!< MCU device ID code,              Address offset: 0x00 */
-  __IO uint32_t CR					{0x00000000}; /*!< Debug configuration register,    Address offset: 0x04 */
-  __IO uint32_t APBFZ1				{0x00000000}; /*!< Debug APB freeze register 1,     Address offset: 0x08 */
-  __IO uint32_t APBFZ2				{0x00000000}; /*!< Debug APB freeze register 2,     Address offset: 0x0C */
+  __IO_REG IDCODE				{0x00000000}; /*!< MCU device ID code,              Address offset: 0x00 */
+  __IO_REG CR					{0x00000000}; /*!< Debug configuration register,    Address offset: 0x04 */
+  __IO_REG APBFZ1				{0x00000000}; /*!< Debug APB freeze register 1,     Address offset: 0x08 */
+  __IO_REG APBFZ2				{0x00000000}; /*!< Debug APB freeze register 2,     Address offset: 0x0C */
 } DBG_TypeDef;
 
 /**
@@ -365,16 +369,16 @@ typedef struct
   */
 typedef struct
 {
-  __IO uint32_t CCR					{0x00000000}; /*!< DMA channel x configuration register        */
-  __IO uint32_t CNDTR				{0x00000000}; /*!< DMA channel x number of data register       */
-  __IO uint32_t CPAR				{0x00000000}; /*!< DMA channel x peripheral address register   */
-  __IO uint32_t CMAR				{0x00000000}; /*!< DMA channel x memory address register       */
+  __IO_REG CCR					{0x00000000}; /*!< DMA channel x configuration register        */
+  __IO_REG CNDTR				{0x00000000}; /*!< DMA channel x number of data register       */
+  __IO_REG CPAR				{0x00000000}; /*!< DMA channel x peripheral address register   */
+  __IO_REG CMAR				{0x00000000}; /*!< DMA channel x memory address register       */
 } DMA_Channel_TypeDef;
 
 typedef struct
 {
-  __IO uint32_t ISR					{0x00000000}; /*!< DMA interrupt status register,                 Address offset: 0x00 */
-  __IO uint32_t IFCR				{0x00000000}; /*!< DMA interrupt flag clear register,             Address offset: 0x04 */
+  __IO_REG ISR					{0x00000000}; /*!< DMA interrupt status register,                 Address offset: 0x00 */
+  __IO_REG IFCR				{0x00000000}; /*!< DMA interrupt flag clear register,             Address offset: 0x04 */
 } DMA_TypeDef;
 
 /**
@@ -382,24 +386,24 @@ typedef struct
   */
 typedef struct
 {
-  __IO uint32_t   CCR				{0x00000000}; /*!< DMA Multiplexer Channel x Control Register    Address offset: 0x0004 * (channel x) */
+  __IO_REG   CCR				{0x00000000}; /*!< DMA Multiplexer Channel x Control Register    Address offset: 0x0004 * (channel x) */
 }DMAMUX_Channel_TypeDef;
 
 typedef struct
 {
-  __IO uint32_t   CSR				{0x00000000}; /*!< DMA Channel Status Register                    Address offset: 0x0080   */
-  __IO uint32_t   CFR				{0x00000000}; /*!< DMA Channel Clear Flag Register                Address offset: 0x0084   */
+  __IO_REG   CSR				{0x00000000}; /*!< DMA Channel Status Register                    Address offset: 0x0080   */
+  __IO_REG   CFR				{0x00000000}; /*!< DMA Channel Clear Flag Register                Address offset: 0x0084   */
 }DMAMUX_ChannelStatus_TypeDef;
 
 typedef struct
 {
-  __IO uint32_t   RGCR				{0x00000000}; /*!< DMA Request Generator x Control Register     Address offset: 0x0100 + 0x0004 * (Req Gen x) */
+  __IO_REG   RGCR				{0x00000000}; /*!< DMA Request Generator x Control Register     Address offset: 0x0100 + 0x0004 * (Req Gen x) */
 }DMAMUX_RequestGen_TypeDef;
 
 typedef struct
 {
-  __IO uint32_t   RGSR				{0x00000000}; /*!< DMA Request Generator Status Register        Address offset: 0x0140   */
-  __IO uint32_t   RGCFR				{0x00000000}; /*!< DMA Request Generator Clear Flag Register    Address offset: 0x0144   */
+  __IO_REG   RGSR				{0x00000000}; /*!< DMA Request Generator Status Register        Address offset: 0x0140   */
+  __IO_REG   RGCFR				{0x00000000}; /*!< DMA Request Generator Clear Flag Register    Address offset: 0x0144   */
 }DMAMUX_RequestGenStatus_TypeDef;
 
 /**
@@ -407,25 +411,25 @@ typedef struct
   */
 typedef struct
 {
-  __IO uint32_t RTSR1				{0x00000000}; /*!< EXTI Rising Trigger Selection Register 1,        Address offset:   0x00 */
-  __IO uint32_t FTSR1				{0x00000000}; /*!< EXTI Falling Trigger Selection Register 1,       Address offset:   0x04 */
-  __IO uint32_t SWIER1				{0x00000000}; /*!< EXTI Software Interrupt event Register 1,        Address offset:   0x08 */
-  __IO uint32_t RPR1				{0x00000000}; /*!< EXTI Rising Pending Register 1,                  Address offset:   0x0C */
-  __IO uint32_t FPR1				{0x00000000}; /*!< EXTI Falling Pending Register 1,                 Address offset:   0x10 */
+  __IO_REG RTSR1				{0x00000000}; /*!< EXTI Rising Trigger Selection Register 1,        Address offset:   0x00 */
+  __IO_REG FTSR1				{0x00000000}; /*!< EXTI Falling Trigger Selection Register 1,       Address offset:   0x04 */
+  __IO_REG SWIER1				{0x00000000}; /*!< EXTI Software Interrupt event Register 1,        Address offset:   0x08 */
+  __IO_REG RPR1				{0x00000000}; /*!< EXTI Rising Pending Register 1,                  Address offset:   0x0C */
+  __IO_REG FPR1				{0x00000000}; /*!< EXTI Falling Pending Register 1,                 Address offset:   0x10 */
        uint32_t RESERVED1[3]		{0x00000000}; /*!< Reserved 1,                                                0x14 -- 0x1C */
-  __IO uint32_t RTSR2				{0x00000000}; /*!< EXTI Rising Trigger Selection Register 2,        Address offset:   0x20 */
-  __IO uint32_t FTSR2				{0x00000000}; /*!< EXTI Falling Trigger Selection Register 2,       Address offset:   0x24 */
-  __IO uint32_t SWIER2				{0x00000000}; /*!< EXTI Software Interrupt event Register 2,        Address offset:   0x28 */
-  __IO uint32_t RPR2				{0x00000000}; /*!< EXTI Rising Pending Register 2,                  Address offset:   0x2C */
-  __IO uint32_t FPR2				{0x00000000}; /*!< EXTI Falling Pending Register 2,                 Address offset:   0x30 */
+  __IO_REG RTSR2				{0x00000000}; /*!< EXTI Rising Trigger Selection Register 2,        Address offset:   0x20 */
+  __IO_REG FTSR2				{0x00000000}; /*!< EXTI Falling Trigger Selection Register 2,       Address offset:   0x24 */
+  __IO_REG SWIER2				{0x00000000}; /*!< EXTI Software Interrupt event Register 2,        Address offset:   0x28 */
+  __IO_REG RPR2				{0x00000000}; /*!< EXTI Rising Pending Register 2,                  Address offset:   0x2C */
+  __IO_REG FPR2				{0x00000000}; /*!< EXTI Falling Pending Register 2,                 Address offset:   0x30 */
        uint32_t RESERVED3[11]		{0x00000000}; /*!< Reserved 3,                                                0x34 -- 0x5C */
-  __IO uint32_t EXTICR[4]			{0x00000000}; /*!< EXTI External Interrupt Configuration Register,            0x60 -- 0x6C */
+  __IO_REG EXTICR[4]			{0x00000000}; /*!< EXTI External Interrupt Configuration Register,            0x60 -- 0x6C */
        uint32_t RESERVED4[4]		{0x00000000}; /*!< Reserved 4,                                                0x70 -- 0x7C */
-  __IO uint32_t IMR1				{0x00000000}; /*!< EXTI Interrupt Mask Register 1,                  Address offset:   0x80 */
-  __IO uint32_t EMR1				{0x00000000}; /*!< EXTI Event Mask Register 1,                      Address offset:   0x84 */
+  __IO_REG IMR1				{0x00000000}; /*!< EXTI Interrupt Mask Register 1,                  Address offset:   0x80 */
+  __IO_REG EMR1				{0x00000000}; /*!< EXTI Event Mask Register 1,                      Address offset:   0x84 */
        uint32_t RESERVED5[2]		{0x00000000}; /*!< Reserved 5,                                                0x88 -- 0x8C */
-  __IO uint32_t IMR2				{0x00000000}; /*!< EXTI Interrupt Mask Register 2,                  Address offset:   0x90 */
-  __IO uint32_t EMR2				{0x00000000}; /*!< EXTI Event Mask Register 2,                      Address offset:   0x94 */
+  __IO_REG IMR2				{0x00000000}; /*!< EXTI Interrupt Mask Register 2,                  Address offset:   0x90 */
+  __IO_REG EMR2				{0x00000000}; /*!< EXTI Event Mask Register 2,                      Address offset:   0x94 */
 } EXTI_TypeDef;
 
 /**
@@ -433,30 +437,30 @@ typedef struct
   */
 typedef struct
 {
-  __IO uint32_t ACR					{0x00000000}; /*!< FLASH Access Control register,                     Address offset: 0x00 */
+  __IO_REG ACR					{0x00000000}; /*!< FLASH Access Control register,                     Address offset: 0x00 */
        uint32_t RESERVED1			{0x00000000}; /*!< Reserved1,                                         Address offset: 0x04 */
-  __IO uint32_t KEYR				{0x00000000}; /*!< FLASH Key register,                                Address offset: 0x08 */
-  __IO uint32_t OPTKEYR				{0x00000000}; /*!< FLASH Option Key register,                         Address offset: 0x0C */
-  __IO uint32_t SR					{0x00000000}; /*!< FLASH Status register,                             Address offset: 0x10 */
-  __IO uint32_t CR					{0x00000000}; /*!< FLASH Control register,                            Address offset: 0x14 */
-  __IO uint32_t ECCR				{0x00000000}; /*!< FLASH ECC bank 1 register,                        Address offset: 0x18 */
-  __IO uint32_t ECC2R				{0x00000000}; /*!< FLASH ECC bank 2 register,                        Address offset: 0x1C */
-  __IO uint32_t OPTR				{0x00000000}; /*!< FLASH Option register,                             Address offset: 0x20 */
-  __IO uint32_t PCROP1ASR			{0x00000000}; /*!< FLASH Bank PCROP area A Start address register,    Address offset: 0x24 */
-  __IO uint32_t PCROP1AER			{0x00000000}; /*!< FLASH Bank PCROP area A End address register,      Address offset: 0x28 */
-  __IO uint32_t WRP1AR				{0x00000000}; /*!< FLASH Bank WRP area A address register,            Address offset: 0x2C */
-  __IO uint32_t WRP1BR				{0x00000000}; /*!< FLASH Bank WRP area B address register,            Address offset: 0x30 */
-  __IO uint32_t PCROP1BSR			{0x00000000}; /*!< FLASH Bank PCROP area B Start address register,    Address offset: 0x34 */
-  __IO uint32_t PCROP1BER			{0x00000000}; /*!< FLASH Bank PCROP area B End address register,      Address offset: 0x38 */
+  __IO_REG KEYR				{0x00000000}; /*!< FLASH Key register,                                Address offset: 0x08 */
+  __IO_REG OPTKEYR				{0x00000000}; /*!< FLASH Option Key register,                         Address offset: 0x0C */
+  __IO_REG SR					{0x00000000}; /*!< FLASH Status register,                             Address offset: 0x10 */
+  __IO_REG CR					{0x00000000}; /*!< FLASH Control register,                            Address offset: 0x14 */
+  __IO_REG ECCR				{0x00000000}; /*!< FLASH ECC bank 1 register,                        Address offset: 0x18 */
+  __IO_REG ECC2R				{0x00000000}; /*!< FLASH ECC bank 2 register,                        Address offset: 0x1C */
+  __IO_REG OPTR				{0x00000000}; /*!< FLASH Option register,                             Address offset: 0x20 */
+  __IO_REG PCROP1ASR			{0x00000000}; /*!< FLASH Bank PCROP area A Start address register,    Address offset: 0x24 */
+  __IO_REG PCROP1AER			{0x00000000}; /*!< FLASH Bank PCROP area A End address register,      Address offset: 0x28 */
+  __IO_REG WRP1AR				{0x00000000}; /*!< FLASH Bank WRP area A address register,            Address offset: 0x2C */
+  __IO_REG WRP1BR				{0x00000000}; /*!< FLASH Bank WRP area B address register,            Address offset: 0x30 */
+  __IO_REG PCROP1BSR			{0x00000000}; /*!< FLASH Bank PCROP area B Start address register,    Address offset: 0x34 */
+  __IO_REG PCROP1BER			{0x00000000}; /*!< FLASH Bank PCROP area B End address register,      Address offset: 0x38 */
        uint32_t RESERVED5[2]		{0x00000000}; /*!< Reserved5,                                         Address offset: 0x3C--0x40 */
-  __IO uint32_t PCROP2ASR			{0x00000000}; /*!< FLASH Bank2 PCROP area A Start address register,   Address offset: 0x44 */
-  __IO uint32_t PCROP2AER			{0x00000000}; /*!< FLASH Bank2 PCROP area A End address register,     Address offset: 0x48 */
-  __IO uint32_t WRP2AR				{0x00000000}; /*!< FLASH Bank2 WRP area A address register,           Address offset: 0x4C */
-  __IO uint32_t WRP2BR				{0x00000000}; /*!< FLASH Bank2 WRP area B address register,           Address offset: 0x50 */
-  __IO uint32_t PCROP2BSR			{0x00000000}; /*!< FLASH Bank2 PCROP area B Start address register,   Address offset: 0x54 */
-  __IO uint32_t PCROP2BER			{0x00000000}; /*!< FLASH Bank2 PCROP area B End address register,     Address offset: 0x58 */
+  __IO_REG PCROP2ASR			{0x00000000}; /*!< FLASH Bank2 PCROP area A Start address register,   Address offset: 0x44 */
+  __IO_REG PCROP2AER			{0x00000000}; /*!< FLASH Bank2 PCROP area A End address register,     Address offset: 0x48 */
+  __IO_REG WRP2AR				{0x00000000}; /*!< FLASH Bank2 WRP area A address register,           Address offset: 0x4C */
+  __IO_REG WRP2BR				{0x00000000}; /*!< FLASH Bank2 WRP area B address register,           Address offset: 0x50 */
+  __IO_REG PCROP2BSR			{0x00000000}; /*!< FLASH Bank2 PCROP area B Start address register,   Address offset: 0x54 */
+  __IO_REG PCROP2BER			{0x00000000}; /*!< FLASH Bank2 PCROP area B End address register,     Address offset: 0x58 */
        uint32_t RESERVED7[9]		{0x00000000}; /*!< Reserved7,                                         Address offset: 0x5C--0x7C */
-  __IO uint32_t SECR				{0x00000000}; /*!< FLASH security register ,                          Address offset: 0x80 */
+  __IO_REG SECR				{0x00000000}; /*!< FLASH security register ,                          Address offset: 0x80 */
 } FLASH_TypeDef;
 
 /**
@@ -464,16 +468,16 @@ typedef struct
   */
 typedef struct
 {
-  __IO uint32_t MODER				{0x00000000}; /*!< GPIO port mode register,               Address offset: 0x00      */
-  __IO uint32_t OTYPER				{0x00000000}; /*!< GPIO port output type register,        Address offset: 0x04      */
-  __IO uint32_t OSPEEDR				{0x00000000}; /*!< GPIO port output speed register,       Address offset: 0x08      */
-  __IO uint32_t PUPDR				{0x00000000}; /*!< GPIO port pull-up/pull-down register,  Address offset: 0x0C      */
-  __IO uint32_t IDR					{0x00000000}; /*!< GPIO port input data register,         Address offset: 0x10      */
-  __IO uint32_t ODR					{0x00000000}; /*!< GPIO port output data register,        Address offset: 0x14      */
-  __IO uint32_t BSRR				{0x00000000}; /*!< GPIO port bit set/reset  register,     Address offset: 0x18      */
-  __IO uint32_t LCKR				{0x00000000}; /*!< GPIO port configuration lock register, Address offset: 0x1C      */
-  __IO uint32_t AFR[2]				{0x00000000}; /*!< GPIO alternate function registers,     Address offset: 0x20-0x24 */
-  __IO uint32_t BRR					{0x00000000}; /*!< GPIO Bit Reset register,               Address offset: 0x28      */
+  __IO_REG MODER				{0x00000000}; /*!< GPIO port mode register,               Address offset: 0x00      */
+  __IO_REG OTYPER				{0x00000000}; /*!< GPIO port output type register,        Address offset: 0x04      */
+  __IO_REG OSPEEDR				{0x00000000}; /*!< GPIO port output speed register,       Address offset: 0x08      */
+  __IO_REG PUPDR				{0x00000000}; /*!< GPIO port pull-up/pull-down register,  Address offset: 0x0C      */
+  __IO_REG IDR					{0x00000000}; /*!< GPIO port input data register,         Address offset: 0x10      */
+  __IO_REG ODR					{0x00000000}; /*!< GPIO port output data register,        Address offset: 0x14      */
+  __IO_REG BSRR				{0x00000000}; /*!< GPIO port bit set/reset  register,     Address offset: 0x18      */
+  __IO_REG LCKR				{0x00000000}; /*!< GPIO port configuration lock register, Address offset: 0x1C      */
+  __IO_REG AFR[2]				{0x00000000}; /*!< GPIO alternate function registers,     Address offset: 0x20-0x24 */
+  __IO_REG BRR					{0x00000000}; /*!< GPIO Bit Reset register,               Address offset: 0x28      */
 } GPIO_TypeDef;
 
 
@@ -482,17 +486,17 @@ typedef struct
   */
 typedef struct
 {
-  __IO uint32_t CR1					{0x00000000}; /*!< I2C Control register 1,            Address offset: 0x00 */
-  __IO uint32_t CR2					{0x00000000}; /*!< I2C Control register 2,            Address offset: 0x04 */
-  __IO uint32_t OAR1				{0x00000000}; /*!< I2C Own address 1 register,        Address offset: 0x08 */
-  __IO uint32_t OAR2				{0x00000000}; /*!< I2C Own address 2 register,        Address offset: 0x0C */
-  __IO uint32_t TIMINGR				{0x00000000}; /*!< I2C Timing register,               Address offset: 0x10 */
-  __IO uint32_t TIMEOUTR			{0x00000000}; /*!< I2C Timeout register,              Address offset: 0x14 */
-  __IO uint32_t ISR					{0x00000000}; /*!< I2C Interrupt and status register, Address offset: 0x18 */
-  __IO uint32_t ICR					{0x00000000}; /*!< I2C Interrupt clear register,      Address offset: 0x1C */
-  __IO uint32_t PECR				{0x00000000}; /*!< I2C PEC register,                  Address offset: 0x20 */
-  __IO uint32_t RXDR				{0x00000000}; /*!< I2C Receive data register,         Address offset: 0x24 */
-  __IO uint32_t TXDR				{0x00000000}; /*!< I2C Transmit data register,        Address offset: 0x28 */
+  __IO_REG CR1					{0x00000000}; /*!< I2C Control register 1,            Address offset: 0x00 */
+  __IO_REG CR2					{0x00000000}; /*!< I2C Control register 2,            Address offset: 0x04 */
+  __IO_REG OAR1				{0x00000000}; /*!< I2C Own address 1 register,        Address offset: 0x08 */
+  __IO_REG OAR2				{0x00000000}; /*!< I2C Own address 2 register,        Address offset: 0x0C */
+  __IO_REG TIMINGR				{0x00000000}; /*!< I2C Timing register,               Address offset: 0x10 */
+  __IO_REG TIMEOUTR			{0x00000000}; /*!< I2C Timeout register,              Address offset: 0x14 */
+  __IO_REG ISR					{0x00000000}; /*!< I2C Interrupt and status register, Address offset: 0x18 */
+  __IO_REG ICR					{0x00000000}; /*!< I2C Interrupt clear register,      Address offset: 0x1C */
+  __IO_REG PECR				{0x00000000}; /*!< I2C PEC register,                  Address offset: 0x20 */
+  __IO_REG RXDR				{0x00000000}; /*!< I2C Receive data register,         Address offset: 0x24 */
+  __IO_REG TXDR				{0x00000000}; /*!< I2C Transmit data register,        Address offset: 0x28 */
 } I2C_TypeDef;
 
 /**
@@ -500,11 +504,11 @@ typedef struct
   */
 typedef struct
 {
-  __IO uint32_t KR					{0x00000000}; /*!< IWDG Key register,       Address offset: 0x00 */
-  __IO uint32_t PR					{0x00000000}; /*!< IWDG Prescaler register, Address offset: 0x04 */
-  __IO uint32_t RLR					{0x00000000}; /*!< IWDG Reload register,    Address offset: 0x08 */
-  __IO uint32_t SR					{0x00000000}; /*!< IWDG Status register,    Address offset: 0x0C */
-  __IO uint32_t WINR				{0x00000000}; /*!< IWDG Window register,    Address offset: 0x10 */
+  __IO_REG KR					{0x00000000}; /*!< IWDG Key register,       Address offset: 0x00 */
+  __IO_REG PR					{0x00000000}; /*!< IWDG Prescaler register, Address offset: 0x04 */
+  __IO_REG RLR					{0x00000000}; /*!< IWDG Reload register,    Address offset: 0x08 */
+  __IO_REG SR					{0x00000000}; /*!< IWDG Status register,    Address offset: 0x0C */
+  __IO_REG WINR				{0x00000000}; /*!< IWDG Window register,    Address offset: 0x10 */
 } IWDG_TypeDef;
 
 /**
@@ -512,16 +516,16 @@ typedef struct
   */
 typedef struct
 {
-  __IO uint32_t ISR					{0x00000000}; /*!< LPTIM Interrupt and Status register,                Address offset: 0x00 */
-  __IO uint32_t ICR					{0x00000000}; /*!< LPTIM Interrupt Clear register,                     Address offset: 0x04 */
-  __IO uint32_t IER					{0x00000000}; /*!< LPTIM Interrupt Enable register,                    Address offset: 0x08 */
-  __IO uint32_t CFGR				{0x00000000}; /*!< LPTIM Configuration register,                       Address offset: 0x0C */
-  __IO uint32_t CR					{0x00000000}; /*!< LPTIM Control register,                             Address offset: 0x10 */
-  __IO uint32_t CMP					{0x00000000}; /*!< LPTIM Compare register,                             Address offset: 0x14 */
-  __IO uint32_t ARR					{0x00000000}; /*!< LPTIM Autoreload register,                          Address offset: 0x18 */
-  __IO uint32_t CNT					{0x00000000}; /*!< LPTIM Counter register,                             Address offset: 0x1C */
-  __IO uint32_t RESERVED1			{0x00000000}; /*!< Reserved1,                                          Address offset: 0x20 */
-  __IO uint32_t CFGR2				{0x00000000}; /*!< LPTIM Option register,                              Address offset: 0x24 */
+  __IO_REG ISR					{0x00000000}; /*!< LPTIM Interrupt and Status register,                Address offset: 0x00 */
+  __IO_REG ICR					{0x00000000}; /*!< LPTIM Interrupt Clear register,                     Address offset: 0x04 */
+  __IO_REG IER					{0x00000000}; /*!< LPTIM Interrupt Enable register,                    Address offset: 0x08 */
+  __IO_REG CFGR				{0x00000000}; /*!< LPTIM Configuration register,                       Address offset: 0x0C */
+  __IO_REG CR					{0x00000000}; /*!< LPTIM Control register,                             Address offset: 0x10 */
+  __IO_REG CMP					{0x00000000}; /*!< LPTIM Compare register,                             Address offset: 0x14 */
+  __IO_REG ARR					{0x00000000}; /*!< LPTIM Autoreload register,                          Address offset: 0x18 */
+  __IO_REG CNT					{0x00000000}; /*!< LPTIM Counter register,                             Address offset: 0x1C */
+  __IO_REG RESERVED1			{0x00000000}; /*!< Reserved1,                                          Address offset: 0x20 */
+  __IO_REG CFGR2				{0x00000000}; /*!< LPTIM Option register,                              Address offset: 0x24 */
 } LPTIM_TypeDef;
 
 
@@ -530,26 +534,26 @@ typedef struct
   */
 typedef struct
 {
-  __IO uint32_t CR1					{0x00000000}; /*!< PWR Power Control Register 1,                     Address offset: 0x00 */
-  __IO uint32_t CR2					{0x00000000}; /*!< PWR Power Control Register 2,                     Address offset: 0x04 */
-  __IO uint32_t CR3					{0x00000000}; /*!< PWR Power Control Register 3,                     Address offset: 0x08 */
-  __IO uint32_t CR4					{0x00000000}; /*!< PWR Power Control Register 4,                     Address offset: 0x0C */
-  __IO uint32_t SR1					{0x00000000}; /*!< PWR Power Status Register 1,                      Address offset: 0x10 */
-  __IO uint32_t SR2					{0x00000000}; /*!< PWR Power Status Register 2,                      Address offset: 0x14 */
-  __IO uint32_t SCR					{0x00000000}; /*!< PWR Power Status Clear Register,                  Address offset: 0x18 */
+  __IO_REG CR1					{0x00000000}; /*!< PWR Power Control Register 1,                     Address offset: 0x00 */
+  __IO_REG CR2					{0x00000000}; /*!< PWR Power Control Register 2,                     Address offset: 0x04 */
+  __IO_REG CR3					{0x00000000}; /*!< PWR Power Control Register 3,                     Address offset: 0x08 */
+  __IO_REG CR4					{0x00000000}; /*!< PWR Power Control Register 4,                     Address offset: 0x0C */
+  __IO_REG SR1					{0x00000000}; /*!< PWR Power Status Register 1,                      Address offset: 0x10 */
+  __IO_REG SR2					{0x00000000}; /*!< PWR Power Status Register 2,                      Address offset: 0x14 */
+  __IO_REG SCR					{0x00000000}; /*!< PWR Power Status Clear Register,                  Address offset: 0x18 */
        uint32_t RESERVED1			{0x00000000}; /*!< Reserved,                                         Address offset: 0x1C */
-  __IO uint32_t PUCRA				{0x00000000}; /*!< PWR Pull-Up Control Register of port A,           Address offset: 0x20 */
-  __IO uint32_t PDCRA				{0x00000000}; /*!< PWR Pull-Down Control Register of port A,         Address offset: 0x24 */
-  __IO uint32_t PUCRB				{0x00000000}; /*!< PWR Pull-Up Control Register of port B,           Address offset: 0x28 */
-  __IO uint32_t PDCRB				{0x00000000}; /*!< PWR Pull-Down Control Register of port B,         Address offset: 0x2C */
-  __IO uint32_t PUCRC				{0x00000000}; /*!< PWR Pull-Up Control Register of port C,           Address offset: 0x30 */
-  __IO uint32_t PDCRC				{0x00000000}; /*!< PWR Pull-Down Control Register of port C,         Address offset: 0x34 */
-  __IO uint32_t PUCRD				{0x00000000}; /*!< PWR Pull-Up Control Register of port D,           Address offset: 0x38 */
-  __IO uint32_t PDCRD				{0x00000000}; /*!< PWR Pull-Down Control Register of port D,         Address offset: 0x3C */
-  __IO uint32_t PUCRE				{0x00000000}; /*!< PWR Pull-Up Control Register of port E,           Address offset: 0x40 */
-  __IO uint32_t PDCRE				{0x00000000}; /*!< PWR Pull-Down Control Register of port E,         Address offset: 0x44 */
-  __IO uint32_t PUCRF				{0x00000000}; /*!< PWR Pull-Up Control Register of port F,           Address offset: 0x48 */
-  __IO uint32_t PDCRF				{0x00000000}; /*!< PWR Pull-Down Control Register of port F,         Address offset: 0x4C */
+  __IO_REG PUCRA				{0x00000000}; /*!< PWR Pull-Up Control Register of port A,           Address offset: 0x20 */
+  __IO_REG PDCRA				{0x00000000}; /*!< PWR Pull-Down Control Register of port A,         Address offset: 0x24 */
+  __IO_REG PUCRB				{0x00000000}; /*!< PWR Pull-Up Control Register of port B,           Address offset: 0x28 */
+  __IO_REG PDCRB				{0x00000000}; /*!< PWR Pull-Down Control Register of port B,         Address offset: 0x2C */
+  __IO_REG PUCRC				{0x00000000}; /*!< PWR Pull-Up Control Register of port C,           Address offset: 0x30 */
+  __IO_REG PDCRC				{0x00000000}; /*!< PWR Pull-Down Control Register of port C,         Address offset: 0x34 */
+  __IO_REG PUCRD				{0x00000000}; /*!< PWR Pull-Up Control Register of port D,           Address offset: 0x38 */
+  __IO_REG PDCRD				{0x00000000}; /*!< PWR Pull-Down Control Register of port D,         Address offset: 0x3C */
+  __IO_REG PUCRE				{0x00000000}; /*!< PWR Pull-Up Control Register of port E,           Address offset: 0x40 */
+  __IO_REG PDCRE				{0x00000000}; /*!< PWR Pull-Down Control Register of port E,         Address offset: 0x44 */
+  __IO_REG PUCRF				{0x00000000}; /*!< PWR Pull-Up Control Register of port F,           Address offset: 0x48 */
+  __IO_REG PDCRF				{0x00000000}; /*!< PWR Pull-Down Control Register of port F,         Address offset: 0x4C */
 } PWR_TypeDef;
 
 /**
@@ -557,31 +561,31 @@ typedef struct
   */
 typedef struct
 {
-  __IO uint32_t CR					{0x00000000}; /*!< RCC Clock Sources Control Register,                                     Address offset: 0x00 */
-  __IO uint32_t ICSCR				{0x00000000}; /*!< RCC Internal Clock Sources Calibration Register,                        Address offset: 0x04 */
-  __IO uint32_t CFGR				{0x00000000}; /*!< RCC Regulated Domain Clocks Configuration Register,                     Address offset: 0x08 */
-  __IO uint32_t PLLCFGR				{0x00000000}; /*!< RCC System PLL configuration Register,                                  Address offset: 0x0C */
-  __IO uint32_t RESERVED0			{0x00000000}; /*!< Reserved,                                                               Address offset: 0x10 */
-  __IO uint32_t CRRCR				{0x00000000}; /*!< RCC Clock Configuration Register,                                       Address offset: 0x14 */
-  __IO uint32_t CIER				{0x00000000}; /*!< RCC Clock Interrupt Enable Register,                                    Address offset: 0x18 */
-  __IO uint32_t CIFR				{0x00000000}; /*!< RCC Clock Interrupt Flag Register,                                      Address offset: 0x1C */
-  __IO uint32_t CICR				{0x00000000}; /*!< RCC Clock Interrupt Clear Register,                                     Address offset: 0x20 */
-  __IO uint32_t IOPRSTR				{0x00000000}; /*!< RCC IO port reset register,                                             Address offset: 0x24 */
-  __IO uint32_t AHBRSTR				{0x00000000}; /*!< RCC AHB peripherals reset register,                                     Address offset: 0x28 */
-  __IO uint32_t APBRSTR1			{0x00000000}; /*!< RCC APB peripherals reset register 1,                                   Address offset: 0x2C */
-  __IO uint32_t APBRSTR2			{0x00000000}; /*!< RCC APB peripherals reset register 2,                                   Address offset: 0x30 */
-  __IO uint32_t IOPENR				{0x00000000}; /*!< RCC IO port enable register,                                            Address offset: 0x34 */
-  __IO uint32_t AHBENR				{0x00000000}; /*!< RCC AHB peripherals clock enable register,                              Address offset: 0x38 */
-  __IO uint32_t APBENR1				{0x00000000}; /*!< RCC APB peripherals clock enable register1,                             Address offset: 0x3C */
-  __IO uint32_t APBENR2				{0x00000000}; /*!< RCC APB peripherals clock enable register2,                             Address offset: 0x40 */
-  __IO uint32_t IOPSMENR			{0x00000000}; /*!< RCC IO port clocks enable in sleep mode register,                       Address offset: 0x44 */
-  __IO uint32_t AHBSMENR			{0x00000000}; /*!< RCC AHB peripheral clocks enable in sleep mode register,                Address offset: 0x48 */
-  __IO uint32_t APBSMENR1			{0x00000000}; /*!< RCC APB peripheral clocks enable in sleep mode register1,               Address offset: 0x4C */
-  __IO uint32_t APBSMENR2			{0x00000000}; /*!< RCC APB peripheral clocks enable in sleep mode register2,               Address offset: 0x50 */
-  __IO uint32_t CCIPR				{0x00000000}; /*!< RCC Peripherals Independent Clocks Configuration Register,              Address offset: 0x54 */
-  __IO uint32_t CCIPR2				{0x00000000}; /*!< RCC Peripherals Independent Clocks Configuration Register2,             Address offset: 0x58 */
-  __IO uint32_t BDCR				{0x00000000}; /*!< RCC Backup Domain Control Register,                                     Address offset: 0x5C */
-  __IO uint32_t CSR					{0x00000000}; /*!< RCC Unregulated Domain Clock Control and Status Register,               Address offset: 0x60 */
+  __IO_REG CR					{0x00000000}; /*!< RCC Clock Sources Control Register,                                     Address offset: 0x00 */
+  __IO_REG ICSCR				{0x00000000}; /*!< RCC Internal Clock Sources Calibration Register,                        Address offset: 0x04 */
+  __IO_REG CFGR				{0x00000000}; /*!< RCC Regulated Domain Clocks Configuration Register,                     Address offset: 0x08 */
+  __IO_REG PLLCFGR				{0x00000000}; /*!< RCC System PLL configuration Register,                                  Address offset: 0x0C */
+  __IO_REG RESERVED0			{0x00000000}; /*!< Reserved,                                                               Address offset: 0x10 */
+  __IO_REG CRRCR				{0x00000000}; /*!< RCC Clock Configuration Register,                                       Address offset: 0x14 */
+  __IO_REG CIER				{0x00000000}; /*!< RCC Clock Interrupt Enable Register,                                    Address offset: 0x18 */
+  __IO_REG CIFR				{0x00000000}; /*!< RCC Clock Interrupt Flag Register,                                      Address offset: 0x1C */
+  __IO_REG CICR				{0x00000000}; /*!< RCC Clock Interrupt Clear Register,                                     Address offset: 0x20 */
+  __IO_REG IOPRSTR				{0x00000000}; /*!< RCC IO port reset register,                                             Address offset: 0x24 */
+  __IO_REG AHBRSTR				{0x00000000}; /*!< RCC AHB peripherals reset register,                                     Address offset: 0x28 */
+  __IO_REG APBRSTR1			{0x00000000}; /*!< RCC APB peripherals reset register 1,                                   Address offset: 0x2C */
+  __IO_REG APBRSTR2			{0x00000000}; /*!< RCC APB peripherals reset register 2,                                   Address offset: 0x30 */
+  __IO_REG IOPENR				{0x00000000}; /*!< RCC IO port enable register,                                            Address offset: 0x34 */
+  __IO_REG AHBENR				{0x00000000}; /*!< RCC AHB peripherals clock enable register,                              Address offset: 0x38 */
+  __IO_REG APBENR1				{0x00000000}; /*!< RCC APB peripherals clock enable register1,                             Address offset: 0x3C */
+  __IO_REG APBENR2				{0x00000000}; /*!< RCC APB peripherals clock enable register2,                             Address offset: 0x40 */
+  __IO_REG IOPSMENR			{0x00000000}; /*!< RCC IO port clocks enable in sleep mode register,                       Address offset: 0x44 */
+  __IO_REG AHBSMENR			{0x00000000}; /*!< RCC AHB peripheral clocks enable in sleep mode register,                Address offset: 0x48 */
+  __IO_REG APBSMENR1			{0x00000000}; /*!< RCC APB peripheral clocks enable in sleep mode register1,               Address offset: 0x4C */
+  __IO_REG APBSMENR2			{0x00000000}; /*!< RCC APB peripheral clocks enable in sleep mode register2,               Address offset: 0x50 */
+  __IO_REG CCIPR				{0x00000000}; /*!< RCC Peripherals Independent Clocks Configuration Register,              Address offset: 0x54 */
+  __IO_REG CCIPR2				{0x00000000}; /*!< RCC Peripherals Independent Clocks Configuration Register2,             Address offset: 0x58 */
+  __IO_REG BDCR				{0x00000000}; /*!< RCC Backup Domain Control Register,                                     Address offset: 0x5C */
+  __IO_REG CSR					{0x00000000}; /*!< RCC Unregulated Domain Clock Control and Status Register,               Address offset: 0x60 */
 } RCC_TypeDef;
 
 /**
@@ -589,31 +593,31 @@ typedef struct
   */
 typedef struct
 {
-  __IO uint32_t TR					{0x00000000}; /*!< RTC time register,                                         Address offset: 0x00 */
-  __IO uint32_t DR					{0x00000000}; /*!< RTC date register,                                         Address offset: 0x04 */
-  __IO uint32_t SSR					{0x00000000}; /*!< RTC sub second register,                                   Address offset: 0x08 */
-  __IO uint32_t ICSR				{0x00000000}; /*!< RTC initialization control and status register,            Address offset: 0x0C */
-  __IO uint32_t PRER				{0x00000000}; /*!< RTC prescaler register,                                    Address offset: 0x10 */
-  __IO uint32_t WUTR				{0x00000000}; /*!< RTC wakeup timer register,                                 Address offset: 0x14 */
-  __IO uint32_t CR					{0x00000000}; /*!< RTC control register,                                      Address offset: 0x18 */
+  __IO_REG TR					{0x00000000}; /*!< RTC time register,                                         Address offset: 0x00 */
+  __IO_REG DR					{0x00000000}; /*!< RTC date register,                                         Address offset: 0x04 */
+  __IO_REG SSR					{0x00000000}; /*!< RTC sub second register,                                   Address offset: 0x08 */
+  __IO_REG ICSR				{0x00000000}; /*!< RTC initialization control and status register,            Address offset: 0x0C */
+  __IO_REG PRER				{0x00000000}; /*!< RTC prescaler register,                                    Address offset: 0x10 */
+  __IO_REG WUTR				{0x00000000}; /*!< RTC wakeup timer register,                                 Address offset: 0x14 */
+  __IO_REG CR					{0x00000000}; /*!< RTC control register,                                      Address offset: 0x18 */
        uint32_t RESERVED0			{0x00000000}; /*!< Reserved                                                   Address offset: 0x1C */
        uint32_t RESERVED1			{0x00000000}; /*!< Reserved                                                   Address offset: 0x20 */
-  __IO uint32_t WPR					{0x00000000}; /*!< RTC write protection register,                             Address offset: 0x24 */
-  __IO uint32_t CALR				{0x00000000}; /*!< RTC calibration register,                                  Address offset: 0x28 */
-  __IO uint32_t SHIFTR				{0x00000000}; /*!< RTC shift control register,                                Address offset: 0x2C */
-  __IO uint32_t TSTR				{0x00000000}; /*!< RTC time stamp time register,                              Address offset: 0x30 */
-  __IO uint32_t TSDR				{0x00000000}; /*!< RTC time stamp date register,                              Address offset: 0x34 */
-  __IO uint32_t TSSSR				{0x00000000}; /*!< RTC time-stamp sub second register,                        Address offset: 0x38 */
+  __IO_REG WPR					{0x00000000}; /*!< RTC write protection register,                             Address offset: 0x24 */
+  __IO_REG CALR				{0x00000000}; /*!< RTC calibration register,                                  Address offset: 0x28 */
+  __IO_REG SHIFTR				{0x00000000}; /*!< RTC shift control register,                                Address offset: 0x2C */
+  __IO_REG TSTR				{0x00000000}; /*!< RTC time stamp time register,                              Address offset: 0x30 */
+  __IO_REG TSDR				{0x00000000}; /*!< RTC time stamp date register,                              Address offset: 0x34 */
+  __IO_REG TSSSR				{0x00000000}; /*!< RTC time-stamp sub second register,                        Address offset: 0x38 */
        uint32_t RESERVED2			{0x00000000}; /*!< Reserved                                                   Address offset: 0x1C */
-  __IO uint32_t ALRMAR				{0x00000000}; /*!< RTC alarm A register,                                      Address offset: 0x40 */
-  __IO uint32_t ALRMASSR			{0x00000000}; /*!< RTC alarm A sub second register,                           Address offset: 0x44 */
-  __IO uint32_t ALRMBR				{0x00000000}; /*!< RTC alarm B register,                                      Address offset: 0x48 */
-  __IO uint32_t ALRMBSSR			{0x00000000}; /*!< RTC alarm B sub second register,                           Address offset: 0x4C */
-  __IO uint32_t SR					{0x00000000}; /*!< RTC Status register,                                       Address offset: 0x50 */
-  __IO uint32_t MISR				{0x00000000}; /*!< RTC Masked Interrupt Status register,                      Address offset: 0x54 */
+  __IO_REG ALRMAR				{0x00000000}; /*!< RTC alarm A register,                                      Address offset: 0x40 */
+  __IO_REG ALRMASSR			{0x00000000}; /*!< RTC alarm A sub second register,                           Address offset: 0x44 */
+  __IO_REG ALRMBR				{0x00000000}; /*!< RTC alarm B register,                                      Address offset: 0x48 */
+  __IO_REG ALRMBSSR			{0x00000000}; /*!< RTC alarm B sub second register,                           Address offset: 0x4C */
+  __IO_REG SR					{0x00000000}; /*!< RTC Status register,                                       Address offset: 0x50 */
+  __IO_REG MISR				{0x00000000}; /*!< RTC Masked Interrupt Status register,                      Address offset: 0x54 */
        uint32_t RESERVED3			{0x00000000}; /*!< Reserved                                                   Address offset: 0x58 */
-  __IO uint32_t SCR					{0x00000000}; /*!< RTC Status Clear register,                                 Address offset: 0x5C */
-  __IO uint32_t OR					{0x00000000}; /*!< RTC option register,                                       Address offset: 0x60 */
+  __IO_REG SCR					{0x00000000}; /*!< RTC Status Clear register,                                 Address offset: 0x5C */
+  __IO_REG OR					{0x00000000}; /*!< RTC option register,                                       Address offset: 0x60 */
 } RTC_TypeDef;
 
 /**
@@ -621,22 +625,22 @@ typedef struct
   */
 typedef struct
 {
-  __IO uint32_t CR1					{0x00000000}; /*!< TAMP configuration register 1,                             Address offset: 0x00 */
-  __IO uint32_t CR2					{0x00000000}; /*!< TAMP configuration register 2,                             Address offset: 0x04 */
+  __IO_REG CR1					{0x00000000}; /*!< TAMP configuration register 1,                             Address offset: 0x00 */
+  __IO_REG CR2					{0x00000000}; /*!< TAMP configuration register 2,                             Address offset: 0x04 */
        uint32_t RESERVED0			{0x00000000}; /*!< Reserved                                                   Address offset: 0x08 */
-  __IO uint32_t FLTCR				{0x00000000}; /*!< Reserved                                                   Address offset: 0x0C */
+  __IO_REG FLTCR				{0x00000000}; /*!< Reserved                                                   Address offset: 0x0C */
        uint32_t RESERVED1[7]		{0x00000000}; /*!< Reserved                                                   Address offset: 0x10 -- 0x28 */
-  __IO uint32_t IER					{0x00000000}; /*!< TAMP Interrupt enable register,                            Address offset: 0x2C */
-  __IO uint32_t SR					{0x00000000}; /*!< TAMP Status register,                                      Address offset: 0x30 */
-  __IO uint32_t MISR				{0x00000000}; /*!< TAMP Masked Interrupt Status register,                     Address offset: 0x34 */
+  __IO_REG IER					{0x00000000}; /*!< TAMP Interrupt enable register,                            Address offset: 0x2C */
+  __IO_REG SR					{0x00000000}; /*!< TAMP Status register,                                      Address offset: 0x30 */
+  __IO_REG MISR				{0x00000000}; /*!< TAMP Masked Interrupt Status register,                     Address offset: 0x34 */
        uint32_t RESERVED2			{0x00000000}; /*!< Reserved                                                   Address offset: 0x38 */
-  __IO uint32_t SCR					{0x00000000}; /*!< TAMP Status clear register,                                Address offset: 0x3C */
+  __IO_REG SCR					{0x00000000}; /*!< TAMP Status clear register,                                Address offset: 0x3C */
        uint32_t RESERVED3[48]		{0x00000000}; /*!< Reserved                                                   Address offset: 0x54 -- 0xFC */
-  __IO uint32_t BKP0R				{0x00000000}; /*!< TAMP backup register 0,                                    Address offset: 0x100 */
-  __IO uint32_t BKP1R				{0x00000000}; /*!< TAMP backup register 1,                                    Address offset: 0x104 */
-  __IO uint32_t BKP2R				{0x00000000}; /*!< TAMP backup register 2,                                    Address offset: 0x108 */
-  __IO uint32_t BKP3R				{0x00000000}; /*!< TAMP backup register 3,                                    Address offset: 0x10C */
-  __IO uint32_t BKP4R				{0x00000000}; /*!< TAMP backup register 4,                                    Address offset: 0x110 */
+  __IO_REG BKP0R				{0x00000000}; /*!< TAMP backup register 0,                                    Address offset: 0x100 */
+  __IO_REG BKP1R				{0x00000000}; /*!< TAMP backup register 1,                                    Address offset: 0x104 */
+  __IO_REG BKP2R				{0x00000000}; /*!< TAMP backup register 2,                                    Address offset: 0x108 */
+  __IO_REG BKP3R				{0x00000000}; /*!< TAMP backup register 3,                                    Address offset: 0x10C */
+  __IO_REG BKP4R				{0x00000000}; /*!< TAMP backup register 4,                                    Address offset: 0x110 */
 } TAMP_TypeDef;
 
   /**
@@ -644,59 +648,59 @@ typedef struct
   */
 typedef struct
 {
-  __IO uint32_t CR1					{0x00000000}; /*!< SPI Control register 1 (not used in I2S mode),       Address offset: 0x00 */
-  __IO uint32_t CR2					{0x00000000}; /*!< SPI Control register 2,                              Address offset: 0x04 */
-  __IO uint32_t SR					{0x00000000}; /*!< SPI Status register,                                 Address offset: 0x08 */
-  __IO uint32_t DR					{0x00000000}; /*!< SPI data register,                                   Address offset: 0x0C */
-  __IO uint32_t CRCPR				{0x00000000}; /*!< SPI CRC polynomial register (not used in I2S mode),  Address offset: 0x10 */
-  __IO uint32_t RXCRCR				{0x00000000}; /*!< SPI Rx CRC register (not used in I2S mode),          Address offset: 0x14 */
-  __IO uint32_t TXCRCR				{0x00000000}; /*!< SPI Tx CRC register (not used in I2S mode),          Address offset: 0x18 */
-  __IO uint32_t I2SCFGR				{0x00000000}; /*!< SPI_I2S configuration register,                      Address offset: 0x1C */
-  __IO uint32_t I2SPR				{0x00000000}; /*!< SPI_I2S prescaler register,                          Address offset: 0x20 */
+  __IO_REG CR1					{0x00000000}; /*!< SPI Control register 1 (not used in I2S mode),       Address offset: 0x00 */
+  __IO_REG CR2					{0x00000000}; /*!< SPI Control register 2,                              Address offset: 0x04 */
+  __IO_REG SR					{0x00000000}; /*!< SPI Status register,                                 Address offset: 0x08 */
+  __IO_REG DR					{0x00000000}; /*!< SPI data register,                                   Address offset: 0x0C */
+  __IO_REG CRCPR				{0x00000000}; /*!< SPI CRC polynomial register (not used in I2S mode),  Address offset: 0x10 */
+  __IO_REG RXCRCR				{0x00000000}; /*!< SPI Rx CRC register (not used in I2S mode),          Address offset: 0x14 */
+  __IO_REG TXCRCR				{0x00000000}; /*!< SPI Tx CRC register (not used in I2S mode),          Address offset: 0x18 */
+  __IO_REG I2SCFGR				{0x00000000}; /*!< SPI_I2S configuration register,                      Address offset: 0x1C */
+  __IO_REG I2SPR				{0x00000000}; /*!< SPI_I2S prescaler register,                          Address offset: 0x20 */
 } SPI_TypeDef;
 /**
   * @brief System configuration controller
   */
 typedef struct
 {
-  __IO uint32_t CFGR1				{0x00000000}; /*!< SYSCFG configuration register 1,                   Address offset: 0x00 */
+  __IO_REG CFGR1				{0x00000000}; /*!< SYSCFG configuration register 1,                   Address offset: 0x00 */
        uint32_t RESERVED0[5]		{0x00000000}; /*!< Reserved,                                                   0x04 --0x14 */
-  __IO uint32_t CFGR2				{0x00000000}; /*!< SYSCFG configuration register 2,                   Address offset: 0x18 */
+  __IO_REG CFGR2				{0x00000000}; /*!< SYSCFG configuration register 2,                   Address offset: 0x18 */
        uint32_t RESERVED1[25]		{0x00000000}; /*!< Reserved                                                           0x1C */
-  __IO uint32_t IT_LINE_SR[32]		{0x00000000}; /*!< SYSCFG configuration IT_LINE register,             Address offset: 0x80 */
+  __IO_REG IT_LINE_SR[32]		{0x00000000}; /*!< SYSCFG configuration IT_LINE register,             Address offset: 0x80 */
 } SYSCFG_TypeDef;
 /**
   * @brief TIM
   */
 typedef struct
 {
-  __IO uint32_t CR1					{0x00000000}; /*!< TIM control register 1,                   Address offset: 0x00 */
-  __IO uint32_t CR2					{0x00000000}; /*!< TIM control register 2,                   Address offset: 0x04 */
-  __IO uint32_t SMCR				{0x00000000}; /*!< TIM slave mode control register,          Address offset: 0x08 */
-  __IO uint32_t DIER				{0x00000000}; /*!< TIM DMA/interrupt enable register,        Address offset: 0x0C */
-  __IO uint32_t SR					{0x00000000}; /*!< TIM status register,                      Address offset: 0x10 */
-  __IO uint32_t EGR					{0x00000000}; /*!< TIM event generation register,            Address offset: 0x14 */
-  __IO uint32_t CCMR1				{0x00000000}; /*!< TIM capture/compare mode register 1,      Address offset: 0x18 */
-  __IO uint32_t CCMR2				{0x00000000}; /*!< TIM capture/compare mode register 2,      Address offset: 0x1C */
-  __IO uint32_t CCER				{0x00000000}; /*!< TIM capture/compare enable register,      Address offset: 0x20 */
-  __IO uint32_t CNT					{0x00000000}; /*!< TIM counter register,                     Address offset: 0x24 */
-  __IO uint32_t PSC					{0x00000000}; /*!< TIM prescaler register,                   Address offset: 0x28 */
-  __IO uint32_t ARR					{0x00000000}; /*!< TIM auto-reload register,                 Address offset: 0x2C */
-  __IO uint32_t RCR					{0x00000000}; /*!< TIM repetition counter register,          Address offset: 0x30 */
-  __IO uint32_t CCR1				{0x00000000}; /*!< TIM capture/compare register 1,           Address offset: 0x34 */
-  __IO uint32_t CCR2				{0x00000000}; /*!< TIM capture/compare register 2,           Address offset: 0x38 */
-  __IO uint32_t CCR3				{0x00000000}; /*!< TIM capture/compare register 3,           Address offset: 0x3C */
-  __IO uint32_t CCR4				{0x00000000}; /*!< TIM capture/compare register 4,           Address offset: 0x40 */
-  __IO uint32_t BDTR				{0x00000000}; /*!< TIM break and dead-time register,         Address offset: 0x44 */
-  __IO uint32_t DCR					{0x00000000}; /*!< TIM DMA control register,                 Address offset: 0x48 */
-  __IO uint32_t DMAR				{0x00000000}; /*!< TIM DMA address for full transfer,        Address offset: 0x4C */
-  __IO uint32_t OR1					{0x00000000}; /*!< TIM option register,                      Address offset: 0x50 */
-  __IO uint32_t CCMR3				{0x00000000}; /*!< TIM capture/compare mode register 3,      Address offset: 0x54 */
-  __IO uint32_t CCR5				{0x00000000}; /*!< TIM capture/compare register5,            Address offset: 0x58 */
-  __IO uint32_t CCR6				{0x00000000}; /*!< TIM capture/compare register6,            Address offset: 0x5C */
-  __IO uint32_t AF1					{0x00000000}; /*!< TIM alternate function register 1,        Address offset: 0x60 */
-  __IO uint32_t AF2					{0x00000000}; /*!< TIM alternate function register 2,        Address offset: 0x64 */
-  __IO uint32_t TISEL				{0x00000000}; /*!< TIM Input Selection register,             Address offset: 0x68 */
+  __IO_REG CR1					{0x00000000}; /*!< TIM control register 1,                   Address offset: 0x00 */
+  __IO_REG CR2					{0x00000000}; /*!< TIM control register 2,                   Address offset: 0x04 */
+  __IO_REG SMCR				{0x00000000}; /*!< TIM slave mode control register,          Address offset: 0x08 */
+  __IO_REG DIER				{0x00000000}; /*!< TIM DMA/interrupt enable register,        Address offset: 0x0C */
+  __IO_REG SR					{0x00000000}; /*!< TIM status register,                      Address offset: 0x10 */
+  __IO_REG EGR					{0x00000000}; /*!< TIM event generation register,            Address offset: 0x14 */
+  __IO_REG CCMR1				{0x00000000}; /*!< TIM capture/compare mode register 1,      Address offset: 0x18 */
+  __IO_REG CCMR2				{0x00000000}; /*!< TIM capture/compare mode register 2,      Address offset: 0x1C */
+  __IO_REG CCER				{0x00000000}; /*!< TIM capture/compare enable register,      Address offset: 0x20 */
+  __IO_REG CNT					{0x00000000}; /*!< TIM counter register,                     Address offset: 0x24 */
+  __IO_REG PSC					{0x00000000}; /*!< TIM prescaler register,                   Address offset: 0x28 */
+  __IO_REG ARR					{0x00000000}; /*!< TIM auto-reload register,                 Address offset: 0x2C */
+  __IO_REG RCR					{0x00000000}; /*!< TIM repetition counter register,          Address offset: 0x30 */
+  __IO_REG CCR1				{0x00000000}; /*!< TIM capture/compare register 1,           Address offset: 0x34 */
+  __IO_REG CCR2				{0x00000000}; /*!< TIM capture/compare register 2,           Address offset: 0x38 */
+  __IO_REG CCR3				{0x00000000}; /*!< TIM capture/compare register 3,           Address offset: 0x3C */
+  __IO_REG CCR4				{0x00000000}; /*!< TIM capture/compare register 4,           Address offset: 0x40 */
+  __IO_REG BDTR				{0x00000000}; /*!< TIM break and dead-time register,         Address offset: 0x44 */
+  __IO_REG DCR					{0x00000000}; /*!< TIM DMA control register,                 Address offset: 0x48 */
+  __IO_REG DMAR				{0x00000000}; /*!< TIM DMA address for full transfer,        Address offset: 0x4C */
+  __IO_REG OR1					{0x00000000}; /*!< TIM option register,                      Address offset: 0x50 */
+  __IO_REG CCMR3				{0x00000000}; /*!< TIM capture/compare mode register 3,      Address offset: 0x54 */
+  __IO_REG CCR5				{0x00000000}; /*!< TIM capture/compare register5,            Address offset: 0x58 */
+  __IO_REG CCR6				{0x00000000}; /*!< TIM capture/compare register6,            Address offset: 0x5C */
+  __IO_REG AF1					{0x00000000}; /*!< TIM alternate function register 1,        Address offset: 0x60 */
+  __IO_REG AF2					{0x00000000}; /*!< TIM alternate function register 2,        Address offset: 0x64 */
+  __IO_REG TISEL				{0x00000000}; /*!< TIM Input Selection register,             Address offset: 0x68 */
 } TIM_TypeDef;
 
 /**
@@ -704,18 +708,18 @@ typedef struct
   */
 typedef struct
 {
-  __IO uint32_t CR1					{0x00000000}; /*!< USART Control register 1,                 Address offset: 0x00  */
-  __IO uint32_t CR2					{0x00000000}; /*!< USART Control register 2,                 Address offset: 0x04  */
-  __IO uint32_t CR3					{0x00000000}; /*!< USART Control register 3,                 Address offset: 0x08  */
-  __IO uint32_t BRR					{0x00000000}; /*!< USART Baud rate register,                 Address offset: 0x0C  */
-  __IO uint32_t GTPR				{0x00000000}; /*!< USART Guard time and prescaler register,  Address offset: 0x10  */
-  __IO uint32_t RTOR				{0x00000000}; /*!< USART Receiver Time Out register,         Address offset: 0x14  */
-  __IO uint32_t RQR					{0x00000000}; /*!< USART Request register,                   Address offset: 0x18  */
-  __IO uint32_t ISR					{0x00000000}; /*!< USART Interrupt and status register,      Address offset: 0x1C  */
-  __IO uint32_t ICR					{0x00000000}; /*!< USART Interrupt flag Clear register,      Address offset: 0x20  */
-  __IO uint32_t RDR					{0x00000000}; /*!< USART Receive Data register,              Address offset: 0x24  */
-  __IO uint32_t TDR					{0x00000000}; /*!< USART Transmit Data register,             Address offset: 0x28  */
-  __IO uint32_t PRESC				{0x00000000}; /*!< USART Prescaler register,                 Address offset: 0x2C  */
+  __IO_REG CR1					{0x00000000}; /*!< USART Control register 1,                 Address offset: 0x00  */
+  __IO_REG CR2					{0x00000000}; /*!< USART Control register 2,                 Address offset: 0x04  */
+  __IO_REG CR3					{0x00000000}; /*!< USART Control register 3,                 Address offset: 0x08  */
+  __IO_REG BRR					{0x00000000}; /*!< USART Baud rate register,                 Address offset: 0x0C  */
+  __IO_REG GTPR				{0x00000000}; /*!< USART Guard time and prescaler register,  Address offset: 0x10  */
+  __IO_REG RTOR				{0x00000000}; /*!< USART Receiver Time Out register,         Address offset: 0x14  */
+  __IO_REG RQR					{0x00000000}; /*!< USART Request register,                   Address offset: 0x18  */
+  __IO_REG ISR					{0x00000000}; /*!< USART Interrupt and status register,      Address offset: 0x1C  */
+  __IO_REG ICR					{0x00000000}; /*!< USART Interrupt flag Clear register,      Address offset: 0x20  */
+  __IO_REG RDR					{0x00000000}; /*!< USART Receive Data register,              Address offset: 0x24  */
+  __IO_REG TDR					{0x00000000}; /*!< USART Transmit Data register,             Address offset: 0x28  */
+  __IO_REG PRESC				{0x00000000}; /*!< USART Prescaler register,                 Address offset: 0x2C  */
 } USART_TypeDef;
 
 /**
@@ -724,22 +728,22 @@ typedef struct
 
 typedef struct
 {
-  __IO uint32_t CHEP0R					{0x00000000}; /*!< USB Channel/Endpoint 0 register,      Address offset: 0x00 */
-  __IO uint32_t CHEP1R					{0x00000000}; /*!< USB Channel/Endpoint 1 register,      Address offset: 0x04 */
-  __IO uint32_t CHEP2R					{0x00000000}; /*!< USB Channel/Endpoint 2 register,      Address offset: 0x08 */
-  __IO uint32_t CHEP3R					{0x00000000}; /*!< USB Channel/Endpoint 3 register,      Address offset: 0x0C */
-  __IO uint32_t CHEP4R					{0x00000000}; /*!< USB Channel/Endpoint 4 register,      Address offset: 0x10 */
-  __IO uint32_t CHEP5R					{0x00000000}; /*!< USB Channel/Endpoint 5 register,      Address offset: 0x14 */
-  __IO uint32_t CHEP6R					{0x00000000}; /*!< USB Channel/Endpoint 6 register,      Address offset: 0x18 */
-  __IO uint32_t CHEP7R					{0x00000000}; /*!< USB Channel/Endpoint 7 register,      Address offset: 0x1C */
-  __IO uint32_t RESERVED0[8]			{0x00000000}; /*!< Reserved,                                                  */
-  __IO uint32_t CNTR					{0x00000000}; /*!< Control register,                     Address offset: 0x40 */
-  __IO uint32_t ISTR					{0x00000000}; /*!< Interrupt status register,            Address offset: 0x44 */
-  __IO uint32_t FNR					    {0x00000000}; /*!< Frame number register,                Address offset: 0x48 */
-  __IO uint32_t DADDR					{0x00000000}; /*!< Device address register,              Address offset: 0x4C */
-  __IO uint32_t RESERVED1				{0x00000000}; /*!< Reserved */
-  __IO uint32_t LPMCSR					{0x00000000}; /*!< LPM Control and Status register,      Address offset: 0x54 */
-  __IO uint32_t BCDR					{0x00000000}; /*!< Battery Charging detector register,   Address offset: 0x58 */
+  __IO_REG CHEP0R					{0x00000000}; /*!< USB Channel/Endpoint 0 register,      Address offset: 0x00 */
+  __IO_REG CHEP1R					{0x00000000}; /*!< USB Channel/Endpoint 1 register,      Address offset: 0x04 */
+  __IO_REG CHEP2R					{0x00000000}; /*!< USB Channel/Endpoint 2 register,      Address offset: 0x08 */
+  __IO_REG CHEP3R					{0x00000000}; /*!< USB Channel/Endpoint 3 register,      Address offset: 0x0C */
+  __IO_REG CHEP4R					{0x00000000}; /*!< USB Channel/Endpoint 4 register,      Address offset: 0x10 */
+  __IO_REG CHEP5R					{0x00000000}; /*!< USB Channel/Endpoint 5 register,      Address offset: 0x14 */
+  __IO_REG CHEP6R					{0x00000000}; /*!< USB Channel/Endpoint 6 register,      Address offset: 0x18 */
+  __IO_REG CHEP7R					{0x00000000}; /*!< USB Channel/Endpoint 7 register,      Address offset: 0x1C */
+  __IO_REG RESERVED0[8]			{0x00000000}; /*!< Reserved,                                                  */
+  __IO_REG CNTR					{0x00000000}; /*!< Control register,                     Address offset: 0x40 */
+  __IO_REG ISTR					{0x00000000}; /*!< Interrupt status register,            Address offset: 0x44 */
+  __IO_REG FNR					    {0x00000000}; /*!< Frame number register,                Address offset: 0x48 */
+  __IO_REG DADDR					{0x00000000}; /*!< Device address register,              Address offset: 0x4C */
+  __IO_REG RESERVED1				{0x00000000}; /*!< Reserved */
+  __IO_REG LPMCSR					{0x00000000}; /*!< LPM Control and Status register,      Address offset: 0x54 */
+  __IO_REG BCDR					{0x00000000}; /*!< Battery Charging detector register,   Address offset: 0x58 */
 } USB_DRD_TypeDef;
 
 /**
@@ -747,8 +751,8 @@ typedef struct
   */
 typedef struct
 {
-  __IO uint32_t TXBD					{0x00000000}; /*!<Transmission buffer address*/
-  __IO uint32_t RXBD					{0x00000000}; /*!<Reception buffer address */
+  __IO_REG TXBD					{0x00000000}; /*!<Transmission buffer address*/
+  __IO_REG RXBD					{0x00000000}; /*!<Reception buffer address */
 } USB_DRD_PMABuffDescTypeDef;
 
 /**
@@ -759,8 +763,8 @@ typedef struct
   */
 typedef struct
 {
-  __IO uint32_t CSR					{0x00000000}; /*!< VREFBUF control and status register,         Address offset: 0x00 */
-  __IO uint32_t CCR					{0x00000000}; /*!< VREFBUF calibration and control register,    Address offset: 0x04 */
+  __IO_REG CSR					{0x00000000}; /*!< VREFBUF control and status register,         Address offset: 0x00 */
+  __IO_REG CCR					{0x00000000}; /*!< VREFBUF calibration and control register,    Address offset: 0x04 */
 } VREFBUF_TypeDef;
 
 /**
@@ -768,9 +772,9 @@ typedef struct
   */
 typedef struct
 {
-  __IO uint32_t CR					{0x00000000}; /*!< WWDG Control register,       Address offset: 0x00 */
-  __IO uint32_t CFR					{0x00000000}; /*!< WWDG Configuration register, Address offset: 0x04 */
-  __IO uint32_t SR					{0x00000000}; /*!< WWDG Status register,        Address offset: 0x08 */
+  __IO_REG CR					{0x00000000}; /*!< WWDG Control register,       Address offset: 0x00 */
+  __IO_REG CFR					{0x00000000}; /*!< WWDG Configuration register, Address offset: 0x04 */
+  __IO_REG SR					{0x00000000}; /*!< WWDG Status register,        Address offset: 0x08 */
 } WWDG_TypeDef;
 
 
@@ -779,21 +783,21 @@ typedef struct
   */
 typedef struct
 {
-  __IO uint32_t CFG1				{0x00000000}; /*!< UCPD configuration register 1,             Address offset: 0x00 */
-  __IO uint32_t CFG2				{0x00000000}; /*!< UCPD configuration register 2,             Address offset: 0x04 */
-  __IO uint32_t RESERVED0			{0x00000000}; /*!< UCPD reserved register,                    Address offset: 0x08 */
-  __IO uint32_t CR					{0x00000000}; /*!< UCPD control register,                     Address offset: 0x0C */
-  __IO uint32_t IMR					{0x00000000}; /*!< UCPD interrupt mask register,              Address offset: 0x10 */
-  __IO uint32_t SR					{0x00000000}; /*!< UCPD status register,                      Address offset: 0x14 */
-  __IO uint32_t ICR					{0x00000000}; /*!< UCPD interrupt flag clear register         Address offset: 0x18 */
-  __IO uint32_t TX_ORDSET			{0x00000000}; /*!< UCPD Tx ordered set type register,         Address offset: 0x1C */
-  __IO uint32_t TX_PAYSZ			{0x00000000}; /*!< UCPD Tx payload size register,             Address offset: 0x20 */
-  __IO uint32_t TXDR				{0x00000000}; /*!< UCPD Tx data register,                     Address offset: 0x24 */
-  __IO uint32_t RX_ORDSET			{0x00000000}; /*!< UCPD Rx ordered set type register,         Address offset: 0x28 */
-  __IO uint32_t RX_PAYSZ			{0x00000000}; /*!< UCPD Rx payload size register,             Address offset: 0x2C */
-  __IO uint32_t RXDR				{0x00000000}; /*!< UCPD Rx data register,                     Address offset: 0x30 */
-  __IO uint32_t RX_ORDEXT1			{0x00000000}; /*!< UCPD Rx ordered set extension 1 register,  Address offset: 0x34 */
-  __IO uint32_t RX_ORDEXT2			{0x00000000}; /*!< UCPD Rx ordered set extension 2 register,  Address offset: 0x38 */
+  __IO_REG CFG1				{0x00000000}; /*!< UCPD configuration register 1,             Address offset: 0x00 */
+  __IO_REG CFG2				{0x00000000}; /*!< UCPD configuration register 2,             Address offset: 0x04 */
+  __IO_REG RESERVED0			{0x00000000}; /*!< UCPD reserved register,                    Address offset: 0x08 */
+  __IO_REG CR					{0x00000000}; /*!< UCPD control register,                     Address offset: 0x0C */
+  __IO_REG IMR					{0x00000000}; /*!< UCPD interrupt mask register,              Address offset: 0x10 */
+  __IO_REG SR					{0x00000000}; /*!< UCPD status register,                      Address offset: 0x14 */
+  __IO_REG ICR					{0x00000000}; /*!< UCPD interrupt flag clear register         Address offset: 0x18 */
+  __IO_REG TX_ORDSET			{0x00000000}; /*!< UCPD Tx ordered set type register,         Address offset: 0x1C */
+  __IO_REG TX_PAYSZ			{0x00000000}; /*!< UCPD Tx payload size register,             Address offset: 0x20 */
+  __IO_REG TXDR				{0x00000000}; /*!< UCPD Tx data register,                     Address offset: 0x24 */
+  __IO_REG RX_ORDSET			{0x00000000}; /*!< UCPD Rx ordered set type register,         Address offset: 0x28 */
+  __IO_REG RX_PAYSZ			{0x00000000}; /*!< UCPD Rx payload size register,             Address offset: 0x2C */
+  __IO_REG RXDR				{0x00000000}; /*!< UCPD Rx data register,                     Address offset: 0x30 */
+  __IO_REG RX_ORDEXT1			{0x00000000}; /*!< UCPD Rx ordered set extension 1 register,  Address offset: 0x34 */
+  __IO_REG RX_ORDEXT2			{0x00000000}; /*!< UCPD Rx ordered set extension 2 register,  Address offset: 0x38 */
 
 } UCPD_TypeDef;
 
@@ -0,0 +1,174 @@
+#!/usr/bin/env python3
+"""Compare Catch2 BENCHMARK results with a stored baseline, and fail if a benchmark has slowed down.
+
+The benchmarks are the hidden test cases tagged [benchmark]. A benchmark has regressed when the lower
+bound of its mean (Catch2's 95% confidence interval) is more than the threshold above the baseline mean.
+Interference from other processes only ever slows a benchmark down, so each benchmark keeps its best
+result over up to --repeat runs, and the runs stop once nothing has regressed. The baseline is the best
+of --repeat runs too. A benchmark in the baseline but missing from the results fails the comparison,
+unless --update replaces the baseline.
+
+Timings depend on the machine and the build, so the baseline file keeps one set of timings per host
+(name, OS and architecture) and --config (the compiler and flags, passed by the CMake targets). With no
+timings recorded for the current host and config the comparison is skipped, not failed: record them with
+--update.
+
+Usage:
+    tools/bench_compare.py --run build/test_suite                  run, compare, exit 1 on regression
+    tools/bench_compare.py --run build/test_suite --update         run and store as the new baseline
+    tools/bench_compare.py results.xml                             compare a saved "--reporter xml" run
+"""
+
+import argparse
+import json
+import os
+import platform
+import subprocess
+import sys
+import tempfile
+import xml.etree.ElementTree as ElementTree
+
+DEFAULT_BASELINE = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'tests', 'bench_baseline.json')
+
+
+def host_key():
+    """The machine the timings were taken on."""
+    return f'{platform.node()} {platform.system()} {platform.machine()}'
+
+
+def load_baselines(path):
+    """The recorded sets of timings, each with the host and config they belong to."""
+    if not os.path.exists(path):
+        return []
+    with open(path, encoding='utf-8') as file:
+        return json.load(file).get('baselines', [])
+
+
+def find_baseline(baselines, host, config):
+    for entry in baselines:
+        if entry['host'] == host and entry['config'] == config:
+            return entry
+    return None
+
+
+def run_benchmarks(test_suite, tags, samples):
+    """Run the benchmarks with the XML reporter writing to a file, away from the tests' own stdout."""
+    with tempfile.TemporaryDirectory() as directory:
+        report = os.path.join(directory, 'benchmarks.xml')
+        command = [test_suite, tags, '--reporter', 'xml', '--out', report, '--benchmark-samples', str(samples)]
+        result = subprocess.run(command, stdout=subprocess.DEVNULL, check=False)
+        if result.returncode != 0:
+            sys.exit(f'{" ".join(command)} failed with exit code {result.returncode}')
+        with open(report, 'rb') as file:
+            return file.read()
+
+
+def parse_results(xml):
+    """Map "test case/benchmark" to (mean, lower bound of the mean) in nanoseconds."""
+    results = {}
+    for test_case in ElementTree.fromstring(xml).iter('TestCase'):
+        for benchmark in test_case.iter('BenchmarkResults'):
+            mean = benchmark.find('mean')
+            name = f'{test_case.get("name")}/{benchmark.get("name")}'
+            results[name] = (float(mean.get('value')), float(mean.get('lowerBound')))
+    return results
+
+
+def merge_best(best, results):
+    """Keep the fastest result of each benchmark."""
+    for name, result in results.items():
+        if name not in best or result[0] < best[name][0]:
+            best[name] = result
+
+
+def regressed(results, baseline, threshold):
+    return sorted(name for name, (_, lower_bound) in results.items()
+                  if name in baseline and lower_bound > baseline[name] * (1.0 + threshold))
+
+
+def compare(results, baseline, threshold):
+    """Print a line per benchmark and return the names of those that regressed."""
+    regressions = []
+    width = max((len(name) for name in set(results) | set(baseline)), default=0)
+    for name in sorted(results):
+        mean, lower_bound = results[name]
+        if name not in baseline:
+            print(f'{name:<{width}}  {mean:12.1f} ns  (new, not in the baseline)')
+            continue
+        reference = baseline[name]
+        change = (mean - reference) / reference
+        slower = lower_bound > reference * (1.0 + threshold)
+        verdict = 'REGRESSION' if slower else 'ok'
+        print(f'{name:<{width}}  {mean:12.1f} ns  baseline {reference:12.1f} ns  {change:+7.1%}  {verdict}')
+        if slower:
+            regressions.append(name)
+    for name in sorted(set(baseline) - set(results)):
+        print(f'{name:<{width}}  MISSING from the results')
+        regressions.append(name)
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('input', nargs='?', help='output of test_suite "[benchmark]" --reporter xml')
+    parser.add_argument('--run', metavar='TEST_SUITE', help='run the benchmarks in this test_suite executable')
+    parser.add_argument('--tags', default='[benchmark]', help='test spec to run, default "[benchmark]"')
+    parser.add_argument('--samples', type=int, default=50, help='samples per benchmark, default 50')
+    parser.add_argument('--repeat', type=int, default=3, help='most runs of the benchmarks with --run, default 3')
+    parser.add_argument('--baseline', default=DEFAULT_BASELINE, help='default tests/bench_baseline.json')
+    parser.add_argument('--threshold', type=float, default=0.25,
+                        help='allowed slowdown as a fraction of the baseline, default 0.25')
+    parser.add_argument('--config', default='',
+                        help='the compiler and build flags of the test_suite, the baseline is kept per config')
+    parser.add_argument('--update', action='store_true',
+                        help='store the results as the baseline for this host and config')
+    args = parser.parse_args()
+
+    if not args.run and not args.input:
+        parser.error('give a results file or --run')
+
+    host = host_key()
+    config = ' '.join(args.config.split())
+    baselines = load_baselines(args.baseline)
+    entry = find_baseline(baselines, host, config)
+    if not args.update and entry is None:
+        print(f'no baseline in {args.baseline} for host "{host}" and config "{config}", skipping the comparison')
+        print('record one with --update (cmake --build build --target bench_baseline)')
+        return
+    baseline = {} if args.update else entry['benchmarks_ns']
+
+    results = {}
+    if args.run:
+        for _ in range(max(args.repeat, 1)):
+            merge_best(results, parse_results(run_benchmarks(args.run, args.tags, args.samples)))
+            if not args.update and not regressed(results, baseline, args.threshold):
+                break
+    else:
+        with open(args.input, 'rb') as file:
+            results = parse_results(file.read())
+
+    if not results:
+        sys.exit('no benchmark results found')
+
+    if args.update:
+        if entry is not None:
+            baselines.remove(entry)
+        baselines.append({
+            'host': host,
+            'config': config,
+            'benchmarks_ns': {name: round(mean, 1) for name, (mean, _) in sorted(results.items())},
+        })
+        with open(args.baseline, 'w', encoding='utf-8') as file:
+            json.dump({'baselines': baselines}, file, indent=2)
+            file.write('\n')
+        print(f'stored {len(results)} benchmarks for host "{host}" and config "{config}" in {args.baseline}')
+        return
+
+    regressions = compare(results, baseline, args.threshold)
+    if regressions:
+        sys.exit(f'{len(regressions)} benchmark(s) missing, or slower than the baseline by more than '
+                 f'{args.threshold:.0%}')
+
+
+if __name__ == '__main__':
+    main()
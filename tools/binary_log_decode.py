@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+"""Decode a noarch::binary_log stream (include/binary_log.hpp) back into text.
+
+The format strings never reach the target, so they are recovered from the sources:
+every BINARY_LOG(logger, "format", ...) call is found and hashed with the same FNV-1a
+as the firmware. Frames from unknown log sites are printed as raw bytes.
+
+Format specs, as each argument arrives as 32 bits with no type information:
+    {}   unsigned decimal      {:d}  signed decimal     {:x}  hex
+    {:X} upper-case hex        {:b}  binary             {:c}  character
+    {:f}  float                {{ and }} are literal braces
+
+Usage:
+    tools/binary_log_decode.py --source src --source include /dev/ttyUSB0
+    tools/binary_log_decode.py --source . capture.bin
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+FRAME_MARKER = 0xA0
+HEADER_SIZE = 5
+ARGUMENT_SIZE = 4
+MAX_ARGUMENTS = 8
+
+SOURCE_EXTENSIONS = ('.c', '.cc', '.cpp', '.h', '.hpp')
+LOG_SITE = re.compile(r'BINARY_LOG\s*\(\s*[^,"]+,\s*"((?:[^"\\]|\\.)*)"')
+PLACEHOLDER = re.compile(r'\{\{|\}\}|\{(?::([dxXbcf]))?\}')
+ESCAPES = {'n': '\n', 't': '\t', 'r': '\r', '0': '\0', '\\': '\\', '"': '"', "'": "'"}
+
+
+def fnv1a_32(data):
+    """Must match noarch::binary_log::fnv1a_32()."""
+    value = 0x811C9DC5
+    for byte in data:
+        value ^= byte
+        value = (value * 0x01000193) & 0xFFFFFFFF
+    return value
+
+
+def unescape(literal):
+    """Turn the C string literal text into the bytes the compiler hashes."""
+    return re.sub(r'\\(.)', lambda m: ESCAPES.get(m.group(1), m.group(1)), literal)
+
+
+def scan_sources(paths):
+    """Map each log site ID to its format string."""
+    table = {}
+    for path in paths:
+        files = [path] if os.path.isfile(path) else (
+            os.path.join(root, name) for root, _, names in os.walk(path) for name in names)
+        for name in files:
+            if not name.endswith(SOURCE_EXTENSIONS):
+                continue
+            with open(name, encoding='utf-8', errors='replace') as source:
+                for match in LOG_SITE.finditer(source.read()):
+                    text = unescape(match.group(1))
+                    site_id = fnv1a_32(text.encode('utf-8'))
+                    if table.get(site_id, text) != text:
+                        print(f'warning: "{text}" and "{table[site_id]}" have the same ID 0x{site_id:08x}',
+                              file=sys.stderr)
+                    table[site_id] = text
+    return table
+
+
+def format_argument(word, spec):
+    if spec == 'd':
+        return str(struct.unpack('<i', struct.pack('<I', word))[0])
+    if spec == 'x':
+        return f'{word:x}'
+    if spec == 'X':
+        return f'{word:X}'
+    if spec == 'b':
+        return f'{word:b}'
+    if spec == 'c':
+        return chr(word & 0xFF)
+    if spec == 'f':
+        return f'{struct.unpack("<f", struct.pack("<I", word))[0]:g}'
+    return str(word)
+
+
+def format_message(text, words):
+    remaining = iter(words)
+
+    def substitute(match):
+        if match.group(0) in ('{{', '}}'):
+            return match.group(0)[0]
+        word = next(remaining, None)
+        return '<missing>' if word is None else format_argument(word, match.group(1))
+
+    return PLACEHOLDER.sub(substitute, text)
+
+
+def decode(stream, table):
+    """Yield one line of text per frame. Bytes that aren't the start of a frame are skipped."""
+    buffer = bytearray()
+    while True:
+        chunk = stream.read(1)
+        if not chunk:
+            return
+        buffer += chunk
+        while buffer:
+            header = buffer[0]
+            count = header & 0x0F
+            if (header & 0xF0) != FRAME_MARKER or count > MAX_ARGUMENTS:
+                del buffer[0]
+                continue
+            size = HEADER_SIZE + count * ARGUMENT_SIZE
+            if len(buffer) < size:
+                break
+            site_id, = struct.unpack_from('<I', buffer, 1)
+            words = struct.unpack_from(f'<{count}I', buffer, HEADER_SIZE)
+            if site_id in table:
+                yield format_message(table[site_id], words)
+            else:
+                yield f'#{site_id:08x} ' + ' '.join(f'0x{byte:02x}' for byte in buffer[HEADER_SIZE:size])
+            del buffer[:size]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('--source', action='append', required=True,
+                        help='source file or directory to scan for BINARY_LOG() calls (repeatable)')
+    parser.add_argument('input', nargs='?', default='-',
+                        help='captured stream or serial device, defaults to stdin')
+    args = parser.parse_args()
+
+    table = scan_sources(args.source)
+    stream = sys.stdin.buffer if args.input == '-' else open(args.input, 'rb', buffering=0)
+    try:
+        for line in decode(stream, table):
+            print(line, flush=True)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == '__main__':
+    main()
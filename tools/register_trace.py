@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+"""Convert or summarise a stm32::mock::RegisterTrace (tests/mocks/mock_trace.hpp) recorded by a host test.
+
+The trace holds every CPU access to the mocked peripheral registers, with its value and virtual time.
+
+    stats   For each section started by RegisterTrace::mark(), count the reads and writes of each register:
+              redundant  writes of the value the register already held, as far as the trace shows
+              repeated   reads returning the same value as the previous read, with no write in between.
+                         These are the iterations of polling loops, e.g. waiting for a flag.
+    vcd     Write a Value Change Dump for a waveform viewer, e.g. GTKWave or Surfer.
+            Each register is a 32-bit signal with read and write events, grouped by peripheral.
+            Marks are written as comments.
+
+Usage:
+    tools/register_trace.py stats usart_transmit.trace
+    tools/register_trace.py vcd usart_transmit.trace > usart_transmit.vcd
+"""
+
+import argparse
+import sys
+from collections import defaultdict
+
+MAGIC = b'RTRC'
+VERSION = 1
+
+TAG_NAME = 1
+TAG_READ = 2
+TAG_WRITE = 3
+TAG_MARK = 4
+
+
+class Trace:
+    def __init__(self):
+        self.names = {}
+        # (time_ns, kind, id or label, value) with kind 'read', 'write' or 'mark'
+        self.entries = []
+
+
+def read_varint(data, offset):
+    value = 0
+    shift = 0
+    while True:
+        byte = data[offset]
+        offset += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, offset
+
+
+def read_text(data, offset):
+    length, offset = read_varint(data, offset)
+    return data[offset:offset + length].decode('utf-8', errors='replace'), offset + length
+
+
+def load(data):
+    """Must match RegisterTrace::save()."""
+    if data[:4] != MAGIC or data[4] != VERSION:
+        raise ValueError('not a version 1 register trace')
+    trace = Trace()
+    offset = 5
+    time_ns = 0
+    while offset < len(data):
+        tag = data[offset]
+        offset += 1
+        if tag == TAG_NAME:
+            register_id, offset = read_varint(data, offset)
+            trace.names[register_id], offset = read_text(data, offset)
+        elif tag in (TAG_READ, TAG_WRITE):
+            delta, offset = read_varint(data, offset)
+            register_id, offset = read_varint(data, offset)
+            value, offset = read_varint(data, offset)
+            time_ns += delta
+            trace.entries.append((time_ns, 'write' if tag == TAG_WRITE else 'read', register_id, value))
+        elif tag == TAG_MARK:
+            delta, offset = read_varint(data, offset)
+            label, offset = read_text(data, offset)
+            time_ns += delta
+            trace.entries.append((time_ns, 'mark', label, None))
+        else:
+            raise ValueError(f'unknown tag {tag} at offset {offset - 1}')
+    return trace
+
+
+def sections(trace):
+    """Split the accesses at the marks. Accesses before the first mark are in an unnamed section."""
+    label, start_ns, accesses = '(start)', 0, []
+    for entry in trace.entries:
+        if entry[1] == 'mark':
+            if accesses or label != '(start)':
+                yield label, start_ns, accesses
+            label, start_ns, accesses = entry[2], entry[0], []
+        else:
+            accesses.append(entry)
+    if accesses or label != '(start)':
+        yield label, start_ns, accesses
+
+
+def print_stats(trace, out):
+    # the last known value of each register, carried across sections
+    known = {}
+    for label, start_ns, accesses in sections(trace):
+        end_ns = accesses[-1][0] if accesses else start_ns
+        out.write(f'{label}: {len(accesses)} accesses over {(end_ns - start_ns) / 1000:.3f}us\n')
+        counts = defaultdict(lambda: {'reads': 0, 'writes': 0, 'redundant': 0, 'repeated': 0})
+        last_read = {}
+        for _, kind, register_id, value in accesses:
+            count = counts[register_id]
+            if kind == 'write':
+                count['writes'] += 1
+                if known.get(register_id) == value:
+                    count['redundant'] += 1
+                last_read.pop(register_id, None)
+            else:
+                count['reads'] += 1
+                if last_read.get(register_id) == value:
+                    count['repeated'] += 1
+                last_read[register_id] = value
+            known[register_id] = value
+
+        width = max((len(trace.names.get(i, str(i))) for i in counts), default=0)
+        out.write(f'  {"register":<{width}} {"reads":>8} {"repeated":>8} {"writes":>8} {"redundant":>9}\n')
+        for register_id, count in sorted(counts.items(), key=lambda item: trace.names.get(item[0], str(item[0]))):
+            name = trace.names.get(register_id, str(register_id))
+            out.write(f'  {name:<{width}} {count["reads"]:>8} {count["repeated"]:>8} '
+                      f'{count["writes"]:>8} {count["redundant"]:>9}\n')
+
+
+def vcd_identifier(index):
+    """Short printable identifiers: '!' to '~', then two characters and so on."""
+    chars = []
+    index += 1
+    while index:
+        index, digit = divmod(index - 1, 94)
+        chars.append(chr(33 + digit))
+    return ''.join(chars)
+
+
+def write_vcd(trace, out):
+    used = sorted({entry[2] for entry in trace.entries if entry[1] != 'mark'})
+    signals = {}
+    scopes = defaultdict(list)
+    for index, register_id in enumerate(used):
+        name = trace.names.get(register_id, f'reg{register_id}')
+        scope, _, register = name.rpartition('.') if '.' in name else ('registers', '', name)
+        ids = tuple(vcd_identifier(3 * index + n) for n in range(3))
+        signals[register_id] = ids
+        scopes[scope].append((register, ids))
+
+    out.write('$comment stm32::mock::RegisterTrace $end\n$timescale 1ns $end\n')
+    for scope, registers in scopes.items():
+        out.write(f'$scope module {scope} $end\n')
+        for register, (value_id, read_id, write_id) in registers:
+            out.write(f'$var wire 32 {value_id} {register} $end\n')
+            out.write(f'$var event 1 {read_id} {register}_read $end\n')
+            out.write(f'$var event 1 {write_id} {register}_write $end\n')
+        out.write('$upscope $end\n')
+    out.write('$enddefinitions $end\n')
+
+    current_ns = None
+    values = {}
+    for time_ns, kind, key, value in trace.entries:
+        if time_ns != current_ns:
+            out.write(f'#{time_ns}\n')
+            current_ns = time_ns
+        if kind == 'mark':
+            out.write(f'$comment {key} $end\n')
+            continue
+        value_id, read_id, write_id = signals[key]
+        if values.get(key) != value:
+            out.write(f'b{value:b} {value_id}\n')
+            values[key] = value
+        out.write(f'1{write_id if kind == "write" else read_id}\n')
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('command', choices=('stats', 'vcd'))
+    parser.add_argument('input', help='trace saved by RegisterTrace::save()')
+    args = parser.parse_args()
+
+    with open(args.input, 'rb') as file:
+        trace = load(file.read())
+    if args.command == 'stats':
+        print_stats(trace, sys.stdout)
+    else:
+        write_vcd(trace, sys.stdout)
+
+
+if __name__ == '__main__':
+    main()